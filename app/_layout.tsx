@@ -4,6 +4,25 @@ import { StatusBar } from 'expo-status-bar';
 import { SafeAreaProvider } from 'react-native-safe-area-context';
 import { GestureHandlerRootView } from 'react-native-gesture-handler';
 import { useAuth } from '@/hooks/useAuth';
+import { useAuthStore } from '@/stores/authStore';
+import resumableUploadService from '@/services/resumableUploadService';
+import ApiTelemetryPanel from '@/components/debug/ApiTelemetryPanel';
+import persistedState from '@/utils/persistedState';
+import startupTrace from '@/utils/startupTrace';
+import { prefetchRoleBundle } from '@/utils/roleBundles';
+import { Role } from '@/models/types';
+
+startupTrace.mark('bundle_loaded');
+// Bắt đầu đọc storage ngay khi nạp module, song song với lúc React dựng cây;
+// biết role từ user đã lưu thì tải trước chunk màn home của role đó
+persistedState.hydrate().then(() => prefetchRoleBundle(persistedState.get('user')?.role));
+
+// Hàng đợi offline chỉ của tài xế: nạp lười để role khác không kéo code chuyến đi của tài xế.
+// start() idempotent => gọi cả khi khôi phục session lẫn khi đăng nhập trong phiên
+const startDriverOutbox = (role?: string | null) => {
+  if (role !== Role.DRIVER) return;
+  import('@/services/driverOutboxService').then(({ default: driverOutboxService }) => driverOutboxService.start());
+};
 // import { useNotification } from '@/hooks/useNotification';
 
 export default function RootLayout() {
@@ -14,7 +33,17 @@ export default function RootLayout() {
 
   useEffect(() => {
     // Khi app mở lại, tự khôi phục session từ AsyncStorage
-    restoreSession();
+    // rồi tải tiếp các upload theo chunk của thao tác đang chờ trong outbox (bỏ upload của form
+    // chỉ sống trong bộ nhớ) và gửi thao tác offline đang chờ (cần token).
+    restoreSession().then(() => {
+      startupTrace.mark('auth_restored');
+      resumableUploadService.resumePending();
+      startDriverOutbox(useAuthStore.getState().user?.role);
+    });
+    // Tài xế đăng nhập trong phiên (không qua restoreSession) cũng cần NetInfo/AppState của outbox
+    return useAuthStore.subscribe((state, prev) => {
+      if (state.user?.role !== prev.user?.role) startDriverOutbox(state.user?.role);
+    });
   }, []);
 
   return (
@@ -29,6 +58,7 @@ export default function RootLayout() {
           <Stack.Screen name="(provider)" />
           <Stack.Screen name="(wallet)" />
         </Stack>
+        {__DEV__ && <ApiTelemetryPanel />}
       </SafeAreaProvider>
     </GestureHandlerRootView>
   );
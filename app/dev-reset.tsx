@@ -2,6 +2,7 @@ import React from 'react'
 import { View, Text, TouchableOpacity, StyleSheet, Alert } from 'react-native'
 import AsyncStorage from '@react-native-async-storage/async-storage'
 import { useRouter } from 'expo-router'
+import persistedState from '@/utils/persistedState'
 
 export default function DevResetScreen() {
   const router = useRouter()
@@ -9,6 +10,7 @@ export default function DevResetScreen() {
   const clearStorage = async () => {
     try {
       await AsyncStorage.clear()
+      persistedState.reset()
       Alert.alert('Success', 'Storage cleared! App will restart.', [
         {
           text: 'OK',
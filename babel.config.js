@@ -19,6 +19,12 @@ module.exports = function (api) {
       }],
     ],
     env: {
+      production: {
+        plugins: [
+          // Bỏ log.trace / log.debug của utils/logger khỏi bản release
+          ["./scripts/babel/stripLogCalls", { levels: ["trace", "debug"] }],
+        ],
+      },
       web: {
         plugins: [
           // Add web-specific transforms to prevent prototype issues
@@ -1,16 +1,6 @@
 import React, { useEffect, useRef, useState } from 'react'
 import { View, TextInput, Text, TouchableOpacity, ScrollView, StyleSheet, ActivityIndicator } from 'react-native'
-import vietmapAutocompleteService from '@/services/vietmapAutocompleteService'
-
-type Suggestion = any
-
-const debounce = (fn: Function, wait = 300) => {
-  let t: any = null
-  return (...args: any[]) => {
-    clearTimeout(t)
-    t = setTimeout(() => fn(...args), wait)
-  }
-}
+import addressAutocompleteEngine, { AutocompleteSession, Suggestion } from '@/services/addressAutocompleteEngine'
 
 interface Props {
   value?: string
@@ -24,32 +14,40 @@ const AddressAutocomplete: React.FC<Props> = ({ value = '', onSelect, placeholde
   const [query, setQuery] = useState<string>(value)
   const [loading, setLoading] = useState(false)
   const [suggestions, setSuggestions] = useState<Suggestion[]>([])
-  const mounted = useRef(true)
+  const sessionRef = useRef<AutocompleteSession | null>(null)
 
+  // 1 phiên cho mỗi ô nhập: huỷ request cũ + chỉ áp kết quả của keystroke mới nhất
   useEffect(() => {
-    mounted.current = true
-    return () => { mounted.current = false }
+    const session = addressAutocompleteEngine.createSession({ displayType, focus }, (state) => {
+      setSuggestions(state.suggestions)
+      setLoading(state.loading)
+    })
+    sessionRef.current = session
+    return () => {
+      session.dispose()
+      sessionRef.current = null
+      if (__DEV__) console.log('[AddressAutocomplete] stats', addressAutocompleteEngine.getStats())
+    }
   }, [])
 
-  useEffect(() => { setQuery(value) }, [value])
-
-  const doSearch = async (text: string) => {
-    if (!text || text.trim().length === 0) {
-      setSuggestions([])
-      return
-    }
-    setLoading(true)
-    const res = await vietmapAutocompleteService.autocomplete({ text, display_type: displayType, focus })
-    if (!mounted.current) return
-    setSuggestions(res || [])
-    setLoading(false)
-  }
+  useEffect(() => {
+    sessionRef.current?.setOptions({ displayType, focus })
+  }, [displayType, focus?.lat, focus?.lng])
 
-  const debounced = useRef(debounce(doSearch, 300)).current
+  useEffect(() => { setQuery(value) }, [value])
 
   const onChange = (text: string) => {
     setQuery(text)
-    debounced(text)
+    sessionRef.current?.input(text)
+  }
+
+  const handleSelect = (item: Suggestion) => {
+    const { fromHistory, ...selected } = item
+    sessionRef.current?.select(selected)
+    setQuery(selected.display || selected.name)
+    setSuggestions([])
+    setLoading(false)
+    onSelect(selected)
   }
 
   return (
@@ -68,9 +66,9 @@ const AddressAutocomplete: React.FC<Props> = ({ value = '', onSelect, placeholde
               <TouchableOpacity 
                 key={item.ref_id ?? item.refId ?? idx} 
                 style={styles.item} 
-                onPress={() => { setQuery(item.display || item.name); setSuggestions([]); onSelect(item) }}
+                onPress={() => handleSelect(item)}
               >
-                <Text style={styles.itemTitle}>{item.name || item.display}</Text>
+                <Text style={styles.itemTitle}>{item.fromHistory ? '🕘 ' : ''}{item.name || item.display}</Text>
                 <Text style={styles.itemSub}>{item.display || item.address}</Text>
               </TouchableOpacity>
             ))}
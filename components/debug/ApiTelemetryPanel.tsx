@@ -0,0 +1,306 @@
+import React, { useEffect, useState } from 'react'
+import { View, Text, TouchableOpacity, StyleSheet, ScrollView, Modal, Share } from 'react-native'
+import apiTelemetry, { LATENCY_BUCKETS_MS, RouteTelemetrySummary } from '@/config/apiTelemetry'
+import requestHedger from '@/config/requestHedging'
+import { logBuffer } from '@/utils/logger'
+
+/**
+ * API Telemetry Panel - xem latency / payload theo endpoint ngay trên máy
+ * Route chậm nhất (p95) lên đầu; histogram thu gọn theo bucket của apiTelemetry.
+ * Dòng Hedge so đuôi latency GET có hedge với nhóm đối chứng không hedge.
+ * Nút Log chia sẻ ring buffer của utils/logger dạng text.
+ */
+
+const REFRESH_MS = 2000
+
+const formatBytes = (bytes: number) => {
+  if (bytes >= 1024 * 1024) return `${(bytes / 1024 / 1024).toFixed(1)} MB`
+  if (bytes >= 1024) return `${Math.round(bytes / 1024)} KB`
+  return `${bytes} B`
+}
+
+const statusOf = (route: RouteTelemetrySummary): 'ok' | 'warning' | 'error' => {
+  if (route.count > 0 && route.errors / route.count > 0.1) return 'error'
+  if (route.p95 > 3000) return 'warning'
+  return 'ok'
+}
+
+const statusColors = {
+  ok: '#10B981',
+  warning: '#F59E0B',
+  error: '#EF4444'
+}
+
+const ApiTelemetryPanel: React.FC<{ visible?: boolean }> = ({ visible = false }) => {
+  const [isVisible, setIsVisible] = useState(visible)
+  const [routes, setRoutes] = useState<RouteTelemetrySummary[]>([])
+  const [hedging, setHedging] = useState(() => requestHedger.getStats())
+
+  useEffect(() => {
+    if (!isVisible) return
+    const refresh = () => {
+      setRoutes(apiTelemetry.getSnapshot())
+      setHedging(requestHedger.getStats())
+    }
+    refresh()
+    const timer = setInterval(refresh, REFRESH_MS)
+    return () => clearInterval(timer)
+  }, [isVisible])
+
+  if (!isVisible) {
+    return (
+      <TouchableOpacity style={styles.debugButton} onPress={() => setIsVisible(true)}>
+        <Text style={styles.debugButtonText}>📡 API</Text>
+      </TouchableOpacity>
+    )
+  }
+
+  const total = routes.reduce((sum, r) => sum + r.count, 0)
+  const errors = routes.reduce((sum, r) => sum + r.errors, 0)
+  const cacheHits = routes.reduce((sum, r) => sum + r.cacheHits, 0)
+
+  return (
+    <Modal visible={isVisible} animationType="slide" transparent={true} onRequestClose={() => setIsVisible(false)}>
+      <View style={styles.modalOverlay}>
+        <View style={styles.modalContent}>
+          <View style={styles.header}>
+            <Text style={styles.title}>📡 API Telemetry</Text>
+            <TouchableOpacity onPress={() => setIsVisible(false)} style={styles.closeButton}>
+              <Text style={styles.closeText}>✕</Text>
+            </TouchableOpacity>
+          </View>
+
+          <View style={styles.toolbar}>
+            <Text style={styles.summary}>
+              {total} request · {errors} lỗi · {cacheHits} cache hit · {routes.length} route
+            </Text>
+            <TouchableOpacity style={styles.toolButton} onPress={() => apiTelemetry.flush()}>
+              <Text style={styles.toolButtonText}>Xuất</Text>
+            </TouchableOpacity>
+            <TouchableOpacity
+              style={styles.toolButton}
+              onPress={() => {
+                apiTelemetry.reset()
+                setRoutes([])
+              }}
+            >
+              <Text style={styles.toolButtonText}>Xoá</Text>
+            </TouchableOpacity>
+            <TouchableOpacity
+              style={styles.toolButton}
+              onPress={() => Share.share({ message: logBuffer.exportText() }).catch(() => {})}
+            >
+              <Text style={styles.toolButtonText}>Log</Text>
+            </TouchableOpacity>
+          </View>
+
+          <Text style={styles.hedging}>
+            Hedge {hedging.hedgesSent}/{hedging.eligible} (thắng {hedging.hedgeWins}, hết ngân sách{' '}
+            {hedging.budgetDenied}) · p95/p99 {hedging.hedged.p95}/{hedging.hedged.p99}ms, đối chứng{' '}
+            {hedging.control.p95}/{hedging.control.p99}ms · timeout {hedging.timeoutsFired}
+          </Text>
+
+          <ScrollView style={styles.scrollView}>
+            {routes.length === 0 && <Text style={styles.empty}>Chưa có request nào</Text>}
+            {routes.map((route) => (
+              <RouteRow key={route.key} route={route} />
+            ))}
+          </ScrollView>
+        </View>
+      </View>
+    </Modal>
+  )
+}
+
+const RouteRow: React.FC<{ route: RouteTelemetrySummary }> = ({ route }) => {
+  const peak = Math.max(1, ...route.buckets)
+  const errorText = Object.entries(route.errorClasses)
+    .map(([kind, count]) => `${kind} ${count}`)
+    .join(', ')
+
+  return (
+    <View style={styles.route}>
+      <View style={styles.routeHeader}>
+        <Text style={[styles.method, { color: statusColors[statusOf(route)] }]}>
+          {route.client} {route.method}
+        </Text>
+        <Text style={styles.template} numberOfLines={1}>
+          /{route.template}
+        </Text>
+      </View>
+      <Text style={styles.metrics}>
+        n={route.count} · avg {route.avgMs}ms · p50 {route.p50} · p95 {route.p95} · p99 {route.p99} · max{' '}
+        {Math.round(route.maxMs)}
+      </Text>
+      <Text style={styles.metrics}>
+        vào {formatBytes(route.count > 0 ? Math.round(route.bytesIn / route.count) : 0)}/req (max{' '}
+        {formatBytes(route.maxBytesIn)}) · ra {formatBytes(route.bytesOut)} · retry {route.retries}
+        {route.cacheHits > 0 ? ` · cache ${route.cacheHits}` : ''}
+      </Text>
+      {!!errorText && <Text style={styles.errors}>Lỗi: {errorText}</Text>}
+      <View style={styles.histogram}>
+        {route.buckets.map((count, i) => (
+          <View key={i} style={styles.histogramColumn}>
+            <View style={[styles.histogramBar, { height: Math.round((count / peak) * 28) }]} />
+          </View>
+        ))}
+      </View>
+      <View style={styles.histogramAxis}>
+        <Text style={styles.axisText}>≤{LATENCY_BUCKETS_MS[0]}ms</Text>
+        <Text style={styles.axisText}>{'>'}{LATENCY_BUCKETS_MS[LATENCY_BUCKETS_MS.length - 1] / 1000}s</Text>
+      </View>
+    </View>
+  )
+}
+
+const styles = StyleSheet.create({
+  debugButton: {
+    position: 'absolute',
+    bottom: 20,
+    left: 20,
+    backgroundColor: '#111827',
+    paddingHorizontal: 16,
+    paddingVertical: 8,
+    borderRadius: 20,
+    zIndex: 9999,
+    shadowColor: '#000',
+    shadowOffset: { width: 0, height: 2 },
+    shadowOpacity: 0.25,
+    shadowRadius: 3.84,
+    elevation: 5
+  },
+  debugButtonText: {
+    color: '#FFFFFF',
+    fontWeight: '600',
+    fontSize: 14
+  },
+  modalOverlay: {
+    flex: 1,
+    backgroundColor: 'rgba(0, 0, 0, 0.5)',
+    justifyContent: 'flex-end'
+  },
+  modalContent: {
+    backgroundColor: '#FFFFFF',
+    borderTopLeftRadius: 20,
+    borderTopRightRadius: 20,
+    maxHeight: '85%',
+    paddingBottom: 20
+  },
+  header: {
+    flexDirection: 'row',
+    justifyContent: 'space-between',
+    alignItems: 'center',
+    padding: 16,
+    borderBottomWidth: 1,
+    borderBottomColor: '#E5E7EB'
+  },
+  title: {
+    fontSize: 18,
+    fontWeight: '700',
+    color: '#111827'
+  },
+  closeButton: {
+    padding: 4
+  },
+  closeText: {
+    fontSize: 24,
+    color: '#6B7280',
+    fontWeight: '300'
+  },
+  toolbar: {
+    flexDirection: 'row',
+    alignItems: 'center',
+    paddingHorizontal: 16,
+    paddingVertical: 10,
+    gap: 8
+  },
+  summary: {
+    flex: 1,
+    fontSize: 13,
+    color: '#374151'
+  },
+  toolButton: {
+    backgroundColor: '#F3F4F6',
+    paddingHorizontal: 12,
+    paddingVertical: 6,
+    borderRadius: 8
+  },
+  toolButtonText: {
+    fontSize: 13,
+    fontWeight: '600',
+    color: '#111827'
+  },
+  hedging: {
+    fontSize: 12,
+    color: '#6B7280',
+    paddingHorizontal: 16,
+    paddingBottom: 8
+  },
+  scrollView: {
+    paddingHorizontal: 16
+  },
+  empty: {
+    textAlign: 'center',
+    color: '#6B7280',
+    paddingVertical: 24
+  },
+  route: {
+    backgroundColor: '#F9FAFB',
+    borderRadius: 8,
+    padding: 12,
+    marginBottom: 8
+  },
+  routeHeader: {
+    flexDirection: 'row',
+    alignItems: 'center',
+    marginBottom: 4
+  },
+  method: {
+    fontSize: 12,
+    fontWeight: '700',
+    marginRight: 8
+  },
+  template: {
+    flex: 1,
+    fontSize: 13,
+    fontWeight: '600',
+    color: '#111827'
+  },
+  metrics: {
+    fontSize: 12,
+    color: '#4B5563',
+    marginTop: 2
+  },
+  errors: {
+    fontSize: 12,
+    color: '#EF4444',
+    marginTop: 2
+  },
+  histogram: {
+    flexDirection: 'row',
+    alignItems: 'flex-end',
+    height: 30,
+    marginTop: 8
+  },
+  histogramColumn: {
+    flex: 1,
+    alignItems: 'stretch',
+    justifyContent: 'flex-end',
+    marginHorizontal: 1
+  },
+  histogramBar: {
+    backgroundColor: '#6366F1',
+    borderRadius: 2,
+    minHeight: 1
+  },
+  histogramAxis: {
+    flexDirection: 'row',
+    justifyContent: 'space-between'
+  },
+  axisText: {
+    fontSize: 10,
+    color: '#9CA3AF'
+  }
+})
+
+export default ApiTelemetryPanel
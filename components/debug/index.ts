@@ -1,4 +1,5 @@
 // Debug components for VietMap development and testing
 export { default as MapDebugPanel } from './MapDebugPanel'
+export { default as ApiTelemetryPanel } from './ApiTelemetryPanel'
 export { default as RealVietMapTest } from './RealVietMapTest'
 export { default as VietMapWebSDK } from './VietMapWebSDK'
\ No newline at end of file
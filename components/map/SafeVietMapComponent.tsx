@@ -301,6 +301,7 @@
 import React, { forwardRef, useImperativeHandle, useRef } from 'react'
 import { View, Text, StyleSheet, Platform } from 'react-native'
 import Svg, { Path, Circle, Defs, LinearGradient, Stop } from 'react-native-svg'
+import type { ClusterFeature, ClusterFeatureCollection, LngLatBBox } from '@/utils/pointCluster'
 
 // Safe loading pattern for React Native
 let VietMapGL: any = null
@@ -327,6 +328,9 @@ export interface SafeVietMapProps {
   externalLocation?: [number, number] | null
   userMarkerBearing?: number | undefined
   driverLocation?: { latitude: number; longitude: number; bearing?: number } | null
+  clusters?: ClusterFeatureCollection // Cụm từ PointClusterIndex, vẽ qua 1 ShapeSource
+  onViewportChange?: (bbox: LngLatBBox, zoom: number) => void
+  onClusterPointPress?: (pointId: string, feature: ClusterFeature) => void
 }
 
 // Define interface for ref methods
@@ -345,7 +349,10 @@ const SafeVietMapComponent = forwardRef<SafeVietMapRef, SafeVietMapProps>(({
   navigationActive = false,
   onLocationUpdate,
   externalLocation = null,
-  userMarkerBearing
+  userMarkerBearing,
+  clusters,
+  onViewportChange,
+  onClusterPointPress
 }, ref) => {
   const cameraRef = useRef<any>(null)
 
@@ -389,7 +396,29 @@ const SafeVietMapComponent = forwardRef<SafeVietMapRef, SafeVietMapProps>(({
   }
 
   // 2. Native Components Destructuring
-  const { MapView, Camera, UserLocation, LineLayer, ShapeSource, PointAnnotation } = VietMapGL
+  const { MapView, Camera, UserLocation, LineLayer, ShapeSource, PointAnnotation, CircleLayer, SymbolLayer } = VietMapGL
+
+  // visibleBounds = [[neLng, neLat], [swLng, swLat]]
+  const handleRegionDidChange = (feature: any) => {
+    const bounds = feature?.properties?.visibleBounds
+    const zoom = feature?.properties?.zoomLevel
+    if (!onViewportChange || !bounds || typeof zoom !== 'number') return
+    onViewportChange([bounds[1][0], bounds[1][1], bounds[0][0], bounds[0][1]], zoom)
+  }
+
+  const handleClusterPress = (event: any) => {
+    const feature: ClusterFeature | undefined = event?.features?.[0]
+    if (!feature?.properties) return
+    if (feature.properties.cluster) {
+      cameraRef.current?.setCamera({
+        centerCoordinate: feature.geometry.coordinates,
+        zoomLevel: feature.properties.expansion_zoom,
+        animationDuration: 500
+      })
+    } else {
+      onClusterPointPress?.(feature.properties.point_id, feature)
+    }
+  }
 
   return (
     <View style={[{ flex: 1, overflow: 'hidden' }, style]}>
@@ -398,6 +427,7 @@ const SafeVietMapComponent = forwardRef<SafeVietMapRef, SafeVietMapProps>(({
         mapStyle={mapStyleUrl}
         logoEnabled={false}
         attributionEnabled={false}
+        onRegionDidChange={onViewportChange ? handleRegionDidChange : undefined}
       >
         <Camera
           ref={cameraRef}
@@ -463,6 +493,45 @@ const SafeVietMapComponent = forwardRef<SafeVietMapRef, SafeVietMapProps>(({
           </ShapeSource>
         )}
 
+        {/* Clusters: 1 source, style theo point_count (data-driven) */}
+        {clusters && clusters.features.length > 0 && (
+          <ShapeSource id="clusterSource" shape={clusters} onPress={handleClusterPress}>
+            <CircleLayer
+              id="clusterCircles"
+              filter={['==', ['get', 'cluster'], true]}
+              style={{
+                circleColor: ['step', ['get', 'point_count'], '#60A5FA', 50, '#F59E0B', 500, '#EF4444'],
+                circleRadius: ['step', ['get', 'point_count'], 16, 50, 22, 500, 28],
+                circleOpacity: 0.85,
+                circleStrokeWidth: 2,
+                circleStrokeColor: '#FFFFFF'
+              }}
+            />
+            {SymbolLayer && (
+              <SymbolLayer
+                id="clusterCount"
+                filter={['==', ['get', 'cluster'], true]}
+                style={{
+                  textField: ['get', 'point_count_abbreviated'],
+                  textSize: 12,
+                  textColor: '#FFFFFF',
+                  textAllowOverlap: true
+                }}
+              />
+            )}
+            <CircleLayer
+              id="clusterPoints"
+              filter={['==', ['get', 'cluster'], false]}
+              style={{
+                circleColor: '#4F46E5',
+                circleRadius: 7,
+                circleStrokeWidth: 2,
+                circleStrokeColor: '#FFFFFF'
+              }}
+            />
+          </ShapeSource>
+        )}
+
         {/* Custom Car Marker */}
         {externalLocation && (
           <PointAnnotation id="userMarker" coordinate={externalLocation}>
@@ -1,10 +1,15 @@
 
 
-import React, { Suspense, forwardRef } from 'react'
+import React, { Suspense, forwardRef, lazy } from 'react'
 import { View, Text, StyleSheet, ActivityIndicator, Platform } from 'react-native'
-import SafeVietMapComponent, { SafeVietMapRef } from './SafeVietMapComponent'
-import VietMapWebWrapper from './VietMapWebWrapper'
-import WebNavigation from './WebNavigation'
+import type { SafeVietMapRef } from './SafeVietMapComponent'
+import type { ClusterFeature, ClusterFeatureCollection, LngLatBBox } from '@/utils/pointCluster'
+
+// SDK bản đồ chỉ nạp khi bản đồ mount lần đầu (như VietMapLazyWrapper), và chỉ nhánh
+// của nền tảng đang chạy: màn hình import VietMapUniversal không kéo theo SDK lúc khởi động
+const SafeVietMapComponent = lazy(() => import('./SafeVietMapComponent'))
+const VietMapWebWrapper = lazy(() => import('./VietMapWebWrapper'))
+const WebNavigation = lazy(() => import('./WebNavigation'))
 
 export interface VietMapUniversalProps {
   coordinates?: [number, number][]
@@ -22,6 +27,9 @@ export interface VietMapUniversalProps {
   primaryRouteColor?: string
   secondaryRouteColor?: string
   driverLocation?: { latitude: number; longitude: number; bearing?: number } | null
+  clusters?: ClusterFeatureCollection
+  onViewportChange?: (bbox: LngLatBBox, zoom: number) => void
+  onClusterPointPress?: (pointId: string, feature: ClusterFeature) => void
 }
 
 const LoadingFallback = () => (
@@ -2,6 +2,8 @@
 
 import React, { useEffect, useRef, useState, useCallback } from 'react'
 import { View, StyleSheet, Platform, ActivityIndicator, Text } from 'react-native'
+import { useRoutePipeline } from '@/hooks/useRoutePipeline'
+import type { ClusterFeature, ClusterFeatureCollection, LngLatBBox } from '@/utils/pointCluster'
 
 declare global {
   interface Window {
@@ -23,8 +25,14 @@ export interface VietMapWebWrapperProps {
   userMarkerPosition?: [number, number]
   userMarkerBearing?: number
   driverLocation?: { latitude: number; longitude: number; bearing?: number } | null
+  progressFraction?: number // 0..1, tô phần tuyến đã đi (line-progress) thay vì setData lại
+  clusters?: ClusterFeatureCollection // Cụm từ PointClusterIndex, vẽ qua 1 geojson source
+  onViewportChange?: (bbox: LngLatBBox, zoom: number) => void
+  onClusterPointPress?: (pointId: string, feature: ClusterFeature) => void
 }
 
+const TRAVELED_ROUTE_COLOR = '#9CA3AF'
+
 // CDN VietMap GL JS v6 (Link chuẩn)
 const SDK_CONFIG = {
   css: 'https://unpkg.com/@vietmap/vietmap-gl-js@6.0.0/dist/vietmap-gl.css',
@@ -44,16 +52,29 @@ export const VietMapWebWrapper: React.FC<VietMapWebWrapperProps> = ({
   onMapClick,
   userMarkerPosition,
   userMarkerBearing,
-  driverLocation
+  driverLocation,
+  progressFraction,
+  clusters,
+  onViewportChange,
+  onClusterPointPress
 }) => {
   const mapContainerRef = useRef<HTMLDivElement>(null)
   const mapRef = useRef<any>(null)
   const markerRef = useRef<any>(null)
   const driverMarkerRef = useRef<any>(null)
+  // Callback mới nhất cho các handler đăng ký 1 lần trên map
+  const onViewportChangeRef = useRef(onViewportChange)
+  onViewportChangeRef.current = onViewportChange
+  const onClusterPointPressRef = useRef(onClusterPointPress)
+  onClusterPointPressRef.current = onClusterPointPress
   
   const [isMapLoaded, setIsMapLoaded] = useState(false)
   const [loadError, setLoadError] = useState<string | null>(null)
 
+  // Lọc toạ độ + bounds của cả 2 tuyến chạy trong Web Worker
+  const { route: primary } = useRoutePipeline(coordinates)
+  const { route: secondary } = useRoutePipeline(secondaryRoute)
+
   // 1. Load Resource
   const loadResource = (url: string, type: 'link' | 'script') => {
     return new Promise<void>((resolve, reject) => {
@@ -138,6 +159,12 @@ export const VietMapWebWrapper: React.FC<VietMapWebWrapperProps> = ({
       })
 
       map.on('click', (e: any) => onMapClick?.([e.lngLat.lng, e.lngLat.lat]))
+      const emitViewport = () => {
+        const b = map.getBounds()
+        onViewportChangeRef.current?.([b.getWest(), b.getSouth(), b.getEast(), b.getNorth()], map.getZoom())
+      }
+      map.on('load', emitViewport)
+      map.on('moveend', emitViewport)
       map.addControl(new window.vietmapgl.NavigationControl(), 'top-right')
 
     } catch (e: any) {
@@ -156,11 +183,11 @@ export const VietMapWebWrapper: React.FC<VietMapWebWrapperProps> = ({
     const secondaryLayerId = 'route-layer-secondary'
 
     try {
-      // Coerce coordinates and filter invalid
-      const pts = (coordinates || []).map((c: any) => [Number(c[0]), Number(c[1])]).filter((c: any) => Number.isFinite(c[0]) && Number.isFinite(c[1]))
-      const pts2 = (secondaryRoute || []).map((c: any) => [Number(c[0]), Number(c[1])]).filter((c: any) => Number.isFinite(c[0]) && Number.isFinite(c[1]))
-      if (pts.length < 2 && pts2.length < 2) {
-        console.debug('[VietMapWebWrapper] addRouteLayer: not enough points for either route, pts=', pts.length, 'pts2=', pts2.length)
+      // Toạ độ đã được worker ép kiểu/lọc, ở đây chỉ đẩy vào source
+      const primaryCount = primary?.pointCount ?? 0
+      const secondaryCount = secondary?.pointCount ?? 0
+      if (primaryCount < 2 && secondaryCount < 2) {
+        console.debug('[VietMapWebWrapper] addRouteLayer: not enough points for either route, pts=', primaryCount, 'pts2=', secondaryCount)
         return
       }
 
@@ -169,11 +196,12 @@ export const VietMapWebWrapper: React.FC<VietMapWebWrapperProps> = ({
 
       // Update existing source if present
       // Primary route
-      if (pts.length >= 2) {
+      if (primary && primaryCount >= 2) {
         if (map.getSource && map.getSource(sourceId)) {
-          try { (map.getSource(sourceId) as any).setData({ type: 'Feature', properties: {}, geometry: { type: 'LineString', coordinates: pts } }) } catch (e) { console.warn('[VietMapWebWrapper] setData primary failed', e) }
+          try { (map.getSource(sourceId) as any).setData(primary.line) } catch (e) { console.warn('[VietMapWebWrapper] setData primary failed', e) }
         } else {
-          map.addSource(sourceId, { type: 'geojson', data: { type: 'Feature', properties: {}, geometry: { type: 'LineString', coordinates: pts } } })
+          // lineMetrics để tô tiến độ bằng line-progress mà không phải cắt lại geometry
+          map.addSource(sourceId, { type: 'geojson', data: primary.line, lineMetrics: true })
           map.addLayer({
             id: layerId,
             type: 'line',
@@ -189,11 +217,11 @@ export const VietMapWebWrapper: React.FC<VietMapWebWrapperProps> = ({
       }
 
       // Secondary route (drawn under/behind primary when present)
-      if (pts2.length >= 2) {
+      if (secondary && secondaryCount >= 2) {
         if (map.getSource && map.getSource(secondarySourceId)) {
-          try { (map.getSource(secondarySourceId) as any).setData({ type: 'Feature', properties: {}, geometry: { type: 'LineString', coordinates: pts2 } }) } catch (e) { console.warn('[VietMapWebWrapper] setData secondary failed', e) }
+          try { (map.getSource(secondarySourceId) as any).setData(secondary.line) } catch (e) { console.warn('[VietMapWebWrapper] setData secondary failed', e) }
         } else {
-          map.addSource(secondarySourceId, { type: 'geojson', data: { type: 'Feature', properties: {}, geometry: { type: 'LineString', coordinates: pts2 } } })
+          map.addSource(secondarySourceId, { type: 'geojson', data: secondary.line })
           map.addLayer({
             id: secondaryLayerId,
             type: 'line',
@@ -204,22 +232,98 @@ export const VietMapWebWrapper: React.FC<VietMapWebWrapperProps> = ({
               'line-width': navigationActive ? 5 : 4,
               'line-opacity': 0.6
             }
-          }, layerId) // insert below primary if primary exists
+          }, map.getLayer(layerId) ? layerId : undefined) // insert below primary if primary exists
         }
       }
 
       try {
-        const bounds = new window.vietmapgl.LngLatBounds()
-        const extPts = pts.length >= 2 ? pts : pts2
-        extPts.forEach((c: any) => bounds.extend(c))
-        map.fitBounds(bounds, { padding: 50 })
+        const b = primaryCount >= 2 ? primary?.bounds : secondary?.bounds
+        if (b) map.fitBounds([b.sw, b.ne], { padding: 50 })
       } catch (e) { console.warn('[VietMapWebWrapper] fitBounds failed', e) }
 
-      console.debug('[VietMapWebWrapper] Route added/updated primaryPts=', pts.length, 'secondaryPts=', pts2.length)
+      console.debug('[VietMapWebWrapper] Route added/updated primaryPts=', primaryCount, 'secondaryPts=', secondaryCount)
     } catch (e) {
       console.error('[VietMapWebWrapper] addRouteLayer failed:', e)
     }
-  }, [coordinates, secondaryRoute, navigationActive, isMapLoaded, primaryRouteColor, secondaryRouteColor])
+  }, [primary, secondary, navigationActive, isMapLoaded, primaryRouteColor, secondaryRouteColor])
+
+  // 4b. Route progress: chỉ đổi paint property, không đụng tới geometry
+  useEffect(() => {
+    const map = mapRef.current
+    if (!map || !isMapLoaded || !primary) return
+    const layerId = 'route-layer'
+    try {
+      if (!map.getLayer(layerId)) return
+      if (typeof progressFraction !== 'number' || progressFraction <= 0) {
+        map.setPaintProperty(layerId, 'line-gradient', undefined)
+        return
+      }
+      const stop = Math.min(Math.max(progressFraction, 0.0001), 0.9999)
+      map.setPaintProperty(layerId, 'line-gradient', [
+        'step', ['line-progress'],
+        TRAVELED_ROUTE_COLOR,
+        stop, primaryRouteColor
+      ])
+    } catch (e) {
+      console.warn('[VietMapWebWrapper] progress paint failed', e)
+    }
+  }, [progressFraction, primary, isMapLoaded, primaryRouteColor])
+
+  // 4c. Clusters: 1 source, style theo point_count (data-driven)
+  useEffect(() => {
+    const map = mapRef.current
+    if (!map || !isMapLoaded) return
+    const sourceId = 'cluster-source'
+    const data = clusters ?? { type: 'FeatureCollection', features: [] }
+    try {
+      const source = map.getSource(sourceId)
+      if (source) {
+        source.setData(data)
+        return
+      }
+      if (!clusters) return
+      map.addSource(sourceId, { type: 'geojson', data })
+      map.addLayer({
+        id: 'cluster-circles',
+        type: 'circle',
+        source: sourceId,
+        filter: ['==', ['get', 'cluster'], true],
+        paint: {
+          'circle-color': ['step', ['get', 'point_count'], '#60A5FA', 50, '#F59E0B', 500, '#EF4444'],
+          'circle-radius': ['step', ['get', 'point_count'], 16, 50, 22, 500, 28],
+          'circle-opacity': 0.85,
+          'circle-stroke-width': 2,
+          'circle-stroke-color': '#FFFFFF'
+        }
+      })
+      map.addLayer({
+        id: 'cluster-count',
+        type: 'symbol',
+        source: sourceId,
+        filter: ['==', ['get', 'cluster'], true],
+        layout: { 'text-field': ['get', 'point_count_abbreviated'], 'text-size': 12, 'text-allow-overlap': true },
+        paint: { 'text-color': '#FFFFFF' }
+      })
+      map.addLayer({
+        id: 'cluster-points',
+        type: 'circle',
+        source: sourceId,
+        filter: ['==', ['get', 'cluster'], false],
+        paint: { 'circle-color': '#4F46E5', 'circle-radius': 7, 'circle-stroke-width': 2, 'circle-stroke-color': '#FFFFFF' }
+      })
+      map.on('click', 'cluster-circles', (e: any) => {
+        const f = e.features?.[0]
+        if (!f) return
+        map.easeTo({ center: f.geometry.coordinates, zoom: f.properties.expansion_zoom })
+      })
+      map.on('click', 'cluster-points', (e: any) => {
+        const f = e.features?.[0]
+        if (f) onClusterPointPressRef.current?.(String(f.properties.point_id), f)
+      })
+    } catch (e) {
+      console.warn('[VietMapWebWrapper] cluster layer failed', e)
+    }
+  }, [clusters, isMapLoaded])
 
   // 5. User Marker
   useEffect(() => {
@@ -316,7 +420,7 @@ export const VietMapWebWrapper: React.FC<VietMapWebWrapperProps> = ({
     }
 
     return () => { if (intervalId) clearInterval(intervalId) }
-  }, [coordinates, isMapLoaded, addRouteLayer])
+  }, [primary, secondary, isMapLoaded, addRouteLayer])
 
   if (Platform.OS !== 'web') return null
 
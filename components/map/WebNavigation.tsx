@@ -469,6 +469,7 @@
 import React, { useState, useEffect, useRef, useCallback } from 'react'
 import { View, Text, StyleSheet, TouchableOpacity, Platform } from 'react-native'
 import VietMapWebWrapper from './VietMapWebWrapper'
+import { useRoutePipeline } from '@/hooks/useRoutePipeline'
 
 export interface WebNavigationProps {
   coordinates: [number, number][]
@@ -502,6 +503,16 @@ export const WebNavigation: React.FC<WebNavigationProps> = ({
   const [speed, setSpeed] = useState(0)
   
   const watchIdRef = useRef<number | null>(null)
+  const externalLocationRef = useRef(externalLocation)
+  externalLocationRef.current = externalLocation
+
+  // Snap + tiến độ tính trong Web Worker; callback GPS chỉ gửi vị trí và nhận lại vài số
+  const { snap } = useRoutePipeline(coordinates)
+  const updateProgress = useCallback((pos: [number, number]) => {
+    snap(pos).then((s) => {
+      if (s) setRouteProgress(s.fraction * 100)
+    })
+  }, [snap])
 
   // --- 1. Simulation & GPS Logic ---
   const startNavigation = useCallback(() => {
@@ -515,16 +526,14 @@ export const WebNavigation: React.FC<WebNavigationProps> = ({
           setCurrentLocation(newLoc)
           onLocationUpdate?.(newLoc)
           setSpeed(pos.coords.speed ? pos.coords.speed * 3.6 : 0) // m/s to km/h
-          
-          // Simple progress simulation based on coordinates index matching would go here
-          // For now we simulate progress for visual demo
-          setRouteProgress(prev => Math.min(prev + 0.1, 100)) 
+          // Có vị trí ngoài (simulator/app) thì tiến độ theo vị trí đó, xem effect bên dưới
+          if (!externalLocationRef.current) updateProgress(newLoc)
         },
         (err) => console.warn(err),
         { enableHighAccuracy: true }
       )
     }
-  }, [])
+  }, [updateProgress])
 
   const stopNavigation = useCallback(() => {
     setIsNavigating(false)
@@ -542,8 +551,10 @@ export const WebNavigation: React.FC<WebNavigationProps> = ({
 
   // Sync external location
   useEffect(() => {
-    if (externalLocation) setCurrentLocation(externalLocation)
-  }, [externalLocation])
+    if (!externalLocation) return
+    setCurrentLocation(externalLocation)
+    if (isNavigating) updateProgress(externalLocation)
+  }, [externalLocation, isNavigating, updateProgress])
 
   if (Platform.OS !== 'web') return null
 
@@ -557,6 +568,7 @@ export const WebNavigation: React.FC<WebNavigationProps> = ({
           navigationActive={isNavigating}
           userMarkerPosition={externalLocation ?? currentLocation ?? undefined}
           userMarkerBearing={userMarkerBearing}
+          progressFraction={isNavigating ? routeProgress / 100 : undefined}
         />
       </View>
 
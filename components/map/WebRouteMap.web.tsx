@@ -1,7 +1,6 @@
 import React, { useEffect, useRef, useMemo, useState } from 'react'
 import { View, Text, StyleSheet } from 'react-native'
-import { decodePolyline } from '@/utils/polyline'
-import { computeBounds } from '@/utils/map'
+import { useRoutePipeline } from '@/hooks/useRoutePipeline'
 import { vietmapStyleUrl, vietmapAPIKey } from '@/config/vietmap'
 
 export interface WebRouteMapProps {
@@ -31,11 +30,13 @@ const WebRouteMap: React.FC<WebRouteMapProps> = ({ routeData, coordinates, style
   const mapRef = useRef<any>(null)
   const watchIdRef = useRef<number | null>(null)
 
-  const coords = useMemo(() => {
-    if (coordinates && coordinates.length > 0) return coordinates
-    if (routeData) return decodePolyline(routeData, 5).coordinates
-    return [] as [number, number][]
-  }, [routeData, coordinates])
+  // Decode/lọc/bounds/snap chạy trong Web Worker, ở đây chỉ áp kết quả vào map
+  const { route, pending: routePending, snap } = useRoutePipeline(coordinates, routeData, 5)
+  const coords = useMemo(() => (route?.line.geometry.coordinates ?? []) as [number, number][], [route])
+  // Map chỉ dựng 1 lần: route mới từ worker đi qua effect cập nhật source bên dưới,
+  // init / fallback style đọc bản mới nhất qua ref thay vì dựng lại map
+  const routeRef = useRef(route)
+  routeRef.current = route
 
   const resolvedStyleUrl = useMemo(() => vietmapStyleUrl('light'), [])
   const styleHasKey = useMemo(() => {
@@ -45,30 +46,6 @@ const WebRouteMap: React.FC<WebRouteMapProps> = ({ routeData, coordinates, style
     } catch { return false }
   }, [resolvedStyleUrl])
 
-  // Helpers for route-snapped bearing when device heading is unavailable
-  const nearestIndex = (pos: [number, number], arr: [number, number][]) => {
-    let best = 0; let bestD = Number.POSITIVE_INFINITY
-    for (let i = 0; i < arr.length; i++) {
-      const dx = arr[i][0] - pos[0]
-      const dy = arr[i][1] - pos[1]
-      const d = dx * dx + dy * dy
-      if (d < bestD) { bestD = d; best = i }
-    }
-    return best
-  }
-  const bearingBetween = (a: [number, number], b: [number, number]) => {
-    // a=[lng,lat], b=[lng,lat]
-    const toRad = (d: number) => d * Math.PI / 180
-    const toDeg = (r: number) => r * 180 / Math.PI
-    const φ1 = toRad(a[1]); const φ2 = toRad(b[1])
-    const Δλ = toRad(b[0] - a[0])
-    const y = Math.sin(Δλ) * Math.cos(φ2)
-    const x = Math.cos(φ1) * Math.cos(φ2) * Math.cos(Δλ) + Math.sin(φ1) * Math.sin(φ2)
-    const θ = Math.atan2(y, x)
-    const brng = (toDeg(θ) + 360) % 360
-    return brng
-  }
-
   useEffect(() => {
     let map: any = null
     let appliedFallback = false
@@ -120,12 +97,9 @@ const WebRouteMap: React.FC<WebRouteMapProps> = ({ routeData, coordinates, style
         }
 
         const addRouteLayer = () => {
-          if (!coords.length) return
-          const line = {
-            type: 'Feature',
-            properties: {},
-            geometry: { type: 'LineString', coordinates: coords }
-          }
+          const route = routeRef.current
+          if (!route || !route.line.geometry.coordinates.length) return
+          const line = route.line
           if (!map.getSource('route')) {
             map.addSource('route', { type: 'geojson', data: line })
           } else {
@@ -135,7 +109,7 @@ const WebRouteMap: React.FC<WebRouteMapProps> = ({ routeData, coordinates, style
           if (!map.getLayer('route')) {
             map.addLayer({ id: 'route', type: 'line', source: 'route', paint: { 'line-color': '#2563EB', 'line-width': 4 } })
           }
-          const b = computeBounds(coords)
+          const b = route.bounds
           if (b) {
             map.fitBounds([b.sw as any, b.ne as any], { padding: 40, duration: 600 })
           }
@@ -144,7 +118,7 @@ const WebRouteMap: React.FC<WebRouteMapProps> = ({ routeData, coordinates, style
         map = new MapGL.Map({
           container: container,
           style: resolvedStyleUrl,
-          center: coords[0] || [106.8019, 10.8412],
+          center: (routeRef.current?.line.geometry.coordinates[0] as [number, number]) || [106.8019, 10.8412],
           zoom: 12,
           transformRequest: (url: string, resourceType: string) => {
             return { url: appendApiKey(url) }
@@ -203,18 +177,14 @@ const WebRouteMap: React.FC<WebRouteMapProps> = ({ routeData, coordinates, style
 
     init()
     return () => { if (map) map.remove(); mapRef.current = null }
-  }, [coords, resolvedStyleUrl, followUserLocation])
+  }, [resolvedStyleUrl, followUserLocation])
 
   // Update route and fit when coordinates change after map is ready
   useEffect(() => {
     const map = mapRef.current
-    if (!map || !coords.length) return
+    if (!map || !route || !coords.length) return
     const apply = () => {
-      const line = {
-        type: 'Feature',
-        properties: {},
-        geometry: { type: 'LineString', coordinates: coords }
-      }
+      const line = route.line
       try {
         if (!map.getSource('route')) {
           map.addSource('route', { type: 'geojson', data: line })
@@ -226,13 +196,13 @@ const WebRouteMap: React.FC<WebRouteMapProps> = ({ routeData, coordinates, style
         }
       } catch {}
       try {
-        const b = computeBounds(coords)
+        const b = route.bounds
         if (b) map.fitBounds([b.sw as any, b.ne as any], { padding: 40, duration: 600 })
       } catch {}
     }
     if ((map as any).__loaded) apply()
     else map.once('load', apply)
-  }, [coords])
+  }, [route, coords])
 
   // Watch browser geolocation to emulate first-person follow on web
   useEffect(() => {
@@ -279,28 +249,31 @@ const WebRouteMap: React.FC<WebRouteMapProps> = ({ routeData, coordinates, style
           } else {
             markerRef.current.setLngLat(lngLatSource)
           }
-          let frameBearing: number | undefined = userMarkerBearing ?? ((typeof heading === 'number' && !Number.isNaN(heading)) ? heading : undefined)
-          if (frameBearing === undefined && coords.length > 1) {
-            const ni = nearestIndex(lngLatSource, coords)
-            const target = coords[Math.min(ni + 1, coords.length - 1)]
-            if (target) frameBearing = bearingBetween(lngLat, target)
-          }
-          if (typeof frameBearing === 'number') {
-            try { markerRef.current.setRotation(frameBearing) } catch {}
+          const applyFrame = (frameBearing: number | undefined) => {
+            if (typeof frameBearing === 'number') {
+              try { markerRef.current?.setRotation(frameBearing) } catch {}
+            }
+            if (followUserLocation || userMarkerPosition) {
+              try {
+                const cameraBearing = followBearing !== undefined ? followBearing : ((typeof frameBearing === 'number') ? frameBearing : (map.getBearing?.() ?? 0))
+                const cameraPitch = followPitch !== undefined ? followPitch : 55
+                
+                map.easeTo({
+                  center: lngLatSource,
+                  zoom: (followZoomLevel ?? 17),
+                  bearing: cameraBearing,
+                  pitch: cameraPitch,
+                  duration: 600
+                })
+              } catch {}
+            }
           }
-          if (followUserLocation || userMarkerPosition) {
-            try {
-              const cameraBearing = followBearing !== undefined ? followBearing : ((typeof frameBearing === 'number') ? frameBearing : (map.getBearing?.() ?? 0))
-              const cameraPitch = followPitch !== undefined ? followPitch : 55
-              
-              map.easeTo({
-                center: lngLatSource,
-                zoom: (followZoomLevel ?? 17),
-                bearing: cameraBearing,
-                pitch: cameraPitch,
-                duration: 600
-              })
-            } catch {}
+          const frameBearing: number | undefined = userMarkerBearing ?? ((typeof heading === 'number' && !Number.isNaN(heading)) ? heading : undefined)
+          if (frameBearing === undefined) {
+            // Không có heading: lấy hướng đoạn tuyến gần nhất, snap chạy trong worker
+            snap(lngLatSource).then((s) => applyFrame(s?.bearing))
+          } else {
+            applyFrame(frameBearing)
           }
         },
         () => { /* ignore errors to avoid noisy UX */ },
@@ -318,7 +291,7 @@ const WebRouteMap: React.FC<WebRouteMapProps> = ({ routeData, coordinates, style
         markerRef.current = null
       }
     }
-  }, [followUserLocation, followZoomLevel, showUserLocation])
+  }, [followUserLocation, followZoomLevel, showUserLocation, snap])
 
   // Ensure marker is visible even if browser geolocation isn't available, using incoming props
   useEffect(() => {
@@ -411,7 +384,7 @@ const WebRouteMap: React.FC<WebRouteMapProps> = ({ routeData, coordinates, style
     return cleanup
   }, [startMarker, endMarker, currentMarker, showOverviewMarkers])
 
-  if (!coords.length) return <View style={[{ justifyContent: 'center', alignItems: 'center' }, style]}><Text>Không có dữ liệu tuyến đường</Text></View>
+  if (!coords.length && !routePending) return <View style={[{ justifyContent: 'center', alignItems: 'center' }, style]}><Text>Không có dữ liệu tuyến đường</Text></View>
 
   // Flatten RN style to extract only width/height for proper React Native Web styling
   const flat = StyleSheet.flatten([{ width: '100%', height: 300 }, style]) as any
@@ -12,6 +12,7 @@ import {
 } from 'react-native';
 import { MaterialIcons, Ionicons } from '@expo/vector-icons';
 import * as ImagePicker from 'expo-image-picker';
+import { IMAGE_PICKER_QUALITY } from '@/services/imagePipeline';
 
 // Types
 export interface ChecklistItemData {
@@ -111,20 +112,16 @@ const HandoverChecklistEditor: React.FC<Props> = ({
       const result = await ImagePicker.launchImageLibraryAsync({
         mediaTypes: ImagePicker.MediaTypeOptions.Images,
         allowsEditing: false,
-        quality: 0.5,
-        base64: true,
+        quality: IMAGE_PICKER_QUALITY,
       });
 
       if (!result.canceled && result.assets[0]) {
         const asset = result.assets[0];
-        const dataUrl = asset.base64
-          ? `data:image/jpeg;base64,${asset.base64}`
-          : undefined;
         
-        // For Web: Convert to File object
-        if (Platform.OS === 'web' && (dataUrl || asset.uri)) {
+        // For Web: Convert to File object (asset.uri là data:/blob: URL)
+        if (Platform.OS === 'web' && asset.uri) {
           try {
-            const response = await fetch(dataUrl || asset.uri);
+            const response = await fetch(asset.uri);
             const blob = await response.blob();
             const file = new File([blob], `evidence-${index}-${Date.now()}.jpg`, {
               type: 'image/jpeg',
@@ -132,7 +129,7 @@ const HandoverChecklistEditor: React.FC<Props> = ({
             updateChecklistItem(index, 'evidenceImage', file);
           } catch (error) {
             console.error('Error converting to File:', error);
-            updateChecklistItem(index, 'evidenceImage', dataUrl || asset.uri);
+            updateChecklistItem(index, 'evidenceImage', asset.uri);
           }
         } else {
           // For Mobile: Use dataUrl or URI
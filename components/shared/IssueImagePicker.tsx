@@ -9,6 +9,7 @@ import {
 } from 'react-native';
 import { MaterialIcons, Ionicons } from '@expo/vector-icons';
 import * as ImagePicker from 'expo-image-picker';
+import { IMAGE_PICKER_QUALITY } from '@/services/imagePipeline';
 
 interface IssueImagePickerProps {
   images: Array<{
@@ -48,21 +49,18 @@ const IssueImagePicker: React.FC<IssueImagePickerProps> = ({
     const result = await ImagePicker.launchImageLibraryAsync({
       mediaTypes: ImagePicker.MediaTypeOptions.Images,
       allowsMultipleSelection: true,
-      quality: 0.5,
+      quality: IMAGE_PICKER_QUALITY,
       selectionLimit: maxImages - images.length,
-      base64: true,
     });
 
     if (!result.canceled && result.assets) {
       const newImages = result.assets.map((asset) => {
         const fileName = asset.fileName || `issue_${Date.now()}.jpg`;
-        const dataUrl = asset.base64
-          ? `data:image/jpeg;base64,${asset.base64}`
-          : asset.uri;
 
+        // Giữ file:// của asset (web: data:/blob: URL), imagePipeline nén khi upload
         return {
-          uri: dataUrl,
-          imageURL: dataUrl,
+          uri: asset.uri,
+          imageURL: asset.uri,
           fileName,
           type: asset.mimeType || 'image/jpeg',
         };
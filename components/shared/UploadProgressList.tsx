@@ -0,0 +1,84 @@
+import React from 'react';
+import { View, Text, StyleSheet } from 'react-native';
+import { Ionicons } from '@expo/vector-icons';
+import useUploadProgress from '@/hooks/useUploadProgress';
+
+/**
+ * Tiến độ từng file đang tải theo chunk (resumableUploadService) trong phiên.
+ * Đặt trong form có ảnh/tài liệu; không có upload nào (hoặc tắt resumable) thì không hiện gì.
+ */
+const UploadProgressList: React.FC = () => {
+  const uploads = useUploadProgress();
+  if (uploads.length === 0) return null;
+
+  return (
+    <View style={styles.container}>
+      {uploads.map((upload) => {
+        const percent = upload.totalBytes > 0 ? Math.round((upload.bytesUploaded / upload.totalBytes) * 100) : 0;
+        const failed = upload.status === 'failed';
+        return (
+          <View key={upload.id} style={styles.row}>
+            <View style={styles.header}>
+              <Ionicons
+                name={failed ? 'alert-circle' : 'cloud-upload-outline'}
+                size={14}
+                color={failed ? '#DC2626' : '#2563EB'}
+              />
+              <Text style={styles.fileName} numberOfLines={1}>
+                {upload.fileName}
+              </Text>
+              <Text style={[styles.percent, failed && styles.failedText]}>{failed ? 'Lỗi' : `${percent}%`}</Text>
+            </View>
+            <View style={styles.track}>
+              <View style={[styles.bar, { width: `${percent}%` }, failed && styles.failedBar]} />
+            </View>
+          </View>
+        );
+      })}
+    </View>
+  );
+};
+
+const styles = StyleSheet.create({
+  container: {
+    width: '100%',
+    gap: 8,
+    marginTop: 8,
+  },
+  row: {
+    gap: 4,
+  },
+  header: {
+    flexDirection: 'row',
+    alignItems: 'center',
+    gap: 6,
+  },
+  fileName: {
+    flex: 1,
+    fontSize: 12,
+    color: '#374151',
+  },
+  percent: {
+    fontSize: 12,
+    fontWeight: '600',
+    color: '#2563EB',
+  },
+  failedText: {
+    color: '#DC2626',
+  },
+  track: {
+    height: 4,
+    borderRadius: 2,
+    backgroundColor: '#E5E7EB',
+    overflow: 'hidden',
+  },
+  bar: {
+    height: '100%',
+    backgroundColor: '#2563EB',
+  },
+  failedBar: {
+    backgroundColor: '#DC2626',
+  },
+});
+
+export default UploadProgressList;
@@ -0,0 +1,278 @@
+import React, { useCallback, useEffect, useMemo, useRef, useState } from 'react';
+import {
+  FlatList,
+  FlatListProps,
+  LayoutChangeEvent,
+  ListRenderItemInfo,
+  NativeScrollEvent,
+  NativeSyntheticEvent,
+  Platform,
+  StyleSheet,
+  View,
+} from 'react-native';
+import { ItemLayoutTable } from '@/utils/listLayout';
+import { ListPerfMonitor } from '@/utils/listPerfMonitor';
+
+/**
+ * VirtualizedCardList - FlatList cho các thẻ nặng (TripCard, PackageCard, ...)
+ *
+ * - getItemLayout từ bảng chiều cao ước lượng trước (estimateHeight), ô đã render
+ *   thì cập nhật bằng số đo thật => cuộn nhanh/nhảy tới vị trí không phải đo lại.
+ * - Mỗi ô là React.memo theo (key, versionOf(item), extraData): nạp thêm trang hay
+ *   đổi 1 dòng không render lại các thẻ còn lại. Mặc định version = reference của item
+ *   (entityStore giữ nguyên reference khi dữ liệu không đổi).
+ * - Ô ngoài cửa sổ render được gỡ khỏi cây native (removeClippedSubviews trên Android),
+ *   cửa sổ render và batch nhỏ để tái dùng tài nguyên thay vì giữ mọi thẻ.
+ * - perfTag: đo FPS và số ô trống mỗi phiên cuộn, gửi analytics 'list_scroll_perf'.
+ *
+ * Callback truyền vào thẻ nên ổn định (useLatestCallback), vì ô chỉ render lại khi
+ * item/extraData đổi.
+ */
+
+type BaseFlatListProps<T> = Omit<
+  FlatListProps<T>,
+  'data' | 'renderItem' | 'keyExtractor' | 'getItemLayout' | 'CellRendererComponent'
+>;
+
+export interface VirtualizedCardListProps<T> extends BaseFlatListProps<T> {
+  data: ReadonlyArray<T> | null | undefined;
+  keyOf: (item: T) => string;
+  renderCard: (item: T) => React.ReactElement | null;
+  /** Chiều cao ước lượng của 1 ô, gồm cả margin của thẻ */
+  estimateHeight: number | ((item: T) => number);
+  /** Giá trị đổi khi nội dung thẻ đổi; mặc định là chính item */
+  versionOf?: (item: T) => unknown;
+  /** Tên danh sách trong báo cáo hiệu năng cuộn; bỏ trống = không đo */
+  perfTag?: string;
+}
+
+interface CellProps<T> {
+  item: T;
+  cellKey: string;
+  version: unknown;
+  extraData: unknown;
+  gridCell: boolean;
+  renderRef: React.MutableRefObject<(item: T) => React.ReactElement | null>;
+  onMeasured: (key: string, height: number) => void;
+  monitor: ListPerfMonitor | null;
+}
+
+function CardCell<T>({ item, cellKey, gridCell, renderRef, onMeasured, monitor }: CellProps<T>) {
+  useEffect(() => {
+    if (!monitor) return;
+    monitor.cellMounted(cellKey);
+    return () => monitor.cellUnmounted(cellKey);
+  }, [monitor, cellKey]);
+
+  const onLayout = useCallback(
+    (e: LayoutChangeEvent) => onMeasured(cellKey, e.nativeEvent.layout.height),
+    [onMeasured, cellKey]
+  );
+
+  return (
+    <View style={gridCell ? styles.gridCell : undefined} onLayout={onLayout}>
+      {renderRef.current(item)}
+    </View>
+  );
+}
+
+const MemoCardCell = React.memo(
+  CardCell,
+  (prev, next) =>
+    prev.cellKey === next.cellKey &&
+    prev.version === next.version &&
+    prev.extraData === next.extraData &&
+    prev.gridCell === next.gridCell
+) as typeof CardCell;
+
+/** Callback giữ nguyên reference nhưng luôn gọi bản mới nhất */
+export function useLatestCallback<A extends any[], R>(fn: (...args: A) => R): (...args: A) => R {
+  const ref = useRef(fn);
+  ref.current = fn;
+  return useCallback((...args: A) => ref.current(...args), []);
+}
+
+function VirtualizedCardList<T>({
+  data,
+  keyOf,
+  renderCard,
+  estimateHeight,
+  versionOf,
+  perfTag,
+  numColumns = 1,
+  extraData,
+  onScroll,
+  onScrollBeginDrag,
+  onScrollEndDrag,
+  onMomentumScrollEnd,
+  onLayout,
+  ...rest
+}: VirtualizedCardListProps<T>) {
+  const items = data ?? [];
+
+  const tableRef = useRef<ItemLayoutTable | null>(null);
+  if (!tableRef.current || tableRef.current.getNumColumns() !== numColumns) {
+    tableRef.current = new ItemLayoutTable(numColumns);
+  }
+  const table = tableRef.current;
+
+  const monitorRef = useRef<ListPerfMonitor | null>(null);
+  if (perfTag && !monitorRef.current) monitorRef.current = new ListPerfMonitor(perfTag);
+  const monitor = perfTag ? monitorRef.current : null;
+  useEffect(() => () => monitorRef.current?.dispose(), []);
+
+  const renderRef = useRef(renderCard);
+  renderRef.current = renderCard;
+
+  const keyToRow = useMemo(() => {
+    const keys = items.map(keyOf);
+    const estimates = items.map((item) =>
+      typeof estimateHeight === 'number' ? estimateHeight : estimateHeight(item)
+    );
+    table.setItems(keys, estimates);
+    const map = new Map<string, number>();
+    keys.forEach((key, i) => map.set(key, Math.floor(i / numColumns)));
+    return map;
+    // estimateHeight/keyOf thường là hàm inline: chỉ tính lại khi dữ liệu đổi
+    // eslint-disable-next-line react-hooks/exhaustive-deps
+  }, [items, table, numColumns]);
+
+  // Số đo mới làm lệch offset: gom lại, render lại FlatList 1 lần mỗi khung
+  const [layoutVersion, setLayoutVersion] = useState(0);
+  const pendingFrame = useRef<number | null>(null);
+  useEffect(
+    () => () => {
+      if (pendingFrame.current !== null) cancelAnimationFrame(pendingFrame.current);
+    },
+    []
+  );
+
+  const onMeasured = useCallback(
+    (key: string, height: number) => {
+      const row = keyToRow.get(key);
+      if (row === undefined || !table.setMeasured(key, height, row)) return;
+      if (pendingFrame.current !== null) return;
+      pendingFrame.current = requestAnimationFrame(() => {
+        pendingFrame.current = null;
+        setLayoutVersion((v) => v + 1);
+      });
+    },
+    [keyToRow, table]
+  );
+
+  const getItemLayout = useCallback(
+    (_: ArrayLike<T> | null | undefined, rowIndex: number) => table.getLayout(rowIndex),
+    [table]
+  );
+
+  const keyExtractor = useCallback((item: T) => keyOf(item), [keyOf]);
+
+  const renderItem = useCallback(
+    ({ item }: ListRenderItemInfo<T>) => {
+      const key = keyOf(item);
+      return (
+        <MemoCardCell
+          item={item}
+          cellKey={key}
+          version={versionOf ? versionOf(item) : item}
+          extraData={extraData}
+          gridCell={numColumns > 1}
+          renderRef={renderRef}
+          onMeasured={onMeasured}
+          monitor={monitor}
+        />
+      );
+    },
+    [keyOf, versionOf, extraData, numColumns, onMeasured, monitor]
+  );
+
+  const listExtraData = useMemo(() => ({ extraData, layoutVersion }), [extraData, layoutVersion]);
+
+  // ============ PERF SAMPLING ============
+
+  const viewportHeight = useRef(0);
+
+  const handleLayout = useCallback(
+    (e: LayoutChangeEvent) => {
+      viewportHeight.current = e.nativeEvent.layout.height;
+      onLayout?.(e);
+    },
+    [onLayout]
+  );
+
+  const handleScroll = useCallback(
+    (e: NativeSyntheticEvent<NativeScrollEvent>) => {
+      if (monitor && table.rowCount() > 0) {
+        const y = e.nativeEvent.contentOffset.y;
+        const first = Math.max(0, table.rowAtOffset(y));
+        const last = table.rowAtOffset(y + viewportHeight.current);
+        let blank = 0;
+        for (let r = first; r <= last; r++) {
+          for (const key of table.keysInRow(r)) if (!monitor.isMounted(key)) blank++;
+        }
+        monitor.sampleBlank(blank);
+      }
+      onScroll?.(e);
+    },
+    [monitor, table, onScroll]
+  );
+
+  const handleScrollBeginDrag = useCallback(
+    (e: NativeSyntheticEvent<NativeScrollEvent>) => {
+      monitor?.beginScroll();
+      onScrollBeginDrag?.(e);
+    },
+    [monitor, onScrollBeginDrag]
+  );
+
+  const handleScrollEndDrag = useCallback(
+    (e: NativeSyntheticEvent<NativeScrollEvent>) => {
+      // Thả tay không có quán tính thì phiên cuộn kết thúc tại đây
+      const velocity = e.nativeEvent.velocity;
+      if (monitor && (!velocity || (Math.abs(velocity.y) < 0.01 && Math.abs(velocity.x) < 0.01))) {
+        monitor.endScroll();
+      }
+      onScrollEndDrag?.(e);
+    },
+    [monitor, onScrollEndDrag]
+  );
+
+  const handleMomentumScrollEnd = useCallback(
+    (e: NativeSyntheticEvent<NativeScrollEvent>) => {
+      monitor?.endScroll();
+      onMomentumScrollEnd?.(e);
+    },
+    [monitor, onMomentumScrollEnd]
+  );
+
+  return (
+    <FlatList
+      initialNumToRender={8}
+      maxToRenderPerBatch={8}
+      updateCellsBatchingPeriod={30}
+      windowSize={9}
+      removeClippedSubviews={Platform.OS === 'android'}
+      {...rest}
+      data={items}
+      numColumns={numColumns}
+      extraData={listExtraData}
+      keyExtractor={keyExtractor}
+      renderItem={renderItem}
+      getItemLayout={getItemLayout}
+      onLayout={handleLayout}
+      onScroll={handleScroll}
+      scrollEventThrottle={rest.scrollEventThrottle ?? 16}
+      onScrollBeginDrag={handleScrollBeginDrag}
+      onScrollEndDrag={handleScrollEndDrag}
+      onMomentumScrollEnd={handleMomentumScrollEnd}
+    />
+  );
+}
+
+const styles = StyleSheet.create({
+  gridCell: {
+    flex: 1,
+  },
+});
+
+export default VirtualizedCardList;
@@ -1,5 +1,9 @@
-import { getToken } from "@/utils/token";
+import { getValidToken } from "@/utils/token";
 import axios from "axios";
+import requestCache from "@/config/requestCache";
+import requestScheduler from "@/config/requestScheduler";
+import apiTelemetry from "@/config/apiTelemetry";
+import requestHedger from "@/config/requestHedging";
 
 // Load baseURL from environment variable
 const baseURL =
@@ -11,7 +15,8 @@ const api = axios.create({
 });
 api.interceptors.request.use(
   async (config) => {
-    const token = await getToken();
+    // Token trong bộ nhớ (không đọc AsyncStorage); sắp hết hạn thì chờ làm mới
+    const token = await getValidToken();
     if (token) {
       config.headers.Authorization = `Bearer ${token}`;
     }
@@ -23,8 +28,27 @@ api.interceptors.request.use(
   }
 );
 
+// Đo latency / payload theo route template (xem components/debug/ApiTelemetryPanel)
+apiTelemetry.install(api, "api");
+
+// GET: timeout theo p99 của route, gửi kép khi quá p95 (bọc sát adapter mạng)
+requestHedger.install(api, "api");
+
+// Xếp hàng theo độ ưu tiên (critical > interactive > upload > background).
+// Cài trước cache để cache bọc ngoài: bản còn tươi trả ngay, không vào hàng đợi
+requestScheduler.install(api);
+
+// GET có `cache` được phục vụ stale-while-revalidate, mutation tự invalidate theo tag
+requestCache.install(api);
+
+/** Header Idempotency-Key cho thao tác ghi có thể bị gửi lại (offline outbox) */
+export const idempotencyHeaders = (key?: string): Record<string, string> =>
+  key ? { "Idempotency-Key": key } : {};
+
 // Public client without attaching Authorization header.
 const apiPublic = axios.create({ baseURL, timeout: 50000 });
+apiTelemetry.install(apiPublic, "public");
+requestHedger.install(apiPublic, "public");
 
 export { apiPublic };
 export default api;
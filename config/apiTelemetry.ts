@@ -0,0 +1,394 @@
+import axios, { AxiosError, AxiosInstance, AxiosResponse, InternalAxiosRequestConfig } from "axios";
+import { track } from "@/utils/analytics";
+import { RingBuffer } from "@/utils/ringBuffer";
+
+/**
+ * API Telemetry - đo latency / payload theo endpoint cho api, apiPublic và fetch trực tiếp
+ *
+ * - Gắn bằng interceptor: latency tính từ lúc request vào axios tới khi có kết quả,
+ *   tức là gồm cả thời gian xếp hàng ở requestScheduler (đúng cái người dùng phải chờ).
+ * - Gom theo route template: "api/trip/3fa85f64-..." -> "api/trip/:id" (GUID, số, hash).
+ * - Mỗi route giữ histogram latency theo bucket cố định, byte vào/ra, số lần retry
+ *   (retryAttempt > 0 hoặc Idempotency-Key đã gặp) và số lỗi theo loại.
+ * - Số route giới hạn MAX_ROUTES; mẫu gần nhất nằm trong RingBuffer cố định,
+ *   định kỳ xuất bản tóm tắt gọn (chỉ các mẫu mới) qua analytics "api_telemetry".
+ * - Response requestCache trả thẳng từ cache (response.fromCache) chỉ đếm cacheHits, không tính latency.
+ */
+
+declare module "axios" {
+  interface AxiosRequestConfig {
+    /** Lần thử lại thứ mấy (0 = lần đầu), để telemetry đếm retry */
+    retryAttempt?: number;
+    /** Nội bộ: mốc bắt đầu do apiTelemetry gắn */
+    telemetryStartedAt?: number;
+  }
+}
+
+export type ApiErrorClass = "timeout" | "network" | "canceled" | "auth" | "client" | "server";
+
+/** Cận trên các bucket latency (ms); bucket cuối là > 30s */
+export const LATENCY_BUCKETS_MS = [50, 100, 200, 300, 500, 750, 1000, 1500, 2000, 3000, 5000, 8000, 13000, 20000, 30000];
+
+export interface RouteTelemetry {
+  key: string;
+  client: string;
+  method: string;
+  template: string;
+  count: number;
+  errors: number;
+  cacheHits: number;
+  retries: number;
+  totalMs: number;
+  maxMs: number;
+  buckets: number[];
+  bytesIn: number;
+  bytesOut: number;
+  maxBytesIn: number;
+  errorClasses: Partial<Record<ApiErrorClass, number>>;
+  lastAt: number;
+}
+
+export interface RouteTelemetrySummary extends RouteTelemetry {
+  avgMs: number;
+  p50: number;
+  p95: number;
+  p99: number;
+}
+
+interface Sample {
+  at: number;
+  key: string;
+  status: number;
+  ms: number;
+  bytesIn: number;
+  retry: boolean;
+  error?: ApiErrorClass;
+}
+
+const MAX_ROUTES = 120;
+const SAMPLE_CAPACITY = 500;
+const EXPORT_INTERVAL_MS = 60 * 1000;
+const MAX_IDEMPOTENCY_KEYS = 200;
+
+const ID_SEGMENT =
+  /^([0-9a-f]{8}-[0-9a-f]{4}-[0-9a-f]{4}-[0-9a-f]{4}-[0-9a-f]{12}|\d+|[0-9a-f]{16,}|[A-Za-z0-9_-]{24,})$/i;
+
+const now = () => (typeof performance !== "undefined" && performance.now ? performance.now() : Date.now());
+
+/** "https://host/api/Trip/abc-guid?x=1" -> "api/trip/:id" */
+export const routeTemplateOf = (url?: string): string => {
+  if (!url) return "";
+  const path = url.replace(/^[a-z]+:\/\/[^/]+/i, "").split(/[?#]/)[0];
+  return path
+    .split("/")
+    .filter(Boolean)
+    .map((segment) => (ID_SEGMENT.test(segment) && /\d/.test(segment) ? ":id" : segment.toLowerCase()))
+    .join("/");
+};
+
+const byteLengthOf = (data: any): number => {
+  if (data == null) return 0;
+  if (typeof data === "string") return data.length;
+  if (data instanceof ArrayBuffer) return data.byteLength;
+  if (ArrayBuffer.isView(data)) return data.byteLength;
+  if (typeof Blob !== "undefined" && data instanceof Blob) return data.size;
+  return 0; // FormData / object chưa serialize: không đoán
+};
+
+// Không stringify body đã parse (tốn CPU với payload lớn): ưu tiên Content-Length, rồi responseText
+const responseBytesOf = (response: AxiosResponse): number => {
+  const len = Number(response.headers?.["content-length"]);
+  if (Number.isFinite(len) && len > 0) return len;
+  const text = (response.request as any)?.responseText;
+  if (typeof text === "string") return text.length;
+  return byteLengthOf(response.data);
+};
+
+export const classifyApiError = (error: any): ApiErrorClass => {
+  if (axios.isCancel(error) || error?.name === "AbortError") return "canceled";
+  if (error?.code === "ECONNABORTED" || error?.code === "ETIMEDOUT") return "timeout";
+  const status = error?.response?.status ?? error?.status;
+  if (status === 401 || status === 403) return "auth";
+  if (typeof status === "number" && status >= 500) return "server";
+  if (typeof status === "number" && status >= 400) return "client";
+  return "network";
+};
+
+// Nội suy tuyến tính trong bucket chứa phân vị (bucket thô, không nội suy thì p95 luôn dính cận trên)
+export const percentileOf = (route: Pick<RouteTelemetry, "buckets" | "count" | "maxMs">, q: number): number => {
+  if (route.count === 0) return 0;
+  const target = Math.ceil(route.count * q);
+  let seen = 0;
+  for (let i = 0; i < route.buckets.length; i++) {
+    const inBucket = route.buckets[i];
+    if (seen + inBucket >= target) {
+      const lower = i === 0 ? 0 : LATENCY_BUCKETS_MS[i - 1];
+      const upper = Math.min(LATENCY_BUCKETS_MS[i] ?? route.maxMs, route.maxMs);
+      return Math.min(route.maxMs, lower + Math.max(0, upper - lower) * ((target - seen) / inBucket));
+    }
+    seen += inBucket;
+  }
+  return route.maxMs;
+};
+
+class ApiTelemetry {
+  private routes = new Map<string, RouteTelemetry>();
+  private samples = new RingBuffer<Sample>(SAMPLE_CAPACITY);
+  private exportedSeq = 0;
+  private lastExportAt = Date.now();
+  private exportTimer: ReturnType<typeof setTimeout> | null = null;
+  private idempotencyKeys = new Map<string, true>();
+
+  /** Gắn interceptor đo đạc vào axios instance; client = tên hiển thị ("api", "public") */
+  install(instance: AxiosInstance, client: string) {
+    instance.interceptors.request.use((config) => {
+      config.telemetryStartedAt = now();
+      return config;
+    });
+    instance.interceptors.response.use(
+      (response) => {
+        this.recordAxios(client, response.config, response);
+        return response;
+      },
+      (error: AxiosError) => {
+        if (error?.config) this.recordAxios(client, error.config, error.response, error);
+        return Promise.reject(error);
+      }
+    );
+  }
+
+  /** Đo 1 lần gọi fetch trực tiếp (vd. VietMap) */
+  async measureFetch(client: string, method: string, url: string, run: () => Promise<Response>): Promise<Response> {
+    const startedAt = now();
+    try {
+      const response = await run();
+      const len = Number(response.headers.get("content-length"));
+      this.record({
+        client,
+        method,
+        url,
+        status: response.status,
+        ms: now() - startedAt,
+        bytesIn: Number.isFinite(len) ? len : 0,
+        bytesOut: 0,
+        retry: false,
+        error: response.ok ? undefined : classifyApiError({ status: response.status }),
+      });
+      return response;
+    } catch (error) {
+      this.record({
+        client,
+        method,
+        url,
+        status: 0,
+        ms: now() - startedAt,
+        bytesIn: 0,
+        bytesOut: 0,
+        retry: false,
+        error: classifyApiError(error),
+      });
+      throw error;
+    }
+  }
+
+  /** Thống kê 1 route (vd. để đặt timeout theo p95) */
+  getRoute(client: string, method: string, url?: string): RouteTelemetrySummary | null {
+    const route = this.routes.get(`${client} ${method.toUpperCase()} ${routeTemplateOf(url)}`);
+    return route ? this.summarize(route) : null;
+  }
+
+  /** Toàn bộ route, chậm nhất (p95) trước */
+  getSnapshot(): RouteTelemetrySummary[] {
+    return Array.from(this.routes.values(), (route) => this.summarize(route)).sort((a, b) => b.p95 - a.p95);
+  }
+
+  getRecentSamples(): Sample[] {
+    return this.samples.toArray();
+  }
+
+  /**
+   * Tóm tắt gọn các mẫu mới từ lần xuất trước:
+   * routes = [key, n, errors, p50, p95, max, avgBytesIn, retries]
+   */
+  exportCompact() {
+    const { items, dropped, nextSeq } = this.samples.since(this.exportedSeq);
+    const windowMs = Date.now() - this.lastExportAt;
+    this.exportedSeq = nextSeq;
+    this.lastExportAt = Date.now();
+
+    const groups = new Map<string, Sample[]>();
+    items.forEach((sample) => {
+      const group = groups.get(sample.key);
+      if (group) group.push(sample);
+      else groups.set(sample.key, [sample]);
+    });
+    const routes = Array.from(groups, ([key, group]) => {
+      const ms = group.map((s) => s.ms).sort((a, b) => a - b);
+      const at = (q: number) => Math.round(ms[Math.min(ms.length - 1, Math.floor(ms.length * q))]);
+      return [
+        key,
+        group.length,
+        group.filter((s) => s.error).length,
+        at(0.5),
+        at(0.95),
+        Math.round(ms[ms.length - 1]),
+        Math.round(group.reduce((sum, s) => sum + s.bytesIn, 0) / group.length),
+        group.filter((s) => s.retry).length,
+      ];
+    });
+    return { v: 1, windowMs, samples: items.length, dropped, routes };
+  }
+
+  /** Xuất ngay (vd. trước khi app vào nền) */
+  flush() {
+    if (this.exportTimer) {
+      clearTimeout(this.exportTimer);
+      this.exportTimer = null;
+    }
+    if (this.samples.nextSeq === this.exportedSeq) return;
+    track("api_telemetry", this.exportCompact());
+  }
+
+  reset() {
+    this.routes.clear();
+    this.samples.clear();
+    this.exportedSeq = 0;
+    this.idempotencyKeys.clear();
+  }
+
+  // ============ PRIVATE METHODS ============
+
+  private recordAxios(client: string, config: InternalAxiosRequestConfig, response?: AxiosResponse, error?: any) {
+    const method = (config.method || "get").toUpperCase();
+    const retry = (config.retryAttempt ?? 0) > 0 || this.seenIdempotencyKey(config);
+
+    // Bản trả từ requestCache: không đi mạng
+    if (response && !error && response.fromCache) {
+      this.routeFor(client, method, config.url).cacheHits++;
+      return;
+    }
+    this.record({
+      client,
+      method,
+      url: config.url,
+      status: response?.status ?? 0,
+      ms: config.telemetryStartedAt !== undefined ? now() - config.telemetryStartedAt : 0,
+      bytesIn: response ? responseBytesOf(response) : 0,
+      bytesOut: byteLengthOf(config.data),
+      retry,
+      error: error ? classifyApiError(error) : undefined,
+    });
+  }
+
+  private seenIdempotencyKey(config: InternalAxiosRequestConfig): boolean {
+    const key = (config.headers as any)?.get?.("Idempotency-Key");
+    if (typeof key !== "string" || !key) return false;
+    if (this.idempotencyKeys.has(key)) return true;
+    this.idempotencyKeys.set(key, true);
+    if (this.idempotencyKeys.size > MAX_IDEMPOTENCY_KEYS) {
+      this.idempotencyKeys.delete(this.idempotencyKeys.keys().next().value as string);
+    }
+    return false;
+  }
+
+  private record(entry: {
+    client: string;
+    method: string;
+    url?: string;
+    status: number;
+    ms: number;
+    bytesIn: number;
+    bytesOut: number;
+    retry: boolean;
+    error?: ApiErrorClass;
+  }) {
+    const route = this.routeFor(entry.client, entry.method, entry.url);
+    const ms = Math.max(0, entry.ms);
+    route.count++;
+    route.totalMs += ms;
+    route.maxMs = Math.max(route.maxMs, ms);
+    const bucket = LATENCY_BUCKETS_MS.findIndex((upper) => ms <= upper);
+    route.buckets[bucket === -1 ? LATENCY_BUCKETS_MS.length : bucket]++;
+    route.bytesIn += entry.bytesIn;
+    route.bytesOut += entry.bytesOut;
+    route.maxBytesIn = Math.max(route.maxBytesIn, entry.bytesIn);
+    if (entry.retry) route.retries++;
+    if (entry.error) {
+      route.errors++;
+      route.errorClasses[entry.error] = (route.errorClasses[entry.error] ?? 0) + 1;
+    }
+
+    this.samples.push({
+      at: Date.now(),
+      key: route.key,
+      status: entry.status,
+      ms,
+      bytesIn: entry.bytesIn,
+      retry: entry.retry,
+      error: entry.error,
+    });
+    this.scheduleExport();
+  }
+
+  private routeFor(client: string, method: string, url?: string): RouteTelemetry {
+    const template = routeTemplateOf(url);
+    const key = `${client} ${method} ${template}`;
+    let route = this.routes.get(key);
+    if (route) {
+      route.lastAt = Date.now();
+      return route;
+    }
+    // Quá giới hạn: bỏ route lâu không gặp nhất để bộ nhớ cố định
+    if (this.routes.size >= MAX_ROUTES) {
+      let oldest: RouteTelemetry | null = null;
+      this.routes.forEach((r) => {
+        if (!oldest || r.lastAt < oldest.lastAt) oldest = r;
+      });
+      if (oldest) this.routes.delete((oldest as RouteTelemetry).key);
+    }
+    route = {
+      key,
+      client,
+      method,
+      template,
+      count: 0,
+      errors: 0,
+      cacheHits: 0,
+      retries: 0,
+      totalMs: 0,
+      maxMs: 0,
+      buckets: new Array(LATENCY_BUCKETS_MS.length + 1).fill(0),
+      bytesIn: 0,
+      bytesOut: 0,
+      maxBytesIn: 0,
+      errorClasses: {},
+      lastAt: Date.now(),
+    };
+    this.routes.set(key, route);
+    return route;
+  }
+
+  // Hẹn xuất khi có mẫu mới: không có request thì không có timer chạy
+  private scheduleExport() {
+    if (this.exportTimer) return;
+    this.exportTimer = setTimeout(() => {
+      this.exportTimer = null;
+      this.flush();
+    }, EXPORT_INTERVAL_MS);
+  }
+
+  private summarize(route: RouteTelemetry): RouteTelemetrySummary {
+    return {
+      ...route,
+      buckets: [...route.buckets],
+      errorClasses: { ...route.errorClasses },
+      avgMs: route.count > 0 ? Math.round(route.totalMs / route.count) : 0,
+      p50: Math.round(percentileOf(route, 0.5)),
+      p95: Math.round(percentileOf(route, 0.95)),
+      p99: Math.round(percentileOf(route, 0.99)),
+    };
+  }
+}
+
+export const apiTelemetry = new ApiTelemetry();
+export default apiTelemetry;
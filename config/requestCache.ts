@@ -0,0 +1,298 @@
+import axios, {
+  AxiosAdapter,
+  AxiosHeaders,
+  AxiosInstance,
+  AxiosResponse,
+  InternalAxiosRequestConfig,
+} from "axios";
+
+/**
+ * Request Cache - stale-while-revalidate cho axios instance dùng chung
+ *
+ * - Chỉ GET có `cache` trong config mới được cache (opt-in theo từng service).
+ * - Còn tươi (< ttlMs): trả ngay từ bộ nhớ, không gọi mạng.
+ * - Cũ nhưng còn dùng được (< maxAgeMs): trả ngay bản cũ, revalidate nền.
+ * - Revalidate gửi If-None-Match với ETag đã lưu; 304 thì giữ body cũ (tính bytes tiết kiệm).
+ * - Các request trùng key đang bay được gộp làm 1.
+ * - Mutation (POST/PUT/PATCH/DELETE) thành công sẽ invalidate tag theo `invalidates`,
+ *   mặc định là tài nguyên của URL (api/package/... -> "package"); lần đọc sau chờ mạng.
+ *
+ * Web: backend cần expose header ETag qua CORS (Access-Control-Expose-Headers).
+ */
+
+export interface RequestCacheOptions {
+  /** Khoá cache, mặc định = method + URL đầy đủ (kèm params) */
+  key?: string;
+  /** Thời gian còn tươi (ms) */
+  ttlMs?: number;
+  /** Quá thời gian này thì bỏ bản cũ, chờ mạng (ms) */
+  maxAgeMs?: number;
+  /** Tag để invalidate theo nhóm, mặc định là tài nguyên của URL */
+  tags?: string[];
+  /** false: bản cũ phải chờ revalidate xong mới trả */
+  swr?: boolean;
+  /** Bỏ qua bản tươi, luôn revalidate (vd. pull-to-refresh) */
+  force?: boolean;
+}
+
+declare module "axios" {
+  interface AxiosRequestConfig {
+    cache?: RequestCacheOptions | false;
+    /** Tag cần invalidate khi mutation thành công */
+    invalidates?: string[];
+  }
+  interface AxiosResponse {
+    /** true: trả thẳng từ cache (hit/stale hit), lượt gọi này không có request mạng nào */
+    fromCache?: boolean;
+  }
+}
+
+export type RequestCacheEvent = "updated" | "invalidated";
+
+interface CacheEntry {
+  key: string;
+  data: any; // dữ liệu thô từ adapter (trước transformResponse)
+  status: number;
+  statusText: string;
+  headers: Record<string, any>;
+  etag?: string;
+  storedAt: number;
+  invalidated: boolean;
+  tags: string[];
+  bytes: number;
+}
+
+/** Kết quả 1 lượt revalidate: entry + request mạng thật (cho telemetry) */
+interface Revalidated {
+  entry: CacheEntry;
+  request: any;
+}
+
+const DEFAULT_TTL_MS = 30 * 1000;
+const DEFAULT_MAX_AGE_MS = 10 * 60 * 1000;
+const MAX_ENTRIES = 200;
+
+const estimateBytes = (data: any, headers: Record<string, any>): number => {
+  const len = Number(headers?.["content-length"]);
+  if (Number.isFinite(len) && len > 0) return len;
+  if (typeof data === "string") return data.length;
+  try {
+    return JSON.stringify(data ?? null).length;
+  } catch {
+    return 0;
+  }
+};
+
+// "api/package/get-packages-by-user" -> "package"
+export const resourceTagOf = (url?: string): string | null => {
+  if (!url) return null;
+  const path = url.replace(/^https?:\/\/[^/]+/i, "").split("?")[0];
+  const parts = path.split("/").filter(Boolean);
+  const start = parts[0]?.toLowerCase() === "api" ? 1 : 0;
+  return parts[start] ? parts[start].toLowerCase() : null;
+};
+
+class RequestCache {
+  // Map giữ thứ tự chèn => LRU đơn giản
+  private entries = new Map<string, CacheEntry>();
+  private inflight = new Map<string, Promise<Revalidated>>();
+  private listeners = new Set<(tags: string[], event: RequestCacheEvent) => void>();
+  private stats = {
+    hits: 0,
+    staleHits: 0,
+    misses: 0,
+    revalidations: 0,
+    notModified: 0,
+    coalesced: 0,
+    bytesSaved: 0,
+    bytesFetched: 0,
+  };
+
+  /** Gắn cache vào axios instance (bọc adapter mặc định) */
+  install(instance: AxiosInstance) {
+    const inner = axios.getAdapter(instance.defaults.adapter);
+    const adapter: AxiosAdapter = (config) => this.handle(inner, config);
+    instance.defaults.adapter = adapter;
+  }
+
+  /** Đánh dấu hết hạn các entry có tag: lần đọc sau revalidate (có ETag) thay vì trả bản cũ */
+  invalidate(tags: string[]) {
+    if (tags.length === 0) return;
+    let touched = false;
+    this.entries.forEach((entry) => {
+      if (entry.tags.some((t) => tags.includes(t))) {
+        entry.invalidated = true;
+        touched = true;
+      }
+    });
+    if (touched) this.emit(tags, "invalidated");
+  }
+
+  /** Xoá toàn bộ (vd. khi logout - cache theo phiên đăng nhập) */
+  clear() {
+    this.entries.clear();
+    this.inflight.clear();
+  }
+
+  /** Nghe thay đổi theo tag: dữ liệu mới sau revalidate nền, hoặc bị invalidate */
+  subscribe(listener: (tags: string[], event: RequestCacheEvent) => void): () => void {
+    this.listeners.add(listener);
+    return () => {
+      this.listeners.delete(listener);
+    };
+  }
+
+  getStats() {
+    const served = this.stats.hits + this.stats.staleHits;
+    const total = served + this.stats.misses;
+    return {
+      ...this.stats,
+      entries: this.entries.size,
+      hitRate: total > 0 ? served / total : 0,
+    };
+  }
+
+  // ============ PRIVATE METHODS ============
+
+  private async handle(inner: AxiosAdapter, config: InternalAxiosRequestConfig): Promise<AxiosResponse> {
+    const method = (config.method || "get").toLowerCase();
+
+    if (method !== "get") {
+      const response = await inner(config);
+      // settle() đã reject lỗi, tới đây là thành công
+      const tags = config.invalidates ?? [resourceTagOf(config.url)].filter((t): t is string => !!t);
+      this.invalidate(tags);
+      return response;
+    }
+
+    const options = config.cache;
+    if (!options) return inner(config);
+
+    const key = options.key ?? `GET ${axios.getUri(config)}`;
+    const ttlMs = options.ttlMs ?? DEFAULT_TTL_MS;
+    const maxAgeMs = options.maxAgeMs ?? DEFAULT_MAX_AGE_MS;
+    const tags = options.tags ?? [resourceTagOf(config.url)].filter((t): t is string => !!t);
+    const entry = this.entries.get(key);
+    const age = entry ? Date.now() - entry.storedAt : Infinity;
+
+    if (entry && !entry.invalidated && !options.force && age < ttlMs) {
+      this.stats.hits++;
+      this.touch(entry);
+      return this.toResponse(entry, config, null);
+    }
+
+    // Bị invalidate sau mutation thì chờ bản mới (vẫn gửi ETag), không trả bản cũ
+    if (entry && !entry.invalidated && !options.force && options.swr !== false && age < maxAgeMs) {
+      this.stats.staleHits++;
+      this.touch(entry);
+      // Đã trả bản cũ cho UI => revalidate chỉ là việc nền, nhường request khác
+      this.revalidate(inner, { ...config, priority: config.priority ?? "background" }, key, tags, entry).catch((e) =>
+        console.warn("[RequestCache] background revalidate failed", key, e?.message ?? e)
+      );
+      return this.toResponse(entry, config, null);
+    }
+
+    this.stats.misses++;
+    const fresh = await this.revalidate(inner, config, key, tags, entry && age < maxAgeMs ? entry : undefined);
+    return this.toResponse(fresh.entry, config, fresh.request);
+  }
+
+  private revalidate(
+    inner: AxiosAdapter,
+    config: InternalAxiosRequestConfig,
+    key: string,
+    tags: string[],
+    previous?: CacheEntry
+  ): Promise<Revalidated> {
+    const pending = this.inflight.get(key);
+    if (pending) {
+      this.stats.coalesced++;
+      return pending;
+    }
+
+    const task = (async () => {
+      const headers = AxiosHeaders.from(config.headers);
+      if (previous?.etag) headers.set("If-None-Match", previous.etag);
+      if (previous) this.stats.revalidations++;
+
+      const response = await inner({
+        ...config,
+        headers,
+        validateStatus: (status) =>
+          status === 304 || (config.validateStatus ? config.validateStatus(status) : status >= 200 && status < 300),
+      });
+
+      if (response.status === 304 && previous) {
+        this.stats.notModified++;
+        this.stats.bytesSaved += previous.bytes;
+        previous.storedAt = Date.now();
+        previous.invalidated = false;
+        this.touch(previous);
+        return { entry: previous, request: response.request };
+      }
+
+      const responseHeaders = AxiosHeaders.from(response.headers as any).toJSON() as Record<string, any>;
+      const bytes = estimateBytes(response.data, responseHeaders);
+      this.stats.bytesFetched += bytes;
+      const next: CacheEntry = {
+        key,
+        data: response.data,
+        status: response.status,
+        statusText: response.statusText,
+        headers: responseHeaders,
+        etag: responseHeaders["etag"] || undefined,
+        storedAt: Date.now(),
+        invalidated: false,
+        tags,
+        bytes,
+      };
+      this.set(next);
+      if (previous && previous.data !== next.data) this.emit(tags, "updated");
+      return { entry: next, request: response.request };
+    })().finally(() => this.inflight.delete(key));
+
+    this.inflight.set(key, task);
+    return task;
+  }
+
+  // Trả bản sao dạng response thô: transformResponse của axios parse lại => mỗi nơi gọi có object riêng.
+  // request = null: phục vụ từ cache (fromCache); miss thì giữ request thật của lượt revalidate.
+  private toResponse(entry: CacheEntry, config: InternalAxiosRequestConfig, request: any): AxiosResponse {
+    return {
+      data: entry.data,
+      status: entry.status === 304 ? 200 : entry.status,
+      statusText: entry.statusText,
+      headers: AxiosHeaders.from(entry.headers),
+      config,
+      request,
+      fromCache: request === null,
+    };
+  }
+
+  private set(entry: CacheEntry) {
+    this.entries.delete(entry.key);
+    this.entries.set(entry.key, entry);
+    while (this.entries.size > MAX_ENTRIES) {
+      const oldest = this.entries.keys().next().value as string;
+      this.entries.delete(oldest);
+    }
+  }
+
+  private touch(entry: CacheEntry) {
+    this.entries.delete(entry.key);
+    this.entries.set(entry.key, entry);
+  }
+
+  private emit(tags: string[], event: RequestCacheEvent) {
+    this.listeners.forEach((listener) => {
+      try {
+        listener(tags, event);
+      } catch (e) {
+        console.warn("[RequestCache] listener failed", e);
+      }
+    });
+  }
+}
+
+export const requestCache = new RequestCache();
+export default requestCache;
@@ -0,0 +1,207 @@
+import axios, { AxiosAdapter, AxiosInstance, AxiosResponse, InternalAxiosRequestConfig } from "axios";
+import apiTelemetry, { RouteTelemetrySummary } from "@/config/apiTelemetry";
+import { track } from "@/utils/analytics";
+import { RingBuffer } from "@/utils/ringBuffer";
+
+/**
+ * Request Hedging - timeout thích ứng + gửi kép (hedge) cho GET
+ *
+ * - Timeout thích ứng: GET dùng timeout mặc định của instance được thay bằng
+ *   p99 × TIMEOUT_MULTIPLIER của route (theo apiTelemetry), kẹp trong
+ *   [MIN_TIMEOUT_MS, timeout mặc định]. Route chưa đủ MIN_SAMPLES mẫu giữ nguyên;
+ *   request tự đặt timeout (vd. chunk upload) không bị đụng tới.
+ *   Mutation giữ timeout tĩnh: cắt sớm 1 POST đã tới server dễ sinh bản ghi trùng.
+ * - Hedge: GET chưa xong sau p95 của route thì gửi lần 2; bên nào về trước thắng,
+ *   bên còn lại bị abort. Chỉ hedge route nhanh (p95 <= MAX_HEDGE_DELAY_MS):
+ *   route vốn chậm là do server, gửi kép chỉ nhân đôi tải.
+ * - Ngân sách: mỗi GET đủ điều kiện nạp HEDGE_BUDGET_RATIO token, mỗi hedge tiêu 1
+ *   => hedge không vượt ~10% số GET dù mạng xấu kéo dài.
+ * - Đo trước/sau: CONTROL_RATE số GET đủ điều kiện chạy không hedge (nhóm đối chứng);
+ *   getStats() so p50/p95/p99 của 2 nhóm.
+ *
+ * Cài dưới requestScheduler (bọc adapter mạng): thời gian xếp hàng không tính vào
+ * timeout/độ trễ hedge, và lần hedge không chiếm thêm slot của scheduler.
+ */
+
+declare module "axios" {
+  interface AxiosRequestConfig {
+    /** false: không hedge request này (vẫn dùng timeout thích ứng) */
+    hedge?: boolean;
+  }
+}
+
+const MIN_SAMPLES = 20;
+const TIMEOUT_MULTIPLIER = 4;
+const MIN_TIMEOUT_MS = 8000;
+const MIN_HEDGE_DELAY_MS = 200;
+const MAX_HEDGE_DELAY_MS = 3000;
+const HEDGE_BUDGET_RATIO = 0.1;
+const HEDGE_BUDGET_MAX = 10;
+const CONTROL_RATE = 0.1;
+const LATENCY_SAMPLES = 300;
+const REPORT_EVERY = 200;
+
+const percentile = (values: number[], q: number) => {
+  if (values.length === 0) return 0;
+  const sorted = [...values].sort((a, b) => a - b);
+  return Math.round(sorted[Math.min(sorted.length - 1, Math.floor(sorted.length * q))]);
+};
+
+const tail = (values: number[]) => ({
+  n: values.length,
+  p50: percentile(values, 0.5),
+  p95: percentile(values, 0.95),
+  p99: percentile(values, 0.99),
+});
+
+class RequestHedger {
+  private budget = 2;
+  private latency = {
+    hedged: new RingBuffer<number>(LATENCY_SAMPLES),
+    control: new RingBuffer<number>(LATENCY_SAMPLES),
+  };
+  private stats = {
+    eligible: 0,
+    completed: 0,
+    hedgesSent: 0,
+    hedgeWins: 0,
+    budgetDenied: 0,
+    adaptiveTimeouts: 0,
+    timeoutsFired: 0,
+  };
+
+  /** Bọc adapter mạng của instance; client trùng tên đã dùng ở apiTelemetry.install */
+  install(instance: AxiosInstance, client: string) {
+    const inner = axios.getAdapter(instance.defaults.adapter);
+    const defaultTimeout = instance.defaults.timeout ?? 0;
+    const adapter: AxiosAdapter = (config) => this.handle(inner, config, client, defaultTimeout);
+    instance.defaults.adapter = adapter;
+  }
+
+  getStats() {
+    return {
+      ...this.stats,
+      budget: Math.round(this.budget * 10) / 10,
+      hedged: tail(this.latency.hedged.toArray()),
+      control: tail(this.latency.control.toArray()),
+    };
+  }
+
+  // ============ PRIVATE METHODS ============
+
+  private async handle(
+    inner: AxiosAdapter,
+    config: InternalAxiosRequestConfig,
+    client: string,
+    defaultTimeout: number
+  ): Promise<AxiosResponse> {
+    if ((config.method || "get").toLowerCase() !== "get") return inner(config);
+
+    const route = apiTelemetry.getRoute(client, "GET", config.url);
+    if (!route || route.count < MIN_SAMPLES) return inner(config);
+
+    const attempt = this.withAdaptiveTimeout(config, route, defaultTimeout);
+    const hedgeable = config.hedge !== false && route.p95 <= MAX_HEDGE_DELAY_MS;
+    if (!hedgeable) return this.timed(inner(attempt), attempt);
+
+    this.stats.eligible++;
+    this.budget = Math.min(HEDGE_BUDGET_MAX, this.budget + HEDGE_BUDGET_RATIO);
+    const control = Math.random() < CONTROL_RATE;
+    const startedAt = Date.now();
+    try {
+      return await (control
+        ? this.timed(inner(attempt), attempt)
+        : this.hedged(inner, attempt, Math.max(MIN_HEDGE_DELAY_MS, route.p95)));
+    } finally {
+      (control ? this.latency.control : this.latency.hedged).push(Date.now() - startedAt);
+      if (++this.stats.completed % REPORT_EVERY === 0) track("request_hedging_report", this.getStats());
+    }
+  }
+
+  private withAdaptiveTimeout(
+    config: InternalAxiosRequestConfig,
+    route: RouteTelemetrySummary,
+    defaultTimeout: number
+  ): InternalAxiosRequestConfig {
+    // Nơi gọi tự đặt timeout khác mặc định => tôn trọng
+    if (config.timeout !== defaultTimeout || defaultTimeout <= 0) return config;
+    const timeout = Math.min(defaultTimeout, Math.max(MIN_TIMEOUT_MS, route.p99 * TIMEOUT_MULTIPLIER));
+    if (timeout >= defaultTimeout) return config;
+    this.stats.adaptiveTimeouts++;
+    return { ...config, timeout };
+  }
+
+  private timed(pending: Promise<AxiosResponse>, config: InternalAxiosRequestConfig): Promise<AxiosResponse> {
+    return pending.catch((error) => {
+      if (error?.code === "ECONNABORTED" && config.timeout) this.stats.timeoutsFired++;
+      throw error;
+    });
+  }
+
+  // Gửi lần 1; quá delayMs chưa xong (và còn ngân sách) thì gửi lần 2, lấy kết quả về trước
+  private hedged(inner: AxiosAdapter, config: InternalAxiosRequestConfig, delayMs: number): Promise<AxiosResponse> {
+    return new Promise<AxiosResponse>((resolve, reject) => {
+      const controllers: AbortController[] = [];
+      const userSignal = config.signal as any;
+      let settled = false;
+      let failures = 0;
+      let firstError: any = null;
+      let timer: ReturnType<typeof setTimeout> | null = null;
+
+      const onUserAbort = () => controllers.forEach((c) => c.abort());
+      const finish = () => {
+        settled = true;
+        if (timer) clearTimeout(timer);
+        timer = null;
+        userSignal?.removeEventListener?.("abort", onUserAbort);
+      };
+
+      const launch = (isHedge: boolean) => {
+        const controller = new AbortController();
+        controllers.push(controller);
+        this.timed(inner({ ...config, signal: controller.signal }), config).then(
+          (response) => {
+            if (settled) return;
+            finish();
+            controllers.forEach((c) => c !== controller && c.abort());
+            if (isHedge) this.stats.hedgeWins++;
+            resolve(response);
+          },
+          (error) => {
+            if (settled) return;
+            failures++;
+            firstError = firstError ?? error;
+            // Mọi lần gửi đều lỗi => trả lỗi đầu tiên. Lỗi trước khi kịp hedge cũng trả
+            // luôn, không gửi lại (hedge không phải retry)
+            if (failures >= controllers.length) {
+              finish();
+              reject(firstError);
+            }
+          }
+        );
+      };
+
+      // axios đổi lỗi thành CanceledError khi thấy signal đã abort
+      if (userSignal?.aborted) {
+        reject(new Error("Request aborted"));
+        return;
+      }
+      userSignal?.addEventListener?.("abort", onUserAbort);
+      launch(false);
+      timer = setTimeout(() => {
+        timer = null;
+        if (settled) return;
+        if (this.budget < 1) {
+          this.stats.budgetDenied++;
+          return;
+        }
+        this.budget -= 1;
+        this.stats.hedgesSent++;
+        launch(true);
+      }, delayMs);
+    });
+  }
+}
+
+export const requestHedger = new RequestHedger();
+export default requestHedger;
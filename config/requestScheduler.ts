@@ -0,0 +1,300 @@
+import axios, { AxiosAdapter, AxiosInstance, InternalAxiosRequestConfig } from "axios";
+import { track } from "@/utils/analytics";
+
+/**
+ * Request Scheduler - xếp hàng request theo độ ưu tiên cho axios instance dùng chung
+ *
+ * - 4 lớp: critical (đổi trạng thái chuyến, check-in/out, tính route) > interactive
+ *   (màn hình đang chờ) > upload (multipart/chunk) > background (revalidate, prefetch, poll).
+ * - Mỗi lớp có giới hạn đồng thời riêng; các lớp không phải critical dùng chung
+ *   MAX_SHARED slot, critical luôn có slot riêng => upload 5 MB không chặn route.
+ * - Upload/background chờ khi còn request critical đang bay hoặc đang xếp hàng.
+ * - Chuyến đang IN_PROGRESS (setNavigationActive): background hoãn tới khi mạng rảnh
+ *   hoặc đã chờ quá BACKGROUND_DEFER_MS, và chỉ chạy 1 cái mỗi lúc.
+ * - Request đang bay không bị ngắt; ưu tiên chỉ áp dụng lúc chọn request kế tiếp.
+ * - Request bị huỷ (config.signal) khi còn trong hàng đợi thì rời hàng ngay.
+ *
+ * Lớp lấy từ config.priority nếu có, không thì đoán theo URL/body (classify).
+ */
+
+export type RequestPriority = "critical" | "interactive" | "upload" | "background";
+
+declare module "axios" {
+  interface AxiosRequestConfig {
+    /** Lớp ưu tiên khi xếp hàng, mặc định đoán theo URL/body */
+    priority?: RequestPriority;
+  }
+}
+
+interface AbortSignalLike {
+  aborted?: boolean;
+  reason?: any;
+  addEventListener?: (type: "abort", listener: () => void) => void;
+  removeEventListener?: (type: "abort", listener: () => void) => void;
+}
+
+interface QueuedTask {
+  priority: RequestPriority;
+  enqueuedAt: number;
+  deferred: boolean;
+  start: () => void;
+  cancel: () => void;
+}
+
+const PRIORITY_ORDER: RequestPriority[] = ["critical", "interactive", "upload", "background"];
+
+const CLASS_LIMITS: Record<RequestPriority, number> = {
+  critical: 4,
+  interactive: 4,
+  // >= parallelChunks của ResumableUploader, không thì chunk của một file bị tuần tự hoá
+  upload: 3,
+  background: 2,
+};
+
+/** Tổng slot cho interactive + upload + background */
+const MAX_SHARED = 6;
+/** Trong chuyến: background chờ tối đa chừng này rồi mới chạy dù mạng chưa rảnh */
+const BACKGROUND_DEFER_MS = 30 * 1000;
+/** Body lớn hơn ngưỡng này coi như upload */
+const LARGE_BODY_BYTES = 256 * 1024;
+const WAIT_SAMPLES = 200;
+
+/** Tính route: API backend và VietMap route/v3; không bắt mọi URL chứa chữ "route" */
+const CRITICAL_URL = /(change-status|check-in|check-out|DriverWorkSession\/(start|end)|PostPackage\/calculate-route|\/route\/v\d+\b)/i;
+const BACKGROUND_URL = /(unread-count|register-token)/i;
+
+const isBinary = (data: any) =>
+  (typeof FormData !== "undefined" && data instanceof FormData) ||
+  (typeof Blob !== "undefined" && data instanceof Blob) ||
+  data instanceof ArrayBuffer ||
+  ArrayBuffer.isView(data);
+
+/** Đoán lớp ưu tiên khi service không truyền config.priority */
+export const classify = (config: { url?: string; method?: string; data?: any; priority?: RequestPriority }): RequestPriority => {
+  if (config.priority) return config.priority;
+  const url = config.url || "";
+  if (CRITICAL_URL.test(url)) return "critical";
+  const data = config.data;
+  if (isBinary(data) || (typeof data === "string" && data.length > LARGE_BODY_BYTES)) return "upload";
+  if (BACKGROUND_URL.test(url)) return "background";
+  return "interactive";
+};
+
+const emptyCounts = (): Record<RequestPriority, number> => ({
+  critical: 0,
+  interactive: 0,
+  upload: 0,
+  background: 0,
+});
+
+class RequestScheduler {
+  private queues: Record<RequestPriority, QueuedTask[]> = {
+    critical: [],
+    interactive: [],
+    upload: [],
+    background: [],
+  };
+  private inFlight = emptyCounts();
+  private navigationActive = false;
+  private deferTimer: ReturnType<typeof setTimeout> | null = null;
+  // Mẫu thời gian chờ gần nhất theo lớp (vòng tròn) để tính p95
+  private waitSamples: Record<RequestPriority, number[]> = {
+    critical: [],
+    interactive: [],
+    upload: [],
+    background: [],
+  };
+  private stats = {
+    started: emptyCounts(),
+    queued: emptyCounts(),
+    deferred: emptyCounts(),
+    cancelled: emptyCounts(),
+    waitMsTotal: emptyCounts(),
+    waitMsMax: emptyCounts(),
+    peakInFlight: 0,
+    peakQueued: 0,
+  };
+
+  /** Gắn scheduler vào axios instance (bọc adapter mặc định). Gọi trước requestCache.install */
+  install(instance: AxiosInstance) {
+    const inner = axios.getAdapter(instance.defaults.adapter);
+    const adapter: AxiosAdapter = (config) => this.handle(inner, config);
+    instance.defaults.adapter = adapter;
+  }
+
+  /** Chạy tác vụ mạng ngoài axios (vd. fetch route VietMap) qua cùng hàng đợi */
+  run<T>(priority: RequestPriority, task: () => Promise<T>, signal?: AbortSignalLike): Promise<T> {
+    return this.schedule(priority, task, signal);
+  }
+
+  /** Chuyến đang chạy / dẫn đường: hoãn background để nhường băng thông */
+  setNavigationActive(active: boolean) {
+    if (this.navigationActive === active) return;
+    this.navigationActive = active;
+    if (!active) {
+      track("request_scheduler_report", this.getStats());
+    }
+    this.pump();
+  }
+
+  getStats() {
+    const classes = {} as Record<
+      RequestPriority,
+      { started: number; queued: number; deferred: number; cancelled: number; waitMsAvg: number; waitMsMax: number; waitMsP95: number; pending: number; inFlight: number }
+    >;
+    PRIORITY_ORDER.forEach((p) => {
+      const sorted = [...this.waitSamples[p]].sort((a, b) => a - b);
+      const started = this.stats.started[p];
+      classes[p] = {
+        started,
+        queued: this.stats.queued[p],
+        deferred: this.stats.deferred[p],
+        cancelled: this.stats.cancelled[p],
+        waitMsAvg: started > 0 ? Math.round(this.stats.waitMsTotal[p] / started) : 0,
+        waitMsMax: this.stats.waitMsMax[p],
+        waitMsP95: sorted.length > 0 ? sorted[Math.min(sorted.length - 1, Math.floor(sorted.length * 0.95))] : 0,
+        pending: this.queues[p].length,
+        inFlight: this.inFlight[p],
+      };
+    });
+    return {
+      navigationActive: this.navigationActive,
+      peakInFlight: this.stats.peakInFlight,
+      peakQueued: this.stats.peakQueued,
+      classes,
+    };
+  }
+
+  // ============ PRIVATE METHODS ============
+
+  private handle(inner: AxiosAdapter, config: InternalAxiosRequestConfig) {
+    // Huỷ khi còn xếp hàng: dispatchRequest của axios thấy signal.aborted sẽ đổi lỗi thành CanceledError
+    return this.schedule(classify(config), () => inner(config), config.signal as AbortSignalLike | undefined);
+  }
+
+  private schedule<T>(
+    priority: RequestPriority,
+    task: () => Promise<T>,
+    signal: AbortSignalLike | undefined
+  ): Promise<T> {
+    const abortError = () => signal?.reason ?? new Error("Request aborted");
+    if (signal?.aborted) return Promise.reject(abortError());
+
+    return new Promise<T>((resolve, reject) => {
+      const onAbort = () => queued.cancel();
+      const queued: QueuedTask = {
+        priority,
+        enqueuedAt: Date.now(),
+        deferred: false,
+        start: () => {
+          signal?.removeEventListener?.("abort", onAbort);
+          // Adapter có thể throw đồng bộ: vẫn phải trả slot
+          new Promise<T>((run) => run(task()))
+            .then(resolve, reject)
+            .finally(() => {
+              this.inFlight[priority]--;
+              this.pump();
+            });
+        },
+        cancel: () => {
+          const queue = this.queues[priority];
+          const index = queue.indexOf(queued);
+          if (index === -1) return;
+          queue.splice(index, 1);
+          this.stats.cancelled[priority]++;
+          reject(abortError());
+        },
+      };
+      signal?.addEventListener?.("abort", onAbort);
+      this.queues[priority].push(queued);
+      this.pump();
+      // Không chạy được ngay => tính là phải xếp hàng
+      if (this.queues[priority].includes(queued)) {
+        this.stats.queued[priority]++;
+        this.stats.peakQueued = Math.max(this.stats.peakQueued, this.pendingCount());
+      }
+    });
+  }
+
+  private pump() {
+    for (const priority of PRIORITY_ORDER) {
+      const queue = this.queues[priority];
+      while (queue.length > 0 && this.canStart(priority, queue[0])) {
+        this.start(queue.shift()!);
+      }
+    }
+    this.armDeferTimer();
+  }
+
+  private canStart(priority: RequestPriority, head: QueuedTask): boolean {
+    if (this.inFlight[priority] >= CLASS_LIMITS[priority]) return false;
+    if (priority === "critical") return true;
+    if (this.sharedInFlight() >= MAX_SHARED) return false;
+    if (priority === "interactive") return true;
+
+    // upload/background nhường critical
+    if (this.inFlight.critical > 0 || this.queues.critical.length > 0) return this.defer(head);
+    if (priority === "upload" || !this.navigationActive) return true;
+
+    // Trong chuyến: background chỉ chạy 1 cái, khi mạng rảnh hoặc đã chờ đủ lâu
+    if (this.inFlight.background > 0) return this.defer(head);
+    const idle = this.totalInFlight() === 0 && this.queues.interactive.length === 0 && this.queues.upload.length === 0;
+    if (idle || Date.now() - head.enqueuedAt >= BACKGROUND_DEFER_MS) return true;
+    return this.defer(head);
+  }
+
+  private defer(task: QueuedTask): false {
+    if (!task.deferred) {
+      task.deferred = true;
+      this.stats.deferred[task.priority]++;
+    }
+    return false;
+  }
+
+  private start(task: QueuedTask) {
+    const waitMs = Date.now() - task.enqueuedAt;
+    const p = task.priority;
+    this.stats.started[p]++;
+    this.stats.waitMsTotal[p] += waitMs;
+    this.stats.waitMsMax[p] = Math.max(this.stats.waitMsMax[p], waitMs);
+    const samples = this.waitSamples[p];
+    samples.push(waitMs);
+    if (samples.length > WAIT_SAMPLES) samples.shift();
+
+    this.inFlight[p]++;
+    this.stats.peakInFlight = Math.max(this.stats.peakInFlight, this.totalInFlight());
+    task.start();
+  }
+
+  // Background bị hoãn theo thời gian cần được đánh thức dù không có request nào kết thúc
+  private armDeferTimer() {
+    if (this.deferTimer) {
+      clearTimeout(this.deferTimer);
+      this.deferTimer = null;
+    }
+    const head = this.queues.background[0];
+    if (!head || !this.navigationActive) return;
+    // Đã quá hạn hoãn mà vẫn chờ => đang nhường critical/slot, request kết thúc sẽ pump lại
+    const delay = head.enqueuedAt + BACKGROUND_DEFER_MS - Date.now();
+    if (delay <= 0) return;
+    this.deferTimer = setTimeout(() => {
+      this.deferTimer = null;
+      this.pump();
+    }, delay + 10);
+  }
+
+  private sharedInFlight() {
+    return this.inFlight.interactive + this.inFlight.upload + this.inFlight.background;
+  }
+
+  private totalInFlight() {
+    return this.inFlight.critical + this.sharedInFlight();
+  }
+
+  private pendingCount() {
+    return PRIORITY_ORDER.reduce((sum, p) => sum + this.queues[p].length, 0);
+  }
+}
+
+export const requestScheduler = new RequestScheduler();
+export default requestScheduler;
@@ -0,0 +1,7 @@
+// Sinh từ scripts/gazetteer/units.json bằng scripts/gazetteer/buildGazetteer.js.
+// Danh mục đơn vị hành chính VN, xem utils/gazetteer.ts để biết định dạng.
+// Phủ: 63 tỉnh/TP, 53 quận/huyện, 0 phường/xã (chưa có dữ liệu cấp xã).
+
+export const VN_GAZETTEER_VERSION = 1
+
+export const VN_GAZETTEER_PACKED = "01||C|Hà Nội|21.0285|105.8542|105.28|20.56|106.02|21.39\n01001|01|Q|Ba Đình|21.0341|105.8141|105.7941|21.0141|105.8341|21.0541\n01002|01|Q|Hoàn Kiếm|21.0288|105.8525|105.8405|21.0168|105.8645|21.0408\n01003|01|Q|Tây Hồ|21.0701|105.818|105.788|21.0401|105.848|21.1001\n01004|01|Q|Long Biên|21.0363|105.895|105.845|20.9863|105.945|21.0863\n01005|01|Q|Cầu Giấy|21.032|105.7907|105.7707|21.012|105.8107|21.052\n01006|01|Q|Đống Đa|21.013|105.827|105.807|20.993|105.847|21.033\n01007|01|Q|Hai Bà Trưng|21.0058|105.8575|105.8375|20.9858|105.8775|21.0258\n01008|01|Q|Hoàng Mai|20.9743|105.8576|105.8226|20.9393|105.8926|21.0093\n01009|01|Q|Thanh Xuân|20.9935|105.8049|105.7849|20.9735|105.8249|21.0135\n01016|01|H|Sóc Sơn|21.2581|105.848|105.728|21.1381|105.968|21.3781\n01017|01|H|Đông Anh|21.1367|105.8481|105.7781|21.0667|105.9181|21.2067\n01018|01|H|Gia Lâm|21.0175|105.9373|105.8673|20.9475|106.0073|21.0875\n01019|01|Q|Nam Từ Liêm|21.0122|105.7645|105.7295|20.9772|105.7995|21.0472\n01020|01|H|Thanh Trì|20.9432|105.8453|105.7953|20.8932|105.8953|20.9932\n01021|01|Q|Bắc Từ Liêm|21.0703|105.7611|105.7261|21.0353|105.7961|21.1053\n01268|01|Q|Hà Đông|20.9592|105.7658|105.7258|20.9192|105.8058|20.9992\n02||P|Hà Giang|22.8233|104.9836|104.33|22.12|105.55|23.39\n04||P|Cao Bằng|22.6657|106.258|105.27|22.36|106.83|23.12\n06||P|Bắc Kạn|22.147|105.8348|105.43|21.8|106.25|22.74\n08||P|Tuyên Quang|21.8236|105.214|104.88|21.5|105.6|22.68\n10||P|Lào Cai|22.4856|103.9707|103.52|21.85|104.64|22.85\n11||P|Điện Biên|21.386|103.023|102.14|20.9|103.6|22.55\n12||P|Lai Châu|22.3964|103.4582|102.33|21.68|103.98|22.82\n14||P|Sơn La|21.3256|103.9188|103.2|20.6|105.05|22.03\n15||P|Yên Bái|21.7229|104.9113|103.92|21.31|105.1|22.28\n17||P|Hòa Bình|20.8133|105.3383|104.82|20.32|105.86|21.13\n19||P|Thái Nguyên|21.5942|105.8482|105.48|21.32|106.25|22.05\n20||P|Lạng Sơn|21.8537|106.7615|106.1|21.32|107.37|22.45\n22||P|Quảng Ninh|20.9599|107.0425|106.42|20.7|108.1|21.66\n24||P|Bắc Giang|21.2731|106.1946|105.88|21.12|107.03|21.62\n25||P|Phú Thọ|21.3227|105.402|104.8|20.9|105.45|21.73\n26||P|Vĩnh Phúc|21.3089|105.6049|105.33|21.13|105.78|21.57\n27||P|Bắc Ninh|21.1861|106.0763|105.9|20.97|106.32|21.26\n30||P|Hải Dương|20.9373|106.3146|106.03|20.62|106.61|21.23\n31||C|Hải Phòng|20.8449|106.6881|106.4|20.63|107.12|21.02\n31303|31|Q|Hồng Bàng|20.865|106.665|106.635|20.835|106.695|20.895\n31304|31|Q|Ngô Quyền|20.852|106.7|106.68|20.832|106.72|20.872\n31305|31|Q|Lê Chân|20.839|106.675|106.655|20.819|106.695|20.859\n33||P|Hưng Yên|20.6464|106.0511|105.9|20.58|106.28|21\n34||P|Thái Bình|20.4463|106.3366|106.03|20.28|106.62|20.73\n35||P|Hà Nam|20.5411|105.9139|105.74|20.35|106.18|20.72\n36||P|Nam Định|20.4388|106.1621|105.9|19.92|106.57|20.52\n37||P|Ninh Bình|20.2506|105.9745|105.55|19.9|106.2|20.47\n38||P|Thanh Hóa|19.8067|105.7852|104.36|19.3|106.1|20.67\n40||P|Nghệ An|18.6796|105.6813|103.87|18.55|105.82|20.01\n42||P|Hà Tĩnh|18.3559|105.8877|105.1|17.9|106.5|18.8\n44||P|Quảng Bình|17.4689|106.6223|105.6|16.92|106.98|18.1\n45||P|Quảng Trị|16.8163|107.1003|106.5|16.3|107.4|17.2\n46||P|Thừa Thiên Huế|16.4637|107.5909|107|15.98|108.2|16.75\n48||C|Đà Nẵng|16.0544|108.2022|107.82|15.92|108.35|16.2\n48490|48|Q|Hải Châu|16.06|108.218|108.193|16.035|108.243|16.085\n48491|48|Q|Thanh Khê|16.064|108.189|108.174|16.049|108.204|16.079\n48492|48|Q|Sơn Trà|16.1|108.252|108.202|16.05|108.302|16.15\n48493|48|Q|Ngũ Hành Sơn|16|108.25|108.21|15.96|108.29|16.04\n48494|48|Q|Liên Chiểu|16.088|108.14|108.08|16.028|108.2|16.148\n48495|48|Q|Cẩm Lệ|16.015|108.197|108.167|15.985|108.227|16.045\n48497|48|H|Hòa Vang|16.03|108.06|107.91|15.88|108.21|16.18\n49||P|Quảng Nam|15.5736|108.474|107.2|14.95|108.75|16.06\n51||P|Quảng Ngãi|15.1214|108.8044|108.2|14.53|109.1|15.42\n52||P|Bình Định|13.783|109.2196|108.6|13.5|109.35|14.7\n54||P|Phú Yên|13.0882|109.0929|108.67|12.7|109.46|13.7\n56||P|Khánh Hòa|12.2388|109.1967|108.67|11.8|109.47|12.87\n58||P|Ninh Thuận|11.5643|108.9886|108.55|11.3|109.23|12.15\n60||P|Bình Thuận|10.9289|108.1021|107.4|10.55|108.87|11.55\n62||P|Kon Tum|14.3497|108.0005|107.33|13.92|108.55|15.42\n64||P|Gia Lai|13.9833|108|107.45|12.97|108.9|14.6\n66||P|Đắk Lắk|12.6667|108.05|107.48|12.16|108.98|13.42\n67||P|Đắk Nông|12.0045|107.6907|107.2|11.75|108.12|12.8\n68||P|Lâm Đồng|11.9404|108.4583|107.25|11.2|108.7|12.35\n70||P|Bình Phước|11.5349|106.8832|106.4|11.3|107.42|12.3\n72||P|Tây Ninh|11.31|106.0983|105.82|10.95|106.48|11.8\n74||P|Bình Dương|10.9804|106.6519|106.35|10.85|106.95|11.5\n74718|74|TP|Thủ Dầu Một|10.9804|106.6519|106.6019|10.9304|106.7019|11.0304\n74724|74|TP|Dĩ An|10.9068|106.769|106.729|10.8668|106.809|10.9468\n74725|74|TP|Thuận An|10.924|106.713|106.673|10.884|106.753|10.964\n75||P|Đồng Nai|10.9574|106.8429|106.75|10.52|107.58|11.58\n75731|75|TP|Biên Hòa|10.9574|106.8429|106.7629|10.8774|106.9229|11.0374\n77||P|Bà Rịa - Vũng Tàu|10.4963|107.1684|106.98|10.33|107.6|10.82\n79||C|Hồ Chí Minh|10.7769|106.7009|106.35|10.37|107.03|11.16\n79760|79|Q|1|10.7757|106.7004|106.6804|10.7557|106.7204|10.7957\n79761|79|Q|12|10.8671|106.6413|106.6013|10.8271|106.6813|10.9071\n79764|79|Q|Gò Vấp|10.8387|106.6653|106.6403|10.8137|106.6903|10.8637\n79765|79|Q|Bình Thạnh|10.8106|106.7091|106.6791|10.7806|106.7391|10.8406\n79766|79|Q|Tân Bình|10.8015|106.6527|106.6277|10.7765|106.6777|10.8265\n79767|79|Q|Tân Phú|10.7901|106.6282|106.6082|10.7701|106.6482|10.8101\n79768|79|Q|Phú Nhuận|10.7992|106.6803|106.6683|10.7872|106.6923|10.8112\n79769|79|TP|Thủ Đức|10.8266|106.7609|106.6809|10.7466|106.8409|10.9066\n79770|79|Q|3|10.7843|106.6844|106.6694|10.7693|106.6994|10.7993\n79771|79|Q|10|10.7728|106.6678|106.6558|10.7608|106.6798|10.7848\n79772|79|Q|11|10.764|106.643|106.631|10.752|106.655|10.776\n79773|79|Q|4|10.7579|106.7057|106.6937|10.7459|106.7177|10.7699\n79774|79|Q|5|10.754|106.6634|106.6484|10.739|106.6784|10.769\n79775|79|Q|6|10.748|106.6352|106.6152|10.728|106.6552|10.768\n79776|79|Q|8|10.7241|106.6286|106.5986|10.6941|106.6586|10.7541\n79777|79|Q|Bình Tân|10.7653|106.6033|106.5683|10.7303|106.6383|10.8003\n79778|79|Q|7|10.734|106.7216|106.6916|10.704|106.7516|10.764\n79783|79|H|Củ Chi|11.0067|106.5131|106.3631|10.8567|106.6631|11.1567\n79784|79|H|Hóc Môn|10.8866|106.5924|106.5324|10.8266|106.6524|10.9466\n79785|79|H|Bình Chánh|10.687|106.5937|106.4937|10.587|106.6937|10.787\n79786|79|H|Nhà Bè|10.6953|106.7046|106.6546|10.6453|106.7546|10.7453\n79787|79|H|Cần Giờ|10.411|106.9547|106.7547|10.211|107.1547|10.611\n80||P|Long An|10.536|106.4137|105.5|10.38|106.8|11.05\n82||P|Tiền Giang|10.36|106.36|105.82|10.2|106.8|10.6\n83||P|Bến Tre|10.2434|106.3756|106.03|9.8|106.82|10.35\n84||P|Trà Vinh|9.9347|106.3453|105.95|9.52|106.6|10.08\n86||P|Vĩnh Long|10.2537|105.9722|105.68|9.88|106.3|10.32\n87||P|Đồng Tháp|10.46|105.6333|105.18|10.1|105.95|10.98\n89||P|An Giang|10.3864|105.4352|104.78|10.18|105.58|10.95\n91||P|Kiên Giang|10.0125|105.0809|103.45|9.38|105.55|10.55\n92||C|Cần Thơ|10.0452|105.7469|105.22|9.92|105.85|10.33\n92916|92|Q|Ninh Kiều|10.034|105.758|105.728|10.004|105.788|10.064\n93||P|Hậu Giang|9.7845|105.4701|105.32|9.58|105.88|10.02\n94||P|Sóc Trăng|9.6025|105.9739|105.55|9.2|106.3|9.93\n95||P|Bạc Liêu|9.2941|105.7278|105.22|9|105.88|9.65\n96||P|Cà Mau|9.1769|105.1524|104.7|8.55|105.4|9.55"
@@ -0,0 +1,72 @@
+/**
+ * Cluster Hook
+ * Giữ 1 PointClusterIndex cho vòng đời component, đồng bộ tăng dần khi
+ * danh sách điểm đổi và trả về cụm cho viewport/zoom hiện tại.
+ */
+
+import { useCallback, useMemo, useRef, useState } from 'react';
+import {
+  ClusterFeatureCollection,
+  ClusterPointInput,
+  LngLatBBox,
+  PointClusterIndex,
+  PointClusterOptions,
+} from '@/utils/pointCluster';
+
+export interface ClusterViewport {
+  bbox: LngLatBBox;
+  zoom: number;
+}
+
+export interface UseClustersResult<P> {
+  index: PointClusterIndex<P>;
+  clusters: ClusterFeatureCollection<P>;
+  viewport: ClusterViewport | null;
+  onViewportChange: (bbox: LngLatBBox, zoom: number) => void;
+}
+
+// Chưa có viewport (map chưa báo) thì lấy cả lãnh thổ VN ở zoom tổng quan
+const DEFAULT_VIEWPORT: ClusterViewport = { bbox: [102, 8, 110, 23.5], zoom: 5 };
+
+export function useClusters<P = Record<string, any>>(
+  points: ClusterPointInput<P>[],
+  options?: PointClusterOptions
+): UseClustersResult<P> {
+  const indexRef = useRef<PointClusterIndex<P> | null>(null);
+  if (!indexRef.current) {
+    indexRef.current = new PointClusterIndex<P>(options);
+  }
+  const index = indexRef.current;
+
+  // sync trong render là an toàn: idempotent theo id và chỉ đổi version khi dữ liệu đổi
+  const version = useMemo(() => {
+    index.sync(points);
+    return index.getVersion();
+  }, [index, points]);
+
+  const [viewport, setViewport] = useState<ClusterViewport | null>(null);
+
+  const onViewportChange = useCallback((bbox: LngLatBBox, zoom: number) => {
+    setViewport((prev) => {
+      // Bỏ qua sự kiện lặp lại cùng khung nhìn để không query lại vô ích
+      if (
+        prev &&
+        prev.zoom === zoom &&
+        prev.bbox[0] === bbox[0] &&
+        prev.bbox[1] === bbox[1] &&
+        prev.bbox[2] === bbox[2] &&
+        prev.bbox[3] === bbox[3]
+      ) {
+        return prev;
+      }
+      return { bbox, zoom };
+    });
+  }, []);
+
+  const clusters = useMemo(() => {
+    const vp = viewport ?? DEFAULT_VIEWPORT;
+    return index.getClusters(vp.bbox, vp.zoom);
+  }, [index, version, viewport]);
+
+  return { index, clusters, viewport, onViewportChange };
+}
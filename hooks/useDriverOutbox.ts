@@ -0,0 +1,21 @@
+/**
+ * Driver Outbox Hook
+ * Trạng thái hàng đợi thao tác offline (driverOutboxService): có mạng hay không,
+ * số thao tác đang chờ và các thao tác bị server từ chối, lọc theo chuyến nếu truyền tripId.
+ */
+
+import { useMemo, useSyncExternalStore } from 'react';
+import driverOutboxService from '@/services/driverOutboxService';
+
+export function useDriverOutbox(tripId?: string | null) {
+  const snapshot = useSyncExternalStore(driverOutboxService.subscribe, driverOutboxService.getSnapshot);
+
+  return useMemo(() => {
+    const scope = tripId ? driverOutboxService.scopeOf(tripId) : null;
+    const entries = scope ? snapshot.entries.filter((e) => e.scope === scope) : snapshot.entries;
+    const rejected = scope ? snapshot.rejected.filter((r) => r.scope === scope) : snapshot.rejected;
+    return { online: snapshot.online, depth: entries.length, entries, rejected };
+  }, [snapshot, tripId]);
+}
+
+export default useDriverOutbox;
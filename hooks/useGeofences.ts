@@ -0,0 +1,63 @@
+/**
+ * Geofence Hook
+ * Giữ 1 GeofenceEngine cho vòng đời component, đồng bộ danh sách fence
+ * và chuyển sự kiện enter/exit/dwell ra callback mới nhất.
+ */
+
+import { useCallback, useEffect, useRef, useState } from 'react';
+import type { Position } from 'geojson';
+import {
+  Geofence,
+  GeofenceEngine,
+  GeofenceEngineConfig,
+  GeofenceEvent,
+  GeofenceFix,
+} from '@/services/geofenceService';
+
+export interface UseGeofencesResult {
+  engine: GeofenceEngine;
+  update: (position: Position, fix?: GeofenceFix) => void;
+  insideIds: string[];
+}
+
+export function useGeofences(
+  fences: Geofence[],
+  onEvent?: (event: GeofenceEvent) => void,
+  config?: GeofenceEngineConfig
+): UseGeofencesResult {
+  const engineRef = useRef<GeofenceEngine | null>(null);
+  if (!engineRef.current) {
+    engineRef.current = new GeofenceEngine(config);
+  }
+  const engine = engineRef.current;
+
+  const onEventRef = useRef(onEvent);
+  onEventRef.current = onEvent;
+
+  const [insideIds, setInsideIds] = useState<string[]>([]);
+
+  useEffect(() => {
+    const unsubscribe = engine.subscribe((event) => {
+      if (event.type !== 'dwell') {
+        setInsideIds(engine.insideFences().map((f) => f.id));
+      }
+      onEventRef.current?.(event);
+    });
+    return () => {
+      unsubscribe();
+      engine.clear();
+    };
+  }, [engine]);
+
+  useEffect(() => {
+    engine.setFences(fences);
+    setInsideIds(engine.insideFences().map((f) => f.id));
+  }, [engine, fences]);
+
+  const update = useCallback(
+    (position: Position, fix?: GeofenceFix) => engine.update(position, fix),
+    [engine]
+  );
+
+  return { engine, update, insideIds };
+}
@@ -1,7 +1,8 @@
-import { useCallback, useEffect, useState } from 'react'
+import { useCallback, useEffect, useRef, useState } from 'react'
 import itemService from '@/services/itemService'
 import { Item, ImageStatus } from '@/models/types'
 import { useAuth } from './useAuth'
+import { useRequestCacheRefresh } from './useRequestCacheRefresh'
 
 export const useItems = (initialPage = 1, initialSize = 20) => {
   const { user } = useAuth()
@@ -17,6 +18,8 @@ export const useItems = (initialPage = 1, initialSize = 20) => {
   const [sortBy, setSortBy] = useState<string>('itemname')
   const [sortOrder, setSortOrder] = useState<'ASC' | 'DESC'>('ASC')
   const [statusFilter, setStatusFilter] = useState<string>('ALL')
+  // Tham số lần fetch gần nhất, để làm mới đúng trang khi cache báo dữ liệu đổi
+  const lastArgsRef = useRef<[number, number, string, string, 'ASC' | 'DESC', string] | null>(null)
 
   const fetchPage = useCallback(async (
     p = page, 
@@ -26,6 +29,7 @@ export const useItems = (initialPage = 1, initialSize = 20) => {
     order = sortOrder,
     statusVal = statusFilter
   ) => {
+    lastArgsRef.current = [p, size, searchQuery, sort, order, statusVal]
     setLoading(true)
     setError(null)
     try {
@@ -91,6 +95,10 @@ export const useItems = (initialPage = 1, initialSize = 20) => {
     if (userId) fetchPage(initialPage, initialSize)
   }, [userId, fetchPage, initialPage, initialSize])
 
+  useRequestCacheRefresh(['item'], () => {
+    if (lastArgsRef.current) fetchPage(...lastArgsRef.current)
+  })
+
   // createItem: send ItemCreateDTO + ItemImages[] (multipart handled in service)
   const createItem = async (payload: any) => {
     setLoading(true)
@@ -5,6 +5,7 @@ import * as Device from "expo-device";
 import * as Notifications from "expo-notifications";
 import Constants from "expo-constants";
 import { useNotificationStore } from "@/stores/notificationStore";
+import changeFeedService from "@/services/changeFeedService";
 
 // Cấu hình hiển thị notification khi app đang mở (Foreground)
 Notifications.setNotificationHandler({
@@ -107,12 +108,14 @@ export const useNotification = (autoRefresh: boolean = false) => {
     }
   }, []);
 
-  // Lấy số lượng thông báo chưa đọc
+  // Lấy số lượng thông báo chưa đọc (trả true nếu số đếm thay đổi - dùng cho back-off polling)
   const fetchUnreadCount = useCallback(async () => {
     try {
       const count = await notificationService.getUnreadCount();
       console.log('📊 Unread count:', count);
+      const changed = count !== useNotificationStore.getState().unreadCount;
       setUnreadCount(count);
+      return changed;
     } catch (error: any) {
       // Ignore 401/403 errors (user logged out or token invalid)
       if (error?.response?.status === 401 || error?.response?.status === 403) {
@@ -137,12 +140,20 @@ export const useNotification = (autoRefresh: boolean = false) => {
     // 2. Fetch unread count ban đầu
     fetchUnreadCount();
 
-    // 3. Auto-refresh unread count mỗi 30 giây (chỉ khi autoRefresh = true)
-    let intervalId: NodeJS.Timeout | undefined;
+    // 3. Auto-refresh unread count (chỉ khi autoRefresh = true): server đẩy NotificationCreated
+    //    qua SignalR; chỉ poll (30s, giãn dần tới 5 phút) khi mất kết nối
+    let unsubscribeFeed: (() => void) | undefined;
+    let unregisterPoller: (() => void) | undefined;
     if (autoRefresh) {
-      intervalId = setInterval(() => {
-        fetchUnreadCount();
-      }, 30000); // 30 seconds
+      unsubscribeFeed = changeFeedService.subscribe("NotificationCreated", (event) => {
+        // Có số đếm trong sự kiện thì store đã được cập nhật, không cần gọi API
+        if (event.unreadCount === undefined) fetchUnreadCount();
+      });
+      unregisterPoller = changeFeedService.registerPoller(
+        "notification-unread-count",
+        fetchUnreadCount,
+        { baseMs: 30000, maxMs: 5 * 60 * 1000, legacyIntervalMs: 30000 }
+      );
     }
 
     // 4. Listener: Khi nhận notification (App đang mở - Foreground)
@@ -177,7 +188,8 @@ export const useNotification = (autoRefresh: boolean = false) => {
 
     // Cleanup listeners khi unmount
     return () => {
-      if (intervalId) clearInterval(intervalId);
+      unsubscribeFeed?.();
+      unregisterPoller?.();
       if (notificationListener.current) {
         notificationListener.current.remove();
       }
@@ -1,13 +1,20 @@
-import { useCallback, useEffect, useState } from 'react'
+import { useCallback, useEffect, useRef, useState } from 'react'
 import packageService from '@/services/packageService'
 import { Package } from '@/models/types'
 import { useAuth } from './useAuth'
+import { useEntityList, useEntityStore } from '@/stores/entityStore'
+import { useRequestCacheRefresh } from './useRequestCacheRefresh'
+import { createLogger } from '@/utils/logger'
+
+const log = createLogger('usePackages')
 
 export const usePackages = (initialPage = 1, initialSize = 20) => {
   const { user } = useAuth()
   const userId = (user as any)?.userId
 
-  const [packages, setPackages] = useState<Package[]>([])
+  // Danh sách chỉ giữ id; dữ liệu package nằm trong entity store dùng chung
+  const [packageIds, setPackageIds] = useState<string[]>([])
+  const packages = useEntityList<Package>('package', packageIds)
   const [total, setTotal] = useState<number>(0)
   const [page, setPage] = useState<number>(initialPage)
   const [pageSize, setPageSize] = useState<number>(initialSize)
@@ -17,6 +24,8 @@ export const usePackages = (initialPage = 1, initialSize = 20) => {
   const [sortField, setSortField] = useState<string>('title')
   const [sortOrder, setSortOrder] = useState<'ASC' | 'DESC'>('DESC')
   const [statusFilter, setStatusFilter] = useState<string>('ALL')
+  // Tham số lần fetch gần nhất, để làm mới đúng trang khi cache báo dữ liệu đổi
+  const lastArgsRef = useRef<[number, number, string, string, 'ASC' | 'DESC', string] | null>(null)
 
   const fetchPage = useCallback(async (
     p = page, 
@@ -26,6 +35,7 @@ export const usePackages = (initialPage = 1, initialSize = 20) => {
     order = sortOrder,
     statusVal = statusFilter
   ) => {
+    lastArgsRef.current = [p, size, searchQuery, sort, order, statusVal]
     setLoading(true)
     setError(null)
     try {
@@ -38,7 +48,7 @@ export const usePackages = (initialPage = 1, initialSize = 20) => {
         status: statusVal !== 'ALL' ? statusVal : undefined
       })
       
-      console.log('📦 [usePackages] API response:', res);
+      log.debug('API response', res)
       
       if (res && res.isSuccess && res.result) {
         const result: any = res.result
@@ -46,11 +56,11 @@ export const usePackages = (initialPage = 1, initialSize = 20) => {
         const rawPackages: any[] = result.data ?? result.items ?? []
         const totalCount: number = result.totalCount ?? rawPackages.length
         
-        console.log(`📦 [usePackages] Found ${rawPackages.length} packages`);
+        log.debug(() => `Found ${rawPackages.length} packages`)
 
         // Map backend DTO to frontend Package interface
         const dataPackages: Package[] = rawPackages.map((pkg: any, idx: number) => {
-          console.log(`  📦 Package ${idx}:`, {
+          log.trace(() => `Package ${idx}`, () => ({
             id: pkg.packageId,
             title: pkg.title,
             status: pkg.status,
@@ -64,7 +74,7 @@ export const usePackages = (initialPage = 1, initialSize = 20) => {
               isBulky: pkg.isBulky,
               isPerishable: pkg.isPerishable,
             }
-          });
+          }))
           
           const imagesRaw = pkg.packageImages ?? pkg.images ?? []
           const images = (imagesRaw || []).map((img: any) => ({
@@ -103,7 +113,7 @@ export const usePackages = (initialPage = 1, initialSize = 20) => {
           } as Package
         })
 
-        setPackages(dataPackages)
+        setPackageIds(useEntityStore.getState().upsertMany('package', dataPackages, (pkg) => pkg.id))
         setTotal(totalCount)
         setPage(p)
         setPageSize(size)
@@ -119,6 +129,10 @@ export const usePackages = (initialPage = 1, initialSize = 20) => {
 
   // REMOVED: No auto-fetch on mount, component will call fetchPage manually
 
+  useRequestCacheRefresh(['package'], () => {
+    if (lastArgsRef.current) fetchPage(...lastArgsRef.current)
+  })
+
   return {
     packages,
     total,
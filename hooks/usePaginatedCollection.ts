@@ -0,0 +1,60 @@
+/**
+ * Paginated Collection Hook
+ * Giữ 1 PaginatedCollection cho vòng đời màn hình, nạp trang đầu khi mount
+ * và trả snapshot + các thao tác cho FlatList (onEndReached/onStartReached/refresh).
+ */
+
+import { useCallback, useEffect, useRef, useState } from 'react';
+import {
+  PaginatedCollection,
+  PaginatedCollectionOptions,
+  PaginatedSnapshot,
+} from '@/utils/paginatedCollection';
+
+export interface UsePaginatedCollectionResult<T> extends PaginatedSnapshot<T> {
+  collection: PaginatedCollection<T>;
+  loadMore: () => void;
+  loadPrevious: () => void;
+  refresh: () => void;
+  reload: () => void;
+}
+
+export function usePaginatedCollection<T>(
+  options: PaginatedCollectionOptions<T>
+): UsePaginatedCollectionResult<T> {
+  const collectionRef = useRef<PaginatedCollection<T> | null>(null);
+  if (!collectionRef.current) {
+    collectionRef.current = new PaginatedCollection<T>(options);
+  }
+  const collection = collectionRef.current;
+
+  const [snapshot, setSnapshot] = useState<PaginatedSnapshot<T>>(() => ({
+    ...collection.getSnapshot(),
+    loading: true,
+  }));
+
+  useEffect(() => {
+    const unsubscribe = collection.subscribe(setSnapshot);
+    collection.reload();
+    return unsubscribe;
+  }, [collection]);
+
+  // onEndReached có thể bắn nhiều lần liên tiếp; collection tự bỏ qua khi đang nạp
+  const loadMore = useCallback(() => {
+    collection.loadMore();
+  }, [collection]);
+
+  const loadPrevious = useCallback(() => {
+    collection.loadPrevious();
+  }, [collection]);
+
+  const refresh = useCallback(() => {
+    collection.reload(true);
+  }, [collection]);
+
+  const reload = useCallback(() => {
+    collection.reload();
+  }, [collection]);
+
+  return { ...snapshot, collection, loadMore, loadPrevious, refresh, reload };
+}
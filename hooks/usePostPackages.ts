@@ -1,13 +1,17 @@
-import { useCallback, useEffect, useState } from 'react'
+import { useCallback, useEffect, useRef, useState } from 'react'
 import postPackageService from '@/services/postPackageService'
 import { FreightPost } from '@/models/types'
 import { useAuth } from './useAuth'
+import { useEntityList, useEntityStore } from '@/stores/entityStore'
+import { useRequestCacheRefresh } from './useRequestCacheRefresh'
 
 export const usePostPackages = (initialPage = 1, initialSize = 20) => {
   const { user } = useAuth()
   const userId = (user as any)?.userId
 
-  const [posts, setPosts] = useState<FreightPost[]>([])
+  // Danh sách chỉ giữ id; dữ liệu bài đăng nằm trong entity store dùng chung
+  const [postIds, setPostIds] = useState<string[]>([])
+  const posts = useEntityList<FreightPost>('post', postIds)
   const [total, setTotal] = useState<number>(0)
   const [page, setPage] = useState<number>(initialPage)
   const [pageSize, setPageSize] = useState<number>(initialSize)
@@ -17,6 +21,8 @@ export const usePostPackages = (initialPage = 1, initialSize = 20) => {
   const [sortBy, setSortBy] = useState<string>('title')
   const [sortOrder, setSortOrder] = useState<'ASC' | 'DESC'>('DESC')
   const [statusFilter, setStatusFilter] = useState<string>('ALL')
+  // Tham số lần fetch gần nhất, để làm mới đúng trang khi cache báo dữ liệu đổi
+  const lastArgsRef = useRef<[number, number, string, string, 'ASC' | 'DESC'] | null>(null)
 
   const fetchPage = useCallback(async (
     p = page, 
@@ -25,6 +31,7 @@ export const usePostPackages = (initialPage = 1, initialSize = 20) => {
     sort = sortBy,
     order = sortOrder
   ) => {
+    lastArgsRef.current = [p, size, searchQuery, sort, order]
     setLoading(true)
     setError(null)
     try {
@@ -85,7 +92,7 @@ export const usePostPackages = (initialPage = 1, initialSize = 20) => {
           },
         }))
 
-        setPosts(dataPosts)
+        setPostIds(useEntityStore.getState().upsertMany('post', dataPosts, (post) => post.id))
         setTotal(totalCount)
         setPage(p)
         setPageSize(size)
@@ -107,6 +114,10 @@ export const usePostPackages = (initialPage = 1, initialSize = 20) => {
     if (userId) fetchPage(page, pageSize, search, sortBy, sortOrder)
   }, [userId, page, pageSize, search, sortBy, sortOrder, fetchPage])
 
+  useRequestCacheRefresh(['postpackage', 'trip'], () => {
+    if (lastArgsRef.current) fetchPage(...lastArgsRef.current)
+  })
+
   return {
     posts,
     total,
@@ -1,7 +1,8 @@
-import { useState, useEffect, useCallback } from 'react'
+import { useState, useEffect, useCallback, useRef } from 'react'
 import tripService from '@/services/tripService'
 import { ProviderTripSummary } from '@/models/types'
 import { useAuth } from './useAuth'
+import { useRequestCacheRefresh } from './useRequestCacheRefresh'
 
 interface UseProviderTripsResult {
   trips: ProviderTripSummary[]
@@ -34,8 +35,11 @@ export function useProviderTrips(): UseProviderTripsResult {
   const [sortDirection, setSortDirection] = useState<'ASC' | 'DESC'>('DESC')
   const [statusFilter, setStatusFilter] = useState('ALL')
 
+  const hasFetchedRef = useRef(false)
+
   const fetchPage = useCallback(async (pageNum: number) => {
     if (!user?.userId) return
+    hasFetchedRef.current = true
     setLoading(true)
     setError(null)
     try {
@@ -85,6 +89,11 @@ export function useProviderTrips(): UseProviderTripsResult {
     }
   }, [user?.userId, pageSize, search, sortField, sortDirection, statusFilter])
 
+  // Chỉ làm mới khi component đã fetch thủ công ít nhất 1 lần
+  useRequestCacheRefresh(['trip'], () => {
+    if (hasFetchedRef.current) fetchPage(page)
+  })
+
   // ✅ BỎ auto-fetch, chỉ fetch khi được gọi thủ công từ component
   // useEffect(() => {
   //   fetchPage(1)
@@ -0,0 +1,24 @@
+/**
+ * Request Cache Refresh Hook
+ * Gọi lại `refresh` khi request cache báo dữ liệu của tag đã đổi (revalidate nền
+ * trả về bản mới, hoặc bị invalidate sau mutation) để màn hình cập nhật mà không
+ * phải tự poll.
+ */
+
+import { useEffect, useRef } from 'react';
+import requestCache from '@/config/requestCache';
+
+export function useRequestCacheRefresh(tags: string[], refresh: () => void) {
+  const refreshRef = useRef(refresh);
+  refreshRef.current = refresh;
+  const tagsKey = tags.join('|');
+
+  useEffect(() => {
+    const watched = tagsKey.split('|');
+    return requestCache.subscribe((changed) => {
+      if (changed.some((t) => watched.includes(t))) refreshRef.current();
+    });
+  }, [tagsKey]);
+}
+
+export default useRequestCacheRefresh;
@@ -0,0 +1,69 @@
+/**
+ * Route Pipeline Hook
+ * Nạp tuyến (polyline hoặc toạ độ) vào routePipeline cho vòng đời component
+ * và trả về hình học đã xử lý + hàm snap chạy ngoài main thread.
+ */
+
+import { useCallback, useEffect, useRef, useState } from 'react';
+import type { Position } from 'geojson';
+import {
+  routePipeline,
+  RouteGeometry,
+  RouteSnap,
+} from '@/utils/routePipeline';
+
+export interface UseRoutePipelineResult {
+  route: RouteGeometry | null;
+  pending: boolean;
+  snap: (position: Position) => Promise<RouteSnap | null>;
+}
+
+export function useRoutePipeline(
+  coordinates?: Position[] | null,
+  encoded?: string | null,
+  precision: number = 5
+): UseRoutePipelineResult {
+  const routeIdRef = useRef<string | null>(null);
+  if (!routeIdRef.current) {
+    routeIdRef.current = routePipeline.createRouteId('map');
+  }
+  const routeId = routeIdRef.current;
+
+  const [route, setRoute] = useState<RouteGeometry | null>(null);
+  const [pending, setPending] = useState(false);
+  const versionRef = useRef(0);
+
+  useEffect(() => {
+    const version = ++versionRef.current;
+    const hasCoords = !!coordinates && coordinates.length > 0;
+    if (!hasCoords && !encoded) {
+      setRoute(null);
+      setPending(false);
+      return;
+    }
+    setPending(true);
+    routePipeline
+      .load(routeId, hasCoords ? { coordinates } : { encoded, precision })
+      .then((result) => {
+        // Bỏ kết quả cũ nếu tuyến đã đổi trong lúc worker xử lý
+        if (version !== versionRef.current) return;
+        setRoute(result);
+        setPending(false);
+      })
+      .catch((error) => {
+        if (version !== versionRef.current) return;
+        console.warn('[useRoutePipeline] load failed', error);
+        setRoute(null);
+        setPending(false);
+      });
+  }, [routeId, coordinates, encoded, precision]);
+
+  useEffect(() => () => routePipeline.release(routeId), [routeId]);
+
+  const snap = useCallback(
+    (position: Position) => routePipeline.snap(routeId, position).catch(() => null),
+    [routeId]
+  );
+
+  return { route, pending, snap };
+}
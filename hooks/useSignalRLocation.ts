@@ -6,6 +6,9 @@
 
 import { useState, useEffect, useRef, useCallback } from 'react';
 import { signalRTrackingService, LocationUpdate } from '@/services/signalRTrackingService';
+import { createLogger } from '@/utils/logger';
+
+const log = createLogger('useSignalRLocation');
 
 export interface DriverLocation {
   latitude: number;
@@ -49,7 +52,7 @@ export function useSignalRLocation({ tripId, enabled = true }: UseSignalRLocatio
         await signalRTrackingService.init({
           baseURL,
           onReceiveLocation: (data: LocationUpdate) => {
-            console.log('[useSignalRLocation] Received location:', data);
+            log.debug('Received location', data);
             setLocation({
               latitude: data.lat,
               longitude: data.lng,
@@ -60,7 +63,7 @@ export function useSignalRLocation({ tripId, enabled = true }: UseSignalRLocatio
             });
           },
           onConnectionChange: (isConnected) => {
-            console.log('[useSignalRLocation] Connection status:', isConnected);
+            log.info('Connection status:', isConnected);
             setConnected(isConnected);
             if (!isConnected) {
               setError('Mất kết nối SignalR');
@@ -69,16 +72,16 @@ export function useSignalRLocation({ tripId, enabled = true }: UseSignalRLocatio
             }
           },
           onError: (err) => {
-            console.error('[useSignalRLocation] Error:', err);
+            log.error('Error:', err);
             setError(err?.message || 'Lỗi kết nối');
           },
         });
 
         // Join trip group
         await signalRTrackingService.joinTripGroup(tripId);
-        console.log('[useSignalRLocation] Joined trip group:', tripId);
+        log.info('Joined trip group:', tripId);
       } catch (err: any) {
-        console.error('[useSignalRLocation] Init failed:', err);
+        log.error('Init failed:', err);
         setError(err?.message || 'Không thể kết nối');
       }
     };
@@ -88,7 +91,7 @@ export function useSignalRLocation({ tripId, enabled = true }: UseSignalRLocatio
     // Cleanup
     return () => {
       if (tripId) {
-        console.log('[useSignalRLocation] Cleanup - leaving trip group');
+        log.info('Cleanup - leaving trip group');
         signalRTrackingService.leaveTripGroup(tripId);
         signalRTrackingService.disconnect();
         initRef.current = false;
@@ -0,0 +1,35 @@
+/**
+ * Upload Progress Hook
+ * Theo dõi tiến độ các upload theo chunk (resumableUploadService): truyền id để
+ * xem 1 file, bỏ trống để lấy mọi upload đang chạy trong phiên.
+ */
+
+import { useEffect, useState } from 'react';
+import resumableUploadService from '@/services/resumableUploadService';
+import { UploadProgress } from '@/utils/resumableUpload';
+
+export function useUploadProgress(id?: string): UploadProgress[] {
+  const [progress, setProgress] = useState<Record<string, UploadProgress>>(() => {
+    const initial = id ? resumableUploadService.getProgress(id) : null;
+    return initial ? { [initial.id]: initial } : {};
+  });
+
+  useEffect(() => {
+    return resumableUploadService.subscribe((p) => {
+      if (id && p.id !== id) return;
+      setProgress((prev) => {
+        // Danh sách chung chỉ giữ upload chưa xong
+        if (!id && (p.status === 'completed' || p.status === 'cancelled')) {
+          if (!(p.id in prev)) return prev;
+          const { [p.id]: _done, ...rest } = prev;
+          return rest;
+        }
+        return { ...prev, [p.id]: p };
+      });
+    });
+  }, [id]);
+
+  return Object.values(progress);
+}
+
+export default useUploadProgress;
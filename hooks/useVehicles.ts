@@ -1,7 +1,9 @@
 import { useState, useEffect, useCallback } from "react";
+import { useRequestCacheRefresh } from "./useRequestCacheRefresh";
 import vehicleService from "@/services/vehicleService";
 import { Vehicle } from "@/models/types";
 import { useAuth } from "./useAuth";
+import { useEntityList, useEntityStore } from "@/stores/entityStore";
 
 interface UseVehiclesResult {
   vehicles: Vehicle[];
@@ -24,7 +26,9 @@ interface UseVehiclesResult {
 
 export function useVehicles(): UseVehiclesResult {
   const { user } = useAuth();
-  const [vehicles, setVehicles] = useState<Vehicle[]>([]);
+  // Danh sách chỉ giữ id; dữ liệu xe nằm trong entity store dùng chung
+  const [vehicleIds, setVehicleIds] = useState<string[]>([]);
+  const vehicles = useEntityList<Vehicle>("vehicle", vehicleIds);
   const [total, setTotal] = useState(0);
   const [page, setPage] = useState(1);
   const [pageSize] = useState(20);
@@ -83,7 +87,9 @@ export function useVehicles(): UseVehiclesResult {
           imageUrls: Array.isArray(v.imageUrls) ? v.imageUrls : [],
         }));
 
-        setVehicles(mapped);
+        setVehicleIds(
+          useEntityStore.getState().upsertMany("vehicle", mapped, (v) => v.id)
+        );
         setTotal(payload?.totalCount ?? mapped.length);
         setPage(pageNum);
       } catch (e: any) {
@@ -104,6 +110,8 @@ export function useVehicles(): UseVehiclesResult {
     fetchPage(page);
   }, [page, fetchPage]);
 
+  useRequestCacheRefresh(["vehicle"], refetch);
+
   return {
     vehicles,
     total,
@@ -4,13 +4,15 @@ import React, { useEffect, useState, useRef } from 'react'
 import { View, StyleSheet, ScrollView, StatusBar, Text, RefreshControl } from 'react-native'
 import { SafeAreaView } from 'react-native-safe-area-context'
 import { useFocusEffect } from '@react-navigation/native'
-import AsyncStorage from '@react-native-async-storage/async-storage'
+import persistedState from '@/utils/persistedState'
+import startupTrace from '@/utils/startupTrace'
 import { useAuth } from '@/hooks/useAuth'
 import { useAuthStore } from '@/stores/authStore'
 import HeaderDriver from './components/HeaderDriver'
 import DriverManagementTabs from './components/DriverManagementTabs'
 import WalletCard from '@/components/WalletCard'
 import DrivingHoursCard from './components/DrivingHoursCard'
+import { DRIVING_LIMITS } from '@/services/drivingHoursAccumulator'
 import userService from '@/services/userService'
 import driverWorkSessionService from '@/services/driverWorkSessionService'
 import walletService from '@/services/walletService'
@@ -25,9 +27,9 @@ const DriverHomeScreen: React.FC = () => {
   const driverData = (profile as any) ?? (user as any) ?? {}
 
   const [drivingStats, setDrivingStats] = useState({
-    continuous: { current: 0, max: 4, status: 'SAFE' },
-    daily: { current: 0, max: 10, status: 'SAFE' },
-    weekly: { current: 0, max: 48, status: 'SAFE' }
+    continuous: { current: 0, max: DRIVING_LIMITS.continuousHours, status: 'SAFE' },
+    daily: { current: 0, max: DRIVING_LIMITS.dailyHours, status: 'SAFE' },
+    weekly: { current: 0, max: DRIVING_LIMITS.weeklyHours, status: 'SAFE' }
   })
 
   const mountedRef = useRef<boolean>(true)
@@ -56,7 +58,7 @@ const DriverHomeScreen: React.FC = () => {
               hasDeclaredInitialHistory: prof.hasDeclaredInitialHistory ?? false,
             }
             useAuthStore.setState({ user: merged })
-            await AsyncStorage.setItem('user', JSON.stringify(merged))
+            persistedState.set('user', merged)
           }
         } catch (e) {
           console.warn('persist profile failed', e)
@@ -71,7 +73,7 @@ const DriverHomeScreen: React.FC = () => {
         const w = wresp?.result ?? wresp
         if (mountedRef.current) {
           useAuthStore.setState({ wallet: w })
-          await AsyncStorage.setItem('wallet', JSON.stringify(w))
+          persistedState.set('wallet', w)
         }
       } catch (e) {
         console.warn('wallet fetch failed', e)
@@ -105,18 +107,21 @@ const DriverHomeScreen: React.FC = () => {
 
       if (mountedRef.current) {
         setDrivingStats({
-          continuous: { current: Number(continuousHours.toFixed(2)), max: 4, status: continuousHours >= 4 ? 'WARNING' : 'SAFE' },
-          daily: { current: Number(dailyHours.toFixed(2)), max: 10, status: dailyHours >= 10 ? 'WARNING' : 'SAFE' },
-          weekly: { current: Number(weeklyHours.toFixed(2)), max: 48, status: weeklyHours >= 48 ? 'WARNING' : 'SAFE' }
+          continuous: { current: Number(continuousHours.toFixed(2)), max: DRIVING_LIMITS.continuousHours, status: continuousHours >= DRIVING_LIMITS.continuousHours ? 'WARNING' : 'SAFE' },
+          daily: { current: Number(dailyHours.toFixed(2)), max: DRIVING_LIMITS.dailyHours, status: dailyHours >= DRIVING_LIMITS.dailyHours ? 'WARNING' : 'SAFE' },
+          weekly: { current: Number(weeklyHours.toFixed(2)), max: DRIVING_LIMITS.weeklyHours, status: weeklyHours >= DRIVING_LIMITS.weeklyHours ? 'WARNING' : 'SAFE' }
         })
       }
+      return true
     } catch (e) {
       console.warn('DriverHome load failed', e)
+      return false
     }
   }
 
   useEffect(() => {
     mountedRef.current = true
+    startupTrace.markFirstRender(user?.role)
     return () => { 
       mountedRef.current = false
     }
@@ -126,7 +131,7 @@ const DriverHomeScreen: React.FC = () => {
   useFocusEffect(
     React.useCallback(() => {
       if (mountedRef.current) {
-        loadProfileAndData()
+        loadProfileAndData().then((ok) => startupTrace.markFirstData(ok))
       }
       return () => {}
     }, [])
@@ -27,6 +27,7 @@ import walletService from "@/services/walletService";
 import { useAuth } from "@/hooks/useAuth";
 import { track } from "@/utils/analytics";
 import useTripStore from "@/stores/tripStore";
+import { useEntity } from "@/stores/entityStore";
 import VietMapUniversal from "@/components/map/VietMapUniversal";
 import { extractRouteWithSteps } from "@/utils/navigation";
 import AddressAutocomplete from "@/components/AddressAutocomplete";
@@ -116,7 +117,7 @@ const DriverPostTripDetailScreen: React.FC = () => {
   const params = useLocalSearchParams();
   const postTripId = String((params as any).postTripId);
   const { user } = useAuth();
-  const { getTripDetail, setTripDetail } = useTripStore();
+  const { setTripDetail } = useTripStore();
 
   // States
   const [loading, setLoading] = useState(true);
@@ -130,7 +131,9 @@ const DriverPostTripDetailScreen: React.FC = () => {
   const [showAIModal, setShowAIModal] = useState(false);
 
   // Trip Detail (for rich data)
-  const [tripDetail, setTripDetailState] = useState<any | null>(null);
+  // Chi tiết chuyến nằm trong entity store: mở lại bài đăng hiển thị ngay bản đã có
+  const [linkedTripId, setLinkedTripId] = useState<string | null>(null);
+  const tripDetail = useEntity<any>("trip", linkedTripId);
   const [routeCoords, setRouteCoords] = useState<[number, number][]>([]);
 
   // Driver Work Session States
@@ -231,9 +234,10 @@ const DriverPostTripDetailScreen: React.FC = () => {
 
         // Fetch linked trip details
         if (normalized.trip?.tripId) {
+          setLinkedTripId(normalized.trip.tripId);
           const tRes: any = await tripService.getById(normalized.trip.tripId);
           if (tRes?.isSuccess) {
-            setTripDetailState(tRes.result);
+            setTripDetail(normalized.trip.tripId, tRes.result);
             // Decode route
             if (tRes.result.tripRoute?.routeData) {
               const { coords } = extractRouteWithSteps(
@@ -375,13 +379,13 @@ const DriverPostTripDetailScreen: React.FC = () => {
           assignmentStatus: "ACCEPTED",
           paymentStatus: depositAmount > 0 ? "PAID" : "UNPAID",
         };
-        if (tripDetail) {
-          setTripDetailState({
-            ...tripDetail,
-            drivers: [...(tripDetail.drivers || []), newDriver],
+        const optimisticTripId = linkedTripId ?? data?.trip?.tripId;
+        if (optimisticTripId) {
+          // Chỉ cập nhật drivers, các nhánh khác của trip giữ nguyên reference
+          setTripDetail(optimisticTripId, {
+            drivers: [...(tripDetail?.drivers || []), newDriver],
           });
-        } else {
-          setTripDetailState({ drivers: [newDriver] });
+          setLinkedTripId(optimisticTripId);
         }
 
         // mark that we just applied so fetchData can handle a 403 gracefully
@@ -25,7 +25,8 @@ import {
   NativeModules,
 } from "react-native";
 import { SafeAreaView } from "react-native-safe-area-context";
-import AsyncStorage from "@react-native-async-storage/async-storage";
+import persistedState from "@/utils/persistedState";
+import { createLogger } from "@/utils/logger";
 import { useRouter, useLocalSearchParams } from "expo-router";
 import { useFocusEffect } from "@react-navigation/native";
 import * as Location from "expo-location";
@@ -75,23 +76,26 @@ import tripService from "@/services/tripService";
 import vietmapService from "@/services/vietmapService";
 import tripProviderContractService from "@/services/tripProviderContractService";
 import tripDriverContractService from "@/services/tripDriverContractService";
-import tripDeliveryIssueService, {
-  DeliveryIssueType,
-} from "@/services/tripDeliveryIssueService";
-import assignmentService from "@/services/assignmentService";
+import { DeliveryIssueType } from "@/services/tripDeliveryIssueService";
+import driverOutboxService from "@/services/driverOutboxService";
+import requestScheduler from "@/config/requestScheduler";
+import { useDriverOutbox } from "@/hooks/useDriverOutbox";
 import { useAuth } from "@/hooks/useAuth";
 import * as ImagePicker from "expo-image-picker";
+import { IMAGE_PICKER_QUALITY } from "@/services/imagePipeline";
 import {
   SimpleRouteSimulator,
   SimulatorLocation,
 } from "@/utils/SimpleRouteSimulator";
 import { signalRTrackingService } from "@/services/signalRTrackingService";
+import changeFeedService from "@/services/changeFeedService";
 
 // Document Components
 import { ContractDocument } from "@/components/documents/ContractDocument";
 import { DeliveryRecordDocument } from "@/components/documents/DeliveryRecordDocument";
 import { HandoverRecordDocument } from "@/components/documents/HandoverRecordDocument";
 import IssueImagePicker from "@/components/shared/IssueImagePicker";
+import UploadProgressList from "@/components/shared/UploadProgressList";
 import HandoverChecklistEditor, {
   HandoverChecklistFormData,
 } from "@/components/shared/HandoverChecklistEditor";
@@ -99,6 +103,9 @@ import HandoverChecklistEditor, {
 import VietMapUniversal from "@/components/map/VietMapUniversal";
 import NavigationHUD from "@/components/map/NavigationHUD";
 import driverWorkSessionService from "@/services/driverWorkSessionService";
+import drivingHoursAccumulator from "@/services/drivingHoursAccumulator";
+import type { Geofence, GeofenceEvent } from "@/services/geofenceService";
+import { useGeofences } from "@/hooks/useGeofences";
 import {
   extractRouteWithSteps,
   nearestCoordIndex,
@@ -111,6 +118,11 @@ import {
   formatSpeed,
   calculateArrivalTime,
 } from "@/utils/navigation-metrics";
+import reverseGeocodeService from "@/services/reverseGeocodeService";
+
+// Log theo từng fix GPS / lần gửi vị trí / render: đi qua logger để bản release không tốn
+const log = createLogger("DriverTripDetail");
+const trackingLog = createLogger("Tracking", { sampleRate: 0.2 });
 
 // --- VehicleIssueType Helper ---
 type VehicleIssueType =
@@ -439,7 +451,7 @@ const getFirstFixFromWatch = async (
   });
 };
 
-const LAST_GOOD_LOCATION_KEY = 'drivershare:lastGoodLocation:v1';
+const LAST_GOOD_LOCATION_KEY = 'drivershare:lastGoodLocation:v1' as const;
 
 const toFiniteNumberOrNull = (value: unknown): number | null => {
   const n = typeof value === 'number' ? value : typeof value === 'string' ? Number(value) : NaN;
@@ -473,7 +485,7 @@ const persistLastGoodLocation = async (loc: any) => {
       timestamp: loc.timestamp ?? Date.now(),
       savedAt: Date.now(),
     };
-    await AsyncStorage.setItem(LAST_GOOD_LOCATION_KEY, JSON.stringify(payload));
+    persistedState.set(LAST_GOOD_LOCATION_KEY, payload);
   } catch {
     // ignore
   }
@@ -481,9 +493,8 @@ const persistLastGoodLocation = async (loc: any) => {
 
 const loadLastGoodLocation = async (): Promise<any | null> => {
   try {
-    const raw = await AsyncStorage.getItem(LAST_GOOD_LOCATION_KEY);
-    if (!raw) return null;
-    const parsed = JSON.parse(raw);
+    const parsed = await persistedState.read(LAST_GOOD_LOCATION_KEY);
+    if (!parsed) return null;
     const lat = toFiniteNumberOrNull(parsed?.coords?.latitude);
     const lng = toFiniteNumberOrNull(parsed?.coords?.longitude);
     if (lat === null || lng === null) return null;
@@ -1720,10 +1731,7 @@ const DriverTripDetailScreenV2: React.FC = () => {
             const resp: any = await driverWorkSessionService.start({
               TripId: trip.tripId,
             });
-            console.log(
-              "[startNavigationToPickupAddress] Start session response:",
-              JSON.stringify(resp, null, 2)
-            );
+            log.debug("[startNavigationToPickupAddress] Start session response:", resp);
             if (!(resp?.isSuccess ?? resp?.statusCode === 200)) {
               showAlertCrossPlatform(
                 "Lỗi",
@@ -1904,10 +1912,7 @@ const DriverTripDetailScreenV2: React.FC = () => {
             const resp: any = await driverWorkSessionService.start({
               TripId: trip.tripId,
             });
-            console.log(
-              "[startNavigationToDeliveryAddress] Start session response:",
-              JSON.stringify(resp, null, 2)
-            );
+            log.debug("[startNavigationToDeliveryAddress] Start session response:", resp);
             if (!(resp?.isSuccess ?? resp?.statusCode === 200)) {
               showAlertCrossPlatform(
                 "Lỗi",
@@ -2412,12 +2417,29 @@ const DriverTripDetailScreenV2: React.FC = () => {
       setSubmittingIssue(true);
       console.log("✅ Starting submission...");
 
+      // DTO chưa có trường vị trí: gắn địa chỉ hiện tại vào cuối mô tả (best-effort)
+      let description = issueDescription.trim();
+      try {
+        const lastKnown = await Location.getLastKnownPositionAsync({
+          maxAge: 60000,
+        });
+        if (lastKnown) {
+          const { address } = await reverseGeocodeService.resolveNow(
+            lastKnown.coords.latitude,
+            lastKnown.coords.longitude
+          );
+          description = `${description}\n📍 Vị trí: ${address}`;
+        }
+      } catch (e) {
+        console.warn("Get issue location failed", e);
+      }
+
       // Create DTO
       const dto = {
         TripId: tripId,
         DeliveryRecordId: activeDeliveryRecord.tripDeliveryRecordId,
         IssueType: issueType,
-        Description: issueDescription.trim(),
+        Description: description,
       };
 
       console.log(
@@ -2428,7 +2450,7 @@ const DriverTripDetailScreenV2: React.FC = () => {
       console.log("📦 DTO:", dto);
 
       // Send DTO + images in one request
-      const response = await tripDeliveryIssueService.reportIssue(
+      const response = await driverOutboxService.reportIssue(
         dto,
         issueImages
       );
@@ -2522,6 +2544,9 @@ const DriverTripDetailScreenV2: React.FC = () => {
   const isFetchingRef = useRef(false);
   const isSignalRInitializingRef = useRef(false);
   const signalRInitializedRef = useRef(false);
+  // Trạng thái chuyến hiện tại cho handler sự kiện đẩy (tránh fetch lại khi không đổi)
+  const tripStatusRef = useRef<string | undefined>(undefined);
+  tripStatusRef.current = trip?.status;
   
   // Manual reconnect function for SignalR
   const reconnectSignalR = useCallback(async () => {
@@ -2610,14 +2635,14 @@ const DriverTripDetailScreenV2: React.FC = () => {
   const [sendingHandoverOtp, setSendingHandoverOtp] = useState(false);
   const handoverOtpInputRefs = useRef<Array<TextInput | null>>([]);
 
-  const PICKUP_MARK_KEY = (id?: string) => `trip:${id}:pickupMarked`;
+  const PICKUP_MARK_KEY = (id?: string) => `trip:${id}:pickupMarked` as const;
 
   // --- Persist Logic ---
   const markPickup = async (val: boolean) => {
     try {
       setPickupMarked(val);
       if (tripId)
-        await AsyncStorage.setItem(PICKUP_MARK_KEY(tripId), val ? "1" : "0");
+        persistedState.set(PICKUP_MARK_KEY(tripId), val ? "1" : "0");
     } catch (e) {
       console.warn("persist pickupMarked failed", e);
     }
@@ -2626,7 +2651,7 @@ const DriverTripDetailScreenV2: React.FC = () => {
   const loadPickupMarked = async () => {
     try {
       if (!tripId) return;
-      const v = await AsyncStorage.getItem(PICKUP_MARK_KEY(tripId));
+      const v = await persistedState.read(PICKUP_MARK_KEY(tripId));
       setPickupMarked(!!v && v === "1");
     } catch (e) {
       console.warn("load pickupMarked failed", e);
@@ -2782,9 +2807,13 @@ const DriverTripDetailScreenV2: React.FC = () => {
       loadPickupMarked();
       // load initial eligibility (day/week totals)
       loadEligibilityAndSession();
-      // start polling every 60s to refresh eligibility
+      // Mỗi phút chỉ tính lại tại máy; hỏi server khi accumulator báo cần đồng bộ
       eligibilityTimerRef.current = setInterval(() => {
-        loadEligibilityAndSession();
+        if (drivingHoursAccumulator.needsReconcile()) {
+          loadEligibilityAndSession();
+        } else {
+          applyLocalEligibility();
+        }
       }, 60 * 1000);
       
       return () => {
@@ -2827,29 +2856,58 @@ const DriverTripDetailScreenV2: React.FC = () => {
     planReturnRouteFromCurrentLocation,
   ]);
 
-  // Polling: Auto-refresh session info khi có nhiều tài xế
+  // Trạng thái chuyến đổi từ phía khác (chủ xe/provider xác nhận...): server đẩy qua SignalR
   useEffect(() => {
-    if (!trip || !tripId) return;
+    if (!tripId) return;
+    return changeFeedService.subscribe("TripStatusChanged", (event) => {
+      if (event.tripId !== tripId) return;
+      if (event.status === tripStatusRef.current) return;
+      log.info("Trip status pushed:", event.status);
+      fetchTripData(true);
+    });
+  }, [tripId]);
 
-    const hasMultipleDrivers = (trip.drivers?.length || 0) > 1;
-    const isActiveTrip = [
-      "IN_PROGRESS",
-      "READY_FOR_VEHICLE_HANDOVER",
-      "VEHICLE_HANDOVERED",
-    ].includes(trip.status);
+  // Session info khi có nhiều tài xế: nhận AssignmentChanged thay vì polling,
+  // chỉ poll (giãn dần) khi mất kết nối SignalR
+  const hasMultipleDrivers = (trip?.drivers?.length || 0) > 1;
+  const isActiveTrip = [
+    "IN_PROGRESS",
+    "READY_FOR_VEHICLE_HANDOVER",
+    "VEHICLE_HANDOVERED",
+  ].includes(trip?.status ?? "");
+
+  // Chuyến đang chạy / đang dẫn đường: hoãn request nền (prefetch, revalidate)
+  // để route và đổi trạng thái đi trước
+  const tripInProgress = navActive || trip?.status === "IN_PROGRESS";
+  useEffect(() => {
+    if (!tripInProgress) return;
+    requestScheduler.setNavigationActive(true);
+    return () => requestScheduler.setNavigationActive(false);
+  }, [tripInProgress]);
 
-    if (hasMultipleDrivers && isActiveTrip) {
-      console.log("[DriverTripDetail] Starting session polling (30s interval)");
-      const interval = setInterval(() => {
-        fetchCurrentSession();
-      }, 30000); // 30 seconds - reduced API calls
+  useEffect(() => {
+    if (!tripId || !hasMultipleDrivers || !isActiveTrip) return;
 
-      return () => {
-        console.log("[DriverTripDetail] Stopping session polling");
-        clearInterval(interval);
-      };
-    }
-  }, [trip, tripId]);
+    // Phiên của chính mình đã theo dõi tại máy; chỉ cần biết tài xế khác đổi ca
+    console.log("[DriverTripDetail] Listening for session changes");
+    const unsubscribe = changeFeedService.subscribe("AssignmentChanged", (event) => {
+      if (event.tripId === tripId) fetchCurrentSession();
+    });
+    const unregisterPoller = changeFeedService.registerPoller(
+      `trip-session-${tripId}`,
+      async () => {
+        await fetchCurrentSession();
+      },
+      // Push là đường chính; poll dự phòng giữ nhịp 5 phút như trước khi có change feed
+      { baseMs: 5 * 60 * 1000, maxMs: 15 * 60 * 1000, legacyIntervalMs: 5 * 60 * 1000 }
+    );
+
+    return () => {
+      console.log("[DriverTripDetail] Stopping session listener");
+      unsubscribe();
+      unregisterPoller();
+    };
+  }, [tripId, hasMultipleDrivers, isActiveTrip]);
 
   // ========== SIGNALR CONNECTION LIFECYCLE ==========
   // Initialize SignalR for BOTH SIM and GPS modes so Owner/Provider can track in real-time
@@ -2881,10 +2939,7 @@ const DriverTripDetailScreenV2: React.FC = () => {
         await signalRTrackingService.init({
           baseURL,
           onConnectionChange: (connected) => {
-            console.log(
-              `[Driver SignalR] Connection status:`,
-              connected ? '🟢 Connected' : '🔴 Disconnected'
-            );
+            log.info(() => `[Driver SignalR] Connection status: ${connected ? '🟢 Connected' : '🔴 Disconnected'}`);
             setSignalRConnected(connected);
             if (!connected) {
               setSignalRError('Mất kết nối SignalR');
@@ -2930,7 +2985,21 @@ const DriverTripDetailScreenV2: React.FC = () => {
     };
   }, [tripId]);
 
+  // Eligibility từ accumulator (mốc server gần nhất + phiên đang chạy, giới hạn ngày/tuần tính tại máy)
+  const applyLocalEligibility = () => {
+    const snap = drivingHoursAccumulator.snapshot();
+    setEligibility({
+      canDrive: snap.canDrive,
+      message: snap.message,
+      hoursToday: snap.hoursToday,
+      hoursWeek: snap.hoursWeek,
+    });
+    setBaseHoursToday(snap.baseHoursToday);
+    setBaseHoursWeek(snap.baseHoursWeek);
+  };
+
   const loadEligibilityAndSession = async () => {
+    await drivingHoursAccumulator.init();
     try {
       const resp: any = await driverWorkSessionService.checkEligibility();
       const data = resp?.result ?? resp;
@@ -2938,6 +3007,10 @@ const DriverTripDetailScreenV2: React.FC = () => {
       // Handle rate limiting
       if (resp?.statusCode === 429) {
         console.warn("[DriverTripDetail] Rate limited - eligibility check");
+        if (drivingHoursAccumulator.hasSynced()) {
+          applyLocalEligibility();
+          return;
+        }
         // Set default eligibility to allow continued operation
         setEligibility({
           canDrive: true,
@@ -2959,14 +3032,20 @@ const DriverTripDetailScreenV2: React.FC = () => {
       const hoursWeek =
         Number(data?.HoursDrivenThisWeek ?? data?.hoursDrivenThisWeek ?? 0) ||
         0;
-      setEligibility({
+      drivingHoursAccumulator.applyServerSnapshot({
         canDrive: !!can,
         message: data?.Message ?? data?.message,
         hoursToday,
         hoursWeek,
       });
+      applyLocalEligibility();
     } catch (e: any) {
       console.warn("[DriverTripDetail] load eligibility failed", e);
+      // Đã có mốc từ lần đồng bộ trước thì tiếp tục tính tại máy
+      if (drivingHoursAccumulator.hasSynced()) {
+        applyLocalEligibility();
+        return;
+      }
       // On network error, set permissive defaults to not block user
       setEligibility({
         canDrive: true,
@@ -2978,15 +3057,36 @@ const DriverTripDetailScreenV2: React.FC = () => {
         hoursWeek: 0,
       });
     }
+  };
 
-    // We do not auto-detect active session from history anymore.
-    // The continuous timer is driven only by Start/End API calls (isSessionRunning).
-    // Update base hours from eligibility so UI totals = base + running session time.
-    if (eligibility) {
-      setBaseHoursToday(eligibility.hoursToday ?? 0);
-      setBaseHoursWeek(eligibility.hoursWeek ?? 0);
+  // The continuous timer is driven only by Start/End API calls (isSessionRunning);
+  // mirror them into the accumulator so day/week totals include the running session.
+  // Lần mount đầu isSessionRunning luôn false: không kết thúc phiên đã lưu (app bị tắt giữa chừng)
+  const sessionMirrorMountedRef = useRef(false);
+  useEffect(() => {
+    if (!tripId) return;
+    const changedAt = Date.now();
+    const firstRun = !sessionMirrorMountedRef.current;
+    sessionMirrorMountedRef.current = true;
+    if (!isSessionRunning) {
+      if (!firstRun) {
+        drivingHoursAccumulator.init().then(() => drivingHoursAccumulator.endSession(changedAt));
+      }
+      return;
     }
-  };
+    // Mốc bắt đầu lấy theo server (StartTime của phiên hiện tại), không theo lúc màn hình nhận sự kiện
+    Promise.all([
+      drivingHoursAccumulator.init(),
+      driverWorkSessionService
+        .getCurrentSessionInTrip(tripId)
+        .then((res: any) => {
+          const session = res?.isSuccess ? res.result : null;
+          const startedAt = Date.parse(session?.startTime ?? session?.StartTime ?? "");
+          return session && session.isSelf !== false && Number.isFinite(startedAt) ? startedAt : changedAt;
+        })
+        .catch(() => changedAt),
+    ]).then(([, startedAt]) => drivingHoursAccumulator.startSession(tripId, startedAt));
+  }, [isSessionRunning, tripId]);
 
   // Tick continuous seconds every second while there's an active session and it's not paused
   useEffect(() => {
@@ -3151,6 +3251,188 @@ const DriverTripDetailScreenV2: React.FC = () => {
     fetchCheckInRoute();
   }, [trip, currentDriver, overlayMapReady]);
 
+  // ========== GEOFENCES ==========
+  // Arrival detection for pickup/delivery and check-in/check-out prompts are
+  // driven by geofence events instead of re-computing distances on every fix.
+  const checkInFenceFixRef = useRef<{ position: Position; timestamp: number } | null>(null);
+  const checkOutFenceFixRef = useRef<{ position: Position; timestamp: number } | null>(null);
+
+  const geofences = useMemo<Geofence[]>(() => {
+    const fences: Geofence[] = [];
+    const pointOf = (lat: any, lng: any): Position | null => {
+      const la = toFiniteNumberOrNull(lat);
+      const ln = toFiniteNumberOrNull(lng);
+      return la === null || ln === null ? null : [ln, la];
+    };
+
+    // Active navigation destination (pickup or delivery)
+    if (
+      navActive &&
+      routeCoords.length > 1 &&
+      (journeyPhase === "TO_PICKUP" || journeyPhase === "TO_DELIVERY")
+    ) {
+      fences.push({
+        id: `destination-${journeyPhase}`,
+        kind: "circle",
+        purpose: journeyPhase === "TO_PICKUP" ? "PICKUP" : "DELIVERY",
+        center: routeCoords[routeCoords.length - 1],
+        radiusM: 50,
+      });
+    }
+
+    if (trip) {
+      const vehiclePickup = pointOf(trip.vehiclePickupLat, trip.vehiclePickupLng);
+      if (vehiclePickup) {
+        fences.push({ id: "vehicle-pickup", kind: "circle", purpose: "VEHICLE_PICKUP", center: vehiclePickup, radiusM: 150, dwellMs: 15000 });
+      }
+      const vehicleReturn = pointOf(trip.vehicleDropoffLat, trip.vehicleDropoffLng);
+      if (vehicleReturn) {
+        fences.push({ id: "vehicle-return", kind: "circle", purpose: "VEHICLE_RETURN", center: vehicleReturn, radiusM: 150, dwellMs: 15000 });
+      }
+    }
+
+    if (currentDriver) {
+      const driverStart = pointOf(currentDriver.startLat, currentDriver.startLng);
+      if (driverStart) {
+        fences.push({ id: "driver-start", kind: "circle", purpose: "DRIVER_START", center: driverStart, radiusM: 150, dwellMs: 15000 });
+      }
+      const driverEnd = pointOf(currentDriver.endLat, currentDriver.endLng);
+      if (driverEnd) {
+        fences.push({ id: "driver-end", kind: "circle", purpose: "DRIVER_END", center: driverEnd, radiusM: 150, dwellMs: 15000 });
+      }
+    }
+    return fences;
+  }, [
+    navActive,
+    routeCoords,
+    journeyPhase,
+    trip?.vehiclePickupLat,
+    trip?.vehiclePickupLng,
+    trip?.vehicleDropoffLat,
+    trip?.vehicleDropoffLng,
+    currentDriver?.startLat,
+    currentDriver?.startLng,
+    currentDriver?.endLat,
+    currentDriver?.endLng,
+  ]);
+
+  const handleGeofenceEvent = (event: GeofenceEvent) => {
+    const { purpose } = event.fence;
+    log.info(() => `[Geofence] ${event.type} ${event.fence.id} (${Math.round(event.distanceM)}m)`);
+
+    if (event.type === "enter") {
+      if (purpose === "PICKUP") setCanConfirmPickup(true);
+      else if (purpose === "DELIVERY") setCanConfirmDelivery(true);
+      return;
+    }
+    if (event.type !== "dwell" || !currentDriver) return;
+
+    const fix = { position: event.position, timestamp: event.timestamp };
+    const isCheckInFence =
+      purpose === "DRIVER_START" || (isMainDriver && purpose === "VEHICLE_PICKUP");
+
+    if (
+      isCheckInFence &&
+      canShowCheckInButton &&
+      !currentDriver.isOnBoard &&
+      !isCheckedIn &&
+      !showCheckInModal
+    ) {
+      checkInFenceFixRef.current = fix;
+      showToast("Bạn đã đến điểm nhận xe. Vui lòng chụp ảnh để check-in.");
+      setShowCheckInModal(true);
+    } else if (
+      purpose === "DRIVER_END" &&
+      !isMainDriver &&
+      currentDriver.isOnBoard &&
+      !currentDriver.isFinished &&
+      !showCheckOutModal
+    ) {
+      checkOutFenceFixRef.current = fix;
+      showToast("Bạn đã đến điểm xuống xe. Vui lòng chụp ảnh để check-out.");
+      setShowCheckOutModal(true);
+    } else if (purpose === "VEHICLE_RETURN" && isMainDriver && isReturnVehicleStatus) {
+      showToast("Bạn đã đến điểm trả xe.");
+    }
+  };
+
+  const { update: updateGeofences } = useGeofences(geofences, handleGeofenceEvent);
+
+  // Mở form check-in/check-out/báo sự cố: tra địa chỉ nền trong lúc tài xế chụp ảnh,
+  // lúc gửi resolveNow() thường đã có sẵn trong cache
+  useEffect(() => {
+    if (!showCheckInModal && !showCheckOutModal && !showIssueReportModal) return;
+    const fix = showCheckInModal
+      ? checkInFenceFixRef.current
+      : showCheckOutModal
+        ? checkOutFenceFixRef.current
+        : null;
+    if (fix) {
+      reverseGeocodeService.prefetch(fix.position[1], fix.position[0]);
+      return;
+    }
+    Location.getLastKnownPositionAsync({ maxAge: 60000 })
+      .then((p) => p && reverseGeocodeService.prefetch(p.coords.latitude, p.coords.longitude))
+      .catch(() => {});
+  }, [showCheckInModal, showCheckOutModal, showIssueReportModal]);
+
+  /**
+   * Position confirmed by a recent dwell event - lets check-in/check-out skip
+   * a fresh (slow) GPS acquisition when the driver is already inside the fence.
+   */
+  const takeRecentFenceFix = (
+    ref: React.MutableRefObject<{ position: Position; timestamp: number } | null>
+  ) => {
+    const fix = ref.current;
+    ref.current = null;
+    if (!fix || Date.now() - fix.timestamp > 60000) return null;
+    return { latitude: fix.position[1], longitude: fix.position[0] };
+  };
+
+  // Secondary driver on board: keep a low-power watch so the check-out fence can fire
+  // even when navigation is not running.
+  useEffect(() => {
+    const needsCheckOutWatch =
+      !!currentDriver &&
+      !isMainDriver &&
+      currentDriver.isOnBoard &&
+      !currentDriver.isFinished &&
+      !navActive &&
+      toFiniteNumberOrNull(currentDriver.endLat) !== null;
+    if (!needsCheckOutWatch) return;
+
+    let cancelled = false;
+    let sub: { remove: () => void } | null = null;
+    (async () => {
+      try {
+        const w = await Location.watchPositionAsync(
+          { accuracy: Location.Accuracy.Balanced, distanceInterval: 10, timeInterval: 5000 },
+          (loc: any) => {
+            const lat = toFiniteNumberOrNull(loc?.coords?.latitude);
+            const lng = toFiniteNumberOrNull(loc?.coords?.longitude);
+            if (lat === null || lng === null) return;
+            updateGeofences([lng, lat], {
+              accuracy: loc?.coords?.accuracy,
+              timestamp: loc?.timestamp,
+            });
+          }
+        );
+        if (cancelled) w.remove();
+        else sub = w;
+      } catch {
+        // ignore
+      }
+    })();
+    return () => {
+      cancelled = true;
+      try {
+        sub?.remove();
+      } catch {
+        // ignore
+      }
+    };
+  }, [currentDriver, isMainDriver, navActive, updateGeofences]);
+
   // Keep a live watch during check-in overlay to eventually get a real GPS fix on MIUI/Redmi.
   // Even if initial one-shot attempts time out, this watch can succeed later and refresh the route.
   useEffect(() => {
@@ -3190,13 +3472,17 @@ const DriverTripDetailScreenV2: React.FC = () => {
             const lng = toFiniteNumberOrNull(loc?.coords?.longitude);
             if (lat === null || lng === null) return;
 
-            console.log('[CheckInRoute] Live GPS fix:', {
+            trackingLog.debug('[CheckInRoute] Live GPS fix', () => ({
               lat,
               lng,
               accuracy: loc?.coords?.accuracy ?? null,
-            });
+            }));
 
             await persistLastGoodLocation(loc);
+            updateGeofences([lng, lat], {
+              accuracy: loc?.coords?.accuracy,
+              timestamp: loc?.timestamp,
+            });
 
             // Throttle route recomputation to avoid spamming VietMap.
             const now = Date.now();
@@ -3311,6 +3597,9 @@ const DriverTripDetailScreenV2: React.FC = () => {
       }
     }
     
+    // Mất sóng mà đã có dữ liệu: giữ màn hình hiện tại (thao tác đã vào outbox)
+    if (trip && !driverOutboxService.getSnapshot().online) return;
+
     isFetchingRef.current = true;
     lastFetchTimeRef.current = Date.now();
     
@@ -3328,6 +3617,11 @@ const DriverTripDetailScreenV2: React.FC = () => {
 
       const data = res.result;
 
+      // Chuyến đã kết thúc: dọn cờ đã lấy hàng và phiên dẫn đường của chuyến
+      if (data.status === "COMPLETED" || data.status === "CANCELLED") {
+        persistedState.remove([PICKUP_MARK_KEY(tripId), `nav_session:trip:${tripId}`]);
+      }
+
       // Parse liquidation report if trip is COMPLETED
       if (data.status === "COMPLETED" && (data as any).liquidationReportJson) {
         try {
@@ -3360,7 +3654,7 @@ const DriverTripDetailScreenV2: React.FC = () => {
           returnRecord?.tripVehicleHandoverRecordId || null;
       }
 
-      setTrip(data);
+      setTrip(driverOutboxService.overlayTrip(data));
 
       if (data?.tripRoute?.routeData) {
         const { coords } = extractRouteWithSteps(data.tripRoute.routeData);
@@ -3480,6 +3774,9 @@ const DriverTripDetailScreenV2: React.FC = () => {
   ) => {
     if (!tripId) return;
 
+    // Moving time for the local driving-hours accumulator (GPS + simulation)
+    drivingHoursAccumulator.onLocation(lat, lng);
+
     // Update UI immediately (ALWAYS)
     setCurrentPos([lng, lat]);
     setCurrentHeading(bearing);
@@ -3526,10 +3823,8 @@ const DriverTripDetailScreenV2: React.FC = () => {
         // Update last sent
         lastSentLocationRef.current = { lat, lng, timestamp: now };
         
-        console.log(
-          `[Tracking:${trackingMode.toUpperCase()}] ✅ Sent: ${lat.toFixed(
-            6
-          )}, ${lng.toFixed(6)}, ${speed.toFixed(1)} km/h`
+        trackingLog.debug(
+          () => `[${trackingMode.toUpperCase()}] ✅ Sent: ${lat.toFixed(6)}, ${lng.toFixed(6)}, ${speed.toFixed(1)} km/h`
         );
       } catch (error) {
         console.error(
@@ -3606,6 +3901,9 @@ const DriverTripDetailScreenV2: React.FC = () => {
             location.heading,
             location.speed
           );
+          updateGeofences([location.longitude, location.latitude], {
+            timestamp: location.timestamp,
+          });
         },
         onComplete: () => {
           console.log("[Simulation] ✅ Route completed - arrived at destination");
@@ -3688,7 +3986,7 @@ const DriverTripDetailScreenV2: React.FC = () => {
         }
         
         console.log("[Driver] 📍 Arrived at pickup point - Changing status...");
-        const res: any = await tripService.changeStatus({
+        const res: any = await driverOutboxService.changeStatus({
           TripId: trip.tripId,
           NewStatus: "ARRIVED_AT_PICKUP",
         });
@@ -3712,7 +4010,7 @@ const DriverTripDetailScreenV2: React.FC = () => {
         }
         
         console.log("[Driver] 📦 Arrived at delivery point - Changing status...");
-        const res: any = await tripService.changeStatus({
+        const res: any = await driverOutboxService.changeStatus({
           TripId: trip.tripId,
           NewStatus: "ARRIVED_AT_DROPOFF",
         });
@@ -4195,6 +4493,12 @@ const DriverTripDetailScreenV2: React.FC = () => {
             // Send location to server (Real mode)
             sendLocationToServer(latitude, longitude, bearing, speed);
 
+            // Arrival / check-in / check-out detection
+            updateGeofences(pos, {
+              accuracy: (loc.coords as any).accuracy,
+              timestamp: (loc as any).timestamp,
+            });
+
             // Calculate progress
             if (routeCoords.length) {
               const nearest = nearestCoordIndex(pos, routeCoords);
@@ -4207,16 +4511,6 @@ const DriverTripDetailScreenV2: React.FC = () => {
               const smooth = smoothSpeed(speed, previousSpeedRef.current);
               previousSpeedRef.current = speed;
               setCurrentSpeed(smooth);
-
-              // Proximity checks
-              const dest =
-                journeyPhase === "TO_PICKUP"
-                  ? routeCoords[0]
-                  : routeCoords[routeCoords.length - 1];
-              if (haversine(pos, dest) <= 50) {
-                if (journeyPhase === "TO_PICKUP") setCanConfirmPickup(true);
-                else setCanConfirmDelivery(true);
-              }
             }
           } catch (error) {
             console.error('[Location] Error processing location update:', error);
@@ -4379,10 +4673,7 @@ const DriverTripDetailScreenV2: React.FC = () => {
       const resp: any = await driverWorkSessionService.start({
         TripId: trip.tripId,
       });
-      console.log(
-        "[handleResumeSession] Start session response:",
-        JSON.stringify(resp, null, 2)
-      );
+      log.debug("[handleResumeSession] Start session response:", resp);
       if (!(resp?.isSuccess ?? resp?.statusCode === 200)) {
         showAlertCrossPlatform(
           "Lỗi",
@@ -4445,7 +4736,7 @@ const DriverTripDetailScreenV2: React.FC = () => {
     // Update trip status to LOADING on the backend
     let statusUpdated = false;
     try {
-      const res: any = await tripService.changeStatus({
+      const res: any = await driverOutboxService.changeStatus({
         TripId: trip!.tripId,
         NewStatus: "LOADING",
       });
@@ -4590,7 +4881,7 @@ const DriverTripDetailScreenV2: React.FC = () => {
 
       try {
         // Update trip status to UNLOADING
-        const res: any = await tripService.changeStatus({
+        const res: any = await driverOutboxService.changeStatus({
           TripId: trip.tripId,
           NewStatus: "UNLOADING",
         });
@@ -4676,7 +4967,7 @@ const DriverTripDetailScreenV2: React.FC = () => {
       const res: any = await tripService.getVehicleHandoverRecord(recordId);
       if (res?.isSuccess) {
         const record = res.result;
-        console.log("📄 Driver loaded handover record FULL:", record);
+        log.debug("📄 Driver loaded handover record FULL:", record);
         console.log("📄 Driver signature fields:", {
           type: record.type,
           handoverSigned: record.handoverSigned,
@@ -4752,7 +5043,7 @@ const DriverTripDetailScreenV2: React.FC = () => {
 
   const handleSaveHandoverChecklist = async (formData: any) => {
     try {
-      const res: any = await tripService.updateVehicleHandoverChecklist({
+      const res: any = await driverOutboxService.updateVehicleHandoverChecklist(tripId!, {
         RecordId: formData.recordId,
         CurrentOdometer: formData.currentOdometer,
         FuelLevel: formData.fuelLevel,
@@ -4915,7 +5206,7 @@ const DriverTripDetailScreenV2: React.FC = () => {
       console.log("📤 Driver sending sign request:", dto);
 
       const res: any = await tripService.signVehicleHandoverRecord(dto);
-      console.log("✍️ Driver sign response:", JSON.stringify(res, null, 2));
+      log.debug("✍️ Driver sign response:", res);
 
       if (res?.isSuccess) {
         showAlertCrossPlatform("Thành công", "Ký biên bản thành công!");
@@ -4969,7 +5260,7 @@ const DriverTripDetailScreenV2: React.FC = () => {
       if (confirmingHandover || !trip) return;
       setConfirmingHandover(true);
       try {
-        const res: any = await tripService.changeStatus({
+        const res: any = await driverOutboxService.changeStatus({
           TripId: trip.tripId,
           NewStatus: "VEHICLE_HANDOVERED",
         });
@@ -5012,7 +5303,7 @@ const DriverTripDetailScreenV2: React.FC = () => {
       if (confirmingVehicleReturning || !trip) return;
       setConfirmingVehicleReturning(true);
       try {
-        const res: any = await tripService.changeStatus({
+        const res: any = await driverOutboxService.changeStatus({
           TripId: trip.tripId,
           NewStatus: "VEHICLE_RETURNING",
         });
@@ -5053,7 +5344,7 @@ const DriverTripDetailScreenV2: React.FC = () => {
       if (confirmingReturn || !trip) return;
       setConfirmingReturn(true);
       try {
-        const res: any = await tripService.changeStatus({
+        const res: any = await driverOutboxService.changeStatus({
           TripId: trip.tripId,
           NewStatus: "VEHICLE_RETURNED",
         });
@@ -5089,6 +5380,28 @@ const DriverTripDetailScreenV2: React.FC = () => {
     setTimeout(() => setToastMsg(null), 2000);
   };
 
+  // --- Offline outbox: thao tác của chuyến đang chờ gửi khi mất sóng ---
+  const outbox = useDriverOutbox(tripId);
+  const prevOutboxDepth = useRef(outbox.depth);
+  useEffect(() => {
+    const prev = prevOutboxDepth.current;
+    prevOutboxDepth.current = outbox.depth;
+    // Đã gửi hết: lấy trạng thái thật từ server
+    if (prev > 0 && outbox.depth === 0) fetchTripData(true);
+  }, [outbox.depth]);
+
+  useEffect(() => {
+    const rejection = outbox.rejected[0];
+    if (!rejection) return;
+    driverOutboxService.dismissRejected(rejection.id);
+    showAlert("Thao tác không được chấp nhận", rejection.error);
+    fetchTripData(true);
+  }, [outbox.rejected]);
+
+  useEffect(() => {
+    if (tripId && driverOutboxService.pendingFor(tripId).checkedIn) setIsCheckedIn(true);
+  }, [tripId]);
+
   // --- Check-in Handler for Main Driver (change status + check-in) ---
   const handleMainDriverCheckIn = async () => {
     if (!trip || !checkInImage) {
@@ -5101,30 +5414,22 @@ const DriverTripDetailScreenV2: React.FC = () => {
       if (status !== "granted") {
         throw new Error("Cần quyền vị trí để check-in.");
       }
-      const now = await getLocationWithTimeout(
-        Location.Accuracy.Balanced
+      const coords =
+        takeRecentFenceFix(checkInFenceFixRef) ||
+        (await getLocationWithTimeout(Location.Accuracy.Balanced)).coords;
+      const latitude = coords.latitude;
+      const longitude = coords.longitude;
+
+      // Địa chỉ: cache đã làm ấm lúc mở form -> mạng (chờ có giới hạn) -> gazetteer -> toạ độ
+      const { address: currentAddress } = await reverseGeocodeService.resolveNow(
+        latitude,
+        longitude
       );
-      const latitude = now.coords.latitude;
-      const longitude = now.coords.longitude;
-
-      // Get current address (use coordinates as fallback)
-      let currentAddress = `${latitude.toFixed(6)}, ${longitude.toFixed(6)}`;
-      try {
-        const results = await vietmapService.searchAddress("", [
-          longitude,
-          latitude,
-        ]);
-        if (results && results.length > 0) {
-          currentAddress = results[0].address || currentAddress;
-        }
-      } catch (e) {
-        console.warn("Get address failed", e);
-      }
 
       // IMPORTANT: Check-in FIRST. If we change status first and check-in fails,
       // the UI can get stuck because main driver can no longer see the check-in button.
       const tryCheckIn = async () =>
-        (await assignmentService.driverCheckIn(
+        (await driverOutboxService.driverCheckIn(
           trip.tripId,
           latitude,
           longitude,
@@ -5146,7 +5451,7 @@ const DriverTripDetailScreenV2: React.FC = () => {
 
       if (maybeStatusGate) {
         try {
-          const statusRes: any = await tripService.changeStatus({
+          const statusRes: any = await driverOutboxService.changeStatus({
             TripId: trip.tripId,
             NewStatus: "VEHICLE_HANDOVERED",
           });
@@ -5165,7 +5470,7 @@ const DriverTripDetailScreenV2: React.FC = () => {
 
         // After successful check-in, update status for main driver.
         try {
-          const statusRes: any = await tripService.changeStatus({
+          const statusRes: any = await driverOutboxService.changeStatus({
             TripId: trip.tripId,
             NewStatus: "VEHICLE_HANDOVERED",
           });
@@ -5211,28 +5516,20 @@ const DriverTripDetailScreenV2: React.FC = () => {
       if (status !== "granted") {
         throw new Error("Cần quyền vị trí để check-in.");
       }
-      const now = await getLocationWithTimeout(
-        Location.Accuracy.Balanced
+      const coords =
+        takeRecentFenceFix(checkInFenceFixRef) ||
+        (await getLocationWithTimeout(Location.Accuracy.Balanced)).coords;
+      const latitude = coords.latitude;
+      const longitude = coords.longitude;
+
+      // Địa chỉ: cache đã làm ấm lúc mở form -> mạng (chờ có giới hạn) -> gazetteer -> toạ độ
+      const { address: currentAddress } = await reverseGeocodeService.resolveNow(
+        latitude,
+        longitude
       );
-      const latitude = now.coords.latitude;
-      const longitude = now.coords.longitude;
-
-      // Get current address (use coordinates as fallback)
-      let currentAddress = `${latitude.toFixed(6)}, ${longitude.toFixed(6)}`;
-      try {
-        const results = await vietmapService.searchAddress("", [
-          longitude,
-          latitude,
-        ]);
-        if (results && results.length > 0) {
-          currentAddress = results[0].address || currentAddress;
-        }
-      } catch (e) {
-        console.warn("Get address failed", e);
-      }
 
       // Call check-in API only
-      const res: any = await assignmentService.driverCheckIn(
+      const res: any = await driverOutboxService.driverCheckIn(
         trip.tripId,
         latitude,
         longitude,
@@ -5268,30 +5565,26 @@ const DriverTripDetailScreenV2: React.FC = () => {
       if (status !== "granted") {
         throw new Error("Cần quyền vị trí để check-out.");
       }
-      const now = await Location.getCurrentPositionAsync({
-        accuracy: Location.Accuracy.Balanced,
-        timeInterval: 5000,
-        maybeTimeoutOrBackgroundMessage: true,
-      });
-      const latitude = now.coords.latitude;
-      const longitude = now.coords.longitude;
-
-      // Get current address (use coordinates as fallback)
-      let currentAddress = `${latitude.toFixed(6)}, ${longitude.toFixed(6)}`;
-      try {
-        const results = await vietmapService.searchAddress("", [
-          longitude,
-          latitude,
-        ]);
-        if (results && results.length > 0) {
-          currentAddress = results[0].address || currentAddress;
-        }
-      } catch (e) {
-        console.warn("Get address failed", e);
-      }
+      const coords =
+        takeRecentFenceFix(checkOutFenceFixRef) ||
+        (
+          await Location.getCurrentPositionAsync({
+            accuracy: Location.Accuracy.Balanced,
+            timeInterval: 5000,
+            maybeTimeoutOrBackgroundMessage: true,
+          })
+        ).coords;
+      const latitude = coords.latitude;
+      const longitude = coords.longitude;
+
+      // Địa chỉ: cache đã làm ấm lúc mở form -> mạng (chờ có giới hạn) -> gazetteer -> toạ độ
+      const { address: currentAddress } = await reverseGeocodeService.resolveNow(
+        latitude,
+        longitude
+      );
 
       // Call check-out API
-      const res: any = await assignmentService.driverCheckOut(
+      const res: any = await driverOutboxService.driverCheckOut(
         trip.tripId,
         latitude,
         longitude,
@@ -5515,7 +5808,7 @@ const DriverTripDetailScreenV2: React.FC = () => {
     const result = await ImagePicker.launchCameraAsync({
       mediaTypes: ImagePicker.MediaTypeOptions.Images,
       allowsEditing: false,
-      quality: 0.5,
+      quality: IMAGE_PICKER_QUALITY,
       base64: true,
     });
     if (!result.canceled && result.assets[0]) {
@@ -5545,7 +5838,7 @@ const DriverTripDetailScreenV2: React.FC = () => {
     const result = await ImagePicker.launchCameraAsync({
       mediaTypes: ImagePicker.MediaTypeOptions.Images,
       allowsEditing: false,
-      quality: 0.5,
+      quality: IMAGE_PICKER_QUALITY,
       base64: true,
     });
     if (!result.canceled && result.assets[0]) {
@@ -5728,6 +6021,17 @@ const DriverTripDetailScreenV2: React.FC = () => {
         </View>
       )} */}
 
+      {/* Offline outbox */}
+      {outbox.depth > 0 && (
+        <View style={styles.outboxBanner}>
+          <Text style={styles.outboxBannerText}>
+            {outbox.online
+              ? `Đang gửi ${outbox.depth} thao tác đã lưu...`
+              : `Mất kết nối: ${outbox.depth} thao tác sẽ tự gửi khi có mạng`}
+          </Text>
+        </View>
+      )}
+
       {/* Toast */}
       {toastMsg && (
         <View style={styles.toastContainer}>
@@ -6414,12 +6718,8 @@ const DriverTripDetailScreenV2: React.FC = () => {
                   setLoadingDeliveryRecord(false);
                   if (res?.isSuccess) {
                     const rec = res.result;
-                    console.log(
-                      "📋 Delivery Record Data:",
-                      JSON.stringify(rec, null, 2)
-                    );
-                    console.log("🔍 Record type field:", rec.type);
-                    console.log("🔍 Record recordType field:", rec.recordType);
+                    log.debug("📋 Delivery Record Data:", rec);
+                    log.debug(() => `🔍 Record type: ${rec.type} / recordType: ${rec.recordType}`);
                     // Map deliveryRecordTerms to terms format for component
                     if (
                       rec.deliveryRecordTemplate?.deliveryRecordTerms &&
@@ -7091,12 +7391,12 @@ const DriverTripDetailScreenV2: React.FC = () => {
                 const recordType =
                   activeDeliveryRecord.recordType || activeDeliveryRecord.type;
                 const isPickup = recordType === "PICKUP";
-                console.log("🔔 Report Issue Button Check:", {
+                log.trace("🔔 Report Issue Button Check:", () => ({
                   recordType: activeDeliveryRecord.recordType,
                   type: activeDeliveryRecord.type,
                   finalType: recordType,
                   isPickup: isPickup,
-                });
+                }));
 
                 if (isPickup) {
                   return (
@@ -7897,6 +8197,7 @@ const DriverTripDetailScreenV2: React.FC = () => {
                 onImagesChange={setIssueImages}
                 maxImages={5}
               />
+              {submittingIssue && <UploadProgressList />}
             </ScrollView>
 
             {/* Footer Buttons */}
@@ -8204,6 +8505,7 @@ const DriverTripDetailScreenV2: React.FC = () => {
                   Hệ thống tự động kiểm tra vị trí so với bãi xe
                 </Text>
               </View>
+              {checkingIn && <UploadProgressList />}
             </ScrollView>
 
             {/* Footer */}
@@ -8298,6 +8600,7 @@ const DriverTripDetailScreenV2: React.FC = () => {
                   xe. Nếu cách quá xa (&gt;5km) sẽ có cảnh báo.
                 </Text>
               </View>
+              {checkingOut && <UploadProgressList />}
             </ScrollView>
 
             <View style={styles.checkInModalFooter}>
@@ -9483,6 +9786,13 @@ const styles = StyleSheet.create({
     zIndex: 3000,
   },
   toastText: { color: "#FFF", fontSize: 13, fontWeight: "600" },
+  outboxBanner: {
+    backgroundColor: "#FEF3C7",
+    paddingHorizontal: 16,
+    paddingVertical: 6,
+    alignItems: "center",
+  },
+  outboxBannerText: { color: "#92400E", fontSize: 12, fontWeight: "600" },
   // Driving hours widget
   hoursWidget: {
     backgroundColor: "rgba(255,255,255,0.95)",
@@ -1,4 +1,4 @@
-import React, { useState, useCallback } from 'react'
+import React, { useState, useCallback, useMemo } from 'react'
 import { 
     View, Text, StyleSheet, FlatList, TouchableOpacity, 
     ActivityIndicator, RefreshControl, StatusBar, TextInput
@@ -8,6 +8,9 @@ import { useRouter } from 'expo-router'
 import { useFocusEffect } from '@react-navigation/native'
 import { Ionicons, MaterialCommunityIcons, FontAwesome5 } from '@expo/vector-icons'
 import postTripService from '@/services/postTripService'
+import VietMapUniversal from '@/components/map/VietMapUniversal'
+import { useClusters } from '@/hooks/useClusters'
+import type { ClusterPointInput } from '@/utils/pointCluster'
 
 // --- 1. TYPES & HELPER FUNCTIONS ---
 
@@ -39,7 +42,12 @@ function normalizePost(raw: AnyObj) {
   
   const totalDrivers = details.reduce((s: number, d: AnyObj) => s + (d.requiredCount ?? d.RequiredCount ?? 0), 0)
 
-  return { id, title, description, status, requiredPayloadInKg, startName, endName, details, createdAt, totalDrivers }
+  // Toạ độ điểm đi (nếu API trả về) để hiển thị trên bản đồ cụm
+  const t = trip || {}
+  const startLat = Number(t.startLat ?? t.StartLat ?? t.startLatitude ?? t.StartLatitude ?? get(t, 'startLocation', 'latitude'))
+  const startLng = Number(t.startLng ?? t.StartLng ?? t.startLongitude ?? t.StartLongitude ?? get(t, 'startLocation', 'longitude'))
+
+  return { id, title, description, status, requiredPayloadInKg, startName, endName, details, createdAt, totalDrivers, startLat, startLng }
 }
 
 // --- 2. POST TRIP CARD ---
@@ -137,6 +145,16 @@ const OpenPostTripsScreen: React.FC = () => {
   const [sortField, setSortField] = useState<string>('CreateAt')
   const [sortDirection, setSortDirection] = useState<'ASC' | 'DESC'>('DESC')
   const [showSearchBar, setShowSearchBar] = useState(false)
+  const [showMap, setShowMap] = useState(false)
+
+  // Bài đăng có toạ độ -> chỉ mục cụm, cập nhật tăng dần khi tải thêm trang
+  const mapPoints = useMemo<ClusterPointInput<{ title: string }>[]>(
+    () => items
+      .filter((it) => Number.isFinite(it.startLat) && Number.isFinite(it.startLng))
+      .map((it) => ({ id: String(it.id), lng: it.startLng, lat: it.startLat, properties: { title: it.title } })),
+    [items]
+  )
+  const { clusters, onViewportChange } = useClusters(mapPoints)
 
   const fetchPage = async (page: number, append = false) => {
     try {
@@ -235,6 +253,9 @@ const OpenPostTripsScreen: React.FC = () => {
           >
             <Ionicons name="search" size={20} color="#4B5563" />
           </TouchableOpacity>
+          <TouchableOpacity style={styles.iconBtn} onPress={() => setShowMap(!showMap)}>
+            <Ionicons name={showMap ? 'list' : 'map-outline'} size={20} color="#4B5563" />
+          </TouchableOpacity>
           <TouchableOpacity style={styles.iconBtn} onPress={toggleSort}>
             <MaterialCommunityIcons 
               name={sortDirection === 'ASC' ? 'sort-ascending' : 'sort-descending'} 
@@ -270,7 +291,22 @@ const OpenPostTripsScreen: React.FC = () => {
         </View>
       )}
 
-      {loading && items.length === 0 ? (
+      {showMap ? (
+        <View style={styles.mapContainer}>
+          <VietMapUniversal
+            coordinates={[]}
+            clusters={clusters}
+            onViewportChange={onViewportChange}
+            onClusterPointPress={(pointId) => navigateToDetail(pointId)}
+            style={{ flex: 1 }}
+          />
+          {mapPoints.length === 0 && !loading && (
+            <View style={styles.mapHint}>
+              <Text style={styles.mapHintText}>Chưa có bài đăng nào có toạ độ để hiển thị.</Text>
+            </View>
+          )}
+        </View>
+      ) : loading && items.length === 0 ? (
         <View style={styles.center}>
             <ActivityIndicator size="large" color="#4F46E5" />
             <Text style={styles.loadingText}>Đang tải danh sách...</Text>
@@ -372,6 +408,9 @@ const styles = StyleSheet.create({
   searchBtnText: { color: '#FFF', fontSize: 14, fontWeight: '700' },
 
   listContent: { padding: 16, paddingBottom: 32 },
+  mapContainer: { flex: 1 },
+  mapHint: { position: 'absolute', top: 12, left: 16, right: 16, backgroundColor: 'rgba(17,24,39,0.8)', borderRadius: 10, padding: 10 },
+  mapHintText: { color: '#F9FAFB', fontSize: 13, textAlign: 'center' },
   loadingText: { marginTop: 12, color: '#6B7280', fontSize: 14 },
 
   card: { 
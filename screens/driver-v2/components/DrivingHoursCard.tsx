@@ -1,6 +1,7 @@
 import React from "react";
 import { View, Text, StyleSheet, TouchableOpacity } from "react-native";
 import { useRouter } from "expo-router";
+import { DRIVING_LIMITS } from "@/services/drivingHoursAccumulator";
 
 // Component hiển thị 1 vòng tròn (đơn giản hóa bằng View border)
 const CircleProgress = ({ current, max, label, color }: any) => {
@@ -30,7 +31,7 @@ const CircleProgress = ({ current, max, label, color }: any) => {
       </View>
 
       <Text style={[styles.statusText, { color }]}>
-        {percent > 80 ? "Sắp tới hạn" : "An toàn"}
+        {percent > DRIVING_LIMITS.warnRatio * 100 ? "Sắp tới hạn" : "An toàn"}
       </Text>
     </View>
   );
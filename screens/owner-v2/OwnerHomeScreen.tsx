@@ -4,7 +4,8 @@ import { SafeAreaView } from 'react-native-safe-area-context'
 import { useFocusEffect } from '@react-navigation/native'
 import { useAuth } from '@/hooks/useAuth'
 import { useAuthStore } from '@/stores/authStore'
-import AsyncStorage from '@react-native-async-storage/async-storage'
+import persistedState from '@/utils/persistedState'
+import startupTrace from '@/utils/startupTrace'
 import HeaderOwner from './components/HeaderOwner'
 import OwnerManagementTabs from './components/OwnerManagementTabs'
 import WalletCard from '../../components/WalletCard'
@@ -38,7 +39,7 @@ const OwnerHomeScreen: React.FC = () => {
             hasVerifiedCitizenId: prof.hasVerifiedCitizenId ?? false,
           }
           useAuthStore.setState({ user: merged })
-          await AsyncStorage.setItem('user', JSON.stringify(merged))
+          persistedState.set('user', merged)
         }
       }
 
@@ -47,17 +48,23 @@ const OwnerHomeScreen: React.FC = () => {
       const w = wresp?.result ?? wresp
       if (w) {
         useAuthStore.setState({ wallet: w })
-        await AsyncStorage.setItem('wallet', JSON.stringify(w))
+        persistedState.set('wallet', w)
       }
+      return true
     } catch (e) {
       console.warn('OwnerHome load failed', e)
+      return false
     }
   }
 
+  useEffect(() => {
+    startupTrace.markFirstRender(user?.role)
+  }, [])
+
   // Load data only when screen is focused (visible)
   useFocusEffect(
     React.useCallback(() => {
-      loadData()
+      loadData().then((ok) => startupTrace.markFirstData(ok))
       return () => {}
     }, [])
   )
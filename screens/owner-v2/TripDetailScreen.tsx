@@ -4,6 +4,8 @@ import React, {
   useMemo,
   useRef,
   useCallback,
+  lazy,
+  Suspense,
 } from "react";
 import {
   View,
@@ -24,6 +26,7 @@ import {
 } from "react-native";
 import { SafeAreaView } from "react-native-safe-area-context";
 import * as ImagePicker from "expo-image-picker";
+import { IMAGE_PICKER_QUALITY } from "@/services/imagePipeline";
 import * as FileSystem from "expo-file-system/legacy";
 import { useRouter, useLocalSearchParams } from "expo-router";
 import { useFocusEffect } from "@react-navigation/native";
@@ -54,7 +57,6 @@ import vietmapService from "@/services/vietmapService";
 
 // --- CUSTOM COMPONENTS ---
 import VietMapUniversal from "@/components/map/VietMapUniversal";
-import { AnimatedRouteProgress } from "@/components/map/AnimatedRouteProgress";
 import DriverAssignModal from "./components/DriverAssignModal";
 import CreatePostTripModal from "./components/CreatePostTripModal";
 import RouteProgressBar from "../../components/map/RouteProgressBar";
@@ -65,6 +67,11 @@ import HandoverChecklistEditor, {
   HandoverChecklistFormData,
 } from "@/components/shared/HandoverChecklistEditor";
 
+// Mô phỏng tuyến cần SDK bản đồ native: chỉ nạp khi bật mô phỏng lần đầu
+const AnimatedRouteProgress = lazy(() =>
+  import("@/components/map/AnimatedRouteProgress").then((m) => ({ default: m.AnimatedRouteProgress }))
+);
+
 const SCREEN_WIDTH = Dimensions.get("window").width;
 
 // --- ENUMS ---
@@ -2051,12 +2058,14 @@ const TripDetailScreen: React.FC = () => {
               
               {simulationActive && routeFeature && (
                 <View style={StyleSheet.absoluteFill} pointerEvents="none">
-                  <AnimatedRouteProgress
-                    route={routeFeature}
-                    isSimulating={simulationActive}
-                    speed={80}
-                    onPositionUpdate={handleSimulationUpdate}
-                  />
+                  <Suspense fallback={null}>
+                    <AnimatedRouteProgress
+                      route={routeFeature}
+                      isSimulating={simulationActive}
+                      speed={80}
+                      onPositionUpdate={handleSimulationUpdate}
+                    />
+                  </Suspense>
                 </View>
               )}
               {/* <View style={styles.floatingProgress}>
@@ -3937,7 +3946,7 @@ const TripDetailScreen: React.FC = () => {
                   const result = await ImagePicker.launchImageLibraryAsync({
                     mediaTypes: ImagePicker.MediaTypeOptions.Images,
                     allowsEditing: false,
-                    quality: 0.5,
+                    quality: IMAGE_PICKER_QUALITY,
                     base64: true,
                   });
 
@@ -4155,12 +4164,14 @@ const TripDetailScreen: React.FC = () => {
             />
             {simulationActive && routeFeature && (
               <View style={StyleSheet.absoluteFill} pointerEvents="none">
-                <AnimatedRouteProgress
-                  route={routeFeature}
-                  isSimulating={simulationActive}
-                  speed={80}
-                  onPositionUpdate={handleSimulationUpdate}
-                />
+                <Suspense fallback={null}>
+                  <AnimatedRouteProgress
+                    route={routeFeature}
+                    isSimulating={simulationActive}
+                    speed={80}
+                    onPositionUpdate={handleSimulationUpdate}
+                  />
+                </Suspense>
               </View>
             )}
             
@@ -19,9 +19,11 @@ import { SafeAreaView } from 'react-native-safe-area-context'
 import { useRouter, useLocalSearchParams } from 'expo-router'
 import { Ionicons, Feather, MaterialIcons, FontAwesome5 } from '@expo/vector-icons'
 import * as ImagePicker from 'expo-image-picker'
+import { IMAGE_PICKER_QUALITY } from '@/services/imagePipeline'
 import DateTimePicker from '@react-native-community/datetimepicker'
 import { VehicleDetail, VehicleImageType, DocumentType, DocumentStatus } from '@/models/types'
 import vehicleService from '@/services/vehicleService'
+import UploadProgressList from '@/components/shared/UploadProgressList'
 
 const { width } = Dimensions.get('window')
 
@@ -132,7 +134,7 @@ const VehicleDetailScreen: React.FC<Props> = ({ onBack }) => {
     const result = await ImagePicker.launchImageLibraryAsync({
       mediaTypes: ImagePicker.MediaTypeOptions.Images,
       allowsEditing: false,
-      quality: 0.5,
+      quality: IMAGE_PICKER_QUALITY,
       base64: true,
     })
 
@@ -159,7 +161,7 @@ const VehicleDetailScreen: React.FC<Props> = ({ onBack }) => {
     const result = await ImagePicker.launchImageLibraryAsync({
       mediaTypes: ImagePicker.MediaTypeOptions.Images,
       allowsEditing: false,
-      quality: 0.5,
+      quality: IMAGE_PICKER_QUALITY,
       base64: true,
     })
 
@@ -352,6 +354,7 @@ const VehicleDetailScreen: React.FC<Props> = ({ onBack }) => {
                   Giấy tờ sẽ được gửi đến Admin để xét duyệt. Vui lòng đảm bảo ảnh chụp rõ nét.
                 </Text>
               </View>
+              {uploading && <UploadProgressList />}
             </ScrollView>
 
             <View style={styles.modalFooter}>
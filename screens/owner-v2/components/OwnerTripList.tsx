@@ -45,9 +45,13 @@
 // export default OwnerTripList
 
 import React from "react";
-import { View, Text, StyleSheet, FlatList } from "react-native";
+import { View, Text, StyleSheet } from "react-native";
 import TripCard from "./TripCard";
 import { MaterialCommunityIcons } from "@expo/vector-icons";
+import VirtualizedCardList, { useLatestCallback } from "@/components/shared/VirtualizedCardList";
+
+// Chiều cao ước lượng của TripCard (gồm margin), ô đã render sẽ dùng số đo thật
+const TRIP_CARD_HEIGHT = 236;
 
 interface TripProps {
   trips: any;
@@ -68,6 +72,11 @@ const OwnerTripList: React.FC<TripProps> = ({
   else if (trips?.items) list = trips.items;
   else if (trips?.result) list = trips.result;
 
+  const handleView = useLatestCallback((tripId: string) => onView?.(tripId));
+  const handleCancel = useLatestCallback((tripId: string, tripCode: string) =>
+    onCancel?.(tripId, tripCode)
+  );
+
   const renderEmpty = () => (
     <View style={styles.emptyContainer}>
       <View style={styles.emptyIconBg}>
@@ -85,17 +94,20 @@ const OwnerTripList: React.FC<TripProps> = ({
   );
 
   return (
-    <FlatList
+    <VirtualizedCardList
       data={list}
-      renderItem={({ item }) => (
+      renderCard={(item: any) => (
         <TripCard
           trip={item}
-          onView={onView}
-          onCancel={onCancel}
+          onView={onView ? handleView : undefined}
+          onCancel={onCancel ? handleCancel : undefined}
           cancelling={cancelling}
         />
       )}
-      keyExtractor={(i) => i.tripId ?? i.id ?? String(Math.random())}
+      keyOf={(i: any) => String(i.tripId ?? i.id)}
+      estimateHeight={TRIP_CARD_HEIGHT}
+      extraData={cancelling}
+      perfTag="owner-trip-list"
       ListEmptyComponent={renderEmpty}
       contentContainerStyle={styles.listContent}
       showsVerticalScrollIndicator={false}
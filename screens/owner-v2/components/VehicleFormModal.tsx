@@ -14,10 +14,12 @@ import {
   Platform,
 } from "react-native";
 import * as ImagePicker from "expo-image-picker";
+import { IMAGE_PICKER_QUALITY } from "@/services/imagePipeline";
 import { Ionicons, Feather, MaterialCommunityIcons } from "@expo/vector-icons";
 import vehicleTypeService from "@/services/vehicleTypeService";
 import { VehicleType } from "@/models/types";
 import DateInput from "@/components/DateInput";
+import UploadProgressList from "@/components/shared/UploadProgressList";
 
 interface Props {
   visible: boolean;
@@ -183,7 +185,7 @@ const VehicleFormModal: React.FC<Props> = ({ visible, onClose, onCreate }) => {
     const result = await ImagePicker.launchImageLibraryAsync({
       mediaTypes: ['images'],
       allowsEditing: false,
-      quality: 0.5,
+      quality: IMAGE_PICKER_QUALITY,
       base64: true,
     });
 
@@ -265,7 +267,7 @@ const VehicleFormModal: React.FC<Props> = ({ visible, onClose, onCreate }) => {
     const result = await ImagePicker.launchImageLibraryAsync({
       mediaTypes: ['images'],
       allowsEditing: false,
-      quality: 0.5,
+      quality: IMAGE_PICKER_QUALITY,
       base64: true,
     });
     
@@ -636,6 +638,7 @@ const VehicleFormModal: React.FC<Props> = ({ visible, onClose, onCreate }) => {
                 </View>
               </View>
             ))} */}
+            {submitting && <UploadProgressList />}
           </ScrollView>
 
           <View style={styles.footer}>
@@ -50,10 +50,14 @@
 // export default VehicleList
 
 import React from 'react'
-import { View, Text, StyleSheet, FlatList, Dimensions } from 'react-native'
+import { View, Text, StyleSheet } from 'react-native'
 import { MaterialCommunityIcons } from '@expo/vector-icons'
 import VehicleCard from './VehicleCard'
 import { Vehicle } from '../../../models/types'
+import VirtualizedCardList, { useLatestCallback } from '@/components/shared/VirtualizedCardList'
+
+// Chiều cao ước lượng 1 hàng VehicleCard (gồm margin), ô đã render sẽ dùng số đo thật
+const VEHICLE_CARD_HEIGHT = 262
 
 interface Props {
   vehicles: any
@@ -70,6 +74,10 @@ const VehicleList: React.FC<Props> = ({ vehicles, onEdit, onDelete, onPress }) =
   else if (vehicles && Array.isArray(vehicles.items)) list = vehicles.items
   else if (vehicles && Array.isArray(vehicles.result)) list = vehicles.result
 
+  const handleEdit = useLatestCallback(onEdit)
+  const handleDelete = useLatestCallback(onDelete)
+  const handlePress = useLatestCallback((vehicleId: string) => onPress?.(vehicleId))
+
   // Component hiển thị khi không có xe
   const renderEmpty = () => (
     <View style={styles.emptyContainer}>
@@ -84,17 +92,19 @@ const VehicleList: React.FC<Props> = ({ vehicles, onEdit, onDelete, onPress }) =
   )
 
   return (
-    <FlatList
+    <VirtualizedCardList
       data={list}
-      renderItem={({ item }) => (
+      renderCard={(item) => (
         <VehicleCard 
           vehicle={item} 
-          onEdit={() => onEdit(item)} 
-          onDelete={() => onDelete(item.id)} 
-          onPress={() => onPress?.(item.id)}
+          onEdit={() => handleEdit(item)} 
+          onDelete={() => handleDelete(item.id)} 
+          onPress={() => handlePress(item.id)}
         />
       )}
-      keyExtractor={(item) => item.id.toString()}
+      keyOf={(item) => item.id.toString()}
+      estimateHeight={VEHICLE_CARD_HEIGHT}
+      perfTag="owner-vehicle-list"
       numColumns={2} // Layout lưới 2 cột
       columnWrapperStyle={styles.columnWrapper} // Căn chỉnh khoảng cách giữa 2 cột
       contentContainerStyle={styles.listContent}
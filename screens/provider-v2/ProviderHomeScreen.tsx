@@ -12,7 +12,8 @@ import { SafeAreaView } from 'react-native-safe-area-context'
 import { useFocusEffect } from '@react-navigation/native'
 import { Provider } from '@/models/types'
 import { useAuthStore } from '@/stores/authStore'
-import AsyncStorage from '@react-native-async-storage/async-storage'
+import persistedState from '@/utils/persistedState'
+import startupTrace from '@/utils/startupTrace'
 import HeaderProvider from './components/HeaderProvider'
 import Stats from './components/Stat'
 import ManagementTabs from './components/ManagementTab'
@@ -51,7 +52,7 @@ const ProviderHomePage: React.FC<ProviderHomePageProps> = ({ provider }) => {
             hasVerifiedCitizenId: prof.hasVerifiedCitizenId ?? false,
           }
           useAuthStore.setState({ user: merged })
-          await AsyncStorage.setItem('user', JSON.stringify(merged))
+          persistedState.set('user', merged)
         }
       }
 
@@ -59,17 +60,23 @@ const ProviderHomePage: React.FC<ProviderHomePageProps> = ({ provider }) => {
       const w = wresp?.result ?? wresp
       if (w) {
         useAuthStore.setState({ wallet: w })
-        await AsyncStorage.setItem('wallet', JSON.stringify(w))
+        persistedState.set('wallet', w)
       }
+      return true
     } catch (e) {
       console.warn('ProviderHome load failed', e)
+      return false
     }
   }
 
+  useEffect(() => {
+    startupTrace.markFirstRender(user?.role)
+  }, [])
+
   // Load data only when screen is focused (visible)
   useFocusEffect(
     React.useCallback(() => {
-      loadData()
+      loadData().then((ok) => startupTrace.markFirstData(ok))
       return () => {}
     }, [])
   )
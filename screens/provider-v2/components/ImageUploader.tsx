@@ -10,6 +10,7 @@ import {
 import { PhotoIcon } from '../icons/ActionIcons'
 // Import thư viện image picker của Expo
 import * as ImagePicker from 'expo-image-picker'
+import { IMAGE_PICKER_QUALITY } from '@/services/imagePipeline'
 
 interface ImageUploaderProps {
   currentImage: string | null
@@ -37,7 +38,7 @@ const ImageUploader: React.FC<ImageUploaderProps> = ({
     const result = await ImagePicker.launchImageLibraryAsync({
       mediaTypes: ['images'],
       allowsEditing: false,
-      quality: 0.7,
+      quality: IMAGE_PICKER_QUALITY,
       base64: true, // Dùng base64 cho preview (không dùng để upload)
     })
 
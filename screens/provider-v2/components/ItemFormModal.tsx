@@ -15,6 +15,7 @@ import {
   ActivityIndicator
 } from 'react-native'
 import * as ImagePicker from 'expo-image-picker'
+import { IMAGE_PICKER_QUALITY } from '@/services/imagePipeline'
 import { Ionicons, MaterialCommunityIcons } from '@expo/vector-icons'
 import { ItemStatus, ImageStatus } from '../../../models/types'
 import { formatVND, parseVND } from '@/utils/currency'
@@ -118,7 +119,7 @@ const ItemFormModal: React.FC<ItemFormModalProps> = ({
     const result = await ImagePicker.launchImageLibraryAsync({
       mediaTypes: ImagePicker.MediaTypeOptions.Images,
       allowsEditing: false,
-      quality: 0.5, // Giảm từ 0.7 xuống 0.5 để giảm kích thước
+      quality: IMAGE_PICKER_QUALITY,
       base64: true
     })
 
@@ -1,8 +1,12 @@
 import React from 'react'
-import { View, Text, StyleSheet, FlatList } from 'react-native'
+import { View, Text, StyleSheet } from 'react-native'
 import { Item } from '../../../models/types'
 import ItemCard from './ItemCard'
 import { CubeIcon } from '../icons/ManagementIcons'
+import VirtualizedCardList, { useLatestCallback } from '@/components/shared/VirtualizedCardList'
+
+// Chiều cao ước lượng của ItemCard (gồm margin), ô đã render sẽ dùng số đo thật
+const ITEM_CARD_HEIGHT = 148
 
 interface ItemListProps {
   items: Item[]
@@ -14,6 +18,10 @@ interface ItemListProps {
 }
 
 const ItemList: React.FC<ItemListProps> = ({ items, onEdit, onDelete, onPack, deletingId, getStatusColor }) => {
+  const handleEdit = useLatestCallback(onEdit)
+  const handleDelete = useLatestCallback(onDelete)
+  const handlePack = useLatestCallback(onPack)
+
   const renderEmptyComponent = () => (
     <View style={styles.emptyContainer}>
 <CubeIcon style={styles.emptyIcon} />
@@ -25,20 +33,24 @@ const ItemList: React.FC<ItemListProps> = ({ items, onEdit, onDelete, onPack, de
   )
 
   return (
-    <FlatList
+    <VirtualizedCardList
       key="single-column-list"
       data={items}
-      renderItem={({ item }) => (
+      renderCard={(item) => (
         <ItemCard
           item={item}
-          onEdit={() => onEdit(item)}
-          onDelete={() => onDelete(item.id)}
-          onPack={() => onPack(item)}
+          onEdit={() => handleEdit(item)}
+          onDelete={() => handleDelete(item.id)}
+          onPack={() => handlePack(item)}
           deleting={Boolean(deletingId && deletingId === item.id)}
           getStatusColor={getStatusColor}
         />
       )}
-      keyExtractor={(item) => item.id}
+      keyOf={(item) => item.id}
+      estimateHeight={ITEM_CARD_HEIGHT}
+      // deletingId chỉ đổi vài ô nhưng hiếm, render lại cả cửa sổ là chấp nhận được
+      extraData={deletingId}
+      perfTag="provider-item-list"
       ListEmptyComponent={renderEmptyComponent}
       style={styles.listContainer}
       contentContainerStyle={styles.listContentContainer}
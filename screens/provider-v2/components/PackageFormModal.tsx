@@ -14,6 +14,7 @@ import {
   Switch,
 } from "react-native";
 import * as ImagePicker from "expo-image-picker";
+import { IMAGE_PICKER_QUALITY } from "@/services/imagePipeline";
 import { Ionicons, MaterialCommunityIcons } from "@expo/vector-icons";
 import { Item, ImageStatus } from "../../../models/types";
 
@@ -129,7 +130,7 @@ const PackageFormModal: React.FC<PackageFormModalProps> = ({
       const result = await ImagePicker.launchImageLibraryAsync({
         mediaTypes: ['images'],
         allowsEditing: false,
-        quality: 0.5, // Giữ 0.5 như itemService
+        quality: IMAGE_PICKER_QUALITY,
         base64: false, // Dùng URI như itemService
       });
 
@@ -1,10 +1,14 @@
 
 
 import React from 'react'
-import { View, Text, StyleSheet, FlatList } from 'react-native'
+import { View, Text, StyleSheet } from 'react-native'
 import { MaterialCommunityIcons } from '@expo/vector-icons'
 import { Package } from '../../../models/types'
 import PackageCard from './PackageCard'
+import VirtualizedCardList, { useLatestCallback } from '@/components/shared/VirtualizedCardList'
+
+// Chiều cao ước lượng của PackageCard (gồm margin), ô đã render sẽ dùng số đo thật
+const PACKAGE_CARD_HEIGHT = 264
 
 interface PackageListProps {
   packages: any
@@ -32,6 +36,10 @@ const PackageList: React.FC<PackageListProps> = ({ packages, onEdit, onDelete, o
   
   console.log('📦 [PackageList] Final list:', list);
 
+  const handleEdit = useLatestCallback(onEdit)
+  const handleDelete = useLatestCallback(onDelete)
+  const handlePost = useLatestCallback(onPost)
+
   const renderEmpty = () => (
     <View style={styles.emptyContainer}>
       <View style={styles.emptyIconBg}>
@@ -43,19 +51,21 @@ const PackageList: React.FC<PackageListProps> = ({ packages, onEdit, onDelete, o
   )
 
   return (
-    <FlatList
+    <VirtualizedCardList
       key="single-column-list"
       data={list}
-      renderItem={({ item }) => (
+      renderCard={(item) => (
         <PackageCard 
           pkg={item} 
-          onEdit={() => onEdit(item)} 
-          onDelete={() => onDelete(item.id)} 
-          onPost={() => onPost(item)}
+          onEdit={() => handleEdit(item)} 
+          onDelete={() => handleDelete(item.id)} 
+          onPost={() => handlePost(item)}
           getStatusColor={getStatusColor}
         />
       )}
-      keyExtractor={(item) => item.id}
+      keyOf={(item) => item.id}
+      estimateHeight={PACKAGE_CARD_HEIGHT}
+      perfTag="provider-package-list"
       contentContainerStyle={styles.listContent}
       ListEmptyComponent={renderEmpty}
       showsVerticalScrollIndicator={false}
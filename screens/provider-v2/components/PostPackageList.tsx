@@ -1,10 +1,14 @@
 
 
 import React from 'react'
-import { View, Text, StyleSheet, FlatList } from 'react-native'
+import { View, Text, StyleSheet } from 'react-native'
 import { MaterialCommunityIcons } from '@expo/vector-icons'
 import { FreightPost } from '../../../models/types'
 import PostPackageCard from './PostPackageCard'
+import VirtualizedCardList, { useLatestCallback } from '@/components/shared/VirtualizedCardList'
+
+// Chiều cao ước lượng của PostPackageCard (gồm margin), ô đã render sẽ dùng số đo thật
+const POST_CARD_HEIGHT = 248
 
 interface PostListProps {
   posts: FreightPost[]
@@ -17,6 +21,12 @@ interface PostListProps {
 }
 
 const PostPackageList: React.FC<PostListProps> = ({ posts, onEdit, onDelete, onView, showActions = true, onSign, onPay }) => {
+  const handleEdit = useLatestCallback(onEdit)
+  const handleDelete = useLatestCallback(onDelete)
+  const handleView = useLatestCallback((postId: string) => onView?.(postId))
+  const handleSign = useLatestCallback((postId: string) => onSign?.(postId))
+  const handlePay = useLatestCallback((postId: string) => onPay?.(postId))
+
   const renderEmpty = () => (
     <View style={styles.emptyContainer}>
       <View style={styles.emptyIconBg}>
@@ -28,20 +38,23 @@ const PostPackageList: React.FC<PostListProps> = ({ posts, onEdit, onDelete, onV
   )
 
   return (
-    <FlatList
+    <VirtualizedCardList
       data={posts}
-      renderItem={({ item }) => (
+      renderCard={(item) => (
         <PostPackageCard 
           post={item} 
-          onEdit={() => onEdit(item)} 
-          onDelete={() => onDelete(item.id)} 
-          onView={onView}
-          onSign={() => onSign?.(item.id)}
-          onPay={() => onPay?.(item.id)}
+          onEdit={() => handleEdit(item)} 
+          onDelete={() => handleDelete(item.id)} 
+          onView={onView ? handleView : undefined}
+          onSign={() => handleSign(item.id)}
+          onPay={() => handlePay(item.id)}
           showActions={showActions}
         />
       )}
-      keyExtractor={(item) => item.id}
+      keyOf={(item) => item.id}
+      estimateHeight={POST_CARD_HEIGHT}
+      extraData={showActions}
+      perfTag="provider-post-package-list"
       contentContainerStyle={styles.listContent}
       ListEmptyComponent={renderEmpty}
       showsVerticalScrollIndicator={false}
@@ -1,9 +1,8 @@
-import React, { useState, useEffect, useCallback } from 'react'
+import React, { useCallback } from 'react'
 import {
   View,
   Text,
   StyleSheet,
-  FlatList,
   TouchableOpacity,
   RefreshControl,
   ActivityIndicator,
@@ -15,83 +14,47 @@ import { MaterialCommunityIcons } from '@expo/vector-icons'
 import { useRouter } from 'expo-router'
 import notificationService, { NotificationDTO } from '@/services/notificationService'
 import { useNotification } from '@/hooks/useNotification'
+import { usePaginatedCollection } from '@/hooks/usePaginatedCollection'
+import VirtualizedCardList from '@/components/shared/VirtualizedCardList'
+
+const PAGE_SIZE = 20
+const PAGE_WINDOW = 400
+// Chiều cao ước lượng thẻ thông báo (tiêu đề 2 dòng + nội dung 3 dòng + margin)
+const NOTIFICATION_CARD_HEIGHT = 150
 
 const NotificationListScreen = () => {
   const router = useRouter()
   const { refreshUnreadCount } = useNotification()
   
-  const [notifications, setNotifications] = useState<NotificationDTO[]>([])
-  const [loading, setLoading] = useState(true)
-  const [refreshing, setRefreshing] = useState(false)
-  const [loadingMore, setLoadingMore] = useState(false)
-  const [pageNumber, setPageNumber] = useState(1)
-  const [hasMore, setHasMore] = useState(true)
-  const [totalCount, setTotalCount] = useState(0)
-
-  const pageSize = 20
-
-  const fetchNotifications = async (page: number = 1, isRefresh: boolean = false) => {
-    try {
-      if (page === 1) {
-        setLoading(true)
-      } else {
-        setLoadingMore(true)
-      }
-
-      const response = await notificationService.getMyNotifications(page, pageSize)
-      console.log('📬 Notifications response:', response)
-      
-      // Backend trả về: { message, statusCode, isSuccess, result: { Items, TotalCount, UnreadCount } }
-      if (response?.isSuccess && response?.result) {
-        const items = response.result.Items || response.result.items || []
-        const total = response.result.TotalCount || response.result.totalCount || 0
-        const totalPages = Math.ceil(total / pageSize)
-        
-        if (isRefresh || page === 1) {
-          setNotifications(items)
-        } else {
-          setNotifications(prev => [...prev, ...items])
-        }
-        
-        setTotalCount(total)
-        setHasMore(page < totalPages)
-        setPageNumber(page)
-      }
-    } catch (error: any) {
-      console.error('Error fetching notifications:', error)
-    } finally {
-      setLoading(false)
-      setRefreshing(false)
-      setLoadingMore(false)
-    }
-  }
-
-  useEffect(() => {
-    fetchNotifications(1)
-  }, [])
+  // Cuộn vô hạn: prefetch trang kế, khử trùng lặp, giữ tối đa PAGE_WINDOW dòng trong bộ nhớ
+  const {
+    collection,
+    items: notifications,
+    totalCount,
+    loading,
+    refreshing,
+    loadingMore,
+    loadMore,
+    loadPrevious,
+    refresh,
+  } = usePaginatedCollection<NotificationDTO>({
+    fetchPage: notificationService.fetchMyNotificationsPage,
+    keyOf: (item) => item.notificationId,
+    pageSize: PAGE_SIZE,
+    maxItems: PAGE_WINDOW,
+  })
 
   const onRefresh = useCallback(() => {
-    setRefreshing(true)
-    fetchNotifications(1, true)
+    refresh()
     refreshUnreadCount()
-  }, [refreshUnreadCount])
-
-  const loadMore = () => {
-    if (!loadingMore && hasMore) {
-      fetchNotifications(pageNumber + 1)
-    }
-  }
+  }, [refresh, refreshUnreadCount])
 
   const handleMarkAsRead = async (notificationId: string) => {
     try {
       await notificationService.markAsRead(notificationId)
       
       // Update local state
-      setNotifications(prev =>
-        prev.map(n =>
-          n.notificationId === notificationId ? { ...n, isRead: true } : n
-        )
-      )
+      collection.update(notificationId, n => ({ ...n, isRead: true }))
       
       // Refresh unread count
       refreshUnreadCount()
@@ -105,7 +68,7 @@ const NotificationListScreen = () => {
       await notificationService.markAllAsRead()
       
       // Update local state
-      setNotifications(prev => prev.map(n => ({ ...n, isRead: true })))
+      collection.updateAll(n => (n.isRead ? n : { ...n, isRead: true }))
       
       // Refresh unread count
       refreshUnreadCount()
@@ -126,8 +89,7 @@ const NotificationListScreen = () => {
           onPress: async () => {
             try {
               await notificationService.deleteNotification(notificationId)
-              setNotifications(prev => prev.filter(n => n.notificationId !== notificationId))
-              setTotalCount(prev => prev - 1)
+              collection.remove(notificationId)
               refreshUnreadCount()
             } catch (error) {
               console.error('Error deleting notification:', error)
@@ -190,7 +152,7 @@ const NotificationListScreen = () => {
     })
   }
 
-  const renderNotification = ({ item }: { item: NotificationDTO }) => (
+  const renderNotification = (item: NotificationDTO) => (
     <TouchableOpacity
       style={[styles.notificationCard, !item.isRead && styles.unreadCard]}
       onPress={() => handleNotificationPress(item)}
@@ -297,10 +259,12 @@ const NotificationListScreen = () => {
       )}
 
       {/* Notification List */}
-      <FlatList
+      <VirtualizedCardList
         data={notifications}
-        renderItem={renderNotification}
-        keyExtractor={(item) => item.notificationId}
+        renderCard={renderNotification}
+        keyOf={(item) => item.notificationId}
+        estimateHeight={NOTIFICATION_CARD_HEIGHT}
+        perfTag="notification-list"
         contentContainerStyle={[
           styles.listContent,
           notifications.length === 0 && styles.emptyListContent,
@@ -309,7 +273,10 @@ const NotificationListScreen = () => {
           <RefreshControl refreshing={refreshing} onRefresh={onRefresh} colors={['#3B82F6']} />
         }
         onEndReached={loadMore}
-        onEndReachedThreshold={0.3}
+        onEndReachedThreshold={0.5}
+        onStartReached={loadPrevious}
+        onStartReachedThreshold={0.5}
+        maintainVisibleContentPosition={{ minIndexForVisible: 0 }}
         ListEmptyComponent={renderEmptyState}
         ListFooterComponent={renderFooter}
         showsVerticalScrollIndicator={false}
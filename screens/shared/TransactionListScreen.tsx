@@ -1,9 +1,8 @@
-import React, { useState, useEffect, useCallback } from 'react';
+import React from 'react';
 import {
   View,
   Text,
   StyleSheet,
-  FlatList,
   TouchableOpacity,
   RefreshControl,
   ActivityIndicator,
@@ -13,83 +12,39 @@ import { SafeAreaView } from 'react-native-safe-area-context';
 import { MaterialCommunityIcons } from '@expo/vector-icons';
 import { useRouter, useLocalSearchParams } from 'expo-router';
 import transactionService, { TransactionDTO } from '@/services/transactionService';
+import { usePaginatedCollection } from '@/hooks/usePaginatedCollection';
+import VirtualizedCardList from '@/components/shared/VirtualizedCardList';
+
+const PAGE_SIZE = 20;
+const PAGE_WINDOW = 400;
+
+// Chiều cao ước lượng thẻ giao dịch: phần cố định + mô tả + từng dòng mã tham chiếu
+const estimateTransactionHeight = (item: TransactionDTO) =>
+  92 + (item.description ? 48 : 0) + (item.externalTransactionCode ? 30 : 0) + (item.tripId ? 30 : 0);
 
 const TransactionListScreen = () => {
   const router = useRouter();
   const params = useLocalSearchParams();
   const roleTitle = params.roleTitle as string || 'Giao dịch';
 
-  const [transactions, setTransactions] = useState<TransactionDTO[]>([]);
-  const [loading, setLoading] = useState(true);
-  const [refreshing, setRefreshing] = useState(false);
-  const [loadingMore, setLoadingMore] = useState(false);
-  const [pageNumber, setPageNumber] = useState(1);
-  const [hasMore, setHasMore] = useState(true);
-  const [totalCount, setTotalCount] = useState(0);
-  const [error, setError] = useState<string | null>(null);
-
-  const pageSize = 20;
-
-  const fetchTransactions = async (page: number = 1, isRefresh: boolean = false) => {
-    try {
-      if (page === 1) {
-        setLoading(true);
-      } else {
-        setLoadingMore(true);
-      }
-
-      const response = await transactionService.getAllMyTransactions(page, pageSize);
-      
-      if (response?.isSuccess && response?.result) {
-        // API returns 'data' not 'items', and 'currentPage' not 'pageNumber'
-        const { data = [], totalCount: total = 0, totalPages = 0 } = response.result;
-        
-        if (isRefresh || page === 1) {
-          setTransactions(data || []);
-        } else {
-          setTransactions(prev => [...prev, ...(data || [])]);
-        }
-        
-        setTotalCount(total || 0);
-        setHasMore(page < totalPages);
-        setPageNumber(page);
-      } else {
-        // Handle failed response
-        if (page === 1) {
-          setTransactions([]);
-          setTotalCount(0);
-        }
-        setHasMore(false);
-      }
-    } catch (error: any) {
-      console.error('Error fetching transactions:', error);
-      setError(error?.response?.data?.message || error?.message || 'Không thể tải giao dịch');
-      if (page === 1) {
-        setTransactions([]);
-        setTotalCount(0);
-      }
-    } finally {
-      setLoading(false);
-      setRefreshing(false);
-      setLoadingMore(false);
-    }
-  };
-
-  useEffect(() => {
-    fetchTransactions(1);
-  }, []);
-
-  const onRefresh = useCallback(() => {
-    setRefreshing(true);
-    setError(null);
-    fetchTransactions(1, true);
-  }, []);
-
-  const loadMore = () => {
-    if (!loadingMore && hasMore) {
-      fetchTransactions(pageNumber + 1);
-    }
-  };
+  // Cuộn vô hạn: prefetch trang kế, khử trùng lặp, giữ tối đa PAGE_WINDOW dòng trong bộ nhớ
+  const {
+    items: transactions,
+    totalCount,
+    loading,
+    refreshing,
+    loadingMore,
+    error,
+    loadMore,
+    loadPrevious,
+    refresh: onRefresh,
+    reload,
+  } = usePaginatedCollection<TransactionDTO>({
+    fetchPage: transactionService.fetchMyTransactionsPage,
+    keyOf: (item) => item.transactionId,
+    pageSize: PAGE_SIZE,
+    maxItems: PAGE_WINDOW,
+  });
 
   const getTransactionTypeConfig = (type: string) => {
     const configs: any = {
@@ -150,7 +105,7 @@ const TransactionListScreen = () => {
     });
   };
 
-  const renderTransaction = ({ item }: { item: TransactionDTO }) => {
+  const renderTransaction = (item: TransactionDTO) => {
     const typeConfig = getTransactionTypeConfig(item.type);
     const statusConfig = getStatusConfig(item.status);
     const isIncome = item.amount > 0; // Positive amount = income, negative = expense
@@ -263,26 +218,31 @@ const TransactionListScreen = () => {
         <View style={styles.errorContainer}>
           <MaterialCommunityIcons name="alert-circle" size={24} color="#DC2626" />
           <Text style={styles.errorText}>{error}</Text>
-          <TouchableOpacity style={styles.retryButton} onPress={() => { setError(null); fetchTransactions(1); }}>
+          <TouchableOpacity style={styles.retryButton} onPress={reload}>
             <Text style={styles.retryButtonText}>Thử lại</Text>
           </TouchableOpacity>
         </View>
       )}
 
       {/* Transaction List */}
-      <FlatList
-        data={transactions || []}
-        renderItem={renderTransaction}
-        keyExtractor={(item) => item?.transactionId || Math.random().toString()}
+      <VirtualizedCardList
+        data={transactions}
+        renderCard={renderTransaction}
+        keyOf={(item) => item.transactionId}
+        estimateHeight={estimateTransactionHeight}
+        perfTag="transaction-list"
         contentContainerStyle={[
           styles.listContent,
-          (transactions?.length === 0 || !transactions) && styles.emptyListContent,
+          transactions.length === 0 && styles.emptyListContent,
         ]}
         refreshControl={
           <RefreshControl refreshing={refreshing} onRefresh={onRefresh} colors={['#3B82F6']} />
         }
         onEndReached={loadMore}
-        onEndReachedThreshold={0.3}
+        onEndReachedThreshold={0.5}
+        onStartReached={loadPrevious}
+        onStartReachedThreshold={0.5}
+        maintainVisibleContentPosition={{ minIndexForVisible: 0 }}
         ListEmptyComponent={!error ? renderEmptyState : null}
         ListFooterComponent={renderFooter}
         showsVerticalScrollIndicator={false}
@@ -0,0 +1,70 @@
+/**
+ * Babel plugin - xoá lời gọi log.trace / log.debug của utils/logger khỏi bản production
+ *
+ * Chỉ đụng tới biến được gán từ createLogger(...) import từ utils/logger, nên
+ * console.debug hay object khác có hàm debug không bị ảnh hưởng. Lời gọi đứng riêng
+ * thành câu lệnh bị xoá; nằm trong biểu thức thì thay bằng `void 0`. Vì vậy đối số của
+ * log.trace/log.debug không được có side effect (logger đã khuyến khích truyền hàm lười).
+ *
+ * Dùng trong babel.config.js (env.production):
+ *   ['./scripts/babel/stripLogCalls', { levels: ['trace', 'debug'] }]
+ * Build với EXPO_PUBLIC_LOG_LEVEL=debug|trace thì giữ lại cấp tương ứng.
+ */
+const LOGGER_SOURCE = /(^|\/)utils\/logger$/
+
+const LEVEL_ORDER = ['trace', 'debug', 'info', 'warn', 'error']
+
+module.exports = function stripLogCalls({ types: t }) {
+  return {
+    name: 'strip-log-calls',
+    visitor: {
+      Program(program, state) {
+        const keepFrom = LEVEL_ORDER.indexOf(process.env.EXPO_PUBLIC_LOG_LEVEL)
+        const levels = new Set(
+          (state.opts.levels || ['trace', 'debug']).filter((level) => keepFrom < 0 || LEVEL_ORDER.indexOf(level) < keepFrom)
+        )
+        if (levels.size === 0) return
+
+        // Tên local của createLogger (import default hoặc named)
+        const factories = new Set()
+        program.get('body').forEach((node) => {
+          if (!node.isImportDeclaration() || !LOGGER_SOURCE.test(node.node.source.value)) return
+          node.get('specifiers').forEach((spec) => {
+            const imported = spec.isImportDefaultSpecifier() ? 'default' : spec.node.imported && spec.node.imported.name
+            if (imported === 'default' || imported === 'createLogger') factories.add(spec.node.local.name)
+          })
+        })
+        if (factories.size === 0) return
+
+        // Binding của các logger: const log = createLogger('Module')
+        const loggers = new Set()
+        program.traverse({
+          VariableDeclarator(path) {
+            const init = path.node.init
+            if (
+              t.isIdentifier(path.node.id) &&
+              t.isCallExpression(init) &&
+              t.isIdentifier(init.callee) &&
+              factories.has(init.callee.name)
+            ) {
+              const binding = path.scope.getBinding(path.node.id.name)
+              if (binding) loggers.add(binding)
+            }
+          },
+        })
+        if (loggers.size === 0) return
+
+        program.traverse({
+          CallExpression(path) {
+            const callee = path.node.callee
+            if (!t.isMemberExpression(callee) || callee.computed || !t.isIdentifier(callee.object)) return
+            if (!levels.has(callee.property.name)) return
+            if (!loggers.has(path.scope.getBinding(callee.object.name))) return
+            if (path.parentPath.isExpressionStatement()) path.parentPath.remove()
+            else path.replaceWith(t.unaryExpression('void', t.numericLiteral(0)))
+          },
+        })
+      },
+    },
+  }
+}
@@ -0,0 +1,87 @@
+/**
+ * Gazetteer Bench - đo thời gian parse và độ trễ tra cứu của utils/gazetteer
+ *
+ * Chạy:
+ *   npx tsx scripts/bench/gazetteerBench.ts [--iterations 2000]
+ */
+
+import { performance } from 'perf_hooks';
+import { Gazetteer } from '@/utils/gazetteer';
+
+const SAMPLE_ADDRESSES = [
+  '12 Nguyễn Huệ, Quận 1, TP.HCM',
+  '45 Bạch Đằng, Hải Châu, Đà Nẵng',
+  '1 Tràng Tiền, Hoàn Kiếm, Hà Nội',
+  'Khu công nghiệp VSIP, Thuận An, Bình Dương',
+  '88 Dien Bien Phu, Binh Thanh, Ho Chi Minh',
+  'Ninh Kiều, Cần Thơ',
+  'Tp Vung Tau, BRVT',
+  'Quan 7 tphcm',
+  'Ha Noi',
+  'Thu Duc, Sai Gon',
+];
+
+const SAMPLE_PREFIXES = ['ha', 'binh', 'quan 1', 'thanh', 'da n', 'hcm', 'lam d', 'kien gian'];
+
+const SAMPLE_POINTS: [number, number][] = [
+  [10.776, 106.7],
+  [21.028, 105.854],
+  [16.068, 108.221],
+  [10.034, 105.788],
+  [12.238, 109.196],
+  [22.336, 103.844],
+];
+
+const args = process.argv.slice(2);
+const iterIdx = args.indexOf('--iterations');
+const ITERATIONS = iterIdx >= 0 ? Math.max(1, Number(args[iterIdx + 1]) || 2000) : 2000;
+
+const percentile = (sorted: number[], p: number): number =>
+  sorted.length === 0 ? 0 : sorted[Math.min(sorted.length - 1, Math.floor((sorted.length * p) / 100))];
+
+function measure(label: string, inputs: readonly unknown[], fn: (input: any) => unknown) {
+  const samples: number[] = [];
+  // Warm-up để JIT ổn định trước khi lấy số liệu
+  for (let i = 0; i < Math.min(200, ITERATIONS); i++) fn(inputs[i % inputs.length]);
+  for (let i = 0; i < ITERATIONS; i++) {
+    const input = inputs[i % inputs.length];
+    const t0 = performance.now();
+    fn(input);
+    samples.push((performance.now() - t0) * 1000);
+  }
+  samples.sort((a, b) => a - b);
+  console.log(
+    `${label.padEnd(22)} p50 ${percentile(samples, 50).toFixed(1).padStart(7)}µs` +
+      `  p95 ${percentile(samples, 95).toFixed(1).padStart(7)}µs` +
+      `  max ${samples[samples.length - 1].toFixed(1).padStart(7)}µs`
+  );
+}
+
+function main() {
+  // Parse nguội: mỗi lần 1 instance mới
+  const loadSamples: number[] = [];
+  for (let i = 0; i < 20; i++) {
+    const g = new Gazetteer();
+    const t0 = performance.now();
+    g.ensureLoaded();
+    loadSamples.push(performance.now() - t0);
+  }
+  loadSamples.sort((a, b) => a - b);
+
+  const gazetteer = new Gazetteer();
+  gazetteer.ensureLoaded();
+  console.log(`[GazetteerBench] ${gazetteer.size} units, ${ITERATIONS} iterations/case`);
+  console.log(
+    `${'load (cold parse)'.padEnd(22)} max ${loadSamples[loadSamples.length - 1].toFixed(2)}ms` +
+      `  p50 ${percentile(loadSamples, 50).toFixed(2)}ms`
+  );
+
+  measure('normalizeAddress', SAMPLE_ADDRESSES, (text: string) => gazetteer.normalizeAddress(text));
+  measure('lookup (prefix/fuzzy)', SAMPLE_PREFIXES, (text: string) => gazetteer.lookup(text, { limit: 5 }));
+  measure('reverseGeocodeCoarse', SAMPLE_POINTS, ([lat, lng]: [number, number]) =>
+    gazetteer.reverseGeocodeCoarse(lat, lng)
+  );
+  measure('describeCoarse', SAMPLE_POINTS, ([lat, lng]: [number, number]) => gazetteer.describeCoarse(lat, lng));
+}
+
+main();
@@ -0,0 +1,86 @@
+/**
+ * Build Gazetteer - đóng gói danh mục đơn vị hành chính thành constants/vnGazetteerData.ts
+ *
+ * Input: JSON array, mỗi phần tử:
+ *   { code, parentCode, type, name, lat, lng, bbox?: [w, s, e, n], radius?: number }
+ *   type: C (TP trực thuộc TW) | P (Tỉnh) | Q (Quận) | H (Huyện) | TP (TP thuộc tỉnh)
+ *         | TX (Thị xã) | PH (Phường) | X (Xã) | TT (Thị trấn)
+ *   Thiếu bbox thì dựng từ tâm ± radius (độ) - chỉ là extent cho geocode thô theo tên;
+ *   reverseGeocodeCoarse chỉ dùng bbox cấp tỉnh (lấy từ ranh giới thật).
+ *
+ * Output: 1 chuỗi, mỗi dòng "code|parentCode|type|name|lat|lng|w|s|e|n", sắp theo code,
+ * toạ độ làm tròn 4 chữ số (~10m) - đủ cho geocode thô, giữ bundle nhỏ.
+ *
+ * Nguồn: scripts/gazetteer/units.json (commit cùng repo). Bản hiện tại chỉ có 63 tỉnh/TP
+ * (bbox theo ranh giới) và quận/huyện của vài TP lớn (extent tâm ± radius), chưa có
+ * phường/xã - bổ sung vào units.json rồi chạy lại, không sửa file output.
+ *
+ * Chạy:
+ *   node scripts/gazetteer/buildGazetteer.js [scripts/gazetteer/units.json] [constants/vnGazetteerData.ts]
+ */
+const fs = require('fs')
+const path = require('path')
+
+const TYPES = new Set(['C', 'P', 'Q', 'H', 'TP', 'TX', 'PH', 'X', 'TT'])
+
+const round = (n) => Number(Number(n).toFixed(4))
+
+function build(units) {
+  const byCode = new Map()
+  for (const u of units) {
+    if (!u.code || !u.name || !TYPES.has(u.type)) {
+      throw new Error(`Invalid unit: ${JSON.stringify(u)}`)
+    }
+    if (byCode.has(String(u.code))) throw new Error(`Duplicate code ${u.code}`)
+    byCode.set(String(u.code), u)
+  }
+  for (const u of units) {
+    if (u.parentCode && !byCode.has(String(u.parentCode))) {
+      throw new Error(`Unknown parent ${u.parentCode} for ${u.code}`)
+    }
+  }
+
+  const rows = units
+    .slice()
+    .sort((a, b) => String(a.code).localeCompare(String(b.code)))
+    .map((u) => {
+      const r = u.radius ?? 0.02
+      const bbox = u.bbox || [u.lng - r, u.lat - r, u.lng + r, u.lat + r]
+      return [
+        u.code,
+        u.parentCode || '',
+        u.type,
+        String(u.name).replace(/[|\n]/g, ' '),
+        round(u.lat),
+        round(u.lng),
+        ...bbox.map(round),
+      ].join('|')
+    })
+  return rows.join('\n')
+}
+
+const LEVELS = { C: 1, P: 1, Q: 2, H: 2, TP: 2, TX: 2, PH: 3, X: 3, TT: 3 }
+
+function emit(packed, units) {
+  const count = [0, 0, 0]
+  units.forEach((u) => count[LEVELS[u.type] - 1]++)
+  return `// Sinh từ scripts/gazetteer/units.json bằng scripts/gazetteer/buildGazetteer.js.
+// Danh mục đơn vị hành chính VN, xem utils/gazetteer.ts để biết định dạng.
+// Phủ: ${count[0]} tỉnh/TP, ${count[1]} quận/huyện, ${count[2]} phường/xã${count[2] === 0 ? ' (chưa có dữ liệu cấp xã)' : ''}.
+
+export const VN_GAZETTEER_VERSION = 1
+
+export const VN_GAZETTEER_PACKED = ${JSON.stringify(packed)}
+`
+}
+
+module.exports = { build, emit }
+
+if (require.main === module) {
+  const input = process.argv[2] || path.join(__dirname, 'units.json')
+  const output = process.argv[3] || path.join(__dirname, '../../constants/vnGazetteerData.ts')
+  const units = JSON.parse(fs.readFileSync(input, 'utf8'))
+  const packed = build(units)
+  fs.writeFileSync(output, emit(packed, units))
+  console.log(`[Gazetteer] Wrote ${units.length} units (${Buffer.byteLength(packed)} bytes) to ${output}`)
+}
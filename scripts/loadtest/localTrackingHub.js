@@ -0,0 +1,343 @@
+/**
+ * Local Tracking Hub - stand-in cho /hubs/tracking của backend
+ *
+ * Cài đặt tối thiểu giao thức SignalR (negotiate v1 + LongPolling + JSON hub protocol)
+ * bằng module http có sẵn của Node, đủ để @microsoft/signalr client kết nối mà
+ * không cần backend thật hay thư viện WebSocket.
+ *
+ * Hub methods: JoinTripGroup, LeaveTripGroup, SendLocationUpdate
+ * Client methods: ReceiveLocation, ReceiveChange (đẩy qua publishChange)
+ *
+ * Chạy độc lập:
+ *   node scripts/loadtest/localTrackingHub.js --port 5299
+ */
+const http = require('http')
+const crypto = require('crypto')
+
+const RS = '\x1e' // record separator của JSON hub protocol
+const HUB_PATH = '/hubs/tracking'
+
+const MessageType = {
+  Invocation: 1,
+  Completion: 3,
+  Ping: 6,
+  Close: 7,
+}
+
+function createLocalTrackingHub(options = {}) {
+  const pollTimeoutMs = options.pollTimeoutMs || 10000
+  const keepAliveMs = options.keepAliveMs || 15000
+  const staleAfterMs = options.staleAfterMs || pollTimeoutMs * 3
+
+  /** connectionToken -> connection */
+  const connections = new Map()
+  /** tripId -> Set<connectionToken> */
+  const groups = new Map()
+
+  const stats = {
+    negotiations: 0,
+    connectionsOpened: 0,
+    connectionsClosed: 0,
+    connectionsDropped: 0,
+    invocations: 0,
+    locationUpdates: 0,
+    changesPublished: 0,
+    messagesDelivered: 0,
+    bytesIn: 0,
+    bytesOut: 0,
+  }
+
+  const send = (conn, message) => {
+    conn.queue.push(JSON.stringify(message) + RS)
+    flush(conn)
+  }
+
+  const flush = (conn) => {
+    if (!conn.pendingPoll || conn.queue.length === 0) return
+    const body = conn.queue.join('')
+    conn.queue = []
+    respondPoll(conn, 200, body)
+  }
+
+  const respondPoll = (conn, status, body = '') => {
+    const res = conn.pendingPoll
+    if (!res) return
+    conn.pendingPoll = null
+    if (conn.pollTimer) {
+      clearTimeout(conn.pollTimer)
+      conn.pollTimer = null
+    }
+    stats.bytesOut += Buffer.byteLength(body)
+    res.writeHead(status, { 'Content-Type': 'text/plain' })
+    res.end(body)
+  }
+
+  const leaveAllGroups = (conn) => {
+    for (const tripId of conn.groups) {
+      const members = groups.get(tripId)
+      if (!members) continue
+      members.delete(conn.token)
+      if (members.size === 0) groups.delete(tripId)
+    }
+    conn.groups.clear()
+  }
+
+  const closeConnection = (conn, pollStatus) => {
+    if (!connections.has(conn.token)) return
+    leaveAllGroups(conn)
+    connections.delete(conn.token)
+    respondPoll(conn, pollStatus)
+    stats.connectionsClosed++
+  }
+
+  const invoke = (conn, message) => {
+    stats.invocations++
+    const args = message.arguments || []
+    let result = null
+    let error
+
+    switch (message.target) {
+      case 'JoinTripGroup': {
+        const tripId = String(args[0])
+        if (!groups.has(tripId)) groups.set(tripId, new Set())
+        groups.get(tripId).add(conn.token)
+        conn.groups.add(tripId)
+        result = { tripId, joined: true }
+        break
+      }
+      case 'LeaveTripGroup': {
+        const tripId = String(args[0])
+        groups.get(tripId)?.delete(conn.token)
+        conn.groups.delete(tripId)
+        break
+      }
+      case 'SendLocationUpdate': {
+        const [tripId, lat, lng, bearing, speed] = args
+        stats.locationUpdates++
+        const payload = {
+          lat,
+          lng,
+          bearing,
+          speed,
+          driverName: conn.id,
+          updatedAt: new Date().toISOString(),
+        }
+        const members = groups.get(String(tripId))
+        if (members) {
+          for (const token of members) {
+            if (token === conn.token) continue
+            const target = connections.get(token)
+            if (!target) continue
+            send(target, { type: MessageType.Invocation, target: 'ReceiveLocation', arguments: [payload] })
+            stats.messagesDelivered++
+          }
+        }
+        break
+      }
+      default:
+        error = `Unknown hub method '${message.target}'`
+    }
+
+    if (message.invocationId) {
+      send(conn, error
+        ? { type: MessageType.Completion, invocationId: message.invocationId, error }
+        : { type: MessageType.Completion, invocationId: message.invocationId, result })
+    }
+  }
+
+  const handleMessages = (conn, text) => {
+    const frames = text.split(RS).filter(Boolean)
+    for (const frame of frames) {
+      let message
+      try {
+        message = JSON.parse(frame)
+      } catch {
+        continue
+      }
+      if (!conn.handshaken) {
+        // Frame đầu tiên là handshake {"protocol":"json","version":1}
+        conn.handshaken = true
+        send(conn, message.protocol === 'json' ? {} : { error: `Unsupported protocol '${message.protocol}'` })
+        continue
+      }
+      if (message.type === MessageType.Invocation) invoke(conn, message)
+      else if (message.type === MessageType.Close) closeConnection(conn, 204)
+    }
+  }
+
+  const readBody = (req) =>
+    new Promise((resolve) => {
+      const chunks = []
+      req.on('data', (chunk) => chunks.push(chunk))
+      req.on('end', () => {
+        const buf = Buffer.concat(chunks)
+        stats.bytesIn += buf.length
+        resolve(buf.toString('utf8'))
+      })
+    })
+
+  const server = http.createServer(async (req, res) => {
+    res.setHeader('Access-Control-Allow-Origin', req.headers.origin || '*')
+    res.setHeader('Access-Control-Allow-Credentials', 'true')
+    res.setHeader('Access-Control-Allow-Headers', 'authorization, content-type, x-requested-with, x-signalr-user-agent')
+    if (req.method === 'OPTIONS') {
+      res.writeHead(204)
+      res.end()
+      return
+    }
+
+    const url = new URL(req.url, 'http://localhost')
+    if (url.pathname === `${HUB_PATH}/negotiate` && req.method === 'POST') {
+      stats.negotiations++
+      const conn = {
+        id: crypto.randomUUID(),
+        token: crypto.randomUUID(),
+        queue: [],
+        groups: new Set(),
+        handshaken: false,
+        pendingPoll: null,
+        pollTimer: null,
+        firstPoll: true,
+        lastSeen: Date.now(),
+      }
+      connections.set(conn.token, conn)
+      stats.connectionsOpened++
+      res.writeHead(200, { 'Content-Type': 'application/json' })
+      res.end(JSON.stringify({
+        negotiateVersion: 1,
+        connectionId: conn.id,
+        connectionToken: conn.token,
+        availableTransports: [{ transport: 'LongPolling', transferFormats: ['Text', 'Binary'] }],
+      }))
+      return
+    }
+
+    if (url.pathname !== HUB_PATH) {
+      res.writeHead(404)
+      res.end()
+      return
+    }
+
+    const conn = connections.get(url.searchParams.get('id') || '')
+    if (!conn) {
+      res.writeHead(404)
+      res.end()
+      return
+    }
+    conn.lastSeen = Date.now()
+
+    if (req.method === 'GET') {
+      if (conn.firstPoll) {
+        // Poll đầu tiên trả về ngay để client chuyển sang trạng thái connected
+        conn.firstPoll = false
+        res.writeHead(200)
+        res.end()
+        return
+      }
+      respondPoll(conn, 200)
+      conn.pendingPoll = res
+      conn.pollTimer = setTimeout(() => respondPoll(conn, 200), pollTimeoutMs)
+      res.on('close', () => {
+        if (conn.pendingPoll !== res) return
+        conn.pendingPoll = null
+        clearTimeout(conn.pollTimer)
+        conn.pollTimer = null
+      })
+      flush(conn)
+      return
+    }
+
+    if (req.method === 'POST') {
+      handleMessages(conn, await readBody(req))
+      res.writeHead(200)
+      res.end()
+      return
+    }
+
+    if (req.method === 'DELETE') {
+      closeConnection(conn, 204)
+      res.writeHead(202)
+      res.end()
+      return
+    }
+
+    res.writeHead(405)
+    res.end()
+  })
+
+  const keepAliveTimer = setInterval(() => {
+    const now = Date.now()
+    for (const conn of connections.values()) {
+      if (!conn.pendingPoll && now - conn.lastSeen > staleAfterMs) {
+        closeConnection(conn, 204)
+        continue
+      }
+      if (conn.handshaken) send(conn, { type: MessageType.Ping })
+    }
+  }, keepAliveMs)
+
+  return {
+    stats,
+    /** Số kết nối đang mở */
+    connectionCount: () => connections.size,
+    groupCount: () => groups.size,
+    /**
+     * Giả lập sự cố mạng: cắt ngẫu nhiên một phần kết nối (poll trả 404),
+     * client sẽ đi qua luồng withAutomaticReconnect.
+     */
+    dropConnections(fraction = 0.1) {
+      let dropped = 0
+      for (const conn of Array.from(connections.values())) {
+        if (Math.random() >= fraction) continue
+        closeConnection(conn, 404)
+        dropped++
+      }
+      stats.connectionsDropped += dropped
+      return dropped
+    },
+    /**
+     * Giả lập backend phát sự kiện thay đổi (changeFeedService): gửi ReceiveChange
+     * tới mọi kết nối, hoặc chỉ nhóm chuyến nếu có tripId.
+     */
+    publishChange(event, tripId) {
+      const tokens = tripId !== undefined ? groups.get(String(tripId)) || new Set() : connections.keys()
+      let delivered = 0
+      for (const token of tokens) {
+        const target = connections.get(token)
+        if (!target) continue
+        send(target, { type: MessageType.Invocation, target: 'ReceiveChange', arguments: [event] })
+        delivered++
+      }
+      stats.changesPublished++
+      stats.messagesDelivered += delivered
+      return delivered
+    },
+    listen(port = 0, host = '127.0.0.1') {
+      return new Promise((resolve) => {
+        server.listen(port, host, () => {
+          const address = server.address()
+          resolve(`http://${host}:${address.port}`)
+        })
+      })
+    },
+    close() {
+      clearInterval(keepAliveTimer)
+      for (const conn of Array.from(connections.values())) closeConnection(conn, 204)
+      return new Promise((resolve) => server.close(() => resolve()))
+    },
+  }
+}
+
+module.exports = { createLocalTrackingHub }
+
+if (require.main === module) {
+  const portArg = process.argv.indexOf('--port')
+  const port = portArg !== -1 ? Number(process.argv[portArg + 1]) : 5299
+  const hub = createLocalTrackingHub()
+  hub.listen(port).then((url) => {
+    console.log(`[LocalTrackingHub] Listening on ${url}${HUB_PATH}`)
+    setInterval(() => {
+      console.log('[LocalTrackingHub]', { connections: hub.connectionCount(), groups: hub.groupCount(), ...hub.stats })
+    }, 10000)
+  })
+}
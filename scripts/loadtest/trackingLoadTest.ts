@@ -0,0 +1,405 @@
+/**
+ * Tracking Load Test - headless load generator cho luồng live tracking
+ *
+ * N tài xế giả lập (SimpleRouteSimulator trên SimulationClock dùng chung) gửi
+ * SendLocationUpdate qua SignalRTrackingService; M viewer JoinTripGroup và nhận
+ * ReceiveLocation. Mặc định chạy kèm localTrackingHub (stand-in của /hubs/tracking).
+ *
+ * Chạy:
+ *   npx tsx scripts/loadtest/trackingLoadTest.ts --drivers 200 --viewers 400 --duration 60
+ *
+ * Tham số:
+ *   --drivers N          Số tài xế (default 50)
+ *   --viewers M          Số viewer, chia đều theo trip (default 100)
+ *   --duration S         Thời gian chạy (giây, default 60)
+ *   --interval MS        Chu kỳ gửi vị trí mỗi tài xế (default 1000)
+ *   --speed KMH          Tốc độ giả lập (default 50)
+ *   --seed N             Seed cho route tổng hợp và dao động tốc độ (default 42)
+ *   --route FILE         Route ghi sẵn: JSON [[lng,lat],...], GeoJSON, route API hoặc polyline
+ *   --hub-url URL        Dùng hub ngoài (backend thật) thay vì hub stand-in
+ *   --drop-every S       Cắt ngẫu nhiên kết nối mỗi S giây để đo reconnect (chỉ với hub stand-in)
+ *   --drop-fraction F    Tỷ lệ kết nối bị cắt mỗi lần (default 0.1)
+ *   --json FILE          Ghi báo cáo cuối dạng JSON
+ *   --verbose            Không tắt log của service
+ */
+
+import * as fs from 'fs';
+import { monitorEventLoopDelay } from 'perf_hooks';
+import * as SignalR from '@microsoft/signalr';
+import {
+  LocationUpdate,
+  SignalRTrackingService,
+} from '@/services/signalRTrackingService';
+import { extractRouteWithSteps } from '@/utils/navigation';
+import { createSeededRandom, simulationClock } from '@/utils/SimulationClock';
+import { SimpleRouteSimulator } from '@/utils/SimpleRouteSimulator';
+
+// eslint-disable-next-line @typescript-eslint/no-var-requires
+const { createLocalTrackingHub } = require('./localTrackingHub');
+
+type Position = [number, number];
+
+interface LoadTestOptions {
+  drivers: number;
+  viewers: number;
+  durationSec: number;
+  intervalMs: number;
+  speedKmH: number;
+  seed: number;
+  routeFile?: string;
+  hubUrl?: string;
+  dropEverySec: number;
+  dropFraction: number;
+  jsonFile?: string;
+  verbose: boolean;
+}
+
+interface ClientStats {
+  disconnects: number;
+  reconnects: number;
+  reconnectMs: number[];
+  disconnectedAt?: number;
+}
+
+const REPORT_EVERY_MS = 5000;
+const CONNECT_BATCH = 50;
+
+const parseArgs = (argv: string[]): LoadTestOptions => {
+  const get = (name: string) => {
+    const idx = argv.indexOf(`--${name}`);
+    return idx !== -1 ? argv[idx + 1] : undefined;
+  };
+  const num = (name: string, fallback: number) => {
+    const raw = get(name);
+    const value = raw !== undefined ? Number(raw) : NaN;
+    return Number.isFinite(value) ? value : fallback;
+  };
+  return {
+    drivers: num('drivers', 50),
+    viewers: num('viewers', 100),
+    durationSec: num('duration', 60),
+    intervalMs: num('interval', 1000),
+    speedKmH: num('speed', 50),
+    seed: num('seed', 42),
+    routeFile: get('route'),
+    hubUrl: get('hub-url'),
+    dropEverySec: num('drop-every', 0),
+    dropFraction: num('drop-fraction', 0.1),
+    jsonFile: get('json'),
+    verbose: argv.includes('--verbose'),
+  };
+};
+
+const percentile = (sorted: number[], p: number): number => {
+  if (sorted.length === 0) return 0;
+  const idx = Math.min(sorted.length - 1, Math.ceil((p / 100) * sorted.length) - 1);
+  return sorted[Math.max(0, idx)];
+};
+
+const summarize = (samples: number[]) => {
+  const sorted = samples.slice().sort((a, b) => a - b);
+  return {
+    count: sorted.length,
+    p50: percentile(sorted, 50),
+    p90: percentile(sorted, 90),
+    p95: percentile(sorted, 95),
+    p99: percentile(sorted, 99),
+    max: sorted.length ? sorted[sorted.length - 1] : 0,
+  };
+};
+
+/**
+ * Route tổng hợp: random walk ~50m/bước quanh TP.HCM, tất định theo seed
+ */
+const buildSyntheticRoute = (random: () => number, points = 400): Position[] => {
+  const route: Position[] = [];
+  let lng = 106.62 + random() * 0.16;
+  let lat = 10.72 + random() * 0.14;
+  let heading = random() * Math.PI * 2;
+  const stepDeg = 50 / 111320;
+  for (let i = 0; i < points; i++) {
+    route.push([lng, lat]);
+    heading += (random() - 0.5) * 0.6;
+    lng += (Math.sin(heading) * stepDeg) / Math.cos((lat * Math.PI) / 180);
+    lat += Math.cos(heading) * stepDeg;
+  }
+  return route;
+};
+
+const loadRecordedRoute = (file: string): Position[] => {
+  const raw = fs.readFileSync(file, 'utf8').trim();
+  let data: any = raw;
+  try {
+    data = JSON.parse(raw);
+  } catch {
+    // encoded polyline
+  }
+  if (Array.isArray(data)) return data as Position[];
+  const { coords } = extractRouteWithSteps(data);
+  return coords as Position[];
+};
+
+const silenceConsole = () => {
+  const original = {
+    log: console.log,
+    info: console.info,
+    warn: console.warn,
+    error: console.error,
+    debug: console.debug,
+  };
+  let errors = 0;
+  console.log = () => {};
+  console.info = () => {};
+  console.warn = () => {};
+  console.debug = () => {};
+  console.error = () => {
+    errors++;
+  };
+  return {
+    out: original.log,
+    errorCount: () => errors,
+    restore: () => Object.assign(console, original),
+  };
+};
+
+const sleep = (ms: number) => new Promise((resolve) => setTimeout(resolve, ms));
+
+async function runLoadTest(options: LoadTestOptions) {
+  const consoleCtl = options.verbose ? null : silenceConsole();
+  const out = consoleCtl ? consoleCtl.out : console.log;
+  const random = createSeededRandom(options.seed);
+
+  // ===== Hub =====
+  const hub = options.hubUrl ? null : createLocalTrackingHub();
+  const baseURL: string = options.hubUrl || (await hub.listen(0));
+  out(`[LoadTest] Hub: ${baseURL}/hubs/tracking ${hub ? '(local stand-in, in-process)' : '(external)'}`);
+
+  // ===== Routes =====
+  const recorded = options.routeFile ? loadRecordedRoute(options.routeFile) : null;
+  if (recorded && recorded.length < 2) {
+    throw new Error(`Route file ${options.routeFile} has fewer than 2 points`);
+  }
+
+  // ===== Metrics =====
+  const sentAt = new Map<string, number>(); // `${tripId}|${lat}|${lng}` -> performance.now()
+  const latencies: number[] = [];
+  let windowLatencies: number[] = [];
+  let sent = 0;
+  let skipped = 0;
+  let received = 0;
+  let unmatched = 0;
+  const clientStats: ClientStats[] = [];
+
+  const tripIdOf = (driverIdx: number) => `loadtest-trip-${driverIdx}`;
+
+  const createClient = async (
+    tripId: string,
+    onReceiveLocation?: (location: LocationUpdate) => void
+  ) => {
+    const service = new SignalRTrackingService();
+    const stats: ClientStats = { disconnects: 0, reconnects: 0, reconnectMs: [] };
+    clientStats.push(stats);
+    await service.init({
+      baseURL,
+      accessTokenFactory: () => 'loadtest',
+      logLevel: options.verbose ? SignalR.LogLevel.Information : SignalR.LogLevel.None,
+      onReceiveLocation,
+      onConnectionChange: (connected) => {
+        if (!connected) {
+          stats.disconnects++;
+          stats.disconnectedAt = performance.now();
+        } else if (stats.disconnectedAt !== undefined) {
+          stats.reconnects++;
+          stats.reconnectMs.push(performance.now() - stats.disconnectedAt);
+          stats.disconnectedAt = undefined;
+        }
+      },
+    });
+    await service.joinTripGroup(tripId);
+    return service;
+  };
+
+  const connectInBatches = async <T>(count: number, factory: (i: number) => Promise<T>) => {
+    const results: T[] = [];
+    for (let start = 0; start < count; start += CONNECT_BATCH) {
+      const batch: Promise<T>[] = [];
+      for (let i = start; i < Math.min(count, start + CONNECT_BATCH); i++) {
+        batch.push(factory(i));
+      }
+      results.push(...(await Promise.all(batch)));
+    }
+    return results;
+  };
+
+  // ===== Viewers =====
+  const connectStartedAt = performance.now();
+  const viewers = await connectInBatches(options.viewers, (i) => {
+    const tripId = tripIdOf(i % Math.max(1, options.drivers));
+    return createClient(tripId, (location) => {
+      received++;
+      const key = `${tripId}|${location.lat}|${location.lng}`;
+      const startedAt = sentAt.get(key);
+      if (startedAt === undefined) {
+        unmatched++;
+        return;
+      }
+      const latency = performance.now() - startedAt;
+      latencies.push(latency);
+      windowLatencies.push(latency);
+    });
+  });
+
+  // ===== Drivers =====
+  const drivers = await connectInBatches(options.drivers, (i) => createClient(tripIdOf(i)));
+  out(
+    `[LoadTest] Connected ${viewers.length} viewers + ${drivers.length} drivers in ${(
+      performance.now() - connectStartedAt
+    ).toFixed(0)} ms`
+  );
+
+  const simulators = drivers.map((service, i) => {
+    const tripId = tripIdOf(i);
+    const simulator: SimpleRouteSimulator = new SimpleRouteSimulator({
+      route: recorded || buildSyntheticRoute(random),
+      speedKmH: options.speedKmH,
+      updateIntervalMs: options.intervalMs,
+      seed: options.seed + i,
+      speedJitter: 0.2,
+      onUpdate: (location) => {
+        if (!service.isConnected()) {
+          skipped++;
+          return;
+        }
+        sent++;
+        sentAt.set(`${tripId}|${location.latitude}|${location.longitude}`, performance.now());
+        service.sendLocationUpdate(
+          tripId,
+          location.latitude,
+          location.longitude,
+          location.heading,
+          location.speed
+        );
+      },
+      // Hết route thì chạy lại từ đầu
+      onComplete: () => simulator.start(0),
+    });
+    return simulator;
+  });
+
+  // Lệch pha để các tài xế không gửi cùng một lúc
+  simulators.forEach((simulator, i) => {
+    setTimeout(() => simulator.start(0), (i * options.intervalMs) / simulators.length);
+  });
+
+  // ===== Run =====
+  const loopDelay = monitorEventLoopDelay({ resolution: 10 });
+  loopDelay.enable();
+  const runStartedAt = performance.now();
+  const cpuStart = process.cpuUsage();
+  let cpuWindow = process.cpuUsage();
+  let windowStartedAt = runStartedAt;
+  let windowSent = 0;
+  let windowReceived = 0;
+  const cpuSamples: number[] = [];
+
+  const dropTimer =
+    hub && options.dropEverySec > 0
+      ? setInterval(() => {
+          const dropped = hub.dropConnections(options.dropFraction);
+          out(`[LoadTest] ⚡ Dropped ${dropped} connections`);
+        }, options.dropEverySec * 1000)
+      : undefined;
+
+  const reportTimer = setInterval(() => {
+    const now = performance.now();
+    const elapsedSec = (now - windowStartedAt) / 1000;
+    const cpu = process.cpuUsage(cpuWindow);
+    const cpuPct = ((cpu.user + cpu.system) / 1000 / (now - windowStartedAt)) * 100;
+    cpuSamples.push(cpuPct);
+    const windowStats = summarize(windowLatencies);
+    const connected = [...viewers, ...drivers].filter((s) => s.isConnected()).length;
+    out(
+      `[LoadTest] t=${((now - runStartedAt) / 1000).toFixed(0)}s ` +
+        `sent=${((sent - windowSent) / elapsedSec).toFixed(0)}/s ` +
+        `recv=${((received - windowReceived) / elapsedSec).toFixed(0)}/s ` +
+        `p50=${windowStats.p50.toFixed(1)}ms p95=${windowStats.p95.toFixed(1)}ms p99=${windowStats.p99.toFixed(1)}ms ` +
+        `connected=${connected}/${viewers.length + drivers.length} ` +
+        `cpu=${cpuPct.toFixed(1)}% loopP99=${(loopDelay.percentile(99) / 1e6).toFixed(1)}ms`
+    );
+    windowStartedAt = now;
+    windowSent = sent;
+    windowReceived = received;
+    windowLatencies = [];
+    cpuWindow = process.cpuUsage();
+
+    // Dọn các mốc gửi cũ để map không phình ra
+    const cutoff = now - 60000;
+    for (const [key, at] of sentAt) {
+      if (at < cutoff) sentAt.delete(key);
+    }
+  }, REPORT_EVERY_MS);
+
+  await sleep(options.durationSec * 1000);
+
+  // ===== Teardown =====
+  clearInterval(reportTimer);
+  if (dropTimer) clearInterval(dropTimer);
+  simulators.forEach((simulator) => simulator.stop());
+  const runMs = performance.now() - runStartedAt;
+  const cpuTotal = process.cpuUsage(cpuStart);
+  loopDelay.disable();
+
+  await Promise.all([...viewers, ...drivers].map((service) => service.disconnect()));
+  if (hub) await hub.close();
+
+  const reconnectMs = clientStats.flatMap((s) => s.reconnectMs);
+  const report = {
+    options,
+    durationMs: runMs,
+    messages: {
+      sent,
+      skippedWhileDisconnected: skipped,
+      received,
+      unmatched,
+      sentPerSec: sent / (runMs / 1000),
+      receivedPerSec: received / (runMs / 1000),
+      expectedFanout: options.drivers > 0 ? sent * (options.viewers / options.drivers) : 0,
+    },
+    latencyMs: summarize(latencies),
+    reconnect: {
+      disconnects: clientStats.reduce((acc, s) => acc + s.disconnects, 0),
+      reconnects: clientStats.reduce((acc, s) => acc + s.reconnects, 0),
+      stillDisconnected: clientStats.filter((s) => s.disconnectedAt !== undefined).length,
+      timeToReconnectMs: summarize(reconnectMs),
+    },
+    cpu: {
+      avgPct: ((cpuTotal.user + cpuTotal.system) / 1000 / runMs) * 100,
+      maxWindowPct: cpuSamples.length ? Math.max(...cpuSamples) : 0,
+      includesHub: !!hub,
+    },
+    eventLoopDelayMs: {
+      p50: loopDelay.percentile(50) / 1e6,
+      p99: loopDelay.percentile(99) / 1e6,
+      max: loopDelay.max / 1e6,
+    },
+    simulationClock: simulationClock.getStats(),
+    hub: hub ? hub.stats : null,
+    serviceErrors: consoleCtl ? consoleCtl.errorCount() : undefined,
+  };
+
+  consoleCtl?.restore();
+  console.log('\n===== Tracking load test report =====');
+  console.log(JSON.stringify(report, null, 2));
+  if (options.jsonFile) {
+    fs.writeFileSync(options.jsonFile, JSON.stringify(report, null, 2));
+    console.log(`[LoadTest] Report written to ${options.jsonFile}`);
+  }
+  return report;
+}
+
+runLoadTest(parseArgs(process.argv.slice(2)))
+  .then(() => process.exit(0))
+  .catch((error) => {
+    console.error('[LoadTest] Failed:', error);
+    process.exit(1);
+  });
@@ -0,0 +1,97 @@
+/**
+ * Scheduler Check - kiểm tra requestScheduler trên axios instance với adapter giả (không cần mạng)
+ *
+ * Kịch bản:
+ *   1. chunks   - `--chunks` PUT chunk (body ArrayBuffer, không truyền priority) như
+ *                 resumableUploadService phải thực sự chạy đồng thời tới giới hạn lớp upload
+ *   2. classify - URL tính route vào critical, URL chỉ chứa chữ "route" thì không
+ *
+ * Chạy:
+ *   npx tsx scripts/scheduler/schedulerCheck.ts --chunks 3 --latency 200
+ *
+ * Tham số:
+ *   --chunks N       Số PUT chunk bắn cùng lúc (default 3 = parallelChunks mặc định)
+ *   --latency MS     Thời gian adapter giả giữ mỗi request (default 200)
+ */
+
+import axios, { AxiosAdapter } from 'axios';
+import { classify, requestScheduler } from '../../config/requestScheduler';
+
+const args = process.argv.slice(2);
+const arg = (name: string, fallback: number) => {
+  const index = args.indexOf(`--${name}`);
+  return index >= 0 && args[index + 1] ? Number(args[index + 1]) : fallback;
+};
+
+const CHUNKS = arg('chunks', 3);
+const LATENCY_MS = arg('latency', 200);
+
+const sleep = (ms: number) => new Promise((resolve) => setTimeout(resolve, ms));
+
+const failures: string[] = [];
+const check = (ok: boolean, message: string) => {
+  console.log(`${ok ? '  ✓' : '  ✗'} ${message}`);
+  if (!ok) failures.push(message);
+};
+
+async function checkChunks() {
+  console.log(`\n[chunks] ${CHUNKS} PUT chunk song song, adapter giữ ${LATENCY_MS}ms`);
+  let inFlight = 0;
+  let peak = 0;
+  const fakeAdapter: AxiosAdapter = async (config) => {
+    inFlight++;
+    peak = Math.max(peak, inFlight);
+    await sleep(LATENCY_MS);
+    inFlight--;
+    return { data: { received: true }, status: 200, statusText: 'OK', headers: {}, config };
+  };
+
+  const instance = axios.create({ adapter: fakeAdapter });
+  requestScheduler.install(instance);
+
+  const startedAt = Date.now();
+  await Promise.all(
+    Array.from({ length: CHUNKS }, (_, index) =>
+      instance.put(`api/uploads/check-upload/chunks/${index}`, new ArrayBuffer(64 * 1024), {
+        headers: { 'Content-Type': 'application/octet-stream' },
+      })
+    )
+  );
+  const elapsed = Date.now() - startedAt;
+
+  const stats = requestScheduler.getStats().classes.upload;
+  check(stats.started === CHUNKS, `cả ${CHUNKS} PUT vào lớp upload (started=${stats.started})`);
+  check(peak === CHUNKS, `đồng thời tối đa ${peak}/${CHUNKS}`);
+  // Tuần tự sẽ mất ~CHUNKS * LATENCY_MS
+  check(elapsed < LATENCY_MS * 2, `tổng thời gian ${elapsed}ms < ${LATENCY_MS * 2}ms`);
+}
+
+function checkClassify() {
+  console.log('\n[classify] URL tính route');
+  const cases: [string, string][] = [
+    ['api/PostPackage/calculate-route', 'critical'],
+    ['https://maps.vietmap.vn/api/route/v3?apikey=x&point=1,2', 'critical'],
+    ['api/Trip/route-history', 'interactive'],
+    ['api/Vehicle/routes', 'interactive'],
+  ];
+  cases.forEach(([url, expected]) => {
+    const actual = classify({ url, method: 'get' });
+    check(actual === expected, `${url} -> ${actual}`);
+  });
+}
+
+async function main() {
+  await checkChunks();
+  checkClassify();
+
+  if (failures.length > 0) {
+    console.error(`\n${failures.length} kiểm tra thất bại`);
+    process.exit(1);
+  }
+  console.log('\nOK');
+}
+
+main().catch((error) => {
+  console.error(error);
+  process.exit(1);
+});
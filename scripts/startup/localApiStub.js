@@ -0,0 +1,254 @@
+/**
+ * Local API Stub - stand-in backend cho đo khởi động trên web (xem startupBench.ts)
+ *
+ * Cùng 1 origin phục vụ:
+ *   - bản web đã export (distDir): index.html được chèn script nạp sẵn phiên đăng nhập
+ *     của role trong ?benchRole= (accessToken/refreshToken/user trong localStorage,
+ *     đúng key của utils/persistedState) và window.__STARTUP_BENCH__ = { reportUrl, run }
+ *   - các API màn home gọi lúc khởi động: api/user/me, api/wallets/my-wallet,
+ *     api/DriverWorkSession/history; route khác trả ResponseDTO rỗng và được đếm
+ *     trong stats.unknownRoutes để biết màn home đã gọi thêm gì
+ *   - POST /__bench/startup: nhận StartupTraceReport (utils/startupTrace.ts)
+ *
+ * Giả lập mạng: latencyMs + jitterMs ngẫu nhiên cho mỗi request API.
+ *
+ * Chạy độc lập (mở http://localhost:5246/?benchRole=Owner bằng trình duyệt):
+ *   node scripts/startup/localApiStub.js --dist dist --port 5246 --latency 80
+ */
+const http = require('http')
+const fs = require('fs')
+const path = require('path')
+
+const ROLES = ['Driver', 'Owner', 'Provider']
+
+const CONTENT_TYPES = {
+  '.html': 'text/html; charset=utf-8',
+  '.js': 'application/javascript',
+  '.css': 'text/css',
+  '.json': 'application/json',
+  '.map': 'application/json',
+  '.png': 'image/png',
+  '.jpg': 'image/jpeg',
+  '.svg': 'image/svg+xml',
+  '.ico': 'image/x-icon',
+  '.ttf': 'font/ttf',
+  '.woff': 'font/woff',
+  '.woff2': 'font/woff2',
+}
+
+const base64url = (value) => Buffer.from(JSON.stringify(value)).toString('base64url')
+
+// JWT không ký: app chỉ jwtDecode để đọc exp / claim
+const fakeJwt = (role, ttlSeconds) =>
+  `${base64url({ alg: 'none', typ: 'JWT' })}.${base64url({
+    userId: `bench-${role.toLowerCase()}`,
+    fullName: `Bench ${role}`,
+    Role: role,
+    exp: Math.floor(Date.now() / 1000) + ttlSeconds,
+  })}.bench`
+
+const roleOfToken = (authorization) => {
+  try {
+    const payload = String(authorization || '').replace(/^Bearer /, '').split('.')[1]
+    const role = JSON.parse(Buffer.from(payload, 'base64url').toString()).Role
+    return ROLES.includes(role) ? role : 'Driver'
+  } catch {
+    return 'Driver'
+  }
+}
+
+const ok = (result) => ({ statusCode: 200, message: 'OK', isSuccess: true, result })
+
+const profileOf = (role) => ({
+  userId: `bench-${role.toLowerCase()}`,
+  fullName: `Bench ${role}`,
+  email: `${role.toLowerCase()}@bench.local`,
+  phoneNumber: '0900000000',
+  role,
+  hasVerifiedCitizenId: true,
+  hasVerifiedDriverLicense: role === 'Driver',
+  hasDeclaredInitialHistory: true,
+  companyName: role === 'Driver' ? undefined : `Bench ${role} Co.`,
+  totalVehicles: 12,
+  totalDrivers: 8,
+  totalTripsCreated: 140,
+  totalItems: 36,
+  totalPackages: 20,
+  totalPackagePosts: 9,
+  averageRating: 4.7,
+})
+
+const seedScript = (role, run, ttlSeconds) => {
+  const user = { ...profileOf(role), userName: `Bench ${role}` }
+  const session = {
+    accessToken: fakeJwt(role, ttlSeconds),
+    refreshToken: `bench-refresh-${role}`,
+    user: JSON.stringify(user),
+  }
+  return `<script>
+(function () {
+  localStorage.clear();
+  var session = ${JSON.stringify(session)};
+  Object.keys(session).forEach(function (key) { localStorage.setItem(key, session[key]); });
+  window.__STARTUP_BENCH__ = { reportUrl: '/__bench/startup', run: ${Number(run) || 0} };
+})();
+</script>`
+}
+
+function createLocalApiStub(options = {}) {
+  const distDir = options.distDir ? path.resolve(options.distDir) : null
+  const latencyMs = options.latencyMs || 0
+  const jitterMs = options.jitterMs || 0
+  const tokenTtlSeconds = options.tokenTtlSeconds || 3600
+  const random = options.random || Math.random
+
+  const reports = []
+  /** run -> resolve() của waitForReport */
+  const waiters = new Map()
+
+  const stats = {
+    pages: 0,
+    assets: 0,
+    apiRequests: 0,
+    reports: 0,
+    /** "GET api/..." -> số lần: route màn home gọi mà stub chưa có fixture */
+    unknownRoutes: {},
+  }
+
+  const json = (res, status, body) => {
+    res.writeHead(status, { 'Content-Type': 'application/json' })
+    res.end(body === undefined ? '' : JSON.stringify(body))
+  }
+
+  const readBody = (req) =>
+    new Promise((resolve, reject) => {
+      const parts = []
+      req.on('data', (part) => parts.push(part))
+      req.on('end', () => resolve(Buffer.concat(parts)))
+      req.on('error', reject)
+    })
+
+  const serveIndex = (res, url) => {
+    const indexPath = path.join(distDir, 'index.html')
+    if (!fs.existsSync(indexPath)) return json(res, 404, { message: `Không thấy ${indexPath}, chạy expo export -p web trước` })
+    let html = fs.readFileSync(indexPath, 'utf8')
+    const role = url.searchParams.get('benchRole')
+    if (ROLES.includes(role)) {
+      // Chạy trước mọi script của bundle
+      html = html.replace(/<head>/i, `<head>${seedScript(role, url.searchParams.get('run'), tokenTtlSeconds)}`)
+    }
+    stats.pages++
+    res.writeHead(200, { 'Content-Type': CONTENT_TYPES['.html'], 'Cache-Control': 'no-store' })
+    res.end(html)
+  }
+
+  const serveStatic = (res, url) => {
+    if (!distDir) return json(res, 404, { message: 'Not found' })
+    const filePath = path.join(distDir, decodeURIComponent(url.pathname))
+    if (!filePath.startsWith(distDir)) return json(res, 403, { message: 'Forbidden' })
+    if (url.pathname === '/' || !fs.existsSync(filePath) || fs.statSync(filePath).isDirectory()) {
+      // Route của expo-router (vd. /(owner)/home) => SPA fallback
+      return serveIndex(res, url)
+    }
+    stats.assets++
+    res.writeHead(200, { 'Content-Type': CONTENT_TYPES[path.extname(filePath)] || 'application/octet-stream' })
+    fs.createReadStream(filePath).pipe(res)
+  }
+
+  const handleApi = async (req, res, url) => {
+    stats.apiRequests++
+    if (latencyMs || jitterMs) {
+      await new Promise((resolve) => setTimeout(resolve, latencyMs + Math.round(random() * jitterMs)))
+    }
+    const role = roleOfToken(req.headers.authorization)
+    const route = url.pathname.replace(/^\//, '')
+
+    if (req.method === 'GET' && /^api\/user\/me$/i.test(route)) return json(res, 200, ok(profileOf(role)))
+    if (req.method === 'GET' && /^api\/wallets\/my-wallet$/i.test(route)) {
+      return json(res, 200, ok({ walletId: `wallet-${role}`, balance: 150500000, currency: 'VND', status: 'ACTIVE' }))
+    }
+    if (req.method === 'GET' && /^api\/DriverWorkSession\/history$/i.test(route)) {
+      return json(res, 200, ok({ TotalHoursInPeriod: 3.5, Sessions: [], TotalCount: 0 }))
+    }
+
+    const key = `${req.method} ${route}`
+    stats.unknownRoutes[key] = (stats.unknownRoutes[key] || 0) + 1
+    return json(res, 200, ok(null))
+  }
+
+  const handle = async (req, res) => {
+    const url = new URL(req.url, 'http://localhost')
+
+    if (url.pathname === '/__bench/startup' && req.method === 'POST') {
+      const report = JSON.parse((await readBody(req)).toString() || '{}')
+      reports.push(report)
+      stats.reports++
+      const waiter = waiters.get(report.run)
+      if (waiter) {
+        waiters.delete(report.run)
+        waiter(report)
+      }
+      return json(res, 204)
+    }
+    if (url.pathname.startsWith('/api/')) return handleApi(req, res, url)
+    // SignalR hub / change feed: không giả lập, app tự xử lý lỗi kết nối
+    if (url.pathname.startsWith('/hubs/')) return json(res, 404, { message: 'Not found' })
+    if (req.method === 'GET') return serveStatic(res, url)
+    return json(res, 404, { message: 'Not found' })
+  }
+
+  const server = http.createServer((req, res) => {
+    handle(req, res).catch((e) => json(res, 500, { message: e.message }))
+  })
+
+  return {
+    stats,
+    reports,
+    /** Chờ báo cáo của lượt chạy run; hết timeoutMs thì trả null */
+    waitForReport(run, timeoutMs) {
+      const existing = reports.find((r) => r.run === run)
+      if (existing) return Promise.resolve(existing)
+      return new Promise((resolve) => {
+        const timer = setTimeout(() => {
+          waiters.delete(run)
+          resolve(null)
+        }, timeoutMs)
+        waiters.set(run, (report) => {
+          clearTimeout(timer)
+          resolve(report)
+        })
+      })
+    },
+    listen(port = 0, host = 'localhost') {
+      return new Promise((resolve) => {
+        server.listen(port, host, () => {
+          const address = server.address()
+          resolve(`http://${host}:${address.port}`)
+        })
+      })
+    },
+    close() {
+      const closed = new Promise((resolve) => server.close(() => resolve()))
+      server.closeAllConnections()
+      return closed
+    },
+  }
+}
+
+module.exports = { createLocalApiStub, ROLES }
+
+if (require.main === module) {
+  const arg = (name, fallback) => {
+    const i = process.argv.indexOf(name)
+    return i !== -1 ? process.argv[i + 1] : fallback
+  }
+  const stub = createLocalApiStub({
+    distDir: arg('--dist', 'dist'),
+    latencyMs: Number(arg('--latency', 0)),
+    jitterMs: Number(arg('--jitter', 0)),
+  })
+  stub.listen(Number(arg('--port', 5246))).then((url) => {
+    console.log(`[LocalApiStub] Listening on ${url} (mở ${url}/?benchRole=Owner)`)
+    setInterval(() => console.log('[LocalApiStub]', stub.stats), 10000)
+  })
+}
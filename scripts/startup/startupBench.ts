@@ -0,0 +1,319 @@
+/**
+ * Startup Bench - đo khởi động lạnh tới màn home của từng role trên web, chạy headless
+ *
+ * Mỗi lượt: Chrome headless với profile mới (không cache HTTP, localStorage trống) mở
+ * localApiStub ?benchRole=<role>; stub nạp sẵn phiên đăng nhập, app báo mốc của
+ * utils/startupTrace (bundle_loaded, auth_restored, first_render, first_data) về stub.
+ * Tổng hợp p50/p95/min/max theo role × mốc, kèm byte JS đã tải (parse/evaluate) và thời
+ * gian nạp trước chunk của role; có --baseline thì so p50 và thoát mã 1 khi mốc nào chậm
+ * hơn (hoặc JS nặng hơn) quá ngưỡng => dùng được làm bước chặn hồi quy trong CI.
+ *
+ * Chạy:
+ *   npx tsx scripts/startup/startupBench.ts --build --runs 7 --out startup.json
+ *   npx tsx scripts/startup/startupBench.ts --runs 7 --baseline startup.json
+ *
+ * Tham số:
+ *   --roles LIST        Role cần đo, phân tách bằng dấu phẩy (default Driver,Owner,Provider)
+ *   --runs N            Số lượt mỗi role (default 5)
+ *   --dist DIR          Thư mục bản web đã export (default dist)
+ *   --build             Chạy expo export -p web trước, trỏ EXPO_PUBLIC_API_BASE_URL về stub
+ *   --port N            Cổng stub (default 5246, trùng baseURL mặc định của config/api.ts)
+ *   --latency MS        Độ trễ mỗi request API (default 80)
+ *   --jitter MS         Độ trễ ngẫu nhiên thêm (default 40)
+ *   --timeout MS        Chờ tối đa mỗi lượt (default 30000)
+ *   --chrome PATH       Đường dẫn Chrome/Chromium (default $CHROME_PATH hoặc tự tìm)
+ *   --out FILE          Ghi kết quả JSON
+ *   --baseline FILE     Kết quả JSON lần trước để so sánh
+ *   --threshold F       Tỷ lệ chậm hơn cho phép so với baseline (default 0.15)
+ *   --min-delta MS      Bỏ qua chênh lệch nhỏ hơn mức này (default 50)
+ */
+
+import { ChildProcess, execSync, spawn } from 'child_process';
+import * as fs from 'fs';
+import * as os from 'os';
+import * as path from 'path';
+import type { StartupMark, StartupTraceReport } from '@/utils/startupTrace';
+
+// eslint-disable-next-line @typescript-eslint/no-var-requires
+const { createLocalApiStub, ROLES } = require('./localApiStub');
+
+const MARKS: StartupMark[] = ['bundle_loaded', 'auth_restored', 'first_render', 'first_data'];
+
+interface BenchOptions {
+  roles: string[];
+  runs: number;
+  distDir: string;
+  build: boolean;
+  port: number;
+  latencyMs: number;
+  jitterMs: number;
+  timeoutMs: number;
+  chrome?: string;
+  out?: string;
+  baseline?: string;
+  threshold: number;
+  minDeltaMs: number;
+}
+
+interface MarkSummary {
+  n: number;
+  p50: number;
+  p95: number;
+  min: number;
+  max: number;
+}
+
+interface RoleSummary {
+  runs: number;
+  timeouts: number;
+  dataErrors: number;
+  marks: Partial<Record<StartupMark, MarkSummary>>;
+  /** Byte JS đã giải nén tải tới first_data (web) */
+  scriptBytes?: MarkSummary;
+  roleBundleMs?: MarkSummary;
+}
+
+interface BenchResult {
+  createdAt: string;
+  options: { runs: number; latencyMs: number; jitterMs: number };
+  roles: Record<string, RoleSummary>;
+  unknownRoutes: Record<string, number>;
+}
+
+const parseArgs = (argv: string[]): BenchOptions => {
+  const get = (name: string) => {
+    const idx = argv.indexOf(`--${name}`);
+    return idx !== -1 ? argv[idx + 1] : undefined;
+  };
+  const num = (name: string, fallback: number) => {
+    const raw = get(name);
+    const value = raw !== undefined ? Number(raw) : NaN;
+    return Number.isFinite(value) ? value : fallback;
+  };
+  const roles = (get('roles') ?? ROLES.join(','))
+    .split(',')
+    .map((r) => r.trim())
+    .filter(Boolean);
+  const unknown = roles.filter((r) => !ROLES.includes(r));
+  if (unknown.length > 0) throw new Error(`Role không hợp lệ: ${unknown.join(', ')} (chọn trong ${ROLES.join(', ')})`);
+  return {
+    roles,
+    runs: Math.max(1, num('runs', 5)),
+    distDir: get('dist') ?? 'dist',
+    build: argv.includes('--build'),
+    port: num('port', 5246),
+    latencyMs: num('latency', 80),
+    jitterMs: num('jitter', 40),
+    timeoutMs: num('timeout', 30000),
+    chrome: get('chrome') ?? process.env.CHROME_PATH,
+    out: get('out'),
+    baseline: get('baseline'),
+    threshold: num('threshold', 0.15),
+    minDeltaMs: num('min-delta', 50),
+  };
+};
+
+const percentile = (sorted: number[], p: number): number =>
+  sorted.length === 0 ? 0 : sorted[Math.min(sorted.length - 1, Math.floor((sorted.length * p) / 100))];
+
+const summarize = (values: number[]): MarkSummary => {
+  const sorted = [...values].sort((a, b) => a - b);
+  return {
+    n: sorted.length,
+    p50: percentile(sorted, 50),
+    p95: percentile(sorted, 95),
+    min: sorted[0] ?? 0,
+    max: sorted[sorted.length - 1] ?? 0,
+  };
+};
+
+// ============ CHROME ============
+
+const CHROME_CANDIDATES = [
+  'google-chrome',
+  'google-chrome-stable',
+  'chromium',
+  'chromium-browser',
+  '/Applications/Google Chrome.app/Contents/MacOS/Google Chrome',
+  'C:\\Program Files\\Google\\Chrome\\Application\\chrome.exe',
+];
+
+const findChrome = (explicit?: string): string => {
+  if (explicit) return explicit;
+  for (const candidate of CHROME_CANDIDATES) {
+    if (path.isAbsolute(candidate)) {
+      if (fs.existsSync(candidate)) return candidate;
+      continue;
+    }
+    try {
+      execSync(`${process.platform === 'win32' ? 'where' : 'command -v'} ${candidate}`, { stdio: 'ignore' });
+      return candidate;
+    } catch {}
+  }
+  throw new Error('Không tìm thấy Chrome/Chromium, truyền --chrome PATH hoặc đặt CHROME_PATH');
+};
+
+// Profile mới mỗi lượt => khởi động lạnh thật (không cache HTTP / service worker / storage)
+const launchChrome = (chrome: string, url: string): { child: ChildProcess; profileDir: string } => {
+  const profileDir = fs.mkdtempSync(path.join(os.tmpdir(), 'startup-bench-'));
+  const child = spawn(
+    chrome,
+    [
+      '--headless=new',
+      '--disable-gpu',
+      '--no-first-run',
+      '--no-default-browser-check',
+      '--disable-extensions',
+      '--disable-background-networking',
+      '--window-size=412,915',
+      `--user-data-dir=${profileDir}`,
+      url,
+    ],
+    { stdio: 'ignore' }
+  );
+  return { child, profileDir };
+};
+
+const stopChrome = async ({ child, profileDir }: { child: ChildProcess; profileDir: string }) => {
+  if (child.exitCode === null) {
+    const exited = new Promise((resolve) => child.once('exit', resolve));
+    child.kill();
+    await Promise.race([exited, new Promise((resolve) => setTimeout(resolve, 3000))]);
+  }
+  fs.rmSync(profileDir, { recursive: true, force: true });
+};
+
+// ============ MAIN ============
+
+const buildWeb = (options: BenchOptions) => {
+  console.log(`[StartupBench] expo export -p web -> ${options.distDir}`);
+  execSync(`npx expo export -p web --output-dir ${options.distDir}`, {
+    stdio: 'inherit',
+    env: { ...process.env, EXPO_PUBLIC_API_BASE_URL: `http://localhost:${options.port}/` },
+  });
+};
+
+const compareWithBaseline = (result: BenchResult, options: BenchOptions): string[] => {
+  const baseline: BenchResult = JSON.parse(fs.readFileSync(options.baseline!, 'utf8'));
+  const regressions: string[] = [];
+  for (const [role, summary] of Object.entries(result.roles)) {
+    for (const mark of MARKS) {
+      const current = summary.marks[mark];
+      const before = baseline.roles[role]?.marks[mark];
+      if (!current || !before) continue;
+      const delta = current.p50 - before.p50;
+      if (delta > options.minDeltaMs && current.p50 > before.p50 * (1 + options.threshold)) {
+        regressions.push(`${role} ${mark}: p50 ${before.p50}ms -> ${current.p50}ms (+${delta}ms)`);
+      }
+    }
+    const bytes = summary.scriptBytes;
+    const bytesBefore = baseline.roles[role]?.scriptBytes;
+    if (bytes && bytesBefore && bytes.p50 > bytesBefore.p50 * (1 + options.threshold)) {
+      regressions.push(`${role} script: ${formatKb(bytesBefore.p50)} -> ${formatKb(bytes.p50)}`);
+    }
+  }
+  return regressions;
+};
+
+const formatKb = (bytes: number) => `${Math.round(bytes / 1024)} KB`;
+
+const printTable = (result: BenchResult) => {
+  console.log('');
+  console.log(`${'role'.padEnd(10)}${'mark'.padEnd(16)}${'p50'.padStart(8)}${'p95'.padStart(8)}${'min'.padStart(8)}${'max'.padStart(8)}`);
+  for (const [role, summary] of Object.entries(result.roles)) {
+    for (const mark of MARKS) {
+      const s = summary.marks[mark];
+      if (!s) continue;
+      console.log(
+        `${role.padEnd(10)}${mark.padEnd(16)}${String(s.p50).padStart(8)}${String(s.p95).padStart(8)}` +
+          `${String(s.min).padStart(8)}${String(s.max).padStart(8)}`
+      );
+    }
+    if (summary.scriptBytes) {
+      console.log(
+        `${role.padEnd(10)}${'script'.padEnd(16)}${formatKb(summary.scriptBytes.p50).padStart(8)}` +
+          (summary.roleBundleMs ? `   prefetch chunk p50 ${summary.roleBundleMs.p50}ms` : '')
+      );
+    }
+    if (summary.timeouts > 0 || summary.dataErrors > 0) {
+      console.log(`${role.padEnd(10)}timeout ${summary.timeouts}/${summary.runs}, lỗi tải dữ liệu ${summary.dataErrors}`);
+    }
+  }
+};
+
+async function main() {
+  const options = parseArgs(process.argv.slice(2));
+  const chrome = findChrome(options.chrome);
+  if (options.build) buildWeb(options);
+
+  const stub = createLocalApiStub({ distDir: options.distDir, latencyMs: options.latencyMs, jitterMs: options.jitterMs });
+  const baseUrl: string = await stub.listen(options.port);
+  console.log(`[StartupBench] ${options.roles.join(', ')} × ${options.runs} lượt qua ${baseUrl}`);
+
+  const result: BenchResult = {
+    createdAt: new Date().toISOString(),
+    options: { runs: options.runs, latencyMs: options.latencyMs, jitterMs: options.jitterMs },
+    roles: {},
+    unknownRoutes: stub.stats.unknownRoutes,
+  };
+
+  let run = 0;
+  try {
+    for (const role of options.roles) {
+      const samples: Partial<Record<StartupMark, number[]>> = {};
+      const scriptBytes: number[] = [];
+      const roleBundleMs: number[] = [];
+      const summary: RoleSummary = { runs: options.runs, timeouts: 0, dataErrors: 0, marks: {} };
+      for (let i = 0; i < options.runs; i++) {
+        run++;
+        const browser = launchChrome(chrome, `${baseUrl}/?benchRole=${role}&run=${run}`);
+        const report: StartupTraceReport | null = await stub.waitForReport(run, options.timeoutMs);
+        await stopChrome(browser);
+
+        if (!report) {
+          summary.timeouts++;
+          console.log(`[StartupBench] ${role} #${i + 1}: không nhận được báo cáo sau ${options.timeoutMs}ms`);
+          continue;
+        }
+        if (!report.dataOk) summary.dataErrors++;
+        MARKS.forEach((mark) => {
+          const value = report.marks[mark];
+          if (value !== undefined) (samples[mark] ??= []).push(value);
+        });
+        if (report.scripts) scriptBytes.push(report.scripts.bytes);
+        if (report.roleBundleMs !== undefined) roleBundleMs.push(report.roleBundleMs);
+        console.log(`[StartupBench] ${role} #${i + 1}: first_data ${report.marks.first_data ?? '-'}ms`);
+      }
+      MARKS.forEach((mark) => {
+        if (samples[mark]?.length) summary.marks[mark] = summarize(samples[mark]!);
+      });
+      if (scriptBytes.length > 0) summary.scriptBytes = summarize(scriptBytes);
+      if (roleBundleMs.length > 0) summary.roleBundleMs = summarize(roleBundleMs);
+      result.roles[role] = summary;
+    }
+  } finally {
+    await stub.close();
+  }
+
+  printTable(result);
+  if (Object.keys(result.unknownRoutes).length > 0) {
+    console.log('\n[StartupBench] Route chưa có fixture trong localApiStub:', result.unknownRoutes);
+  }
+  if (options.out) {
+    fs.writeFileSync(options.out, JSON.stringify(result, null, 2));
+    console.log(`[StartupBench] Đã ghi ${options.out}`);
+  }
+
+  const timedOut = Object.values(result.roles).some((s) => s.timeouts === s.runs);
+  const regressions = options.baseline ? compareWithBaseline(result, options) : [];
+  if (regressions.length > 0) {
+    console.log('\n[StartupBench] Chậm hơn baseline:');
+    regressions.forEach((line) => console.log(`  ${line}`));
+  }
+  if (timedOut || regressions.length > 0) process.exit(1);
+}
+
+main().catch((e) => {
+  console.error('[StartupBench]', e?.message ?? e);
+  process.exit(1);
+});
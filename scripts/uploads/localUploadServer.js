@@ -0,0 +1,186 @@
+/**
+ * Local Upload Server - stand-in cho /api/uploads (upload theo chunk, xem utils/resumableUpload.ts)
+ *
+ * Dùng module http có sẵn của Node, giữ chunk trong bộ nhớ:
+ *   POST /api/uploads                      -> tạo phiên
+ *   GET  /api/uploads/{id}                 -> chunk đã nhận
+ *   PUT  /api/uploads/{id}/chunks/{index}  -> kiểm tra X-Chunk-Sha256, 409 nếu sai
+ *   POST /api/uploads/{id}/complete        -> đối chiếu fileHash (SHA-256 của chuỗi hash chunk)
+ *
+ * Giả lập mạng xấu: failRate (tỷ lệ PUT chunk trả 503), corruptRate (tỷ lệ chunk bị
+ * hỏng trên đường truyền -> 409), latencyMs; expireSession(id) để thử luồng 404.
+ *
+ * Chạy độc lập:
+ *   node scripts/uploads/localUploadServer.js --port 5298 --fail-rate 0.1
+ */
+const http = require('http')
+const crypto = require('crypto')
+
+const sha256 = (data) => crypto.createHash('sha256').update(data).digest('hex')
+
+function createLocalUploadServer(options = {}) {
+  const failRate = options.failRate || 0
+  const corruptRate = options.corruptRate || 0
+  const latencyMs = options.latencyMs || 0
+  const random = options.random || Math.random
+
+  /** uploadId -> session */
+  const sessions = new Map()
+  /** fileId -> { fileName, mimeType, data } */
+  const files = new Map()
+  let nextId = 1
+
+  const stats = {
+    sessionsCreated: 0,
+    sessionsCompleted: 0,
+    chunksReceived: 0,
+    chunksDuplicate: 0,
+    chunksRejected: 0,
+    injectedFailures: 0,
+    bytesIn: 0,
+  }
+
+  const json = (res, status, body) => {
+    res.writeHead(status, { 'Content-Type': 'application/json' })
+    res.end(body === undefined ? '' : JSON.stringify(body))
+  }
+
+  const readBody = (req) =>
+    new Promise((resolve, reject) => {
+      const parts = []
+      req.on('data', (part) => parts.push(part))
+      req.on('end', () => resolve(Buffer.concat(parts)))
+      req.on('error', reject)
+    })
+
+  const receivedOf = (session) => Array.from(session.chunks.keys()).sort((a, b) => a - b)
+
+  const handle = async (req, res) => {
+    const url = new URL(req.url, 'http://localhost')
+    const parts = url.pathname.split('/').filter(Boolean)
+    if (parts[0] !== 'api' || parts[1] !== 'uploads') return json(res, 404, { message: 'Not found' })
+    const body = await readBody(req)
+    stats.bytesIn += body.length
+    if (latencyMs) await new Promise((resolve) => setTimeout(resolve, latencyMs))
+
+    // POST /api/uploads
+    if (parts.length === 2 && req.method === 'POST') {
+      const meta = JSON.parse(body.toString() || '{}')
+      if (!(meta.size >= 0) || !(meta.chunkSize > 0) || !(meta.chunkCount > 0)) {
+        return json(res, 400, { message: 'size/chunkSize/chunkCount không hợp lệ' })
+      }
+      const uploadId = `u${nextId++}`
+      sessions.set(uploadId, { ...meta, uploadId, chunks: new Map(), fileId: null })
+      stats.sessionsCreated++
+      return json(res, 200, { uploadId, receivedChunks: [] })
+    }
+
+    const session = sessions.get(parts[2])
+    if (!session) return json(res, 404, { message: 'Phiên upload không tồn tại hoặc đã hết hạn' })
+
+    // GET /api/uploads/{id}
+    if (parts.length === 3 && req.method === 'GET') {
+      return json(res, 200, {
+        uploadId: session.uploadId,
+        receivedChunks: receivedOf(session),
+        completed: !!session.fileId,
+        fileId: session.fileId || undefined,
+        url: session.fileId ? `/files/${session.fileId}` : undefined,
+      })
+    }
+
+    // PUT /api/uploads/{id}/chunks/{index}
+    if (parts.length === 5 && parts[3] === 'chunks' && req.method === 'PUT') {
+      const index = Number(parts[4])
+      if (!Number.isInteger(index) || index < 0 || index >= session.chunkCount) {
+        return json(res, 400, { message: 'Chunk index không hợp lệ' })
+      }
+      if (random() < failRate) {
+        stats.injectedFailures++
+        return json(res, 503, { message: 'Injected failure' })
+      }
+      let data = body
+      if (random() < corruptRate && data.length > 0) {
+        data = Buffer.from(data)
+        data[0] ^= 0xff
+      }
+      const expected = index === session.chunkCount - 1 ? session.size - index * session.chunkSize : session.chunkSize
+      if (data.length !== expected || sha256(data) !== req.headers['x-chunk-sha256']) {
+        stats.chunksRejected++
+        return json(res, 409, { message: 'Chunk không khớp hash/kích thước' })
+      }
+      if (session.chunks.has(index)) stats.chunksDuplicate++
+      else stats.chunksReceived++
+      session.chunks.set(index, data)
+      return json(res, 200)
+    }
+
+    // POST /api/uploads/{id}/complete
+    if (parts.length === 4 && parts[3] === 'complete' && req.method === 'POST') {
+      if (session.fileId) return json(res, 200, { fileId: session.fileId, url: `/files/${session.fileId}` })
+      const { fileHash } = JSON.parse(body.toString() || '{}')
+      if (session.chunks.size !== session.chunkCount) {
+        return json(res, 409, { message: 'Chưa nhận đủ chunk', receivedChunks: receivedOf(session) })
+      }
+      const ordered = receivedOf(session).map((i) => session.chunks.get(i))
+      const hashList = ordered.map((chunk) => sha256(chunk)).join('')
+      if (sha256(hashList) !== fileHash) return json(res, 409, { message: 'fileHash không khớp' })
+      session.fileId = `f${session.uploadId.slice(1)}`
+      files.set(session.fileId, { fileName: session.fileName, mimeType: session.mimeType, data: Buffer.concat(ordered) })
+      stats.sessionsCompleted++
+      return json(res, 200, { fileId: session.fileId, url: `/files/${session.fileId}` })
+    }
+
+    return json(res, 404, { message: 'Not found' })
+  }
+
+  const server = http.createServer((req, res) => {
+    handle(req, res).catch((e) => json(res, 500, { message: e.message }))
+  })
+
+  return {
+    stats,
+    /** Nội dung file đã ghép (để kiểm tra byte-by-byte) */
+    getFile(fileId) {
+      return files.get(fileId) || null
+    },
+    /** Xoá phiên như khi hết hạn trên backend: request sau nhận 404 */
+    expireSession(uploadId) {
+      return sessions.delete(uploadId)
+    },
+    sessionIds() {
+      return Array.from(sessions.keys())
+    },
+    listen(port = 0, host = '127.0.0.1') {
+      return new Promise((resolve) => {
+        server.listen(port, host, () => {
+          const address = server.address()
+          resolve(`http://${host}:${address.port}`)
+        })
+      })
+    },
+    close() {
+      const closed = new Promise((resolve) => server.close(() => resolve()))
+      server.closeAllConnections()
+      return closed
+    },
+  }
+}
+
+module.exports = { createLocalUploadServer }
+
+if (require.main === module) {
+  const arg = (name, fallback) => {
+    const i = process.argv.indexOf(name)
+    return i !== -1 ? Number(process.argv[i + 1]) : fallback
+  }
+  const server = createLocalUploadServer({
+    failRate: arg('--fail-rate', 0),
+    corruptRate: arg('--corrupt-rate', 0),
+    latencyMs: arg('--latency', 0),
+  })
+  server.listen(arg('--port', 5298)).then((url) => {
+    console.log(`[LocalUploadServer] Listening on ${url}/api/uploads`)
+    setInterval(() => console.log('[LocalUploadServer]', server.stats), 10000)
+  })
+}
@@ -0,0 +1,303 @@
+/**
+ * Upload Smoke Test - chạy ResumableUploader với adapter Node trên localUploadServer
+ *
+ * Kịch bản:
+ *   1. flaky    - nhiều file song song, server trả 503 / hỏng chunk ngẫu nhiên
+ *   2. restart  - "app" dừng giữa chừng, uploader mới cùng storage gọi resumePending()
+ *                 và chỉ tải phần server chưa nhận
+ *   3. expired  - phiên bị xoá trên server giữa chừng (404) -> tạo lại phiên, tải lại
+ *   4. outbox   - thao tác durable trong OfflineOutbox, app dừng giữa lúc tải ảnh; lần chạy sau
+ *                 upload có owner tiếp tục, upload không owner bị bỏ, thao tác gửi lại dùng đúng
+ *                 fileId đã tải (không tải lại từ đầu)
+ * Mỗi kịch bản so khớp byte file server ghép được với file gốc.
+ *
+ * Chạy:
+ *   npx tsx scripts/uploads/uploadSmokeTest.ts --size 3000000 --files 4 --fail-rate 0.15
+ *
+ * Tham số:
+ *   --size BYTES        Kích thước mỗi file (default 2500000)
+ *   --files N           Số file ở kịch bản flaky (default 3)
+ *   --chunk BYTES       Kích thước chunk (default 262144)
+ *   --fail-rate F       Tỷ lệ PUT chunk trả 503 (default 0.15)
+ *   --corrupt-rate F    Tỷ lệ chunk hỏng trên đường truyền (default 0.05)
+ *   --server-url URL    Dùng server ngoài thay vì stand-in (bỏ qua kịch bản expired)
+ */
+
+import * as crypto from 'crypto';
+import * as fs from 'fs';
+import * as os from 'os';
+import * as path from 'path';
+import {
+  ResumableUploader,
+  UploadAdapters,
+  UploadHttpError,
+  UploadSessionInfo,
+  UploadSlot,
+  UploadTransport,
+} from '@/utils/resumableUpload';
+import { OfflineOutbox } from '@/utils/offlineOutbox';
+
+// eslint-disable-next-line @typescript-eslint/no-var-requires
+const { createLocalUploadServer } = require('./localUploadServer');
+
+interface SmokeOptions {
+  size: number;
+  files: number;
+  chunkSize: number;
+  failRate: number;
+  corruptRate: number;
+  serverUrl?: string;
+}
+
+const parseArgs = (argv: string[]): SmokeOptions => {
+  const get = (name: string) => {
+    const idx = argv.indexOf(`--${name}`);
+    return idx !== -1 ? argv[idx + 1] : undefined;
+  };
+  const num = (name: string, fallback: number) => {
+    const raw = get(name);
+    const value = raw !== undefined ? Number(raw) : NaN;
+    return Number.isFinite(value) ? value : fallback;
+  };
+  return {
+    size: num('size', 2500000),
+    files: num('files', 3),
+    chunkSize: num('chunk', 256 * 1024),
+    failRate: num('fail-rate', 0.15),
+    corruptRate: num('corrupt-rate', 0.05),
+    serverUrl: get('server-url'),
+  };
+};
+
+// ============ NODE ADAPTERS ============
+
+const memoryStorage = () => {
+  const data = new Map<string, string>();
+  return {
+    data,
+    getItem: async (key: string) => data.get(key) ?? null,
+    setItem: async (key: string, value: string) => {
+      data.set(key, value);
+    },
+  };
+};
+
+const fetchTransport = (baseUrl: string): UploadTransport => {
+  const call = async <T>(method: string, url: string, body?: any, headers?: Record<string, string>): Promise<T> => {
+    let resp: Response;
+    try {
+      resp = await fetch(`${baseUrl}${url}`, { method, body, headers });
+    } catch (e: any) {
+      throw new Error(`Network error: ${e?.message}`);
+    }
+    const text = await resp.text();
+    if (!resp.ok) throw new UploadHttpError(`${method} ${url} -> ${resp.status} ${text}`, resp.status);
+    return (text ? JSON.parse(text) : undefined) as T;
+  };
+  const jsonHeaders = { 'Content-Type': 'application/json' };
+  return {
+    createSession: (body) => call<UploadSessionInfo>('POST', '/api/uploads', JSON.stringify(body), jsonHeaders),
+    getSession: (uploadId) => call<UploadSessionInfo>('GET', `/api/uploads/${uploadId}`),
+    putChunk: (uploadId, index, bytes, sha256) =>
+      call<void>('PUT', `/api/uploads/${uploadId}/chunks/${index}`, bytes, {
+        'Content-Type': 'application/octet-stream',
+        'X-Chunk-Sha256': sha256,
+      }),
+    complete: (uploadId, body) =>
+      call('POST', `/api/uploads/${uploadId}/complete`, JSON.stringify(body), jsonHeaders),
+  };
+};
+
+const nodeAdapters = (
+  storage: UploadAdapters['storage'],
+  transport: UploadTransport
+): UploadAdapters => ({
+  storage,
+  async fileSize(uri) {
+    try {
+      return (await fs.promises.stat(uri)).size;
+    } catch {
+      return -1;
+    }
+  },
+  async readChunk(uri, offset, length) {
+    const handle = await fs.promises.open(uri, 'r');
+    try {
+      const buffer = Buffer.alloc(length);
+      const { bytesRead } = await handle.read(buffer, 0, length, offset);
+      return new Uint8Array(buffer.buffer, buffer.byteOffset, bytesRead);
+    } finally {
+      await handle.close();
+    }
+  },
+  async sha256Hex(data) {
+    return crypto.createHash('sha256').update(data).digest('hex');
+  },
+  transport,
+});
+
+/** Transport treo vĩnh viễn sau `limit` chunk thành công: giả lập app bị tắt giữa chừng */
+const haltingTransport = (inner: UploadTransport, limit: number): UploadTransport => {
+  let accepted = 0;
+  return {
+    ...inner,
+    async putChunk(uploadId, index, bytes, sha256) {
+      if (accepted >= limit) return new Promise<void>(() => {});
+      await inner.putChunk(uploadId, index, bytes, sha256);
+      accepted++;
+    },
+  };
+};
+
+// ============ SCENARIOS ============
+
+const makeFile = (dir: string, name: string, size: number) => {
+  const file = path.join(dir, name);
+  fs.writeFileSync(file, crypto.randomBytes(size));
+  return file;
+};
+
+const assertSameBytes = (server: any, fileId: string, file: string) => {
+  if (!server) return;
+  const stored = server.getFile(fileId);
+  if (!stored || !Buffer.from(stored.data).equals(fs.readFileSync(file))) {
+    throw new Error(`File ${path.basename(file)} ghép trên server không khớp bản gốc`);
+  }
+};
+
+const waitUntil = async (check: () => boolean, timeoutMs = 10000) => {
+  const deadline = Date.now() + timeoutMs;
+  while (!check()) {
+    if (Date.now() > deadline) throw new Error('Hết thời gian chờ');
+    await new Promise((resolve) => setTimeout(resolve, 20));
+  }
+};
+
+async function runSmokeTest(options: SmokeOptions) {
+  const server = options.serverUrl
+    ? null
+    : createLocalUploadServer({ failRate: options.failRate, corruptRate: options.corruptRate });
+  const baseUrl = options.serverUrl ?? (await server.listen());
+  const dir = fs.mkdtempSync(path.join(os.tmpdir(), 'upload-smoke-'));
+  const uploaderOptions = { chunkSize: options.chunkSize, retryBaseMs: 20, maxChunkAttempts: 8 };
+  const report: Record<string, any> = { baseUrl, options };
+
+  try {
+    // 1. flaky
+    {
+      const uploader = new ResumableUploader(nodeAdapters(memoryStorage(), fetchTransport(baseUrl)), uploaderOptions);
+      const files = Array.from({ length: options.files }, (_, i) => makeFile(dir, `flaky-${i}.bin`, options.size));
+      const startedAt = Date.now();
+      const results = await Promise.all(
+        files.map((file) =>
+          uploader.upload({ uri: file, fileName: path.basename(file), mimeType: 'application/octet-stream' })
+        )
+      );
+      results.forEach((result, i) => assertSameBytes(server, result.fileId, files[i]));
+      report.flaky = { ms: Date.now() - startedAt, uploader: uploader.getStats() };
+    }
+
+    // 2. restart
+    {
+      const storage = memoryStorage();
+      const file = makeFile(dir, 'restart.bin', options.size);
+      const input = { uri: file, fileName: 'restart.bin', mimeType: 'application/octet-stream' };
+      const chunkCount = Math.ceil(options.size / options.chunkSize);
+      const first = new ResumableUploader(
+        nodeAdapters(storage, haltingTransport(fetchTransport(baseUrl), Math.floor(chunkCount / 2))),
+        uploaderOptions
+      );
+      const id = await first.enqueue(input);
+      await waitUntil(() => (first.getProgress(id)?.chunksDone ?? 0) >= Math.floor(chunkCount / 2));
+      // Chờ lần ghi trạng thái cuối (persist gộp, chạy nối tiếp)
+      await new Promise((resolve) => setTimeout(resolve, 50));
+
+      const second = new ResumableUploader(nodeAdapters(storage, fetchTransport(baseUrl)), uploaderOptions);
+      const resumed = await second.resumePending();
+      const result = await second.waitFor(id);
+      assertSameBytes(server, result.fileId, file);
+      const stats = second.getStats();
+      if (resumed !== 1 || stats.chunksSkipped === 0) throw new Error('Khởi động lại không tiếp tục từ chunk đã tải');
+      report.restart = { resumed, chunkCount, uploader: stats };
+    }
+
+    // 3. expired
+    if (server) {
+      const file = makeFile(dir, 'expired.bin', options.size);
+      const uploader = new ResumableUploader(nodeAdapters(memoryStorage(), fetchTransport(baseUrl)), uploaderOptions);
+      const id = await uploader.enqueue({ uri: file, fileName: 'expired.bin', mimeType: 'application/octet-stream' });
+      await waitUntil(() => (uploader.getProgress(id)?.chunksDone ?? 0) >= 2);
+      const before = new Set<string>(server.sessionIds());
+      before.forEach((uploadId) => server.expireSession(uploadId));
+      const result = await uploader.waitFor(id);
+      assertSameBytes(server, result.fileId, file);
+      report.expired = { expiredSessions: before.size, uploader: uploader.getStats() };
+    }
+
+    // 4. outbox
+    {
+      const storage = memoryStorage();
+      const file = makeFile(dir, 'outbox.bin', options.size);
+      const orphan = makeFile(dir, 'orphan.bin', options.size);
+      const input = { uri: file, fileName: 'outbox.bin', mimeType: 'application/octet-stream' };
+      const chunkCount = Math.ceil(options.size / options.chunkSize);
+      const submitted: { fileId: string; replay: boolean }[] = [];
+      // Như driverOutboxService: slot ảnh nằm trong entry, owner = id entry
+      const createOutbox = (uploader: ResumableUploader) => {
+        const outbox = new OfflineOutbox({ storage, isRetryable: () => true });
+        outbox.register<{ note: string }>('submitForm', async (_payload, ctx) => {
+          const slot: UploadSlot = {
+            owner: ctx.entryId!,
+            get: () => ctx.resume.photo,
+            set: (state) => ctx.saveResume('photo', state),
+          };
+          const result = await uploader.uploadInSlot(slot, async () => input);
+          submitted.push({ fileId: result!.fileId, replay: ctx.replay });
+          return { ok: true };
+        });
+        return outbox;
+      };
+
+      const first = new ResumableUploader(
+        nodeAdapters(storage, haltingTransport(fetchTransport(baseUrl), Math.floor(chunkCount / 2))),
+        uploaderOptions
+      );
+      // Form chỉ sống trong bộ nhớ (không owner): lần chạy sau phải bỏ
+      await first.enqueue({ uri: orphan, fileName: 'orphan.bin', mimeType: 'application/octet-stream' });
+      // Treo giữa chừng: không bao giờ xong ở lần chạy này
+      createOutbox(first).submit('submitForm', { note: 'restart' }, { scope: 'form', durable: true });
+      await waitUntil(() => first.getStats().chunksUploaded >= Math.floor(chunkCount / 2));
+      await new Promise((resolve) => setTimeout(resolve, 50));
+
+      const second = new ResumableUploader(nodeAdapters(storage, fetchTransport(baseUrl)), uploaderOptions);
+      const discarded = await second.discardPending((owner) => !owner);
+      const resumed = await second.resumePending();
+      const outbox = createOutbox(second);
+      await outbox.drain();
+
+      const stats = second.getStats();
+      if (discarded !== 1 || resumed !== 1) throw new Error(`Khởi động lại: bỏ ${discarded}, tiếp tục ${resumed} (cần 1/1)`);
+      if (submitted.length !== 1 || !submitted[0].replay || outbox.getSnapshot().depth !== 0) {
+        throw new Error('Thao tác trong outbox không được gửi lại đúng 1 lần');
+      }
+      if (stats.chunksSkipped === 0 || stats.filesStarted !== 1) throw new Error('Thao tác gửi lại tải ảnh từ đầu');
+      assertSameBytes(server, submitted[0].fileId, file);
+      report.outbox = { discarded, resumed, chunkCount, uploader: stats };
+    }
+
+    report.server = server ? server.stats : null;
+    console.log('\n===== Upload smoke test report =====');
+    console.log(JSON.stringify(report, null, 2));
+    console.log('[UploadSmoke] OK');
+  } finally {
+    fs.rmSync(dir, { recursive: true, force: true });
+    await server?.close();
+  }
+}
+
+runSmokeTest(parseArgs(process.argv.slice(2)))
+  .then(() => process.exit(0))
+  .catch((error) => {
+    console.error('[UploadSmoke] Failed:', error);
+    process.exit(1);
+  });
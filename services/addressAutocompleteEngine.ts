@@ -0,0 +1,401 @@
+import AsyncStorage from '@react-native-async-storage/async-storage'
+import vietmapAutocompleteService, { AutocompleteParams } from '@/services/vietmapAutocompleteService'
+import { PrefixTrie, foldVietnamese } from '@/utils/prefixTrie'
+
+/**
+ * Address Autocomplete Engine
+ *
+ * - Lịch sử địa chỉ đã chọn (gần đây + hay dùng) nằm trong prefix trie trên máy,
+ *   trả gợi ý ngay ở keystroke mà không chờ mạng
+ * - Request mạng: debounce, AbortController huỷ request cũ, sequence fencing để
+ *   response đến trễ không ghi đè gợi ý mới hơn
+ * - Cache LRU theo text đã fold (gõ lùi / gõ lại không tốn request)
+ * - Thống kê: độ trễ keystroke -> gợi ý (local và mạng), số request tiết kiệm được
+ */
+
+export type Suggestion = any
+
+export interface AutocompleteState {
+  query: string
+  suggestions: Suggestion[]
+  loading: boolean
+}
+
+export interface AutocompleteSessionOptions {
+  displayType?: number
+  focus?: { lat: number; lng: number }
+  debounceMs?: number // default 300
+  minNetworkChars?: number // default 2
+  limit?: number // default 8
+}
+
+export interface AutocompleteStats {
+  keystrokes: number
+  localHits: number // keystroke có gợi ý local ngay
+  requestsSent: number
+  requestsAborted: number
+  staleResponsesDropped: number
+  cacheHits: number
+  debouncedKeystrokes: number // keystroke bị gộp bởi debounce
+  requestsSaved: number // keystrokes - requestsSent
+  localLatencyP50Ms: number
+  localLatencyP95Ms: number
+  networkLatencyP50Ms: number
+  networkLatencyP95Ms: number
+}
+
+type CounterName =
+  | 'keystrokes'
+  | 'localHits'
+  | 'requestsSent'
+  | 'requestsAborted'
+  | 'staleResponsesDropped'
+  | 'cacheHits'
+  | 'debouncedKeystrokes'
+
+interface HistoryEntry {
+  key: string
+  suggestion: Suggestion
+  count: number
+  lastUsed: number
+}
+
+const HISTORY_KEY = '@address_history_v1'
+const HISTORY_MAX = 200
+const CACHE_MAX = 100
+const LATENCY_SAMPLES = 200
+const DAY_MS = 24 * 60 * 60 * 1000
+
+const nowMs = (): number =>
+  typeof performance !== 'undefined' && typeof performance.now === 'function' ? performance.now() : Date.now()
+
+const suggestionKey = (s: Suggestion): string =>
+  String(s?.ref_id ?? s?.refId ?? foldVietnamese(s?.display || s?.name || s?.address || ''))
+
+const suggestionText = (s: Suggestion): string =>
+  [s?.name, s?.display, s?.address].filter(Boolean).join(' ')
+
+const percentile = (samples: number[], p: number): number => {
+  if (samples.length === 0) return 0
+  const sorted = samples.slice().sort((a, b) => a - b)
+  return sorted[Math.min(sorted.length - 1, Math.floor((p / 100) * sorted.length))]
+}
+
+class AddressAutocompleteEngine {
+  private trie = new PrefixTrie()
+  private history = new Map<string, HistoryEntry>()
+  private loadPromise: Promise<void> | null = null
+  private persistTimer: ReturnType<typeof setTimeout> | null = null
+  // Map giữ thứ tự chèn => LRU đơn giản
+  private cache = new Map<string, Suggestion[]>()
+
+  private localLatencies: number[] = []
+  private networkLatencies: number[] = []
+  private counters: Record<CounterName, number> = {
+    keystrokes: 0,
+    localHits: 0,
+    requestsSent: 0,
+    requestsAborted: 0,
+    staleResponsesDropped: 0,
+    cacheHits: 0,
+    debouncedKeystrokes: 0,
+  }
+
+  /** Nạp lịch sử từ AsyncStorage (1 lần, gọi nhiều lần an toàn) */
+  init(): Promise<void> {
+    if (!this.loadPromise) {
+      this.loadPromise = (async () => {
+        try {
+          const raw = await AsyncStorage.getItem(HISTORY_KEY)
+          const entries: HistoryEntry[] = raw ? JSON.parse(raw) : []
+          for (const entry of entries) {
+            this.history.set(entry.key, entry)
+            this.trie.insert(entry.key, suggestionText(entry.suggestion))
+          }
+        } catch (e) {
+          console.warn('[AddressAutocomplete] load history failed', e)
+        }
+      })()
+    }
+    return this.loadPromise
+  }
+
+  /** Gợi ý từ lịch sử, xếp theo tần suất + độ mới (frecency) */
+  searchLocal(text: string, limit: number = 5): Suggestion[] {
+    const ids = this.trie.search(text, limit * 4)
+    if (ids.length === 0) return []
+    const now = Date.now()
+    return ids
+      .map((id) => this.history.get(id)!)
+      .filter(Boolean)
+      .map((e) => ({ e, score: e.count / (1 + (now - e.lastUsed) / (7 * DAY_MS)) }))
+      .sort((a, b) => b.score - a.score)
+      .slice(0, limit)
+      .map(({ e }) => ({ ...e.suggestion, fromHistory: true }))
+  }
+
+  /** Ghi nhận địa chỉ người dùng đã chọn */
+  recordSelection(suggestion: Suggestion): void {
+    if (!suggestion) return
+    const key = suggestionKey(suggestion)
+    if (!key) return
+    const { fromHistory, ...clean } = suggestion
+    const existing = this.history.get(key)
+    if (existing) {
+      existing.count++
+      existing.lastUsed = Date.now()
+      existing.suggestion = clean
+    } else {
+      this.history.set(key, { key, suggestion: clean, count: 1, lastUsed: Date.now() })
+      this.trie.insert(key, suggestionText(clean))
+      this.evictHistory()
+    }
+    this.schedulePersist()
+  }
+
+  async clearHistory(): Promise<void> {
+    this.history.clear()
+    this.trie.clear()
+    try {
+      await AsyncStorage.removeItem(HISTORY_KEY)
+    } catch {}
+  }
+
+  createSession(
+    options: AutocompleteSessionOptions,
+    onUpdate: (state: AutocompleteState) => void
+  ): AutocompleteSession {
+    this.init()
+    return new AutocompleteSession(this, options, onUpdate)
+  }
+
+  getStats(): AutocompleteStats {
+    const c = this.counters
+    return {
+      ...c,
+      requestsSaved: Math.max(0, c.keystrokes - c.requestsSent),
+      localLatencyP50Ms: percentile(this.localLatencies, 50),
+      localLatencyP95Ms: percentile(this.localLatencies, 95),
+      networkLatencyP50Ms: percentile(this.networkLatencies, 50),
+      networkLatencyP95Ms: percentile(this.networkLatencies, 95),
+    }
+  }
+
+  // ============ INTERNAL (dùng bởi AutocompleteSession) ============
+
+  /** @internal */
+  count(name: CounterName): void {
+    this.counters[name]++
+  }
+
+  /** @internal */
+  sampleLatency(kind: 'local' | 'network', ms: number): void {
+    const arr = kind === 'local' ? this.localLatencies : this.networkLatencies
+    arr.push(ms)
+    if (arr.length > LATENCY_SAMPLES) arr.shift()
+  }
+
+  /** @internal */
+  cacheGet(key: string): Suggestion[] | undefined {
+    const hit = this.cache.get(key)
+    if (hit) {
+      this.cache.delete(key)
+      this.cache.set(key, hit)
+    }
+    return hit
+  }
+
+  /** @internal */
+  cacheSet(key: string, value: Suggestion[]): void {
+    this.cache.delete(key)
+    this.cache.set(key, value)
+    if (this.cache.size > CACHE_MAX) {
+      this.cache.delete(this.cache.keys().next().value as string)
+    }
+  }
+
+  private evictHistory() {
+    if (this.history.size <= HISTORY_MAX) return
+    // Bỏ entry ít giá trị nhất (cũ + ít dùng)
+    let worstKey: string | null = null
+    let worstScore = Infinity
+    const now = Date.now()
+    for (const e of Array.from(this.history.values())) {
+      const score = e.count / (1 + (now - e.lastUsed) / (7 * DAY_MS))
+      if (score < worstScore) {
+        worstScore = score
+        worstKey = e.key
+      }
+    }
+    if (worstKey) {
+      this.history.delete(worstKey)
+      this.trie.remove(worstKey)
+    }
+  }
+
+  private schedulePersist() {
+    if (this.persistTimer) clearTimeout(this.persistTimer)
+    this.persistTimer = setTimeout(() => {
+      this.persistTimer = null
+      AsyncStorage.setItem(HISTORY_KEY, JSON.stringify(Array.from(this.history.values()))).catch((e) =>
+        console.warn('[AddressAutocomplete] persist history failed', e)
+      )
+    }, 500)
+  }
+}
+
+/**
+ * Phiên autocomplete cho 1 ô nhập. Mỗi keystroke tăng seq; chỉ response có seq
+ * mới nhất được áp dụng, request cũ bị abort.
+ */
+export class AutocompleteSession {
+  private seq = 0
+  private controller: AbortController | null = null
+  private timer: ReturnType<typeof setTimeout> | null = null
+  private local: Suggestion[] = []
+  private disposed = false
+
+  constructor(
+    private engine: AddressAutocompleteEngine,
+    private options: AutocompleteSessionOptions,
+    private onUpdate: (state: AutocompleteState) => void
+  ) {}
+
+  setOptions(options: AutocompleteSessionOptions): void {
+    this.options = options
+  }
+
+  input(text: string): void {
+    if (this.disposed) return
+    const startedAt = nowMs()
+    const seq = ++this.seq
+    this.engine.count('keystrokes')
+    if (this.timer) {
+      clearTimeout(this.timer)
+      this.timer = null
+      this.engine.count('debouncedKeystrokes')
+    }
+    this.abortInFlight()
+
+    const trimmed = (text || '').trim()
+    const limit = this.options.limit ?? 8
+    if (!trimmed) {
+      this.local = []
+      this.onUpdate({ query: text, suggestions: [], loading: false })
+      return
+    }
+
+    // 1. Local: trả ngay trong cùng keystroke
+    this.local = this.engine.searchLocal(trimmed, Math.min(5, limit))
+    if (this.local.length > 0) {
+      this.engine.count('localHits')
+      this.engine.sampleLatency('local', nowMs() - startedAt)
+    }
+
+    const cacheKey = this.cacheKey(trimmed)
+    const cached = this.engine.cacheGet(cacheKey)
+    if (cached) {
+      this.engine.count('cacheHits')
+      this.engine.sampleLatency('network', nowMs() - startedAt)
+      this.onUpdate({ query: text, suggestions: this.merge(cached), loading: false })
+      return
+    }
+
+    const needsNetwork = foldVietnamese(trimmed).length >= (this.options.minNetworkChars ?? 2)
+    this.onUpdate({ query: text, suggestions: this.local, loading: needsNetwork })
+    if (!needsNetwork) return
+
+    // 2. Mạng: debounce rồi gửi, kèm signal để huỷ được
+    this.timer = setTimeout(() => {
+      this.timer = null
+      this.fetchRemote(text, trimmed, cacheKey, seq, startedAt)
+    }, this.options.debounceMs ?? 300)
+  }
+
+  cancel(): void {
+    if (this.timer) {
+      clearTimeout(this.timer)
+      this.timer = null
+    }
+    this.abortInFlight()
+    this.seq++
+  }
+
+  /** Người dùng chọn 1 gợi ý: ghi lịch sử và dừng mọi request đang chờ */
+  select(suggestion: Suggestion): void {
+    this.cancel()
+    this.engine.recordSelection(suggestion)
+  }
+
+  dispose(): void {
+    this.cancel()
+    this.disposed = true
+  }
+
+  // ============ PRIVATE METHODS ============
+
+  private async fetchRemote(text: string, trimmed: string, cacheKey: string, seq: number, startedAt: number) {
+    const controller = typeof AbortController !== 'undefined' ? new AbortController() : null
+    this.controller = controller
+    this.engine.count('requestsSent')
+    const params: AutocompleteParams = {
+      text: trimmed,
+      display_type: this.options.displayType,
+      focus: this.options.focus,
+    }
+    try {
+      const res = await vietmapAutocompleteService.autocomplete(params, { signal: controller?.signal })
+      if (this.controller === controller) this.controller = null
+      const results = res || []
+      this.engine.cacheSet(cacheKey, results)
+      // Fencing: response của keystroke cũ không được ghi đè
+      if (seq !== this.seq || this.disposed) {
+        this.engine.count('staleResponsesDropped')
+        return
+      }
+      this.engine.sampleLatency('network', nowMs() - startedAt)
+      this.onUpdate({ query: text, suggestions: this.merge(results), loading: false })
+    } catch (e) {
+      if (this.controller === controller) this.controller = null
+      if (vietmapAutocompleteService.isAbortError(e)) return
+      // Không cache lỗi: gõ lại cùng chuỗi sẽ thử mạng lần nữa
+      console.warn('[AddressAutocomplete] remote failed', e)
+      if (seq === this.seq && !this.disposed) {
+        this.onUpdate({ query: text, suggestions: this.local, loading: false })
+      }
+    }
+  }
+
+  private abortInFlight() {
+    if (!this.controller) return
+    this.controller.abort()
+    this.controller = null
+    this.engine.count('requestsAborted')
+  }
+
+  // Lịch sử lên đầu, kết quả mạng theo sau, bỏ trùng
+  private merge(remote: Suggestion[]): Suggestion[] {
+    const limit = this.options.limit ?? 8
+    const seen = new Set<string>()
+    const out: Suggestion[] = []
+    for (const s of this.local.concat(remote)) {
+      const key = suggestionKey(s)
+      if (seen.has(key)) continue
+      seen.add(key)
+      out.push(s)
+      if (out.length >= limit) break
+    }
+    return out
+  }
+
+  private cacheKey(trimmed: string): string {
+    const f = this.options.focus
+    // Làm tròn focus ~1km để cache vẫn trúng khi vị trí xê dịch nhẹ
+    const focusKey = f ? `${f.lat.toFixed(2)},${f.lng.toFixed(2)}` : ''
+    return `${this.options.displayType ?? ''}|${focusKey}|${foldVietnamese(trimmed)}`
+  }
+}
+
+export const addressAutocompleteEngine = new AddressAutocompleteEngine()
+
+export default addressAutocompleteEngine
@@ -1,6 +1,8 @@
-import api from "@/config/api";
+import api, { idempotencyHeaders } from "@/config/api";
 import { Platform } from "react-native";
 import * as FileSystem from "expo-file-system/legacy";
+import resumableUploadService from "@/services/resumableUploadService";
+import type { UploadSlot, UploadSlots } from "@/utils/resumableUpload";
 
 export interface CreateAssignmentPayload {
   tripId: string
@@ -43,7 +45,8 @@ const ensureFileName = (value: string | undefined, fallback: string) => {
 const appendEvidenceImage = async (
   formData: FormData,
   evidenceImage: any,
-  fallbackPrefix: string
+  fallbackPrefix: string,
+  slot?: UploadSlot
 ) => {
   const uri: string | undefined = evidenceImage?.imageURL || evidenceImage?.uri;
   if (!uri) throw new Error("Invalid image format");
@@ -56,6 +59,13 @@ const appendEvidenceImage = async (
   );
   if (!fileName.includes(".")) fileName = `${fileName}.${ext}`;
 
+  // Backend có /api/uploads: ảnh tải theo chunk (có tiến độ), form chỉ mang EvidenceImageUploadId
+  if (resumableUploadService.isEnabled()) {
+    const appended = await resumableUploadService.appendImage(formData, "EvidenceImage", evidenceImage, "evidence", fileName, slot);
+    if (!appended) throw new Error("Invalid image format");
+    return;
+  }
+
   if (uri.startsWith("data:")) {
     if (Platform.OS === "web") {
       const resp = await fetch(uri);
@@ -127,6 +137,19 @@ const appendEvidenceImage = async (
   throw new Error("Unsupported image URI");
 };
 
+/**
+ * Lỗi HTTP của check-in/check-out: ResponseDTO nghiệp vụ (4xx) trả về để màn hình hiển thị;
+ * 5xx/408/429 hoặc body không phải DTO (trang lỗi HTML/text của gateway) thì ném lại
+ * để nơi gọi (driverOutboxService) quyết định thử lại theo HTTP status thật.
+ */
+const errorResponseDTO = (e: any) => {
+  const status = e?.response?.status
+  const data = e?.response?.data
+  if (typeof status !== 'number' || status >= 500 || status === 408 || status === 429) return null
+  if (!data || typeof data !== 'object' || !('isSuccess' in data || 'statusCode' in data)) return null
+  return data
+}
+
 const assignmentService = {
   async assignDriverByOwner(payload: CreateAssignmentPayload) {
     try {
@@ -182,7 +205,7 @@ const assignmentService = {
     }
   }
   ,
-  async driverCheckIn(tripId: string, latitude: number, longitude: number, currentAddress: string, evidenceImage: any) {
+  async driverCheckIn(tripId: string, latitude: number, longitude: number, currentAddress: string, evidenceImage: any, idempotencyKey?: string, uploads?: UploadSlots) {
     try {
       const formData = new FormData()
       formData.append('TripId', tripId)
@@ -190,19 +213,20 @@ const assignmentService = {
       formData.append('Longitude', String(longitude))
       if (currentAddress) formData.append('CurrentAddress', currentAddress)
 
-      await appendEvidenceImage(formData, evidenceImage, "checkin");
+      await appendEvidenceImage(formData, evidenceImage, "checkin", uploads?.("EvidenceImage"));
       
       const res = await api.post('api/TripDriverAssignments/check-in', formData, {
-        headers: { 'Content-Type': 'multipart/form-data' }
+        headers: { 'Content-Type': 'multipart/form-data', ...idempotencyHeaders(idempotencyKey) }
       })
       return res.data
     } catch (e: any) {
-      if (e?.response?.data) return e.response.data
+      const dto = errorResponseDTO(e)
+      if (dto) return dto
       throw e
     }
   },
 
-  async driverCheckOut(tripId: string, latitude: number, longitude: number, currentAddress: string, evidenceImage: any) {
+  async driverCheckOut(tripId: string, latitude: number, longitude: number, currentAddress: string, evidenceImage: any, idempotencyKey?: string, uploads?: UploadSlots) {
     try {
       const formData = new FormData()
       formData.append('TripId', tripId)
@@ -210,14 +234,15 @@ const assignmentService = {
       formData.append('Longitude', String(longitude))
       if (currentAddress) formData.append('CurrentAddress', currentAddress)
 
-      await appendEvidenceImage(formData, evidenceImage, "checkout");
+      await appendEvidenceImage(formData, evidenceImage, "checkout", uploads?.("EvidenceImage"));
       
       const res = await api.post('api/TripDriverAssignments/check-out', formData, {
-        headers: { 'Content-Type': 'multipart/form-data' }
+        headers: { 'Content-Type': 'multipart/form-data', ...idempotencyHeaders(idempotencyKey) }
       })
       return res.data
     } catch (e: any) {
-      if (e?.response?.data) return e.response.data
+      const dto = errorResponseDTO(e)
+      if (dto) return dto
       throw e
     }
   }
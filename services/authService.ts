@@ -1,7 +1,7 @@
 // src/services/authService.ts
-import api from "@/config/api";
+import api, { apiPublic } from "@/config/api";
 import { jwtDecode } from "jwt-decode";
-import { setToken, removeToken } from "@/utils/token";
+import { setToken, removeToken, setTokenRefresher } from "@/utils/token";
 import { ResponseDTO, AuthenticatedUser, Role } from "@/models/types";
 
 interface DecodedToken {
@@ -11,6 +11,24 @@ interface DecodedToken {
   exp?: number;
 }
 
+// Backend chưa có /api/auth/refresh-token: chỉ bật khi build với EXPO_PUBLIC_TOKEN_REFRESH=true,
+// không thì mỗi phiên bắn request lỗi trong 2 phút cuối trước khi token hết hạn
+const TOKEN_REFRESH_ENABLED = process.env.EXPO_PUBLIC_TOKEN_REFRESH === "true";
+
+// Làm mới access token bằng refresh token (gọi qua apiPublic: không qua interceptor gắn token)
+if (TOKEN_REFRESH_ENABLED) {
+  setTokenRefresher(async (refreshToken, accessToken) => {
+    const response = await apiPublic.post<ResponseDTO>("/api/auth/refresh-token", {
+      accessToken,
+      refreshToken,
+    });
+    const result = response.data?.isSuccess ? response.data.result : null;
+    return result?.accessToken
+      ? { accessToken: result.accessToken, refreshToken: result.refreshToken }
+      : null;
+  });
+}
+
 export const authService = {
   login: async (
     credentials: { email: string; password: string },
@@ -38,7 +56,7 @@ export const authService = {
       } catch (e) {
         console.warn("[authService] removeToken warning", e);
       }
-      await setToken(accessToken);
+      await setToken(accessToken, refreshToken);
 
       // Đồng thời set header mặc định cho axios instance để chắc chắn request tiếp theo dùng token mới
       try {
@@ -0,0 +1,407 @@
+/**
+ * Change Feed Service
+ * Kênh đẩy thay đổi từ server qua connection SignalR sẵn có, thay cho các vòng polling
+ *
+ * - Server gửi hub method "ReceiveChange" với payload { type, ... } (xem ChangeEvent).
+ * - Mỗi sự kiện invalidate tag tương ứng trong requestCache và cập nhật store,
+ *   sau đó báo cho các subscriber (màn hình tự quyết định có fetch lại hay không).
+ * - Poller chỉ chạy khi mất kết nối, giãn dần (back-off) nếu không có gì mới;
+ *   khi kết nối lại chạy bù 1 lần để không lỡ thay đổi trong lúc mất kết nối.
+ * - getStats() so sánh số request polling thực tế với số request mà vòng
+ *   setInterval cũ sẽ gửi trong cùng khoảng thời gian.
+ */
+
+import { signalRTrackingService } from '@/services/signalRTrackingService';
+import { requestCache } from '@/config/requestCache';
+import { getEntity, useEntityStore } from '@/stores/entityStore';
+import { useNotificationStore } from '@/stores/notificationStore';
+
+export const CHANGE_HUB_METHOD = 'ReceiveChange';
+
+export interface TripStatusChangedEvent {
+  type: 'TripStatusChanged';
+  tripId: string;
+  status: string;
+}
+
+export interface AssignmentChangedEvent {
+  type: 'AssignmentChanged';
+  tripId: string;
+  assignmentId?: string;
+  driverId?: string;
+  status?: string;
+}
+
+export interface NotificationCreatedEvent {
+  type: 'NotificationCreated';
+  unreadCount?: number;
+}
+
+export interface WalletChangedEvent {
+  type: 'WalletChanged';
+  balance?: number;
+}
+
+export type ChangeEvent =
+  | TripStatusChangedEvent
+  | AssignmentChangedEvent
+  | NotificationCreatedEvent
+  | WalletChangedEvent;
+
+export type ChangeEventType = ChangeEvent['type'];
+
+type ChangeHandler<T extends ChangeEventType> = (event: Extract<ChangeEvent, { type: T }>) => void;
+
+export interface PollerOptions {
+  /** Chu kỳ đầu khi mất kết nối (ms) */
+  baseMs: number;
+  /** Chu kỳ tối đa sau khi giãn (ms) */
+  maxMs: number;
+  /** Chu kỳ của vòng setInterval cũ, chỉ dùng để ước lượng số request tiết kiệm */
+  legacyIntervalMs?: number;
+}
+
+/** Trả true nếu lần poll thấy dữ liệu mới (đặt lại chu kỳ về baseMs) */
+type PollFn = () => Promise<boolean | void> | boolean | void;
+
+interface Poller extends PollerOptions {
+  name: string;
+  fn: PollFn;
+  delayMs: number;
+  timer: ReturnType<typeof setTimeout> | null;
+  running: boolean;
+}
+
+const EVENT_TAGS: Record<ChangeEventType, string[]> = {
+  TripStatusChanged: ['trip'],
+  AssignmentChanged: ['trip', 'assignment'],
+  NotificationCreated: ['notification'],
+  WalletChanged: ['wallets'],
+};
+
+const BACKOFF_FACTOR = 1.5;
+const RECONNECT_BASE_MS = 5 * 1000;
+const RECONNECT_MAX_MS = 2 * 60 * 1000;
+
+// Server .NET có thể serialize PascalCase
+const pick = (raw: any, key: string) => raw?.[key] ?? raw?.[key.charAt(0).toUpperCase() + key.slice(1)];
+
+const optionalString = (v: any): string | undefined =>
+  v === undefined || v === null || v === '' ? undefined : String(v);
+
+const optionalNumber = (v: any): number | undefined => {
+  if (v === undefined || v === null || v === '') return undefined;
+  const n = Number(v);
+  return Number.isFinite(n) ? n : undefined;
+};
+
+export function parseChangeEvent(raw: any): ChangeEvent | null {
+  const type = pick(raw, 'type');
+  switch (type) {
+    case 'TripStatusChanged': {
+      const tripId = optionalString(pick(raw, 'tripId'));
+      const status = optionalString(pick(raw, 'status'));
+      return tripId && status ? { type, tripId, status } : null;
+    }
+    case 'AssignmentChanged': {
+      const tripId = optionalString(pick(raw, 'tripId'));
+      if (!tripId) return null;
+      return {
+        type,
+        tripId,
+        assignmentId: optionalString(pick(raw, 'assignmentId')),
+        driverId: optionalString(pick(raw, 'driverId')),
+        status: optionalString(pick(raw, 'status')),
+      };
+    }
+    case 'NotificationCreated':
+      return { type, unreadCount: optionalNumber(pick(raw, 'unreadCount')) };
+    case 'WalletChanged':
+      return { type, balance: optionalNumber(pick(raw, 'balance')) };
+    default:
+      return null;
+  }
+}
+
+class ChangeFeedService {
+  private handlers = new Map<ChangeEventType, Set<(event: any) => void>>();
+  private pollers = new Map<string, Poller>();
+  private connected = false;
+  private connectedSince: number | null = null;
+  private connectedMs = 0;
+  private startedAt: number | null = null;
+  private detachHub: (() => void) | null = null;
+  private detachConnection: (() => void) | null = null;
+  private ensureTimer: ReturnType<typeof setTimeout> | null = null;
+  private ensureDelayMs = RECONNECT_BASE_MS;
+  private ensuring = false;
+  private stats = {
+    eventsReceived: {
+      TripStatusChanged: 0,
+      AssignmentChanged: 0,
+      NotificationCreated: 0,
+      WalletChanged: 0,
+    } as Record<ChangeEventType, number>,
+    eventsDropped: 0,
+    pollRequests: 0,
+    catchUpPolls: 0,
+    // Ước lượng số request vòng setInterval cũ sẽ gửi, theo từng poller
+    legacyPollRequests: 0,
+  };
+
+  /**
+   * Nghe 1 loại sự kiện. Tự mở kênh khi có người nghe đầu tiên.
+   */
+  public subscribe<T extends ChangeEventType>(type: T, handler: ChangeHandler<T>): () => void {
+    let set = this.handlers.get(type);
+    if (!set) {
+      set = new Set();
+      this.handlers.set(type, set);
+    }
+    set.add(handler as (event: any) => void);
+    this.start();
+    return () => {
+      set!.delete(handler as (event: any) => void);
+      this.stopIfIdle();
+    };
+  }
+
+  /**
+   * Polling dự phòng: chỉ chạy khi kênh đẩy mất kết nối.
+   * Trùng tên thì thay poller cũ (vd. màn hình mount lại).
+   */
+  public registerPoller(name: string, fn: PollFn, options: PollerOptions): () => void {
+    this.unregisterPoller(name);
+    const poller: Poller = {
+      ...options,
+      name,
+      fn,
+      delayMs: options.baseMs,
+      timer: null,
+      running: false,
+    };
+    // start() trước để lần chạy bù khi vừa kết nối không trùng lần fetch đầu của caller
+    this.start();
+    this.pollers.set(name, poller);
+    if (!this.connected) this.schedulePoll(poller);
+    return () => {
+      if (this.pollers.get(name) === poller) this.unregisterPoller(name);
+    };
+  }
+
+  public isConnected(): boolean {
+    return this.connected;
+  }
+
+  /**
+   * Số liệu so sánh trước/sau: pollRequests là request polling thực tế,
+   * legacyPollRequests là số request các vòng setInterval cũ sẽ gửi trong cùng thời gian.
+   */
+  public getStats() {
+    const now = Date.now();
+    const currentMs = this.connectedSince !== null ? now - this.connectedSince : 0;
+    const connectedMs = this.connectedMs + currentMs;
+    const totalEvents = Object.values(this.stats.eventsReceived).reduce((a, b) => a + b, 0);
+    let legacyPollRequests = this.stats.legacyPollRequests;
+    this.pollers.forEach((poller) => {
+      if (poller.legacyIntervalMs) legacyPollRequests += Math.floor(currentMs / poller.legacyIntervalMs);
+    });
+    return {
+      ...this.stats,
+      legacyPollRequests,
+      eventsReceived: { ...this.stats.eventsReceived },
+      totalEvents,
+      connected: this.connected,
+      connectedMs,
+      uptimeMs: this.startedAt !== null ? now - this.startedAt : 0,
+      activePollers: this.pollers.size,
+      savedRequests: Math.max(0, legacyPollRequests - this.stats.pollRequests - this.stats.catchUpPolls),
+    };
+  }
+
+  // ============ PRIVATE METHODS ============
+
+  private start() {
+    if (!this.startedAt) this.startedAt = Date.now();
+    if (!this.detachHub) {
+      this.detachHub = signalRTrackingService.onHubEvent(CHANGE_HUB_METHOD, (payload: any) =>
+        this.handleRaw(payload)
+      );
+    }
+    if (!this.detachConnection) {
+      this.detachConnection = signalRTrackingService.addConnectionListener((connected) =>
+        this.setConnected(connected)
+      );
+    }
+    if (signalRTrackingService.isConnected()) {
+      this.setConnected(true);
+    } else {
+      this.ensureConnection();
+    }
+  }
+
+  private stopIfIdle() {
+    const hasHandlers = Array.from(this.handlers.values()).some((set) => set.size > 0);
+    if (hasHandlers || this.pollers.size > 0) return;
+    this.detachHub?.();
+    this.detachHub = null;
+    this.detachConnection?.();
+    this.detachConnection = null;
+    if (this.ensureTimer) clearTimeout(this.ensureTimer);
+    this.ensureTimer = null;
+    this.accumulateConnected();
+    this.connected = false;
+  }
+
+  private hasRegistrations(): boolean {
+    return this.detachHub !== null;
+  }
+
+  // Mở connection dùng chung nếu chưa có (màn hình chuyến cũng dùng connection này)
+  private async ensureConnection() {
+    if (this.ensuring || this.ensureTimer || !this.hasRegistrations()) return;
+    if (signalRTrackingService.isConnected()) return;
+    this.ensuring = true;
+    try {
+      await signalRTrackingService.init({
+        baseURL: process.env.EXPO_PUBLIC_API_BASE_URL || 'http://localhost:5246/',
+      });
+    } catch (error: any) {
+      console.warn('[ChangeFeed] Connect failed:', error?.message ?? error);
+    } finally {
+      this.ensuring = false;
+    }
+    if (signalRTrackingService.isConnected()) {
+      this.ensureDelayMs = RECONNECT_BASE_MS;
+      this.setConnected(true);
+    } else {
+      this.scheduleEnsure();
+    }
+  }
+
+  private scheduleEnsure() {
+    if (this.ensureTimer || !this.hasRegistrations()) return;
+    const delay = this.ensureDelayMs;
+    this.ensureDelayMs = Math.min(this.ensureDelayMs * BACKOFF_FACTOR, RECONNECT_MAX_MS);
+    this.ensureTimer = setTimeout(() => {
+      this.ensureTimer = null;
+      this.ensureConnection();
+    }, delay);
+  }
+
+  private setConnected(connected: boolean) {
+    if (connected === this.connected) return;
+    this.connected = connected;
+    if (connected) {
+      this.connectedSince = Date.now();
+      console.log('[ChangeFeed] 🟢 Push channel up - polling paused');
+      this.pollers.forEach((poller) => {
+        this.clearPoll(poller);
+        poller.delayMs = poller.baseMs;
+        // Chạy bù 1 lần cho khoảng thời gian mất kết nối
+        this.stats.catchUpPolls++;
+        this.runPoll(poller, false);
+      });
+    } else {
+      this.accumulateConnected();
+      console.log('[ChangeFeed] 🔴 Push channel down - fallback polling');
+      this.pollers.forEach((poller) => this.schedulePoll(poller));
+      // Màn hình chuyến có thể đã disconnect connection dùng chung => tự mở lại
+      if (this.hasRegistrations()) this.scheduleEnsure();
+    }
+  }
+
+  private accumulateConnected() {
+    if (this.connectedSince === null) return;
+    const elapsed = Date.now() - this.connectedSince;
+    this.connectedMs += elapsed;
+    this.connectedSince = null;
+    this.pollers.forEach((poller) => {
+      if (poller.legacyIntervalMs) {
+        this.stats.legacyPollRequests += Math.floor(elapsed / poller.legacyIntervalMs);
+      }
+    });
+  }
+
+  private schedulePoll(poller: Poller) {
+    this.clearPoll(poller);
+    poller.timer = setTimeout(() => {
+      poller.timer = null;
+      this.runPoll(poller, true);
+    }, poller.delayMs);
+  }
+
+  private clearPoll(poller: Poller) {
+    if (poller.timer) clearTimeout(poller.timer);
+    poller.timer = null;
+  }
+
+  private async runPoll(poller: Poller, reschedule: boolean) {
+    if (poller.running) return;
+    poller.running = true;
+    let changed = false;
+    try {
+      if (reschedule) this.stats.pollRequests++;
+      // Khi mất kết nối vòng setInterval cũ cũng chạy => tính 1 request mỗi lượt theo chu kỳ cũ
+      if (reschedule && poller.legacyIntervalMs) {
+        this.stats.legacyPollRequests += Math.max(1, Math.round(poller.delayMs / poller.legacyIntervalMs));
+      }
+      changed = (await poller.fn()) === true;
+    } catch (error: any) {
+      console.warn(`[ChangeFeed] Poll "${poller.name}" failed:`, error?.message ?? error);
+    } finally {
+      poller.running = false;
+    }
+    if (!reschedule || this.connected || this.pollers.get(poller.name) !== poller) return;
+    poller.delayMs = changed ? poller.baseMs : Math.min(poller.delayMs * BACKOFF_FACTOR, poller.maxMs);
+    this.schedulePoll(poller);
+  }
+
+  private unregisterPoller(name: string) {
+    const poller = this.pollers.get(name);
+    if (!poller) return;
+    this.clearPoll(poller);
+    this.pollers.delete(name);
+    this.stopIfIdle();
+  }
+
+  private handleRaw(payload: any) {
+    const event = parseChangeEvent(payload);
+    if (!event) {
+      this.stats.eventsDropped++;
+      console.warn('[ChangeFeed] Unknown change event:', payload);
+      return;
+    }
+    this.stats.eventsReceived[event.type]++;
+    this.route(event);
+    this.handlers.get(event.type)?.forEach((handler) => {
+      try {
+        handler(event);
+      } catch (error) {
+        console.warn('[ChangeFeed] Handler failed:', error);
+      }
+    });
+  }
+
+  // Invalidate cache + cập nhật store trước khi báo subscriber
+  private route(event: ChangeEvent) {
+    requestCache.invalidate(EVENT_TAGS[event.type]);
+    switch (event.type) {
+      case 'TripStatusChanged':
+        if (getEntity('trip', event.tripId)) {
+          useEntityStore.getState().upsert('trip', event.tripId, { status: event.status });
+        }
+        break;
+      case 'NotificationCreated':
+        if (event.unreadCount !== undefined) {
+          useNotificationStore.getState().setUnreadCount(event.unreadCount);
+        }
+        break;
+      default:
+        break;
+    }
+  }
+}
+
+export const changeFeedService = new ChangeFeedService();
+export default changeFeedService;
@@ -0,0 +1,321 @@
+import { AppState, Platform } from 'react-native'
+import AsyncStorage from '@react-native-async-storage/async-storage'
+import NetInfo from '@react-native-community/netinfo'
+import * as FileSystem from 'expo-file-system/legacy'
+import assignmentService from '@/services/assignmentService'
+import tripService from '@/services/tripService'
+import tripDeliveryIssueService, { TripDeliveryIssueCreateDTO } from '@/services/tripDeliveryIssueService'
+import resumableUploadService from '@/services/resumableUploadService'
+import { getEntity, useEntityStore } from '@/stores/entityStore'
+import { track } from '@/utils/analytics'
+import { OfflineOutbox, OutboxHandlerContext, OutboxRejectedError, OutboxSnapshot } from '@/utils/offlineOutbox'
+import type { UploadSlots } from '@/utils/resumableUpload'
+
+/**
+ * Driver Outbox Service - thao tác của tài xế vẫn chạy khi mất sóng (kho bãi, vùng sâu)
+ *
+ * Bọc check-in/check-out, báo sự cố, checklist bàn giao xe và đổi trạng thái chuyến qua
+ * OfflineOutbox. Hàm trả về cùng dạng response với service gốc; khi phải xếp hàng thì
+ * trả `{ isSuccess: true, statusCode: 202, queued: true }` để màn hình đi tiếp như thành công.
+ *
+ * - Scope = chuyến: các thao tác của 1 chuyến gửi lại đúng thứ tự (check-in trước đổi trạng thái).
+ * - Ảnh minh chứng chép vào documentDirectory/outbox (cache của picker có thể bị dọn).
+ *   Web không lưu được File qua lần tải lại trang: ảnh chỉ giữ trong bộ nhớ.
+ * - Bật resumable upload: thao tác có ảnh gửi durable (entry lưu trước khi tải ảnh), id upload
+ *   và fileId ghi vào entry. App bị tắt giữa chừng thì lần sau upload tiếp tục
+ *   (resumableUploadService.resumePending) và lần gửi lại dùng fileId đã xong.
+ * - Optimistic: trạng thái chuyến đang chờ gửi được áp vào entityStore và overlayTrip();
+ *   server từ chối thì lấy lại chuyến từ server.
+ * - Mạng: NetInfo + AppState active kích hoạt xả hàng đợi; báo cáo 'outbox_drained'.
+ */
+
+type TripStatusDTO = { TripId: string; NewStatus: string }
+type HandoverChecklistDTO = Parameters<typeof tripService.updateVehicleHandoverChecklist>[0]
+
+const OUTBOX_DIR = `${(FileSystem as any).documentDirectory ?? ''}outbox/`
+const QUEUED_MESSAGE = 'Đã lưu thao tác, sẽ tự gửi khi có mạng'
+
+// Web: File/Blob không ghi được vào AsyncStorage, giữ trong bộ nhớ theo ref
+const memoryAttachments = new Map<string, any>()
+
+const scopeOf = (tripId: string) => `trip:${tripId}`
+
+const isRetryable = (e: any): boolean => {
+  if (e instanceof OutboxRejectedError) return false
+  const status = e?.response?.status
+  if (typeof status === 'number') return status >= 500 || status === 408 || status === 429
+  // Không có response: mất mạng/timeout của axios
+  return !!(e?.isAxiosError || e?.request || e?.code === 'ERR_NETWORK' || e?.code === 'ECONNABORTED')
+}
+
+/** Service trả ResponseDTO thay vì throw (5xx / body không phải DTO thì service đã ném): 5xx thì thử lại, isSuccess=false thì bị từ chối */
+const ensureAccepted = (res: any) => {
+  const status = res?.statusCode
+  if (typeof status === 'number' && (status >= 500 || status === 408 || status === 429)) {
+    throw Object.assign(new Error(res?.message || `HTTP ${status}`), { response: { status, data: res } })
+  }
+  if (res?.isSuccess === false || (typeof status === 'number' && status >= 400)) {
+    throw new OutboxRejectedError(res?.message || 'Yêu cầu bị từ chối', res)
+  }
+  return res
+}
+
+const persistAttachment = async (entryId: string, name: string, source: any): Promise<any> => {
+  if (source === null || source === undefined) return null
+  if (Platform.OS === 'web') {
+    const ref = `${entryId}/${name}`
+    memoryAttachments.set(ref, source)
+    return { outboxMemoryRef: ref }
+  }
+  const obj = typeof source === 'string' ? { uri: source } : source
+  const uri: string | undefined = [obj.uri, obj.imageURL].find((u) => typeof u === 'string' && u.length > 0)
+  const base64: string | undefined =
+    obj.base64 || (uri?.startsWith('data:') ? uri : undefined) || (obj.imageURL?.startsWith('data:') ? obj.imageURL : undefined)
+  const fileName = obj.fileName || obj.name || `${name}.jpg`
+  const dest = `${OUTBOX_DIR}${entryId}_${name}_${fileName}`.replace(/[^\w./:-]/g, '_')
+  try {
+    await FileSystem.makeDirectoryAsync(OUTBOX_DIR, { intermediates: true }).catch(() => {})
+    if (uri && !uri.startsWith('data:')) {
+      await FileSystem.copyAsync({ from: uri, to: dest })
+    } else if (base64) {
+      await FileSystem.writeAsStringAsync(dest, base64.slice(base64.indexOf(',') + 1), {
+        encoding: (FileSystem as any).EncodingType?.Base64 ?? 'base64',
+      })
+    } else {
+      return null
+    }
+    return { uri: dest, fileName, mimeType: obj.mimeType || obj.type || 'image/jpeg' }
+  } catch (e) {
+    // Không chép được (content:// lạ, ...): giữ nguyên nguồn, vẫn gửi được nếu file còn
+    console.warn('[DriverOutbox] không lưu được ảnh đính kèm', e)
+    return { uri, fileName, mimeType: obj.mimeType || obj.type || 'image/jpeg' }
+  }
+}
+
+const releaseAttachment = async (ref: any) => {
+  if (!ref) return
+  if (ref.outboxMemoryRef) {
+    memoryAttachments.delete(ref.outboxMemoryRef)
+    return
+  }
+  if (typeof ref.uri === 'string' && ref.uri.startsWith(OUTBOX_DIR)) {
+    await FileSystem.deleteAsync(ref.uri, { idempotent: true })
+  }
+}
+
+/** Slot upload theo field trong entry đang gửi (gửi thẳng không qua entry thì không có) */
+const uploadSlots = (ctx: OutboxHandlerContext): UploadSlots => (field) =>
+  ctx.entryId
+    ? { owner: ctx.entryId, get: () => ctx.resume[field], set: (state) => ctx.saveResume(field, state) }
+    : undefined
+
+/** Ref attachment -> nguồn ảnh cho service (gửi thẳng thì đã là nguồn gốc) */
+const resolveAttachment = (ref: any) => (ref?.outboxMemoryRef ? memoryAttachments.get(ref.outboxMemoryRef) ?? null : ref)
+
+const outbox = new OfflineOutbox({
+  storage: AsyncStorage,
+  isRetryable,
+  persistAttachment,
+  releaseAttachment,
+  onDrained: (report) => track('outbox_drained', report),
+})
+
+// ============ HANDLERS ============
+
+interface CheckPayload {
+  tripId: string
+  latitude: number
+  longitude: number
+  currentAddress: string
+}
+
+outbox.register<CheckPayload>('checkIn', async (p, ctx) =>
+  ensureAccepted(
+    await assignmentService.driverCheckIn(
+      p.tripId,
+      p.latitude,
+      p.longitude,
+      p.currentAddress,
+      resolveAttachment(ctx.attachments.evidence),
+      ctx.idempotencyKey,
+      uploadSlots(ctx)
+    )
+  )
+)
+
+outbox.register<CheckPayload>('checkOut', async (p, ctx) =>
+  ensureAccepted(
+    await assignmentService.driverCheckOut(
+      p.tripId,
+      p.latitude,
+      p.longitude,
+      p.currentAddress,
+      resolveAttachment(ctx.attachments.evidence),
+      ctx.idempotencyKey,
+      uploadSlots(ctx)
+    )
+  )
+)
+
+outbox.register<TripStatusDTO>('changeStatus', async (dto, { idempotencyKey }) =>
+  ensureAccepted(await tripService.changeStatus(dto, idempotencyKey))
+)
+
+outbox.register<TripDeliveryIssueCreateDTO>('reportIssue', async (dto, ctx) =>
+  ensureAccepted(
+    await tripDeliveryIssueService.reportIssue(
+      dto,
+      (ctx.attachments.images ?? []).map(resolveAttachment).filter(Boolean),
+      ctx.idempotencyKey,
+      uploadSlots(ctx)
+    )
+  )
+)
+
+outbox.register<HandoverChecklistDTO>('handoverChecklist', async (dto, ctx) => {
+  const evidence: any[] = ctx.attachments.evidence ?? []
+  const ChecklistItems = dto.ChecklistItems.map((item, i) => ({
+    ...item,
+    EvidenceImage: resolveAttachment(evidence[i]) ?? undefined,
+  }))
+  return ensureAccepted(
+    await tripService.updateVehicleHandoverChecklist({ ...dto, ChecklistItems }, ctx.idempotencyKey, uploadSlots(ctx))
+  )
+})
+
+// ============ OPTIMISTIC STATE ============
+
+const pendingStatus = (snapshot: OutboxSnapshot, tripId: string): string | undefined => {
+  let status: string | undefined
+  snapshot.entries.forEach((e) => {
+    if (e.kind === 'changeStatus' && e.payload.TripId === tripId) status = e.payload.NewStatus
+  })
+  return status
+}
+
+const applyOptimisticStatus = (tripId: string, status: string) => {
+  // Chỉ sửa chuyến đã có trong store (không tạo entity thiếu dữ liệu)
+  if (getEntity('trip', tripId)) useEntityStore.getState().upsert('trip', tripId, { status })
+}
+
+// Bị từ chối: bỏ trạng thái optimistic, lấy lại bản thật từ server
+let seenRejected = new Set<string>()
+outbox.subscribe((snapshot) => {
+  const next = new Set<string>()
+  snapshot.rejected.forEach((r) => {
+    next.add(r.id)
+    if (seenRejected.has(r.id) || r.kind !== 'changeStatus') return
+    const tripId = r.payload?.TripId
+    if (!tripId || !getEntity('trip', tripId)) return
+    tripService
+      .getById(tripId)
+      .then((res: any) => {
+        if (res?.isSuccess && res.result) useEntityStore.getState().upsert('trip', tripId, res.result)
+      })
+      .catch(() => {})
+  })
+  seenRejected = next
+})
+
+const queuedResponse = (entryId: string) => ({
+  isSuccess: true,
+  statusCode: 202,
+  queued: true,
+  outboxEntryId: entryId,
+  message: QUEUED_MESSAGE,
+  result: null,
+})
+
+const submit = async (kind: string, payload: any, tripId: string, attachments?: Record<string, any>) => {
+  try {
+    // Có ảnh tải theo chunk: lưu entry trước để upload và thao tác sống qua lần app bị tắt
+    const durable = !!attachments && resumableUploadService.isEnabled()
+    const res = await outbox.submit(kind, payload, { scope: scopeOf(tripId), attachments, durable })
+    if (!res.queued) return res.result
+    track('outbox_queued', { kind, depth: outbox.getSnapshot().depth })
+    return queuedResponse(res.entryId)
+  } catch (e: any) {
+    // Giữ hành vi cũ của service: response bị từ chối trả về cho màn hình hiển thị
+    if (e instanceof OutboxRejectedError && e.response) return e.response
+    throw e
+  }
+}
+
+let started = false
+
+const driverOutboxService = {
+  /** Gọi sau khi khôi phục phiên đăng nhập: nạp hàng đợi, theo dõi mạng và xả */
+  start() {
+    if (started) return
+    started = true
+    NetInfo.addEventListener((state) => {
+      outbox.setOnline(state.isConnected !== false && state.isInternetReachable !== false)
+    })
+    AppState.addEventListener('change', (next) => {
+      if (next === 'active') outbox.drain()
+    })
+    outbox.load().then(() => outbox.drain())
+  },
+
+  driverCheckIn: (
+    tripId: string,
+    latitude: number,
+    longitude: number,
+    currentAddress: string,
+    evidenceImage: any
+  ) => submit('checkIn', { tripId, latitude, longitude, currentAddress }, tripId, { evidence: evidenceImage }),
+
+  driverCheckOut: (
+    tripId: string,
+    latitude: number,
+    longitude: number,
+    currentAddress: string,
+    evidenceImage: any
+  ) => submit('checkOut', { tripId, latitude, longitude, currentAddress }, tripId, { evidence: evidenceImage }),
+
+  async changeStatus(dto: TripStatusDTO) {
+    const res: any = await submit('changeStatus', dto, dto.TripId)
+    if (res?.queued) applyOptimisticStatus(dto.TripId, dto.NewStatus)
+    return res
+  },
+
+  reportIssue: (dto: TripDeliveryIssueCreateDTO, images: any[]) =>
+    submit('reportIssue', dto, dto.TripId, { images }),
+
+  updateVehicleHandoverChecklist: (tripId: string, dto: HandoverChecklistDTO) => {
+    const { ChecklistItems, ...rest } = dto
+    return submit(
+      'handoverChecklist',
+      { ...rest, ChecklistItems: ChecklistItems.map(({ EvidenceImage, ...item }) => item) },
+      tripId,
+      { evidence: ChecklistItems.map((item) => item.EvidenceImage ?? null) }
+    )
+  },
+
+  /** Áp thao tác đang chờ gửi lên dữ liệu chuyến vừa tải từ server */
+  overlayTrip<T extends { tripId?: string; status?: string }>(trip: T): T {
+    if (!trip?.tripId) return trip
+    const status = pendingStatus(outbox.getSnapshot(), trip.tripId)
+    return status && status !== trip.status ? { ...trip, status } : trip
+  },
+
+  /** Thao tác đang chờ của 1 chuyến */
+  pendingFor(tripId: string) {
+    const entries = outbox.getSnapshot().entries.filter((e) => e.scope === scopeOf(tripId))
+    return {
+      depth: entries.length,
+      status: pendingStatus(outbox.getSnapshot(), tripId),
+      checkedIn: entries.some((e) => e.kind === 'checkIn'),
+      checkedOut: entries.some((e) => e.kind === 'checkOut'),
+    }
+  },
+
+  scopeOf,
+  getSnapshot: () => outbox.getSnapshot(),
+  subscribe: (listener: (snapshot: OutboxSnapshot) => void) => outbox.subscribe(listener),
+  dismissRejected: (id: string) => outbox.dismissRejected(id),
+  drain: () => outbox.drain(),
+  getStats: () => outbox.getStats(),
+}
+
+export default driverOutboxService
@@ -0,0 +1,284 @@
+import AsyncStorage from '@react-native-async-storage/async-storage'
+import { haversine } from '@/utils/navigation'
+
+/**
+ * Driving Hours Accumulator - cộng dồn giờ lái trên máy
+ *
+ * Thay cho việc hỏi server mỗi phút: giữ mốc giờ lái (hôm nay/tuần này) từ lần
+ * đồng bộ gần nhất, cộng thêm thời gian xe thực sự di chuyển (đo từ luồng GPS) của
+ * phiên đang chạy theo sự kiện start/end. Giới hạn liên tục/ngày/tuần được kiểm tra
+ * tại máy với cùng quy tắc của DrivingHoursCard; chỉ đồng bộ lại với server khi
+ * trạng thái đổi (qua ngày/tuần, chạm giới hạn) hoặc sau một khoảng dài.
+ * Phần GPS bị gián đoạn (app bị tắt) không được cộng; lần đồng bộ kế tiếp lấy lại
+ * mốc của server.
+ */
+
+export const DRIVING_LIMITS = {
+  continuousHours: 4,
+  dailyHours: 10,
+  weeklyHours: 48,
+  // > 80% thì hiển thị "Sắp tới hạn"
+  warnRatio: 0.8,
+}
+
+export type DrivingLimitStatus = 'SAFE' | 'APPROACHING' | 'WARNING'
+
+export interface DrivingLimitStat {
+  current: number // giờ
+  max: number
+  status: DrivingLimitStatus
+}
+
+export interface DrivingHoursSnapshot {
+  canDrive: boolean
+  message?: string
+  hoursToday: number
+  hoursWeek: number
+  /** Giờ lái hôm nay/tuần này không tính phiên đang chạy */
+  baseHoursToday: number
+  baseHoursWeek: number
+  /** Thời gian đồng hồ từ lúc bắt đầu phiên (chỉ để hiển thị) */
+  sessionSeconds: number
+  /** Thời gian di chuyển của phiên, dùng cho giới hạn liên tục */
+  movingSeconds: number
+  continuous: DrivingLimitStat
+  daily: DrivingLimitStat
+  weekly: DrivingLimitStat
+}
+
+interface ActiveSession {
+  tripId: string
+  startedAt: number
+  movingMs: number
+  /** Phần movingMs thuộc ngày/tuần hiện tại (qua kỳ mới thì đặt lại) */
+  movingTodayMs: number
+  movingWeekMs: number
+}
+
+interface PersistedState {
+  dayKey: string
+  weekKey: string
+  baseTodayMs: number
+  baseWeekMs: number
+  serverCanDrive: boolean
+  serverMessage?: string
+  syncedAt: number // 0 = chưa đồng bộ lần nào
+  syncedCanDrive: boolean // canDrive (đã tính local) tại lần đồng bộ
+  session: ActiveSession | null
+}
+
+const STORAGE_KEY = '@driving_hours_v1'
+const HOUR_MS = 60 * 60 * 1000
+const RECONCILE_INTERVAL_MS = 15 * 60 * 1000
+// Vận tốc tối thiểu tính là đang chạy (~5 km/h), khoảng trống GPS tối đa được cộng
+const MOVING_MIN_MPS = 1.5
+const MAX_FIX_GAP_MS = 30 * 1000
+
+const pad = (n: number) => (n < 10 ? `0${n}` : String(n))
+
+const startOfDay = (ts: number) => {
+  const d = new Date(ts)
+  return new Date(d.getFullYear(), d.getMonth(), d.getDate()).getTime()
+}
+
+// Tuần bắt đầu từ thứ Hai
+const startOfWeek = (ts: number) => {
+  const d = new Date(startOfDay(ts))
+  const dow = (d.getDay() + 6) % 7
+  d.setDate(d.getDate() - dow)
+  return d.getTime()
+}
+
+const dateKey = (ts: number) => {
+  const d = new Date(ts)
+  return `${d.getFullYear()}-${pad(d.getMonth() + 1)}-${pad(d.getDate())}`
+}
+
+export function drivingLimitStatus(current: number, max: number): DrivingLimitStatus {
+  if (current >= max) return 'WARNING'
+  if (current > max * DRIVING_LIMITS.warnRatio) return 'APPROACHING'
+  return 'SAFE'
+}
+
+const stat = (hours: number, max: number): DrivingLimitStat => ({
+  current: Number(hours.toFixed(2)),
+  max,
+  status: drivingLimitStatus(hours, max),
+})
+
+const emptyState = (now: number): PersistedState => ({
+  dayKey: dateKey(now),
+  weekKey: dateKey(startOfWeek(now)),
+  baseTodayMs: 0,
+  baseWeekMs: 0,
+  serverCanDrive: true,
+  syncedAt: 0,
+  syncedCanDrive: true,
+  session: null,
+})
+
+class DrivingHoursAccumulator {
+  private state: PersistedState = emptyState(Date.now())
+  private loadPromise: Promise<void> | null = null
+  private persistTimer: ReturnType<typeof setTimeout> | null = null
+  private lastFix: { lat: number; lng: number; at: number } | null = null
+
+  /** Nạp trạng thái đã lưu (1 lần, gọi nhiều lần an toàn) */
+  init(): Promise<void> {
+    if (!this.loadPromise) {
+      this.loadPromise = (async () => {
+        try {
+          const raw = await AsyncStorage.getItem(STORAGE_KEY)
+          if (raw) this.state = { ...this.state, ...JSON.parse(raw) }
+          const session = this.state.session
+          if (session) {
+            session.movingTodayMs = session.movingTodayMs ?? 0
+            session.movingWeekMs = session.movingWeekMs ?? 0
+          }
+        } catch (e) {
+          console.warn('[DrivingHours] load state failed', e)
+        }
+        this.rollover(Date.now())
+      })()
+    }
+    return this.loadPromise
+  }
+
+  /**
+   * Mốc từ server (check-eligibility). Giờ server không gồm phiên đang chạy,
+   * giống cách màn hình vẫn cộng base + thời gian phiên.
+   */
+  applyServerSnapshot(data: { canDrive: boolean; message?: string; hoursToday: number; hoursWeek: number }) {
+    const now = Date.now()
+    this.rollover(now)
+    this.state.baseTodayMs = Math.max(0, data.hoursToday) * HOUR_MS
+    this.state.baseWeekMs = Math.max(0, data.hoursWeek) * HOUR_MS
+    this.state.serverCanDrive = data.canDrive
+    this.state.serverMessage = data.message
+    this.state.syncedAt = now
+    this.state.syncedCanDrive = this.snapshot(now).canDrive
+    this.schedulePersist()
+  }
+
+  startSession(tripId: string, startedAt: number = Date.now()) {
+    if (this.state.session?.tripId === tripId) return
+    if (this.state.session) this.endSession(startedAt)
+    this.rollover(startedAt)
+    this.state.session = { tripId, startedAt, movingMs: 0, movingTodayMs: 0, movingWeekMs: 0 }
+    this.lastFix = null
+    this.schedulePersist()
+  }
+
+  /** Kết thúc phiên: dồn thời gian di chuyển của phiên vào mốc ngày/tuần để không cần gọi server ngay */
+  endSession(endedAt: number = Date.now()) {
+    const session = this.state.session
+    if (!session) return
+    this.rollover(endedAt)
+    this.state.baseTodayMs += session.movingTodayMs
+    this.state.baseWeekMs += session.movingWeekMs
+    this.state.session = null
+    this.lastFix = null
+    this.schedulePersist()
+  }
+
+  /** Điểm GPS (thật hoặc mô phỏng): cộng thời gian xe di chuyển trong phiên */
+  onLocation(lat: number, lng: number, timestamp: number = Date.now()) {
+    const session = this.state.session
+    if (!session) return
+    const prev = this.lastFix
+    this.lastFix = { lat, lng, at: timestamp }
+    if (!prev || timestamp <= prev.at) return
+    const dt = Math.min(timestamp - prev.at, MAX_FIX_GAP_MS)
+    const speed = haversine([prev.lng, prev.lat], [lng, lat]) / ((timestamp - prev.at) / 1000)
+    if (speed < MOVING_MIN_MPS) return
+    this.rollover(timestamp)
+    session.movingMs += dt
+    session.movingTodayMs += dt
+    session.movingWeekMs += dt
+    this.schedulePersist()
+  }
+
+  snapshot(now: number = Date.now()): DrivingHoursSnapshot {
+    this.rollover(now)
+    const { session } = this.state
+    const sessionMs = session ? Math.max(0, now - session.startedAt) : 0
+    const movingMs = session?.movingMs ?? 0
+    const todayMs = this.state.baseTodayMs + (session?.movingTodayMs ?? 0)
+    const weekMs = this.state.baseWeekMs + (session?.movingWeekMs ?? 0)
+
+    const hoursToday = todayMs / HOUR_MS
+    const hoursWeek = weekMs / HOUR_MS
+    const daily = stat(hoursToday, DRIVING_LIMITS.dailyHours)
+    const weekly = stat(hoursWeek, DRIVING_LIMITS.weeklyHours)
+    const continuous = stat(movingMs / HOUR_MS, DRIVING_LIMITS.continuousHours)
+
+    let canDrive = this.state.serverCanDrive
+    let message = this.state.serverMessage
+    if (weekly.status === 'WARNING') {
+      canDrive = false
+      message = `Đã đạt giới hạn ${DRIVING_LIMITS.weeklyHours}h lái xe trong tuần`
+    } else if (daily.status === 'WARNING') {
+      canDrive = false
+      message = `Đã đạt giới hạn ${DRIVING_LIMITS.dailyHours}h lái xe trong ngày`
+    }
+
+    return {
+      canDrive,
+      message,
+      hoursToday,
+      hoursWeek,
+      baseHoursToday: this.state.baseTodayMs / HOUR_MS,
+      baseHoursWeek: this.state.baseWeekMs / HOUR_MS,
+      sessionSeconds: Math.floor(sessionMs / 1000),
+      movingSeconds: Math.floor(movingMs / 1000),
+      continuous,
+      daily,
+      weekly,
+    }
+  }
+
+  hasSynced(): boolean {
+    return this.state.syncedAt > 0
+  }
+
+  /** Có cần hỏi lại server không: chưa đồng bộ, quá lâu, hoặc trạng thái đã đổi */
+  needsReconcile(now: number = Date.now()): boolean {
+    if (this.state.syncedAt === 0) return true
+    if (now - this.state.syncedAt >= RECONCILE_INTERVAL_MS) return true
+    if (startOfDay(this.state.syncedAt) !== startOfDay(now)) return true
+    return this.snapshot(now).canDrive !== this.state.syncedCanDrive
+  }
+
+  // ============ PRIVATE METHODS ============
+
+  // Qua ngày/tuần mới: phần đã lái của kỳ cũ không còn tính
+  private rollover(now: number) {
+    const dayKey = dateKey(now)
+    const weekKey = dateKey(startOfWeek(now))
+    const { session } = this.state
+    if (this.state.weekKey !== weekKey) {
+      this.state.weekKey = weekKey
+      this.state.baseWeekMs = 0
+      if (session) session.movingWeekMs = 0
+    }
+    if (this.state.dayKey !== dayKey) {
+      this.state.dayKey = dayKey
+      this.state.baseTodayMs = 0
+      if (session) session.movingTodayMs = 0
+    }
+  }
+
+  // Ghi trạng thái lúc timer chạy => đã hẹn thì không hẹn lại (điểm GPS dồn dập chỉ ghi 1 lần)
+  private schedulePersist() {
+    if (this.persistTimer) return
+    this.persistTimer = setTimeout(() => {
+      this.persistTimer = null
+      AsyncStorage.setItem(STORAGE_KEY, JSON.stringify(this.state)).catch((e) =>
+        console.warn('[DrivingHours] persist state failed', e)
+      )
+    }, 500)
+  }
+}
+
+export const drivingHoursAccumulator = new DrivingHoursAccumulator()
+export default drivingHoursAccumulator
@@ -1,5 +1,6 @@
 import api from '@/config/api'
 import { ResponseDTO } from '@/models/types'
+import resumableUploadService from '@/services/resumableUploadService'
 
 export interface EkycResult {
   documentId: string
@@ -78,29 +79,10 @@ export const ekycService = {
     try {
       const formData = new FormData()
 
-      // Handle different file formats (Web File vs React Native image picker)
-      if (front instanceof File) {
-        formData.append('front', front)
-        formData.append('back', back as File)
-        formData.append('selfie', selfie as File)
-      } else {
-        // React Native format
-        formData.append('front', {
-          uri: front.uri,
-          name: front.name,
-          type: front.type,
-        } as any)
-        formData.append('back', {
-          uri: (back as any).uri,
-          name: (back as any).name,
-          type: (back as any).type,
-        } as any)
-        formData.append('selfie', {
-          uri: (selfie as any).uri,
-          name: (selfie as any).name,
-          type: (selfie as any).type,
-        } as any)
-      }
+      // Web File hoặc object của ImagePicker; pipeline thu nhỏ về kích thước đủ cho OCR
+      await resumableUploadService.appendImage(formData, 'front', front, 'identity', 'front.jpg')
+      await resumableUploadService.appendImage(formData, 'back', back, 'identity', 'back.jpg')
+      await resumableUploadService.appendImage(formData, 'selfie', selfie, 'identity', 'selfie.jpg')
 
       const response = await api.post<ResponseDTO<EkycResult>>(
         '/api/UserDocument/upload-identity',
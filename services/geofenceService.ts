@@ -0,0 +1,416 @@
+import type { Position } from 'geojson'
+
+/**
+ * Geofence Engine
+ * Đăng ký vùng (tròn / đa giác) cho điểm lấy xe, lấy hàng, giao hàng, trả xe...
+ * và phát sự kiện enter / exit / dwell từ luồng GPS.
+ *
+ * - Spatial prefilter: lưới ô ~1km -> chỉ xét các fence có bbox chạm ô hiện tại
+ * - Debounce: cần N fix liên tiếp (hoặc đủ thời gian) mới xác nhận enter/exit
+ * - Hysteresis: bán kính thoát lớn hơn bán kính vào để tránh nhảy trạng thái ở mép vùng
+ * - Dwell: dùng 1 timer duy nhất hẹn đúng deadline gần nhất (GPS đứng yên vẫn phát dwell)
+ */
+
+export type GeofencePurpose =
+  | 'VEHICLE_PICKUP' // Bãi lấy xe (check-in tài xế chính)
+  | 'PICKUP' // Điểm lấy hàng
+  | 'DELIVERY' // Điểm giao hàng
+  | 'VEHICLE_RETURN' // Điểm trả xe
+  | 'DRIVER_START' // Điểm lên xe của tài xế phụ (check-in)
+  | 'DRIVER_END' // Điểm xuống xe của tài xế phụ (check-out)
+
+interface GeofenceBase {
+  id: string
+  purpose: GeofencePurpose
+  dwellMs?: number // Thời gian ở trong vùng để phát 'dwell' (default 20s)
+  metadata?: Record<string, any>
+}
+
+export interface CircleGeofence extends GeofenceBase {
+  kind: 'circle'
+  center: Position // [lng, lat]
+  radiusM: number
+}
+
+export interface PolygonGeofence extends GeofenceBase {
+  kind: 'polygon'
+  ring: Position[] // [lng, lat][], không cần khép kín
+}
+
+export type Geofence = CircleGeofence | PolygonGeofence
+
+export type GeofenceEventType = 'enter' | 'exit' | 'dwell'
+
+export interface GeofenceEvent {
+  type: GeofenceEventType
+  fence: Geofence
+  position: Position
+  timestamp: number
+  distanceM: number // Khoảng cách tới tâm (circle) hoặc 0 (polygon, bên trong)
+}
+
+export interface GeofenceFix {
+  accuracy?: number | null // meters
+  timestamp?: number
+}
+
+export interface GeofenceEngineConfig {
+  hysteresisM?: number // Bán kính thoát = radius + hysteresis, default 20
+  enterConfirmations?: number // Số fix liên tiếp bên trong để xác nhận enter, default 2
+  exitConfirmations?: number // Số fix liên tiếp bên ngoài để xác nhận exit, default 3
+  confirmAfterMs?: number // Hoặc đủ thời gian này thì xác nhận luôn, default 5000
+  maxAccuracyM?: number // Bỏ qua fix có sai số lớn hơn, default 100
+  defaultDwellMs?: number // default 20000
+}
+
+type FenceState = 'OUTSIDE' | 'ENTERING' | 'INSIDE' | 'EXITING'
+
+interface FenceEntry {
+  fence: Geofence
+  minLng: number
+  minLat: number
+  maxLng: number
+  maxLat: number
+  cells: string[]
+  state: FenceState
+  pendingCount: number
+  pendingSince: number
+  enteredAt: number
+  dwellEmitted: boolean
+}
+
+type Listener = (event: GeofenceEvent) => void
+
+// ~1.1km mỗi ô ở xích đạo - đủ nhỏ để lọc, đủ lớn để fence thường chỉ chiếm 1-4 ô
+const CELL_DEG = 0.01
+const M_PER_DEG_LAT = 111320
+
+const cellKey = (x: number, y: number) => `${x}:${y}`
+
+const toRad = (d: number) => (d * Math.PI) / 180
+
+/**
+ * Equirectangular - đủ chính xác trong phạm vi vài km, rẻ hơn haversine
+ */
+const fastDistanceM = (a: Position, b: Position) => {
+  const x = toRad(b[0] - a[0]) * Math.cos(toRad((a[1] + b[1]) / 2))
+  const y = toRad(b[1] - a[1])
+  return Math.sqrt(x * x + y * y) * 6371000
+}
+
+const pointInRing = (p: Position, ring: Position[]) => {
+  let inside = false
+  for (let i = 0, j = ring.length - 1; i < ring.length; j = i++) {
+    const xi = ring[i][0]
+    const yi = ring[i][1]
+    const xj = ring[j][0]
+    const yj = ring[j][1]
+    const intersect = yi > p[1] !== yj > p[1] && p[0] < ((xj - xi) * (p[1] - yi)) / (yj - yi) + xi
+    if (intersect) inside = !inside
+  }
+  return inside
+}
+
+export class GeofenceEngine {
+  private readonly hysteresisM: number
+  private readonly enterConfirmations: number
+  private readonly exitConfirmations: number
+  private readonly confirmAfterMs: number
+  private readonly maxAccuracyM: number
+  private readonly defaultDwellMs: number
+
+  private entries = new Map<string, FenceEntry>()
+  private grid = new Map<string, Set<string>>()
+  private listeners = new Set<Listener>()
+  private lastPosition: Position | null = null
+  private dwellTimer?: ReturnType<typeof setTimeout>
+
+  constructor(config: GeofenceEngineConfig = {}) {
+    this.hysteresisM = config.hysteresisM ?? 20
+    this.enterConfirmations = config.enterConfirmations ?? 2
+    this.exitConfirmations = config.exitConfirmations ?? 3
+    this.confirmAfterMs = config.confirmAfterMs ?? 5000
+    this.maxAccuracyM = config.maxAccuracyM ?? 100
+    this.defaultDwellMs = config.defaultDwellMs ?? 20000
+  }
+
+  /**
+   * Đăng ký (hoặc cập nhật) fence. Giữ nguyên trạng thái nếu hình học không đổi.
+   */
+  register(fence: Geofence) {
+    const existing = this.entries.get(fence.id)
+    if (existing && this.sameGeometry(existing.fence, fence)) {
+      existing.fence = fence
+      return
+    }
+    if (existing) this.unregister(fence.id)
+
+    const bbox = this.boundsOf(fence)
+    const cells: string[] = []
+    const x0 = Math.floor(bbox.minLng / CELL_DEG)
+    const x1 = Math.floor(bbox.maxLng / CELL_DEG)
+    const y0 = Math.floor(bbox.minLat / CELL_DEG)
+    const y1 = Math.floor(bbox.maxLat / CELL_DEG)
+    for (let x = x0; x <= x1; x++) {
+      for (let y = y0; y <= y1; y++) {
+        const key = cellKey(x, y)
+        cells.push(key)
+        if (!this.grid.has(key)) this.grid.set(key, new Set())
+        this.grid.get(key)!.add(fence.id)
+      }
+    }
+
+    this.entries.set(fence.id, {
+      fence,
+      ...bbox,
+      cells,
+      state: 'OUTSIDE',
+      pendingCount: 0,
+      pendingSince: 0,
+      enteredAt: 0,
+      dwellEmitted: false,
+    })
+  }
+
+  unregister(id: string) {
+    const entry = this.entries.get(id)
+    if (!entry) return
+    for (const key of entry.cells) {
+      const bucket = this.grid.get(key)
+      if (!bucket) continue
+      bucket.delete(id)
+      if (bucket.size === 0) this.grid.delete(key)
+    }
+    this.entries.delete(id)
+    this.scheduleDwell()
+  }
+
+  /**
+   * Thay toàn bộ tập fence (fence cũ không còn trong danh sách sẽ bị gỡ)
+   */
+  setFences(fences: Geofence[]) {
+    const keep = new Set(fences.map((f) => f.id))
+    for (const id of Array.from(this.entries.keys())) {
+      if (!keep.has(id)) this.unregister(id)
+    }
+    fences.forEach((f) => this.register(f))
+  }
+
+  clear() {
+    this.entries.clear()
+    this.grid.clear()
+    this.lastPosition = null
+    if (this.dwellTimer) clearTimeout(this.dwellTimer)
+    this.dwellTimer = undefined
+  }
+
+  subscribe(listener: Listener) {
+    this.listeners.add(listener)
+    return () => {
+      this.listeners.delete(listener)
+    }
+  }
+
+  isInside(id: string) {
+    const state = this.entries.get(id)?.state
+    return state === 'INSIDE' || state === 'EXITING'
+  }
+
+  /**
+   * Fence đang chứa vị trí hiện tại, lọc theo purpose nếu cần
+   */
+  insideFences(purpose?: GeofencePurpose): Geofence[] {
+    const result: Geofence[] = []
+    this.entries.forEach((entry) => {
+      if ((entry.state === 'INSIDE' || entry.state === 'EXITING') && (!purpose || entry.fence.purpose === purpose)) {
+        result.push(entry.fence)
+      }
+    })
+    return result
+  }
+
+  getLastPosition() {
+    return this.lastPosition
+  }
+
+  /**
+   * Đưa 1 fix GPS vào engine. Chỉ đánh giá các fence trong ô hiện tại
+   * cộng với các fence đang ở trạng thái khác OUTSIDE (để phát hiện exit).
+   */
+  update(position: Position, fix: GeofenceFix = {}) {
+    if (!position || !Number.isFinite(position[0]) || !Number.isFinite(position[1])) return
+    if (fix.accuracy != null && fix.accuracy > this.maxAccuracyM) return
+
+    const now = fix.timestamp ?? Date.now()
+    this.lastPosition = position
+
+    const candidates = new Set<string>()
+    const bucket = this.grid.get(cellKey(Math.floor(position[0] / CELL_DEG), Math.floor(position[1] / CELL_DEG)))
+    bucket?.forEach((id) => candidates.add(id))
+    this.entries.forEach((entry, id) => {
+      if (entry.state !== 'OUTSIDE') candidates.add(id)
+    })
+
+    candidates.forEach((id) => {
+      const entry = this.entries.get(id)
+      if (entry) this.evaluate(entry, position, now)
+    })
+    this.scheduleDwell()
+  }
+
+  // ============ PRIVATE ============
+
+  private evaluate(entry: FenceEntry, position: Position, now: number) {
+    const { fence } = entry
+    const inBBox =
+      position[0] >= entry.minLng &&
+      position[0] <= entry.maxLng &&
+      position[1] >= entry.minLat &&
+      position[1] <= entry.maxLat
+
+    let distanceM = 0
+    let insideEnter = false
+    let insideExit = false
+    if (fence.kind === 'circle') {
+      distanceM = fastDistanceM(position, fence.center)
+      insideEnter = distanceM <= fence.radiusM
+      insideExit = distanceM <= fence.radiusM + this.hysteresisM
+    } else if (inBBox) {
+      insideEnter = insideExit = pointInRing(position, fence.ring)
+    }
+
+    switch (entry.state) {
+      case 'OUTSIDE':
+        if (insideEnter) {
+          entry.state = 'ENTERING'
+          entry.pendingCount = 1
+          entry.pendingSince = now
+          this.confirmEnterIfReady(entry, position, now, distanceM)
+        }
+        break
+      case 'ENTERING':
+        if (!insideEnter) {
+          entry.state = 'OUTSIDE'
+          entry.pendingCount = 0
+          break
+        }
+        entry.pendingCount++
+        this.confirmEnterIfReady(entry, position, now, distanceM)
+        break
+      case 'INSIDE':
+        if (!insideExit) {
+          entry.state = 'EXITING'
+          entry.pendingCount = 1
+          entry.pendingSince = now
+          this.confirmExitIfReady(entry, position, now, distanceM)
+        }
+        break
+      case 'EXITING':
+        if (insideExit) {
+          entry.state = 'INSIDE'
+          entry.pendingCount = 0
+          break
+        }
+        entry.pendingCount++
+        this.confirmExitIfReady(entry, position, now, distanceM)
+        break
+    }
+  }
+
+  private confirmEnterIfReady(entry: FenceEntry, position: Position, now: number, distanceM: number) {
+    if (entry.pendingCount < this.enterConfirmations && now - entry.pendingSince < this.confirmAfterMs) return
+    entry.state = 'INSIDE'
+    entry.pendingCount = 0
+    entry.enteredAt = entry.pendingSince
+    entry.dwellEmitted = false
+    this.emit({ type: 'enter', fence: entry.fence, position, timestamp: now, distanceM })
+  }
+
+  private confirmExitIfReady(entry: FenceEntry, position: Position, now: number, distanceM: number) {
+    if (entry.pendingCount < this.exitConfirmations && now - entry.pendingSince < this.confirmAfterMs) return
+    entry.state = 'OUTSIDE'
+    entry.pendingCount = 0
+    this.emit({ type: 'exit', fence: entry.fence, position, timestamp: now, distanceM })
+  }
+
+  /**
+   * Hẹn 1 timer cho deadline dwell gần nhất (không polling)
+   */
+  private scheduleDwell() {
+    if (this.dwellTimer) {
+      clearTimeout(this.dwellTimer)
+      this.dwellTimer = undefined
+    }
+    let nextDeadline = Infinity
+    this.entries.forEach((entry) => {
+      if (entry.state !== 'INSIDE' || entry.dwellEmitted) return
+      const deadline = entry.enteredAt + (entry.fence.dwellMs ?? this.defaultDwellMs)
+      if (deadline < nextDeadline) nextDeadline = deadline
+    })
+    if (!Number.isFinite(nextDeadline)) return
+    this.dwellTimer = setTimeout(() => {
+      this.dwellTimer = undefined
+      this.flushDwell(Date.now())
+    }, Math.max(0, nextDeadline - Date.now()))
+  }
+
+  private flushDwell(now: number) {
+    const position = this.lastPosition
+    if (!position) return
+    this.entries.forEach((entry) => {
+      if (entry.state !== 'INSIDE' || entry.dwellEmitted) return
+      if (now - entry.enteredAt < (entry.fence.dwellMs ?? this.defaultDwellMs)) return
+      entry.dwellEmitted = true
+      const distanceM = entry.fence.kind === 'circle' ? fastDistanceM(position, entry.fence.center) : 0
+      this.emit({ type: 'dwell', fence: entry.fence, position, timestamp: now, distanceM })
+    })
+    this.scheduleDwell()
+  }
+
+  private emit(event: GeofenceEvent) {
+    this.listeners.forEach((listener) => {
+      try {
+        listener(event)
+      } catch (e) {
+        console.warn('[Geofence] listener error', e)
+      }
+    })
+  }
+
+  private boundsOf(fence: Geofence) {
+    if (fence.kind === 'circle') {
+      const pad = fence.radiusM + this.hysteresisM
+      const dLat = pad / M_PER_DEG_LAT
+      const dLng = pad / (M_PER_DEG_LAT * Math.max(0.01, Math.cos(toRad(fence.center[1]))))
+      return {
+        minLng: fence.center[0] - dLng,
+        maxLng: fence.center[0] + dLng,
+        minLat: fence.center[1] - dLat,
+        maxLat: fence.center[1] + dLat,
+      }
+    }
+    let minLng = Infinity
+    let minLat = Infinity
+    let maxLng = -Infinity
+    let maxLat = -Infinity
+    for (const [lng, lat] of fence.ring) {
+      if (lng < minLng) minLng = lng
+      if (lng > maxLng) maxLng = lng
+      if (lat < minLat) minLat = lat
+      if (lat > maxLat) maxLat = lat
+    }
+    return { minLng, minLat, maxLng, maxLat }
+  }
+
+  private sameGeometry(a: Geofence, b: Geofence) {
+    if (a.kind === 'circle' && b.kind === 'circle') {
+      return a.center[0] === b.center[0] && a.center[1] === b.center[1] && a.radiusM === b.radiusM
+    }
+    if (a.kind === 'polygon' && b.kind === 'polygon') {
+      return a.ring.length === b.ring.length && a.ring.every((p, i) => p[0] === b.ring[i][0] && p[1] === b.ring[i][1])
+    }
+    return false
+  }
+}
+
+export default GeofenceEngine
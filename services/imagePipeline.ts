@@ -0,0 +1,375 @@
+import { Image, Platform } from 'react-native'
+import * as FileSystem from 'expo-file-system/legacy'
+import { manipulateAsync, SaveFormat, Action } from 'expo-image-manipulator'
+import { track } from '@/utils/analytics'
+
+/**
+ * Image Pipeline - thu nhỏ + nén ảnh trước khi upload multipart
+ *
+ * - Mỗi mục đích (ảnh xe, giấy tờ, sản phẩm, sự cố, eKYC) có cạnh dài tối đa và
+ *   chất lượng JPEG riêng; ảnh picker trả về ở độ phân giải gốc, pipeline nén 1 lần
+ *   nên picker nên để IMAGE_PICKER_QUALITY (không nén 2 lần).
+ * - Native: giải mã/resize/encode bằng expo-image-manipulator (chạy ở native thread,
+ *   không phải JS thread). Ưu tiên file:// / content:// của asset, chỉ ghi base64 ra
+ *   file tạm khi nguồn duy nhất là data: URL.
+ * - Web: data:/blob: URL -> Blob bằng fetch (trình duyệt tự giải mã, không lặp từng byte
+ *   trong JS), decode bằng createImageBitmap, vẽ lên OffscreenCanvas nếu có.
+ * - Ảnh đã nhỏ hơn đích, hoặc nén ra lớn hơn bản gốc, thì gửi bản gốc.
+ * - Thống kê byte gửi đi / byte tiết kiệm / thời gian truyền ước lượng tiết kiệm.
+ */
+
+export type ImagePurpose = 'vehicle' | 'vehicleDocument' | 'item' | 'package' | 'issue' | 'evidence' | 'identity'
+
+interface ImageTarget {
+  /** Cạnh dài tối đa (px) */
+  maxEdge: number
+  quality: number
+}
+
+const TARGETS: Record<ImagePurpose, ImageTarget> = {
+  vehicle: { maxEdge: 1600, quality: 0.72 },
+  // Giấy tờ/CCCD cần đọc được chữ nhỏ
+  vehicleDocument: { maxEdge: 2048, quality: 0.8 },
+  item: { maxEdge: 1280, quality: 0.7 },
+  package: { maxEdge: 1280, quality: 0.7 },
+  issue: { maxEdge: 1600, quality: 0.75 },
+  evidence: { maxEdge: 1600, quality: 0.75 },
+  identity: { maxEdge: 2048, quality: 0.85 },
+}
+
+/** Chất lượng cho ImagePicker: pipeline nén lại theo mục đích nên lấy gần gốc */
+export const IMAGE_PICKER_QUALITY = 0.9
+
+// Uplink di động ước lượng (~1.5 Mbps) để quy đổi byte tiết kiệm ra thời gian
+const UPLINK_BYTES_PER_MS = 1500000 / 8 / 1000
+
+/** File đính kèm FormData kiểu React Native */
+export interface RNFile {
+  uri: string
+  name: string
+  type: string
+}
+
+export type ImageSource =
+  | string
+  | Blob
+  | {
+      uri?: string | null
+      imageURL?: string | null
+      base64?: string | null
+      fileName?: string | null
+      name?: string | null
+      type?: string | null
+      mimeType?: string | null
+      width?: number
+      height?: number
+      [key: string]: any
+    }
+
+export interface PreparedImage {
+  /** Blob trên web, RNFile trên native */
+  file: Blob | RNFile
+  name: string
+  type: string
+  originalBytes: number
+  bytes: number
+  width?: number
+  height?: number
+  processingMs: number
+  resized: boolean
+}
+
+export interface ImagePipelineStats {
+  images: number
+  resized: number
+  originalBytes: number
+  uploadedBytes: number
+  bytesSaved: number
+  processingMs: number
+  /** Thời gian truyền tiết kiệm ước lượng, đã trừ thời gian xử lý */
+  estimatedTimeSavedMs: number
+}
+
+interface ResolvedSource {
+  uri?: string
+  blob?: Blob
+  name: string
+  type: string
+  width?: number
+  height?: number
+}
+
+class ImagePipeline {
+  private stats: ImagePipelineStats = {
+    images: 0,
+    resized: 0,
+    originalBytes: 0,
+    uploadedBytes: 0,
+    bytesSaved: 0,
+    processingMs: 0,
+    estimatedTimeSavedMs: 0,
+  }
+
+  /**
+   * Chuẩn bị 1 ảnh để upload. Trả null nếu nguồn không có dữ liệu ảnh.
+   * Lỗi xử lý (định dạng không giải mã được, ...) thì trả bản gốc.
+   */
+  async prepare(source: ImageSource, purpose: ImagePurpose, fallbackName: string): Promise<PreparedImage | null> {
+    const startedAt = Date.now()
+    const resolved = await this.resolve(source, fallbackName)
+    if (!resolved) return null
+
+    const target = TARGETS[purpose]
+    let prepared: PreparedImage
+    try {
+      prepared =
+        Platform.OS === 'web'
+          ? await this.prepareWeb(resolved, target)
+          : await this.prepareNative(resolved, target)
+    } catch (e) {
+      console.warn('[imagePipeline] xử lý ảnh thất bại, gửi bản gốc', e)
+      prepared = await this.passthrough(resolved)
+    }
+    prepared.processingMs = Date.now() - startedAt
+    this.record(purpose, prepared)
+    return prepared
+  }
+
+  /** Chuẩn bị ảnh và append vào FormData; trả false nếu bỏ qua */
+  async append(
+    form: FormData,
+    field: string,
+    source: ImageSource | null | undefined,
+    purpose: ImagePurpose,
+    fallbackName: string
+  ): Promise<boolean> {
+    if (!source) return false
+    const prepared = await this.prepare(source, purpose, fallbackName)
+    if (!prepared) return false
+    if (isBlob(prepared.file)) {
+      // @ts-ignore - RN FormData typing không có overload (name, blob, fileName)
+      form.append(field, prepared.file, prepared.name)
+    } else {
+      form.append(field, prepared.file as any)
+    }
+    return true
+  }
+
+  getStats(): ImagePipelineStats {
+    return { ...this.stats }
+  }
+
+  // ============ SOURCE ============
+
+  private async resolve(source: ImageSource, fallbackName: string): Promise<ResolvedSource | null> {
+    if (isBlob(source)) {
+      const name = (source as any).name || fallbackName
+      return { blob: source, name, type: source.type || mimeFromName(name) }
+    }
+
+    const obj = typeof source === 'string' ? { uri: source } : source
+    const uris = [obj.uri, obj.imageURL].filter((u): u is string => typeof u === 'string' && u.length > 0)
+    if (obj.base64) {
+      uris.push(obj.base64.startsWith('data:') ? obj.base64 : `data:${obj.type || 'image/jpeg'};base64,${obj.base64}`)
+    }
+    // Native: ưu tiên file trên đĩa (khỏi giải mã base64); web: URL nào cũng fetch được
+    const uri =
+      Platform.OS === 'web'
+        ? uris[0]
+        : uris.find((u) => !u.startsWith('data:')) ?? uris[0]
+    if (!uri) return null
+
+    const type = normalizeMime(obj.mimeType || obj.type || mimeFromDataUrl(uri) || mimeFromName(obj.fileName || obj.name || ''))
+    let name = (obj.fileName || obj.name || '').trim() || fallbackName
+    if (!name.includes('.')) name = `${name}.${extensionFromMime(type)}`
+    return { uri, name, type, width: obj.width, height: obj.height }
+  }
+
+  private async passthrough(resolved: ResolvedSource): Promise<PreparedImage> {
+    if (Platform.OS === 'web') {
+      const blob = resolved.blob ?? (await fetchBlob(resolved.uri!))
+      return this.result(blob, resolved.name, resolved.type, blob.size, blob.size, false)
+    }
+    const uri = await this.materialize(resolved)
+    const bytes = await fileSize(uri)
+    return this.result({ uri, name: resolved.name, type: resolved.type }, resolved.name, resolved.type, bytes, bytes, false)
+  }
+
+  // ============ NATIVE ============
+
+  private async prepareNative(resolved: ResolvedSource, target: ImageTarget): Promise<PreparedImage> {
+    if (resolved.uri?.startsWith('http')) return this.passthrough(resolved)
+    const uri = await this.materialize(resolved)
+    const originalBytes = await fileSize(uri)
+
+    const size =
+      resolved.width && resolved.height ? { width: resolved.width, height: resolved.height } : await imageSize(uri)
+    const actions: Action[] = []
+    if (size && Math.max(size.width, size.height) > target.maxEdge) {
+      actions.push({
+        resize: size.width >= size.height ? { width: target.maxEdge } : { height: target.maxEdge },
+      })
+    }
+
+    const out = await manipulateAsync(uri, actions, { compress: target.quality, format: SaveFormat.JPEG })
+    const bytes = await fileSize(out.uri)
+    // Ảnh gốc đã nhỏ/nén tốt hơn: giữ bản gốc
+    if (actions.length === 0 && originalBytes > 0 && bytes >= originalBytes) {
+      return this.result({ uri, name: resolved.name, type: resolved.type }, resolved.name, resolved.type, originalBytes, originalBytes, false)
+    }
+    const name = replaceExtension(resolved.name, 'jpg')
+    return {
+      ...this.result({ uri: out.uri, name, type: 'image/jpeg' }, name, 'image/jpeg', originalBytes, bytes, actions.length > 0),
+      width: out.width,
+      height: out.height,
+    }
+  }
+
+  /** Native: đảm bảo có file:// (chỉ nguồn data: mới phải ghi base64 ra file tạm) */
+  private async materialize(resolved: ResolvedSource): Promise<string> {
+    const uri = resolved.uri!
+    if (!uri.startsWith('data:')) return uri
+    const base64Data = uri.slice(uri.indexOf(',') + 1)
+    const baseDir = (FileSystem as any).cacheDirectory ?? (FileSystem as any).documentDirectory ?? ''
+    const tempUri = `${baseDir}upload-${Date.now()}-${resolved.name}`
+    await FileSystem.writeAsStringAsync(tempUri, base64Data, {
+      encoding: (FileSystem as any).EncodingType?.Base64 ?? 'base64',
+    })
+    return tempUri
+  }
+
+  // ============ WEB ============
+
+  private async prepareWeb(resolved: ResolvedSource, target: ImageTarget): Promise<PreparedImage> {
+    const blob = resolved.blob ?? (await fetchBlob(resolved.uri!))
+    const originalBytes = blob.size
+    if (typeof createImageBitmap !== 'function' || !blob.type.startsWith('image/')) {
+      return this.result(blob, resolved.name, resolved.type, originalBytes, originalBytes, false)
+    }
+
+    const bitmap = await createImageBitmap(blob)
+    try {
+      const scale = Math.min(1, target.maxEdge / Math.max(bitmap.width, bitmap.height))
+      const width = Math.round(bitmap.width * scale)
+      const height = Math.round(bitmap.height * scale)
+      const encoded = await encodeJpeg(bitmap, width, height, target.quality)
+      if (!encoded || (scale === 1 && encoded.size >= originalBytes)) {
+        return this.result(blob, resolved.name, resolved.type, originalBytes, originalBytes, false)
+      }
+      const name = replaceExtension(resolved.name, 'jpg')
+      return { ...this.result(encoded, name, 'image/jpeg', originalBytes, encoded.size, scale < 1), width, height }
+    } finally {
+      bitmap.close?.()
+    }
+  }
+
+  // ============ STATS ============
+
+  private result(
+    file: Blob | RNFile,
+    name: string,
+    type: string,
+    originalBytes: number,
+    bytes: number,
+    resized: boolean
+  ): PreparedImage {
+    return { file, name, type, originalBytes, bytes, processingMs: 0, resized }
+  }
+
+  private record(purpose: ImagePurpose, prepared: PreparedImage) {
+    const saved = Math.max(0, prepared.originalBytes - prepared.bytes)
+    const s = this.stats
+    s.images++
+    if (prepared.resized) s.resized++
+    s.originalBytes += prepared.originalBytes
+    s.uploadedBytes += prepared.bytes
+    s.bytesSaved += saved
+    s.processingMs += prepared.processingMs
+    s.estimatedTimeSavedMs = Math.round(s.bytesSaved / UPLINK_BYTES_PER_MS - s.processingMs)
+    track('image_upload_prepared', {
+      purpose,
+      originalBytes: prepared.originalBytes,
+      bytes: prepared.bytes,
+      bytesSaved: saved,
+      processingMs: prepared.processingMs,
+      resized: prepared.resized,
+    })
+  }
+}
+
+// ============ HELPERS ============
+
+const isBlob = (v: any): v is Blob => typeof Blob !== 'undefined' && v instanceof Blob
+
+const normalizeMime = (value?: string | null) => {
+  const v = (value || 'image/jpeg').toLowerCase()
+  if (v.startsWith('image/image')) return 'image/jpeg'
+  return v.includes('/') ? v : `image/${v === 'jpg' || v === 'image' ? 'jpeg' : v}`
+}
+
+const mimeFromDataUrl = (uri: string) =>
+  uri.startsWith('data:') ? uri.substring(5, uri.indexOf(';')) || undefined : undefined
+
+const mimeFromName = (name: string) => {
+  const ext = name.split('.').pop()?.toLowerCase()
+  if (ext === 'png') return 'image/png'
+  if (ext === 'webp') return 'image/webp'
+  if (ext === 'heic' || ext === 'heif') return 'image/heic'
+  return 'image/jpeg'
+}
+
+const extensionFromMime = (mimeType: string) => {
+  const m = mimeType.toLowerCase()
+  if (m.includes('png')) return 'png'
+  if (m.includes('webp')) return 'webp'
+  if (m.includes('heic') || m.includes('heif')) return 'heic'
+  return 'jpg'
+}
+
+const replaceExtension = (name: string, ext: string) => {
+  const dot = name.lastIndexOf('.')
+  return `${dot > 0 ? name.slice(0, dot) : name}.${ext}`
+}
+
+const fetchBlob = async (uri: string): Promise<Blob> => {
+  const resp = await fetch(uri)
+  return await resp.blob()
+}
+
+const fileSize = async (uri: string): Promise<number> => {
+  try {
+    const info: any = await FileSystem.getInfoAsync(uri)
+    return info?.exists && typeof info.size === 'number' ? info.size : 0
+  } catch {
+    return 0
+  }
+}
+
+const imageSize = (uri: string): Promise<{ width: number; height: number } | null> =>
+  new Promise((resolve) => {
+    Image.getSize(
+      uri,
+      (width, height) => resolve({ width, height }),
+      () => resolve(null)
+    )
+  })
+
+const encodeJpeg = async (bitmap: ImageBitmap, width: number, height: number, quality: number): Promise<Blob | null> => {
+  if (typeof OffscreenCanvas !== 'undefined') {
+    const canvas = new OffscreenCanvas(width, height)
+    const ctx = canvas.getContext('2d')
+    if (!ctx) return null
+    ctx.drawImage(bitmap, 0, 0, width, height)
+    return await canvas.convertToBlob({ type: 'image/jpeg', quality })
+  }
+  const canvas = document.createElement('canvas')
+  canvas.width = width
+  canvas.height = height
+  const ctx = canvas.getContext('2d')
+  if (!ctx) return null
+  ctx.drawImage(bitmap, 0, 0, width, height)
+  return await new Promise<Blob | null>((resolve) => canvas.toBlob(resolve, 'image/jpeg', quality))
+}
+
+const imagePipeline = new ImagePipeline()
+export default imagePipeline
@@ -1,9 +1,7 @@
 import api from '@/config/api'
 import { Item, ResponseDTO } from '@/models/types'
 import { Alert } from 'react-native'
-import { Platform } from 'react-native';
-// DÒNG ĐÃ SỬA:
-import * as FileSystem from 'expo-file-system/legacy';
+import imagePipeline from '@/services/imagePipeline'
 interface PaginatedResult<T = any> {
   items: T[]
   totalCount: number
@@ -21,7 +19,7 @@ const itemService = {
     sortOrder?: 'ASC' | 'DESC'
     status?: string
   } = {}) {
-    const res = await api.get(`api/item/get-items-by-user-id`, { params })
+    const res = await api.get(`api/item/get-items-by-user-id`, { params, cache: { tags: ['item'] } })
     return res.data as ResponseDTO<PaginatedResult<any>>
   },
 
@@ -50,139 +48,16 @@ async createItem(payload: any) {
     // 2. Thêm hình ảnh
     const imagesRaw: any[] = payload.ItemImages ?? payload.images ?? []
 
-    // helper: convert data URL to Blob (CHỈ DÙNG CHO WEB)
-    const dataUrlToBlob = async (dataUrl: string) => {
-      // (Hàm này giữ nguyên, nó dùng cho web)
-      try {
-        const resp = await fetch(dataUrl)
-        return await resp.blob()
-      } catch (err) {
-        try {
-          const base64Marker = ';base64,'
-          const parts = dataUrl.split(base64Marker)
-          const contentType = dataUrl.substring(dataUrl.indexOf(':') + 1, dataUrl.indexOf(';'))
-          const raw = atob(parts[1])
-          const rawLength = raw.length
-          const uInt8Array = new Uint8Array(rawLength)
-          for (let i = 0; i < rawLength; ++i) {
-            uInt8Array[i] = raw.charCodeAt(i)
-          }
-          return new Blob([uInt8Array], { type: contentType })
-        } catch (e) {
-          console.warn('Không thể chuyển dataURL sang Blob', e)
-          throw e
-        }
-      }
-    }
-
     for (let i = 0; i < imagesRaw.length; i++) {
-      const img = imagesRaw[i] 
-
+      const img = imagesRaw[i]
       // Lấy URI (fallback sang itemImageURL nếu uri là null)
-      let uri: string | undefined
-      if (typeof img === 'string') uri = img
-      else if (typeof img === 'object') uri = img.uri ?? img.itemImageURL
-      
-      console.log(`>>> [createItem] Đang xử lý ảnh URI: ${uri ? uri.substring(0, 30) + '...' : 'null'}`)
-      
-      if (!uri) {
-        console.warn('Bỏ qua ảnh không hợp lệ (không tìm thấy URI):', img)
-        continue
-      }
-
+      const source = typeof img === 'string' ? img : { ...img, uri: img?.uri ?? img?.itemImageURL }
       try {
-        if (uri.startsWith('data:')) {
-          // ==========================
-          // === L LUỒNG (data:) ===
-          // ==========================
-          
-          if (Platform.OS === 'web') {
-            // === LUỒNG WEB ===
-            console.log('>>> [createItem] Đang xử lý data:URL trên WEB');
-            const blob = await dataUrlToBlob(uri)
-            const fileName = img.fileName || `photo-${Date.now()}-${i}.jpg`
-            // @ts-ignore
-            form.append('ItemImages', blob, fileName)
-
-          } else {
-            // === LUỒNG MOBILE (iOS-Edit) ===
-            console.log('>>> [createItem] Đang xử lý data:URL trên MOBILE (iOS-Edit)');
-            
-            // Tách phần base64 ra
-            const base64Data = uri.split(',')[1];
-            
-            // Lấy tên file và type
-            const fileName = img.fileName || `photo-${Date.now()}.jpg`;
-            const mimeType = img.type || 'image/jpeg';
-
-            // Tạo file tạm
-            // Access cacheDirectory via any cast to avoid TS typing issues; fall back to documentDirectory if needed.
-            const baseDir = (FileSystem as any).cacheDirectory ?? (FileSystem as any).documentDirectory ?? '';
-            const tempUri = baseDir + fileName;
-            
-            // Ghi dữ liệu base64 vào file tạm
-                        await FileSystem.writeAsStringAsync(tempUri, base64Data, {
-                            // Some versions of expo-file-system don't export EncodingType on the module type;
-                            // cast to any to avoid the TypeScript error and fall back to the literal 'base64'.
-                            encoding: (FileSystem as any).EncodingType?.Base64 ?? 'base64',
-                        });
-
-            // Build object file
-            const rnFile: any = {
-                uri: tempUri, // Dùng file: URI của file tạm
-                name: fileName,
-                type: mimeType,
-            }
-
-
-            
-            // @ts-ignore
-            form.append('ItemImages', rnFile);
-          }
-        
-        } else if (uri.startsWith('file://') || uri.startsWith('content://') || uri.startsWith('/')) {
-          // ==================================
-          // === LUỒNG MOBILE (file:) (Android/iOS-No-Edit) ===
-          // ==================================
-          
-          const fileName = img.fileName || `photo-${Date.now()}-${i}.jpg`;
-          const mimeType = img.type || 'image/jpeg';
-
-          const rnFile: any = {
-            uri: uri,
-            name: fileName,
-            type: mimeType,
-          }
-
-          const debugFile = JSON.stringify(rnFile, null, 2);
-          Alert.alert(
-            '>>> [createItem] ĐANG APPEND FILE MOBILE (file://):', 
-            debugFile
-          );
-          
-          // @ts-ignore
-          form.append('ItemImages', rnFile)
-
-        } else if (uri.startsWith('http://') || uri.startsWith('https://')) {
-          // ===========================
-          // === LUỒNG URL (http:) ===
-          // ===========================
-          try {
-            const resp = await fetch(uri)
-            const blob = await resp.blob()
-            const fileName = img.fileName || `photo-${Date.now()}-${i}.jpg`
-            // @ts-ignore
-            form.append('ItemImages', blob, fileName)
-          } catch (e) {
-            console.warn('Không thể tải ảnh từ URL:', uri, e)
-          }
-
-        } else {
-          console.warn('Định dạng URI ảnh không được hỗ trợ:', uri)
-        }
+        const appended = await imagePipeline.append(form, 'ItemImages', source, 'item', `photo-${Date.now()}-${i}.jpg`)
+        if (!appended) console.warn('Bỏ qua ảnh không hợp lệ (không tìm thấy URI):', img)
       } catch (err) {
         console.warn('Lỗi khi xử lý ảnh:', err)
-        Alert.alert('Lỗi xử lý ảnh', (err as Error).message); // Thêm Alert lỗi ở đây
+        Alert.alert('Lỗi xử lý ảnh', (err as Error).message)
       }
     }
 
@@ -212,28 +87,15 @@ async createItem(payload: any) {
 },
 
   async createItemImage(itemId: string, imageDataUrl: string) {
-    // imageDataUrl is expected to be a data URL (data:image/..;base64,...)
+    // imageDataUrl: data URL (data:image/..;base64,...) hoặc file:// của ImagePicker
     try {
-      // convert data URL to Blob (works in browser). In React Native this may not be supported
-      const blob = await (async () => {
-        if (typeof window !== 'undefined' && imageDataUrl.startsWith('data:')) {
-          const res = await fetch(imageDataUrl)
-          return await res.blob()
-        }
-        // Fallback: try to fetch as well (some RN environments support it)
-        const res = await fetch(imageDataUrl)
-        return await res.blob()
-      })()
-
       const form = new FormData()
       // backend expects fields: ItemId (Guid) and File (IFormFile)
       form.append('ItemId', itemId as any)
-      // append file blob with filename
-      // @ts-ignore
-      form.append('File', blob, 'photo.jpg')
+      await imagePipeline.append(form, 'File', imageDataUrl, 'item', 'photo.jpg')
 
       // Let axios/browser set Content-Type including the multipart boundary
-      const res = await api.post('api/itemimages/Create-ItemImage', form)
+      const res = await api.post('api/itemimages/Create-ItemImage', form, { invalidates: ['item'] })
       return res.data as ResponseDTO
     } catch (e: any) {
       console.warn('createItemImage failed', e)
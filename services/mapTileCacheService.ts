@@ -1,4 +1,4 @@
-import AsyncStorage from '@react-native-async-storage/async-storage'
+import persistedState from '@/utils/persistedState'
 
 interface TileBounds {
   minLon: number
@@ -17,7 +17,7 @@ interface CachedRegion {
   sizeBytes: number
 }
 
-const CACHED_REGIONS_KEY = '@cached_regions'
+const CACHED_REGIONS_KEY = '@cached_regions' as const
 
 /**
  * MapTileCacheService - Offline map tile caching
@@ -42,18 +42,13 @@ class MapTileCacheService {
   }
 
   async getCachedRegions(): Promise<CachedRegion[]> {
-    try {
-      const data = await AsyncStorage.getItem(CACHED_REGIONS_KEY)
-      return data ? JSON.parse(data) : []
-    } catch {
-      return []
-    }
+    return ((await persistedState.read(CACHED_REGIONS_KEY)) as CachedRegion[] | null) ?? []
   }
 
   async deleteCachedRegion(regionId: string): Promise<void> {
     const regions = await this.getCachedRegions()
     const updated = regions.filter(r => r.id !== regionId)
-    await AsyncStorage.setItem(CACHED_REGIONS_KEY, JSON.stringify(updated))
+    persistedState.set(CACHED_REGIONS_KEY, updated)
   }
 
   async getCacheSize(): Promise<number> {
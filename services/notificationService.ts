@@ -1,4 +1,6 @@
 import api from '@/config/api'
+import type { RequestPriority } from '@/config/requestScheduler'
+import { CursorPage, CursorPageRequest, offsetCursor, toOffsetPage } from '@/utils/paginatedCollection'
 
 export interface NotificationDTO {
   notificationId: string
@@ -43,10 +45,11 @@ class NotificationService {
   }
 
   // Lấy danh sách thông báo
-  async getMyNotifications(pageNumber: number = 1, pageSize: number = 20) {
+  async getMyNotifications(pageNumber: number = 1, pageSize: number = 20, priority?: RequestPriority) {
     try {
       const response = await api.get('/api/Notification/my-notifications', {
-        params: { pageNumber, pageSize }
+        params: { pageNumber, pageSize },
+        priority,
       })
       return response.data
     } catch (error) {
@@ -55,6 +58,20 @@ class NotificationService {
     }
   }
 
+  // Trang theo cursor cho PaginatedCollection (cursor = số trang)
+  fetchMyNotificationsPage = async ({ cursor, pageSize, prefetch }: CursorPageRequest): Promise<CursorPage<NotificationDTO>> => {
+    const pageNumber = offsetCursor.toPageNumber(cursor)
+    const response = await this.getMyNotifications(pageNumber, pageSize, prefetch ? 'background' : undefined)
+    if (!response?.isSuccess || !response?.result) {
+      throw new Error(response?.message || 'Không thể tải thông báo')
+    }
+    // Backend trả về: { Items, TotalCount, UnreadCount } (PascalCase hoặc camelCase)
+    const result: PaginatedNotificationDTO = response.result
+    return toOffsetPage(result.Items || result.items || [], pageNumber, pageSize, {
+      totalCount: result.TotalCount ?? result.totalCount ?? 0,
+    })
+  }
+
   // Đếm số thông báo chưa đọc
   async getUnreadCount() {
     try {
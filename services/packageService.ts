@@ -1,6 +1,9 @@
 import api from "@/config/api";
-import { Platform, Alert } from 'react-native';
-import * as FileSystem from 'expo-file-system/legacy';
+import { Alert } from 'react-native';
+import imagePipeline from '@/services/imagePipeline';
+import { createLogger } from '@/utils/logger';
+
+const log = createLogger('packageService');
 
 interface ResponseDTO<T = any> {
   isSuccess: boolean;
@@ -12,14 +15,14 @@ interface ResponseDTO<T = any> {
 const packageService = {
   async createPackage(payload: any) {
     try {
-      console.log("📦 [packageService] Creating package with payload:", {
+      log.debug("📦 Creating package with payload:", () => ({
         ...payload,
         images: payload.images?.map((img: any, i: number) => ({
           index: i,
           type: img instanceof File ? 'File' : img instanceof Blob ? 'Blob' : 'URI',
           name: img.name || img.uri || 'unknown'
         }))
-      });
+      }));
       
       const formData = new FormData();
       
@@ -44,139 +47,31 @@ const packageService = {
 
       // Append images - Sử dụng logic giống itemService (đã test thành công)
       if (payload.images && payload.images.length > 0) {
-        console.log(`📸 [packageService] Processing ${payload.images.length} images`);
-        
-        // Helper: convert data URL to Blob (CHỈ DÙNG CHO WEB)
-        const dataUrlToBlob = async (dataUrl: string) => {
-          try {
-            const resp = await fetch(dataUrl);
-            return await resp.blob();
-          } catch (err) {
-            try {
-              const base64Marker = ';base64,';
-              const parts = dataUrl.split(base64Marker);
-              const contentType = dataUrl.substring(dataUrl.indexOf(':') + 1, dataUrl.indexOf(';'));
-              const raw = atob(parts[1]);
-              const rawLength = raw.length;
-              const uInt8Array = new Uint8Array(rawLength);
-              for (let i = 0; i < rawLength; ++i) {
-                uInt8Array[i] = raw.charCodeAt(i);
-              }
-              return new Blob([uInt8Array], { type: contentType });
-            } catch (e) {
-              console.warn('Không thể chuyển dataURL sang Blob', e);
-              throw e;
-            }
-          }
-        };
+        log.debug(() => `📸 Processing ${payload.images.length} images`);
         
         for (let i = 0; i < payload.images.length; i++) {
           const img = payload.images[i];
-          
-          // Lấy URI (fallback sang packageImageURL nếu uri là null)
-          let uri: string | undefined;
-          if (typeof img === 'string') uri = img;
-          else if (typeof img === 'object') uri = img.uri ?? img.packageImageURL;
-          
-          console.log(`>>> [packageService] Đang xử lý ảnh URI: ${uri ? uri.substring(0, 30) + '...' : 'null'}`);
-          
-          if (!uri) {
-            console.warn('Bỏ qua ảnh không hợp lệ (không tìm thấy URI):', img);
-            continue;
-          }
-          
+          // File/Blob (web) dùng trực tiếp; object thì fallback sang packageImageURL nếu uri là null
+          const source =
+            typeof img === 'string' || img instanceof Blob
+              ? img
+              : { ...img, uri: img?.uri ?? img?.packageImageURL };
           try {
-            if (uri.startsWith('data:')) {
-              // ==========================
-              // === LUỒNG (data:) ===
-              // ==========================
-              
-              if (Platform.OS === 'web') {
-                // === LUỒNG WEB ===
-                console.log('>>> [packageService] Đang xử lý data:URL trên WEB');
-                const blob = await dataUrlToBlob(uri);
-                const fileName = img.fileName || `package_${Date.now()}_${i}.jpg`;
-                // @ts-ignore
-                formData.append('PackageImages', blob, fileName);
-                
-              } else {
-                // === LUỒNG MOBILE (iOS-Edit) ===
-                console.log('>>> [packageService] Đang xử lý data:URL trên MOBILE (iOS-Edit)');
-                
-                // Tách phần base64 ra
-                const base64Data = uri.split(',')[1];
-                
-                // Lấy tên file và type
-                const fileName = img.fileName || `package_${Date.now()}.jpg`;
-                const mimeType = img.type || 'image/jpeg';
-                
-                // Tạo file tạm
-                const baseDir = (FileSystem as any).cacheDirectory ?? (FileSystem as any).documentDirectory ?? '';
-                const tempUri = baseDir + fileName;
-                
-                // Ghi dữ liệu base64 vào file tạm
-                await FileSystem.writeAsStringAsync(tempUri, base64Data, {
-                  encoding: (FileSystem as any).EncodingType?.Base64 ?? 'base64',
-                });
-                
-                // Build object file
-                const rnFile: any = {
-                  uri: tempUri, // Dùng file: URI của file tạm
-                  name: fileName,
-                  type: mimeType,
-                };
-                
-                // @ts-ignore
-                formData.append('PackageImages', rnFile);
-              }
-            
-            } else if (uri.startsWith('file://') || uri.startsWith('content://') || uri.startsWith('/')) {
-              // ==================================
-              // === LUỒNG MOBILE (file:) (Android/iOS-No-Edit) ===
-              // ==================================
-              
-              const fileName = img.fileName || `package_${Date.now()}_${i}.jpg`;
-              let mimeType = img.type || 'image/jpeg';
-              // Fix: Đảm bảo MIME type có format đúng (image/jpeg không phải image)
-              if (mimeType && !mimeType.includes('/')) {
-                mimeType = `image/${mimeType}`;
-              }
-              
-              const rnFile: any = {
-                uri: uri,
-                name: fileName,
-                type: mimeType,
-              };
-              
-              console.log(`>>> [packageService] ĐANG APPEND FILE MOBILE (file://): ${JSON.stringify(rnFile)}`);
-              
-              // @ts-ignore
-              formData.append('PackageImages', rnFile);
-              
-            } else if (uri.startsWith('http://') || uri.startsWith('https://')) {
-              // ===========================
-              // === LUỒNG URL (http:) ===
-              // ===========================
-              try {
-                const resp = await fetch(uri);
-                const blob = await resp.blob();
-                const fileName = img.fileName || `package_${Date.now()}_${i}.jpg`;
-                // @ts-ignore
-                formData.append('PackageImages', blob, fileName);
-              } catch (e) {
-                console.warn('Không thể tải ảnh từ URL:', uri, e);
-              }
-              
-            } else {
-              console.warn('Định dạng URI ảnh không được hỗ trợ:', uri);
-            }
+            const appended = await imagePipeline.append(
+              formData,
+              'PackageImages',
+              source,
+              'package',
+              `package_${Date.now()}_${i}.jpg`
+            );
+            if (!appended) console.warn('Bỏ qua ảnh không hợp lệ (không tìm thấy URI):', img);
           } catch (err) {
             console.warn('Lỗi khi xử lý ảnh:', err);
             Alert.alert('Lỗi xử lý ảnh', (err as Error).message);
           }
         }
       } else {
-        console.log("📸 [packageService] No images to upload");
+        log.debug("📸 No images to upload");
       }
 
       const res = await api.post("api/package/provider-create-package", formData, {
@@ -201,7 +96,10 @@ const packageService = {
     } = {}
   ) {
     try {
-      const res = await api.get("api/package/get-packages-by-user", { params });
+      const res = await api.get("api/package/get-packages-by-user", {
+        params,
+        cache: { tags: ["package"] },
+      });
       return res.data;
     } catch (e: any) {
       console.error("getPackagesByUserId failed", e);
@@ -235,7 +133,7 @@ const packageService = {
 
   async updatePackage(payload: any) {
     try {
-      console.log("📦 [packageService.updatePackage] Payload:", payload);
+      log.debug("📦 [updatePackage] Payload:", payload);
       
       const dto = {   
         PackageId: payload.packageId || payload.PackageId,
@@ -257,9 +155,9 @@ const packageService = {
           payload.otherRequirements ?? payload.OtherRequirements ?? "",
       };
       
-      console.log("📦 [packageService.updatePackage] DTO to send:", dto);
+      log.debug("📦 [updatePackage] DTO to send:", dto);
       const res = await api.put("api/package/update-package", dto);
-      console.log("✅ [packageService.updatePackage] Response:", res.data);
+      log.debug("✅ [updatePackage] Response:", res.data);
       return res.data;
     } catch (e: any) {
       console.error("updatePackage failed", e);
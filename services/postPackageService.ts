@@ -1,5 +1,8 @@
 import api from '@/config/api'
 import { vietmapServicesKey } from '@/config/vietmap'
+import { createLogger } from '@/utils/logger'
+
+const log = createLogger('postPackageService')
 
 // --- RESPONSE DTO ---
 interface ResponseDTO<T = any> {
@@ -110,7 +113,7 @@ const geocodeAddress = async (address: string): Promise<{ lat: number; lng: numb
   try {
     // Bước 1: Search API - tìm địa điểm
     const searchUrl = `https://maps.vietmap.vn/api/search/v3?apikey=${vietmapServicesKey}&text=${encodeURIComponent(address)}`
-    console.log('🔍 Step 1: Searching for address:', address)
+    log.debug('🔍 Step 1: Searching for address:', address)
     
     const searchResponse = await fetch(searchUrl)
     
@@ -120,7 +123,7 @@ const geocodeAddress = async (address: string): Promise<{ lat: number; lng: numb
     }
     
     const searchData = await searchResponse.json()
-    console.log('📥 Search results:', searchData?.length || 0, 'found')
+    log.debug(() => `📥 Search results: ${searchData?.length || 0} found`)
     
     // Kiểm tra có kết quả không
     if (!Array.isArray(searchData) || searchData.length === 0) {
@@ -136,12 +139,12 @@ const geocodeAddress = async (address: string): Promise<{ lat: number; lng: numb
       return null
     }
     
-    console.log('✅ Found ref_id:', refId)
-    console.log('   Display:', firstResult.display)
+    log.debug('✅ Found ref_id:', refId)
+    log.debug('   Display:', firstResult.display)
     
     // Bước 2: Place API - lấy tọa độ từ ref_id
     const placeUrl = `https://maps.vietmap.vn/api/place/v3?apikey=${vietmapServicesKey}&refid=${refId}`
-    console.log('🔍 Step 2: Getting coordinates for ref_id:', refId)
+    log.debug('🔍 Step 2: Getting coordinates for ref_id:', refId)
     
     const placeResponse = await fetch(placeUrl)
     
@@ -157,9 +160,9 @@ const geocodeAddress = async (address: string): Promise<{ lat: number; lng: numb
       return null
     }
     
-    console.log('✅ Geocoded successfully!')
-    console.log('   Address:', placeData.display || placeData.name)
-    console.log('   Coordinates:', { lat: placeData.lat, lng: placeData.lng })
+    log.debug('✅ Geocoded successfully!')
+    log.debug('   Address:', () => placeData.display || placeData.name)
+    log.debug('   Coordinates:', () => ({ lat: placeData.lat, lng: placeData.lng }))
     
     return { lat: placeData.lat, lng: placeData.lng }
     
@@ -173,11 +176,11 @@ const geocodeAddress = async (address: string): Promise<{ lat: number; lng: numb
  * Đảm bảo Location có đầy đủ tọa độ bằng cách geocode nếu thiếu
  */
 const ensureLocationCoordinates = async (location: Location): Promise<Location> => {
-  console.log('🔍 ensureLocationCoordinates input:', location)
+  log.debug('🔍 ensureLocationCoordinates input:', location)
   
   // If already has coordinates, validate and return
   if (location.latitude && location.longitude && location.address) {
-    console.log('✅ Location already has coordinates:', location)
+    log.debug('✅ Location already has coordinates:', location)
     return location
   }
 
@@ -187,7 +190,7 @@ const ensureLocationCoordinates = async (location: Location): Promise<Location>
     throw new Error('Địa chỉ không được để trống')
   }
 
-  console.log('🔍 Geocoding address:', location.address)
+  log.debug('🔍 Geocoding address:', location.address)
 
   const coords = await geocodeAddress(location.address)
   
@@ -202,7 +205,7 @@ const ensureLocationCoordinates = async (location: Location): Promise<Location>
     longitude: coords.lng
   }
   
-  console.log('✅ Geocoded result:', result)
+  log.debug('✅ Geocoded result:', result)
   
   // Final validation to ensure all fields are present
   if (!result.address || result.latitude === null || result.latitude === undefined || 
@@ -228,7 +231,7 @@ const calculateRoute = async (dto: RouteCalculationRequestDTO): Promise<Response
       throw new Error('End location must have address, latitude, and longitude')
     }
 
-    console.log('📤 Sending calculate route request:', JSON.stringify(dto, null, 2))
+    log.debug('📤 Sending calculate route request:', dto)
 
     // Gọi Backend API để tính toán (Location đã có đầy đủ tọa độ)
     const response = await api.post<ResponseDTO<RouteCalculationResultDTO>>(
@@ -236,7 +239,7 @@ const calculateRoute = async (dto: RouteCalculationRequestDTO): Promise<Response
       dto
     )
 
-    console.log('📥 Calculate route response:', response.data)
+    log.debug('📥 Calculate route response:', response.data)
 
     return response.data
   } catch (error: any) {
@@ -332,7 +335,8 @@ const getOpenPosts = async (params: {
   sortOrder?: 'ASC' | 'DESC'
 } = {}): Promise<ResponseDTO> => {
   try {
-    const res = await api.get('api/PostPackage/get-open', { params })
+    // Bài được nhận thành chuyến sẽ rời danh sách OPEN => nghe cả tag trip
+    const res = await api.get('api/PostPackage/get-open', { params, cache: { tags: ['postpackage', 'trip'] } })
     return res.data as ResponseDTO
   } catch (error: any) {
     console.error('getOpenPosts failed', error)
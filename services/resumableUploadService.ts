@@ -0,0 +1,191 @@
+import { Platform } from 'react-native'
+import AsyncStorage from '@react-native-async-storage/async-storage'
+import { File } from 'expo-file-system'
+import * as Crypto from 'expo-crypto'
+import api from '@/config/api'
+import imagePipeline, { ImagePurpose, ImageSource } from '@/services/imagePipeline'
+import {
+  ResumableUploader,
+  UploadAdapters,
+  UploadHttpError,
+  UploadProgress,
+  UploadResult,
+  UploadSessionInfo,
+  UploadSlot,
+} from '@/utils/resumableUpload'
+
+/**
+ * Resumable Upload Service - nối ResumableUploader với RN (AsyncStorage, file, axios)
+ *
+ * Bật bằng EXPO_PUBLIC_RESUMABLE_UPLOADS=true khi backend có /api/uploads; tắt thì
+ * appendImage gửi multipart như cũ qua imagePipeline.
+ *
+ * - Native: đọc chunk trực tiếp từ file bằng FileHandle (offset + readBytes), không nạp
+ *   cả file vào JS; SHA-256 bằng expo-crypto.
+ * - Web: Blob giữ trong bộ nhớ theo object URL, chunk = blob.slice(); SHA-256 bằng
+ *   crypto.subtle. Object URL mất khi tải lại trang nên web chỉ tiếp tục trong phiên.
+ * - Mỗi chunk có timeout riêng (30s) thay vì timeout 120s chung của cả request multipart.
+ * - Tiếp tục được trong phiên (mất mạng giữa chừng, chunk lỗi). Qua lần khởi động lại chỉ
+ *   với upload có slot: thao tác tài xế đi qua outbox durable, entry giữ id upload/fileId.
+ * - Tiến độ từng file: components/shared/UploadProgressList (hooks/useUploadProgress).
+ */
+
+const ENABLED = process.env.EXPO_PUBLIC_RESUMABLE_UPLOADS === 'true'
+const CHUNK_TIMEOUT_MS = 30000
+
+// Web: object URL -> Blob (blob:/data: fetch 1 lần rồi slice)
+const webBlobs = new Map<string, Blob>()
+
+const webBlob = async (uri: string): Promise<Blob | null> => {
+  const cached = webBlobs.get(uri)
+  if (cached) return cached
+  try {
+    const blob = await (await fetch(uri)).blob()
+    webBlobs.set(uri, blob)
+    return blob
+  } catch {
+    return null
+  }
+}
+
+const toHex = (buffer: ArrayBuffer) =>
+  Array.from(new Uint8Array(buffer), (b) => b.toString(16).padStart(2, '0')).join('')
+
+const httpError = (e: any): Error => {
+  const status = e?.response?.status
+  if (typeof status === 'number') return new UploadHttpError(e?.message || `HTTP ${status}`, status)
+  return e instanceof Error ? e : new Error(String(e))
+}
+
+const request = async <T>(run: () => Promise<{ data: T }>): Promise<T> => {
+  try {
+    return (await run()).data
+  } catch (e) {
+    throw httpError(e)
+  }
+}
+
+const adapters: UploadAdapters = {
+  storage: AsyncStorage,
+
+  async fileSize(uri) {
+    if (Platform.OS === 'web') {
+      const blob = await webBlob(uri)
+      return blob ? blob.size : -1
+    }
+    try {
+      const file = new File(uri)
+      return file.exists ? file.size ?? -1 : -1
+    } catch {
+      return -1
+    }
+  },
+
+  async readChunk(uri, offset, length) {
+    if (Platform.OS === 'web') {
+      const blob = await webBlob(uri)
+      if (!blob) throw new Error('File nguồn không còn')
+      return new Uint8Array(await blob.slice(offset, offset + length).arrayBuffer())
+    }
+    const handle = new File(uri).open()
+    try {
+      handle.offset = offset
+      return handle.readBytes(length)
+    } finally {
+      handle.close()
+    }
+  },
+
+  async sha256Hex(data) {
+    if (typeof data === 'string') {
+      if (Platform.OS === 'web') {
+        return toHex(await crypto.subtle.digest('SHA-256', new TextEncoder().encode(data)))
+      }
+      return Crypto.digestStringAsync(Crypto.CryptoDigestAlgorithm.SHA256, data)
+    }
+    if (Platform.OS === 'web') return toHex(await crypto.subtle.digest('SHA-256', data))
+    return toHex(await Crypto.digest(Crypto.CryptoDigestAlgorithm.SHA256, data))
+  },
+
+  transport: {
+    createSession: (body) => request(() => api.post<UploadSessionInfo>('api/uploads', body)),
+    getSession: (uploadId) => request(() => api.get<UploadSessionInfo>(`api/uploads/${uploadId}`)),
+    async putChunk(uploadId, index, bytes, sha256) {
+      // Gửi đúng phần của chunk (Uint8Array có thể là view của buffer lớn hơn)
+      const body = bytes.buffer.slice(bytes.byteOffset, bytes.byteOffset + bytes.byteLength)
+      await request(() =>
+        api.put(`api/uploads/${uploadId}/chunks/${index}`, body, {
+          timeout: CHUNK_TIMEOUT_MS,
+          headers: { 'Content-Type': 'application/octet-stream', 'X-Chunk-Sha256': sha256 },
+          transformRequest: (data) => data,
+        })
+      )
+    },
+    complete: (uploadId, body) =>
+      request(() => api.post<UploadResult>(`api/uploads/${uploadId}/complete`, body, { timeout: CHUNK_TIMEOUT_MS })),
+  },
+}
+
+const uploader = new ResumableUploader(adapters)
+
+const resumableUploadService = {
+  isEnabled: () => ENABLED,
+
+  /**
+   * Nén ảnh qua imagePipeline rồi append vào FormData:
+   * - bật resumable: tải theo chunk trước, form chỉ mang `${field}UploadId`. Có `slot` (entry
+   *   outbox) thì dùng lại upload/fileId đã lưu trong slot, không nén và tải lại
+   * - tắt: append file multipart như imagePipeline.append
+   */
+  async appendImage(
+    form: FormData,
+    field: string,
+    source: ImageSource | null | undefined,
+    purpose: ImagePurpose,
+    fallbackName: string,
+    slot?: UploadSlot
+  ): Promise<boolean> {
+    if (!ENABLED) return imagePipeline.append(form, field, source, purpose, fallbackName)
+    if (!source && !slot?.get()) return false
+
+    let uri = null as string | null
+    const prepare = async () => {
+      const prepared = source ? await imagePipeline.prepare(source, purpose, fallbackName) : null
+      if (!prepared) return null
+      if (prepared.file instanceof Blob) {
+        uri = URL.createObjectURL(prepared.file)
+        webBlobs.set(uri, prepared.file)
+      } else {
+        uri = prepared.file.uri
+      }
+      return { uri, fileName: prepared.name, mimeType: prepared.type, size: prepared.bytes > 0 ? prepared.bytes : undefined }
+    }
+    try {
+      const result = slot
+        ? await uploader.uploadInSlot(slot, prepare, { purpose })
+        : await prepare().then((file) => (file ? uploader.upload(file, { purpose }) : null))
+      if (!result) return false
+      form.append(`${field}UploadId`, result.fileId)
+      return true
+    } finally {
+      if (uri && webBlobs.delete(uri)) URL.revokeObjectURL(uri)
+    }
+  },
+
+  /**
+   * Gọi khi app khởi động: tiếp tục upload có owner (thao tác trong outbox, lần gửi lại sẽ
+   * nhận fileId), bỏ upload không owner - form chờ fileId của chúng chỉ nằm trong bộ nhớ.
+   */
+  async resumePending(): Promise<number> {
+    if (!ENABLED) return 0
+    await uploader.discardPending((owner) => !owner)
+    return uploader.resumePending()
+  },
+
+  getProgress: (id: string): UploadProgress | null => uploader.getProgress(id),
+  subscribe: (listener: (progress: UploadProgress) => void) => uploader.subscribe(listener),
+  cancel: (id: string) => uploader.cancel(id),
+  getStats: () => uploader.getStats(),
+}
+
+export default resumableUploadService
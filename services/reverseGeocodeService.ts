@@ -0,0 +1,299 @@
+import AsyncStorage from '@react-native-async-storage/async-storage'
+import NetInfo from '@react-native-community/netinfo'
+import vietmapService from '@/services/vietmapService'
+import { encodeGeohash, geohashNeighborhood } from '@/utils/geohash'
+import { haversine } from '@/utils/navigation'
+import { gazetteer } from '@/utils/gazetteer'
+
+/**
+ * Reverse Geocode Service - toạ độ -> địa chỉ đọc được cho check-in/check-out/báo sự cố
+ *
+ * - Lượng tử hoá vị trí theo ô geohash (mặc định 7 ký tự ~150m), cache bền vững
+ *   trong AsyncStorage với TTL.
+ * - Tra ô hiện tại + 8 ô kề, lấy kết quả gần nhất trong bán kính maxDistanceM
+ *   => tài xế check-in lặp lại ở cùng kho bãi nhận địa chỉ ngay, không gọi mạng.
+ * - Gộp các request đồng thời cho cùng truy vấn (precision + toạ độ làm tròn ~10m),
+ *   có timeout để không treo khi mạng yếu.
+ * - Mạng lỗi: dùng kết quả cache đã hết hạn, rồi mới tới gazetteer offline (cấp tỉnh).
+ * - Luồng gửi (check-in/check-out/báo sự cố) dùng resolveNow(): có mạng thì chờ tra cứu tối đa
+ *   onlineWaitMs, mất mạng thì trả ngay bản dự phòng; màn hình gọi prefetch() lúc mở form
+ *   để tới khi gửi thường đã có sẵn địa chỉ trong cache.
+ */
+
+const CACHE_KEY = '@reverse_geocode_cache_v1'
+const DAY_MS = 24 * 60 * 60 * 1000
+
+export type ReverseGeocodeSource = 'cache' | 'network' | 'stale' | 'offline' | 'coordinates'
+
+export interface ReverseGeocodeResult {
+  address: string
+  source: ReverseGeocodeSource
+  /** Khoảng cách từ vị trí hỏi tới vị trí của kết quả cache (m) */
+  distanceM: number
+}
+
+export interface ReverseGeocodeOptions {
+  precision?: number
+  maxDistanceM?: number
+  ttlMs?: number
+  timeoutMs?: number
+  /** resolveNow(): thời gian tối đa chờ mạng khi đang online */
+  onlineWaitMs?: number
+  maxEntries?: number
+}
+
+interface CacheEntry {
+  lat: number
+  lng: number
+  address: string
+  at: number // thời điểm lấy từ mạng
+  used: number // lần dùng gần nhất, để đuổi LRU
+}
+
+const DEFAULT_OPTIONS: Required<ReverseGeocodeOptions> = {
+  precision: 7,
+  maxDistanceM: 75,
+  ttlMs: 30 * DAY_MS,
+  timeoutMs: 4000,
+  onlineWaitMs: 2500,
+  maxEntries: 500,
+}
+
+const formatCoordinates = (lat: number, lng: number) => `${lat.toFixed(6)}, ${lng.toFixed(6)}`
+
+class ReverseGeocodeService {
+  private options: Required<ReverseGeocodeOptions> = { ...DEFAULT_OPTIONS }
+  // geohash -> các kết quả trong ô
+  private cells = new Map<string, CacheEntry[]>()
+  private entryCount = 0
+  private inflight = new Map<string, Promise<ReverseGeocodeResult>>()
+  private loadPromise: Promise<void> | null = null
+  private persistTimer: ReturnType<typeof setTimeout> | null = null
+  private stats = { cacheHits: 0, networkHits: 0, staleHits: 0, offlineHits: 0, misses: 0 }
+
+  configure(options: ReverseGeocodeOptions) {
+    this.options = { ...this.options, ...options }
+  }
+
+  /** Nạp cache từ AsyncStorage (1 lần, gọi nhiều lần an toàn) */
+  init(): Promise<void> {
+    if (!this.loadPromise) {
+      this.loadPromise = (async () => {
+        try {
+          const raw = await AsyncStorage.getItem(CACHE_KEY)
+          const entries: CacheEntry[] = raw ? JSON.parse(raw) : []
+          for (const entry of entries) this.insert(entry)
+        } catch (e) {
+          console.warn('[ReverseGeocode] load cache failed', e)
+        }
+      })()
+    }
+    return this.loadPromise
+  }
+
+  /**
+   * Địa chỉ cho vị trí. Không bao giờ throw: tệ nhất trả về toạ độ dạng text.
+   */
+  async resolve(lat: number, lng: number): Promise<ReverseGeocodeResult> {
+    await this.init()
+    const now = Date.now()
+
+    const nearest = this.findNearest(lat, lng)
+    if (nearest && now - nearest.entry.at <= this.options.ttlMs) {
+      nearest.entry.used = now
+      this.stats.cacheHits++
+      return { address: nearest.entry.address, source: 'cache', distanceM: nearest.distanceM }
+    }
+
+    // Gộp các lần gọi trùng truy vấn (vd. bấm check-in 2 lần liên tiếp); cùng ô nhưng khác
+    // vị trí/precision thì không dùng chung kết quả của người gọi trước
+    const key = this.requestKey(lat, lng)
+    const pending = this.inflight.get(key)
+    if (pending) return pending
+
+    const task = this.fetchAndCache(lat, lng, nearest).finally(() => this.inflight.delete(key))
+    this.inflight.set(key, task)
+    return task
+  }
+
+  /**
+   * Địa chỉ cho luồng gửi: cache tươi trả ngay; có mạng thì chờ tra cứu (đang chạy hoặc mới)
+   * tối đa onlineWaitMs; mất mạng / quá hạn thì cache hết hạn -> gazetteer -> toạ độ, còn
+   * tra cứu vẫn chạy nền để làm ấm cache. Không bao giờ throw.
+   */
+  async resolveNow(lat: number, lng: number): Promise<ReverseGeocodeResult> {
+    await this.init()
+    const nearest = this.findNearest(lat, lng)
+    if (nearest && Date.now() - nearest.entry.at <= this.options.ttlMs) {
+      nearest.entry.used = Date.now()
+      this.stats.cacheHits++
+      return { address: nearest.entry.address, source: 'cache', distanceM: nearest.distanceM }
+    }
+
+    const lookup = this.resolve(lat, lng)
+    const net = await NetInfo.fetch().catch(() => null)
+    const online = !!net && net.isConnected !== false && net.isInternetReachable !== false
+    if (online) {
+      let timer: ReturnType<typeof setTimeout> | null = null
+      const timeout = new Promise<null>((resolve) => {
+        timer = setTimeout(() => resolve(null), this.options.onlineWaitMs)
+      })
+      const result = await Promise.race([lookup, timeout]).finally(() => timer && clearTimeout(timer))
+      if (result) return result
+    }
+    return this.fallback(lat, lng, nearest)
+  }
+
+  /** Làm ấm cache cho vị trí sắp dùng (vd. lúc mở form check-in) */
+  prefetch(lat: number, lng: number): void {
+    this.resolve(lat, lng).catch(() => {})
+  }
+
+  /** Chỉ tra cache (đồng bộ), không gọi mạng */
+  peek(lat: number, lng: number): string | null {
+    const nearest = this.findNearest(lat, lng)
+    return nearest && Date.now() - nearest.entry.at <= this.options.ttlMs ? nearest.entry.address : null
+  }
+
+  async clear(): Promise<void> {
+    this.cells.clear()
+    this.entryCount = 0
+    try {
+      await AsyncStorage.removeItem(CACHE_KEY)
+    } catch (e) {
+      console.warn('[ReverseGeocode] clear cache failed', e)
+    }
+  }
+
+  getStats() {
+    return { ...this.stats, entries: this.entryCount, cells: this.cells.size }
+  }
+
+  // ============ PRIVATE METHODS ============
+
+  private async fetchAndCache(
+    lat: number,
+    lng: number,
+    nearest: { entry: CacheEntry; distanceM: number } | null
+  ): Promise<ReverseGeocodeResult> {
+    let address: string | null = null
+    try {
+      address = await this.fetchAddress(lat, lng)
+    } catch (e) {
+      console.warn('[ReverseGeocode] network lookup failed', e)
+    }
+
+    if (address) {
+      this.stats.networkHits++
+      this.insert({ lat, lng, address, at: Date.now(), used: Date.now() })
+      this.schedulePersist()
+      return { address, source: 'network', distanceM: 0 }
+    }
+    return this.fallback(lat, lng, nearest)
+  }
+
+  private fallback(
+    lat: number,
+    lng: number,
+    nearest: { entry: CacheEntry; distanceM: number } | null
+  ): ReverseGeocodeResult {
+    if (nearest) {
+      nearest.entry.used = Date.now()
+      this.stats.staleHits++
+      return { address: nearest.entry.address, source: 'stale', distanceM: nearest.distanceM }
+    }
+
+    const coords = formatCoordinates(lat, lng)
+    const area = gazetteer.describeCoarse(lat, lng)
+    if (area) {
+      this.stats.offlineHits++
+      return { address: `${area} (${coords})`, source: 'offline', distanceM: 0 }
+    }
+    this.stats.misses++
+    return { address: coords, source: 'coordinates', distanceM: 0 }
+  }
+
+  private async fetchAddress(lat: number, lng: number): Promise<string | null> {
+    let timer: ReturnType<typeof setTimeout> | null = null
+    const timeout = new Promise<null>((resolve) => {
+      timer = setTimeout(() => resolve(null), this.options.timeoutMs)
+    })
+    try {
+      const results = await Promise.race([vietmapService.searchAddress('', [lng, lat]), timeout])
+      return results && results.length > 0 ? results[0].address || null : null
+    } finally {
+      if (timer) clearTimeout(timer)
+    }
+  }
+
+  private requestKey(lat: number, lng: number): string {
+    return `${this.options.precision}:${lat.toFixed(4)},${lng.toFixed(4)}`
+  }
+
+  private findNearest(lat: number, lng: number): { entry: CacheEntry; distanceM: number } | null {
+    let best: CacheEntry | null = null
+    let bestDist = Infinity
+    for (const cell of geohashNeighborhood(lat, lng, this.options.precision)) {
+      const entries = this.cells.get(cell)
+      if (!entries) continue
+      for (const entry of entries) {
+        const d = haversine([lng, lat], [entry.lng, entry.lat])
+        if (d < bestDist) {
+          bestDist = d
+          best = entry
+        }
+      }
+    }
+    return best && bestDist <= this.options.maxDistanceM ? { entry: best, distanceM: bestDist } : null
+  }
+
+  private insert(entry: CacheEntry) {
+    const cell = encodeGeohash(entry.lat, entry.lng, this.options.precision)
+    const list = this.cells.get(cell) || []
+    // Kết quả mới gần (≤ 10m) kết quả cũ thì thay thế thay vì nhân bản
+    const dupIndex = list.findIndex((e) => haversine([e.lng, e.lat], [entry.lng, entry.lat]) <= 10)
+    if (dupIndex >= 0) {
+      list[dupIndex] = entry
+    } else {
+      list.push(entry)
+      this.entryCount++
+    }
+    this.cells.set(cell, list)
+    if (this.entryCount > this.options.maxEntries) this.evictOldest()
+  }
+
+  private evictOldest() {
+    let worstCell: string | null = null
+    let worstIndex = -1
+    let worstUsed = Infinity
+    for (const [cell, list] of Array.from(this.cells.entries())) {
+      for (let i = 0; i < list.length; i++) {
+        if (list[i].used < worstUsed) {
+          worstUsed = list[i].used
+          worstCell = cell
+          worstIndex = i
+        }
+      }
+    }
+    if (worstCell === null) return
+    const list = this.cells.get(worstCell)!
+    list.splice(worstIndex, 1)
+    if (list.length === 0) this.cells.delete(worstCell)
+    this.entryCount--
+  }
+
+  private schedulePersist() {
+    if (this.persistTimer) clearTimeout(this.persistTimer)
+    this.persistTimer = setTimeout(() => {
+      this.persistTimer = null
+      const entries: CacheEntry[] = []
+      this.cells.forEach((list) => entries.push(...list))
+      AsyncStorage.setItem(CACHE_KEY, JSON.stringify(entries)).catch((e) =>
+        console.warn('[ReverseGeocode] persist cache failed', e)
+      )
+    }, 1000)
+  }
+}
+
+export const reverseGeocodeService = new ReverseGeocodeService()
+export default reverseGeocodeService
@@ -5,7 +5,10 @@
  */
 
 import * as SignalR from '@microsoft/signalr';
-import { getToken } from '@/utils/token';
+import { getValidToken } from '@/utils/token';
+import { createLogger } from '@/utils/logger';
+
+const log = createLogger('SignalR');
 
 export interface LocationUpdate {
   lat: number;
@@ -22,9 +25,11 @@ export interface SignalRConfig {
   onConnectionChange?: (connected: boolean) => void;
   onError?: (error: any) => void;
   disabled?: boolean; // Disable SignalR for simulation-only testing
+  accessTokenFactory?: () => string | Promise<string>; // Override token source (headless/load test)
+  logLevel?: SignalR.LogLevel; // Default Information
 }
 
-class SignalRTrackingService {
+export class SignalRTrackingService {
   private connection: SignalR.HubConnection | null = null;
   private baseURL: string = '';
   private onReceiveLocation?: (location: LocationUpdate) => void;
@@ -35,13 +40,32 @@ class SignalRTrackingService {
   private maxReconnectAttempts: number = 999; // Vô hạn retry
   private manualReconnectTimer?: ReturnType<typeof setInterval>;
   private currentTripId?: string; // Track current trip for manual reconnect
+  // Listener dùng chung (vd. changeFeedService), tồn tại qua các lần tạo lại connection
+  private hubListeners = new Map<string, Set<(...args: any[]) => void>>();
+  private connectionListeners = new Set<(connected: boolean) => void>();
+
+  private initPromise: Promise<void> | null = null;
 
   /**
    * Initialize SignalR Connection
+   * Các lần gọi đồng thời (màn hình chuyến + changeFeedService) được xếp hàng
+   * để không tạo 2 connection.
    */
   public async init(config: SignalRConfig): Promise<void> {
+    while (this.initPromise) {
+      await this.initPromise.catch(() => undefined);
+    }
+    this.initPromise = this.initOnce(config);
+    try {
+      await this.initPromise;
+    } finally {
+      this.initPromise = null;
+    }
+  }
+
+  private async initOnce(config: SignalRConfig): Promise<void> {
     if (config.disabled) {
-      console.log('[SignalR] Disabled - Simulation mode only');
+      log.info('Disabled - Simulation mode only');
       return;
     }
 
@@ -49,14 +73,16 @@ class SignalRTrackingService {
     if (this.connection) {
       // If already connected, just update callbacks
       if (this.connection.state === SignalR.HubConnectionState.Connected) {
-        console.log('[SignalR] Already connected, updating callbacks only');
+        log.info('Already connected, updating callbacks only');
         this.onReceiveLocation = config.onReceiveLocation;
         this.onConnectionChange = config.onConnectionChange;
         this.onError = config.onError;
+        // Connection có sẵn (do service khác mở) => báo trạng thái cho caller mới
+        this.onConnectionChange?.(true);
         return;
       }
       // If not connected but connection exists, log warning
-      console.warn('[SignalR] Connection exists but not connected, state:', this.connection.state);
+      log.warn('Connection exists but not connected, state:', this.connection.state);
       return;
     }
 
@@ -66,14 +92,16 @@ class SignalRTrackingService {
     this.onError = config.onError;
 
     try {
-      const token = await getToken();
+      // Mỗi lần (re)connect lấy token mới nhất từ bộ nhớ: token được làm mới giữa chừng vẫn dùng được
+      const accessTokenFactory = config.accessTokenFactory
+        ?? (async () => (await getValidToken()) || '');
       
       const hubURL = `${this.baseURL}/hubs/tracking`;
-      console.log('[SignalR] Connecting to:', hubURL);
+      log.info('Connecting to:', hubURL);
 
       this.connection = new SignalR.HubConnectionBuilder()
         .withUrl(hubURL, {
-          accessTokenFactory: () => token || '',
+          accessTokenFactory,
           transport: SignalR.HttpTransportType.WebSockets | SignalR.HttpTransportType.LongPolling,
           skipNegotiation: false,
         })
@@ -89,27 +117,29 @@ class SignalRTrackingService {
             }
           },
         })
-        .configureLogging(SignalR.LogLevel.Information)
+        .configureLogging(config.logLevel ?? SignalR.LogLevel.Information)
         .build();
 
       // Event handlers (using arrow functions to preserve 'this' context)
       this.connection.onclose((error) => {
-        console.warn('[SignalR] Connection closed:', error?.message);
-        if (this.onConnectionChange) {
-          this.onConnectionChange(false);
-        }
+        log.warn('Connection closed:', error?.message);
+        this.notifyConnection(false);
         
         // Start manual reconnect timer as backup
         this.startManualReconnect();
       });
 
       this.connection.onreconnecting((error) => {
-        console.log('[SignalR] Reconnecting...', error?.message);
+        log.info('Reconnecting...', error?.message);
         this.reconnectAttempts++;
+        // Báo mất kết nối ngay khi bắt đầu reconnect (không đợi onclose)
+        if (this.reconnectAttempts === 1) {
+          this.notifyConnection(false);
+        }
       });
 
       this.connection.onreconnected((connectionId) => {
-        console.log('[SignalR] Reconnected. ConnectionId:', connectionId);
+        log.info('Reconnected. ConnectionId:', connectionId);
         this.reconnectAttempts = 0;
         this.stopManualReconnect();
         
@@ -119,35 +149,36 @@ class SignalRTrackingService {
           setTimeout(async () => {
             try {
               await this.joinTripGroup(this.currentTripId!);
-              console.log('[SignalR] Auto-rejoined trip:', this.currentTripId);
+              log.info('Auto-rejoined trip:', this.currentTripId);
             } catch (err) {
-              console.error('[SignalR] Failed to rejoin trip:', err);
+              log.error('Failed to rejoin trip:', err);
             }
           }, 100);
         }
         
-        if (this.onConnectionChange) {
-          this.onConnectionChange(true);
-        }
+        this.notifyConnection(true);
       });
 
       // Listen for location updates from server
       this.connection.on('ReceiveLocation', (data: LocationUpdate) => {
-        console.log('[SignalR] ReceiveLocation:', data);
+        log.debug('ReceiveLocation', data);
         if (this.onReceiveLocation) {
           this.onReceiveLocation(data);
         }
       });
 
+      // Listener dùng chung đăng ký trước khi kết nối
+      this.hubListeners.forEach((handlers, method) => {
+        handlers.forEach((handler) => this.connection!.on(method, handler));
+      });
+
       // Start connection
       await this.connection.start();
-      console.log('[SignalR] Connected successfully. ConnectionId:', this.connection.connectionId);
+      log.info('Connected successfully. ConnectionId:', this.connection.connectionId);
       
-      if (this.onConnectionChange) {
-        this.onConnectionChange(true);
-      }
+      this.notifyConnection(true);
     } catch (error: any) {
-      console.error('[SignalR] Connection failed:', error);
+      log.error('Connection failed:', error);
       if (this.onError) {
         this.onError(error);
       }
@@ -164,13 +195,13 @@ class SignalRTrackingService {
     }
 
     try {
-      console.log('[SignalR] Joining trip group:', tripId);
+      log.info('Joining trip group:', tripId);
       this.currentTripId = tripId; // Track current trip
       const result = await this.connection.invoke('JoinTripGroup', tripId);
-      console.log('[SignalR] Joined trip group:', tripId, 'Result:', result);
+      log.info('Joined trip group', { tripId, result });
       return result;
     } catch (error: any) {
-      console.error('[SignalR] Failed to join trip group:', error);
+      log.error('Failed to join trip group:', error);
       throw error;
     }
   }
@@ -180,19 +211,19 @@ class SignalRTrackingService {
    */
   public async leaveTripGroup(tripId: string): Promise<void> {
     if (!this.connection || this.connection.state !== SignalR.HubConnectionState.Connected) {
-      console.warn('[SignalR] Not connected, cannot leave group');
+      log.warn('Not connected, cannot leave group');
       return;
     }
 
     try {
-      console.log('[SignalR] Leaving trip group:', tripId);
+      log.info('Leaving trip group:', tripId);
       await this.connection.invoke('LeaveTripGroup', tripId);
       if (this.currentTripId === tripId) {
         this.currentTripId = undefined; // Clear tracked trip
       }
-      console.log('[SignalR] Left trip group:', tripId);
+      log.info('Left trip group:', tripId);
     } catch (error: any) {
-      console.error('[SignalR] Failed to leave trip group:', error);
+      log.error('Failed to leave trip group:', error);
     }
   }
 
@@ -213,7 +244,7 @@ class SignalRTrackingService {
 
     try {
       await this.connection.invoke('SendLocationUpdate', tripId, lat, lng, bearing, speed);
-      console.log(`[SignalR] Sent location: ${lat}, ${lng}, bearing: ${bearing}, speed: ${speed}`);
+      log.debug(() => `Sent location: ${lat}, ${lng}, bearing: ${bearing}, speed: ${speed}`);
     } catch (error: any) {
       // Silent fail for CORS errors (expected when testing on web)
       const isCorsError = error?.message?.includes('Failed to fetch') || 
@@ -221,20 +252,47 @@ class SignalRTrackingService {
                           error?.message?.includes('Network Error');
       
       if (!isCorsError) {
-        console.error('[SignalR] Failed to send location:', error);
+        log.error('Failed to send location:', error);
         if (this.onError) {
           this.onError(error);
         }
       } else {
         // Just log once for CORS issue (backend needs to enable CORS)
-        if (typeof (window as any).__signalr_cors_warned === 'undefined') {
-          console.warn('[SignalR] ⚠️ CORS Error - Backend needs to enable CORS for', window.location.origin);
+        if (typeof window !== 'undefined' && typeof (window as any).__signalr_cors_warned === 'undefined') {
+          log.warn('⚠️ CORS Error - Backend needs to enable CORS for', window.location.origin);
           (window as any).__signalr_cors_warned = true;
         }
       }
     }
   }
 
+  /**
+   * Đăng ký handler cho 1 hub method trên connection hiện tại và mọi connection tạo sau
+   */
+  public onHubEvent(method: string, handler: (...args: any[]) => void): () => void {
+    let handlers = this.hubListeners.get(method);
+    if (!handlers) {
+      handlers = new Set();
+      this.hubListeners.set(method, handlers);
+    }
+    handlers.add(handler);
+    this.connection?.on(method, handler);
+    return () => {
+      handlers!.delete(handler);
+      this.connection?.off(method, handler);
+    };
+  }
+
+  /**
+   * Nghe trạng thái kết nối (nhiều listener, không thay callback của init)
+   */
+  public addConnectionListener(listener: (connected: boolean) => void): () => void {
+    this.connectionListeners.add(listener);
+    return () => {
+      this.connectionListeners.delete(listener);
+    };
+  }
+
   /**
    * Get connection state
    */
@@ -257,18 +315,16 @@ class SignalRTrackingService {
     if (!this.connection) return;
 
     try {
-      console.log('[SignalR] Disconnecting...');
+      log.info('Disconnecting...');
       this.stopManualReconnect();
       this.currentTripId = undefined;
       await this.connection.stop();
       this.connection = null;
-      console.log('[SignalR] Disconnected');
+      log.info('Disconnected');
       
-      if (this.onConnectionChange) {
-        this.onConnectionChange(false);
-      }
+      this.notifyConnection(false);
     } catch (error: any) {
-      console.error('[SignalR] Error during disconnect:', error);
+      log.error('Error during disconnect:', error);
     }
   }
 
@@ -277,12 +333,12 @@ class SignalRTrackingService {
    */
   public async reconnect(): Promise<void> {
     if (this.connection && this.connection.state === SignalR.HubConnectionState.Connected) {
-      console.log('[SignalR] Already connected');
+      log.info('Already connected');
       return;
     }
 
     if (this.isConnecting) {
-      console.log('[SignalR] Already reconnecting...');
+      log.info('Already reconnecting...');
       return;
     }
 
@@ -294,24 +350,22 @@ class SignalRTrackingService {
       }
       
       await this.connection.start();
-      console.log('[SignalR] Reconnected successfully');
+      log.info('Reconnected successfully');
       
       // Rejoin trip if available
       if (this.currentTripId) {
         try {
           await this.joinTripGroup(this.currentTripId);
-          console.log('[SignalR] Auto-rejoined trip:', this.currentTripId);
+          log.info('Auto-rejoined trip:', this.currentTripId);
         } catch (joinErr) {
-          console.error('[SignalR] Failed to rejoin trip:', joinErr);
+          log.error('Failed to rejoin trip:', joinErr);
           // Don't throw - connection is established, just rejoin failed
         }
       }
       
-      if (this.onConnectionChange) {
-        this.onConnectionChange(true);
-      }
+      this.notifyConnection(true);
     } catch (error: any) {
-      console.error('[SignalR] Reconnect failed:', error);
+      log.error('Reconnect failed:', error);
       if (this.onError) {
         this.onError(error);
       }
@@ -321,20 +375,31 @@ class SignalRTrackingService {
     }
   }
 
+  private notifyConnection(connected: boolean): void {
+    this.onConnectionChange?.(connected);
+    this.connectionListeners.forEach((listener) => {
+      try {
+        listener(connected);
+      } catch (err) {
+        log.warn('Connection listener failed:', err);
+      }
+    });
+  }
+
   /**
    * Start manual reconnect timer (backup when automatic fails)
    */
   private startManualReconnect = (): void => {
     this.stopManualReconnect();
     
-    console.log('[SignalR] Starting manual reconnect timer (30s interval)');
+    log.info('Starting manual reconnect timer (30s interval)');
     this.manualReconnectTimer = setInterval(async () => {
       if (!this.isConnected()) {
-        console.log('[SignalR] Manual reconnect attempt...');
+        log.info('Manual reconnect attempt...');
         try {
           await this.reconnect();
         } catch (err) {
-          console.error('[SignalR] Manual reconnect failed:', err);
+          log.error('Manual reconnect failed:', err);
         }
       } else {
         this.stopManualReconnect();
@@ -349,7 +414,7 @@ class SignalRTrackingService {
     if (this.manualReconnectTimer) {
       clearInterval(this.manualReconnectTimer);
       this.manualReconnectTimer = undefined;
-      console.log('[SignalR] Stopped manual reconnect timer');
+      log.info('Stopped manual reconnect timer');
     }
   }
 }
@@ -1,4 +1,6 @@
 import api from "@/config/api";
+import type { RequestPriority } from "@/config/requestScheduler";
+import { CursorPage, CursorPageRequest, offsetCursor, toOffsetPage } from "@/utils/paginatedCollection";
 
 export interface TransactionDTO {
   transactionId: string;
@@ -31,10 +33,11 @@ const transactionService = {
    * @param pageNumber - Current page number
    * @param pageSize - Number of items per page
    */
-  getAllMyTransactions: async (pageNumber: number = 1, pageSize: number = 10) => {
+  getAllMyTransactions: async (pageNumber: number = 1, pageSize: number = 10, priority?: RequestPriority) => {
     try {
       const response = await api.get('/api/Transaction', {
-        params: { pageNumber, pageSize }
+        params: { pageNumber, pageSize },
+        priority,
       });
       return response.data;
     } catch (error: any) {
@@ -43,6 +46,28 @@ const transactionService = {
     }
   },
 
+  /**
+   * Cursor page adapter for PaginatedCollection (cursor = page number)
+   */
+  fetchMyTransactionsPage: async ({ cursor, pageSize, prefetch }: CursorPageRequest): Promise<CursorPage<TransactionDTO>> => {
+    const pageNumber = offsetCursor.toPageNumber(cursor);
+    const response = await transactionService.getAllMyTransactions(
+      pageNumber,
+      pageSize,
+      prefetch ? 'background' : undefined
+    );
+    if (!response?.isSuccess || !response?.result) {
+      throw new Error(response?.message || 'Không thể tải giao dịch');
+    }
+    // API returns 'data' not 'items', and 'currentPage' not 'pageNumber'
+    const result: PaginatedTransactions = response.result;
+    return toOffsetPage(result.data || [], pageNumber, pageSize, {
+      totalCount: result.totalCount,
+      totalPages: result.totalPages,
+      hasNextPage: result.hasNextPage,
+    });
+  },
+
   /**
    * Get transaction by ID
    * @param transactionId - Transaction ID
@@ -1,6 +1,7 @@
-import api from "@/config/api";
-import { Platform } from "react-native";
-import * as FileSystem from "expo-file-system/legacy";
+import api, { idempotencyHeaders } from "@/config/api";
+import imagePipeline from "@/services/imagePipeline";
+import resumableUploadService from "@/services/resumableUploadService";
+import type { UploadSlot, UploadSlots } from "@/utils/resumableUpload";
 
 export enum DeliveryIssueType {
   DAMAGED = "DAMAGED",
@@ -23,152 +24,32 @@ type IssueImage = {
   type: string;
 };
 
-const normalizeMimeType = (value?: string) => {
-  const v = value || "image/jpeg";
-  return v.includes("/") ? v : `image/${v}`;
-};
-
-const extensionFromMime = (mimeType: string) => {
-  const m = (mimeType || "").toLowerCase();
-  if (m.includes("png")) return "png";
-  if (m.includes("webp")) return "webp";
-  if (m.includes("heic") || m.includes("heif")) return "heic";
-  return "jpg";
-};
-
-const ensureFileName = (value: string | undefined, fallback: string) => {
-  const name = (value || "").trim();
-  return name.length > 0 ? name : fallback;
-};
-
-const dataUrlToBlob = async (dataUrl: string) => {
-  // Web-only helper: convert data URL to Blob
-  try {
-    const resp = await fetch(dataUrl);
-    return await resp.blob();
-  } catch (err) {
-    // Fallback for older browsers
-    const base64Marker = ";base64,";
-    const parts = dataUrl.split(base64Marker);
-    const contentType = dataUrl.substring(
-      dataUrl.indexOf(":") + 1,
-      dataUrl.indexOf(";")
-    );
-    const raw = atob(parts[1]);
-    const rawLength = raw.length;
-    const uInt8Array = new Uint8Array(rawLength);
-    for (let i = 0; i < rawLength; ++i) {
-      uInt8Array[i] = raw.charCodeAt(i);
-    }
-    return new Blob([uInt8Array], { type: contentType });
-  }
-};
-
 const appendIssueImage = async (
   formData: FormData,
   fieldName: string,
   image: Partial<IssueImage>,
-  index: number
+  index: number,
+  slot?: UploadSlot
 ) => {
-  const uri = image.imageURL || image.uri;
-  if (!uri) return;
-
-  const mimeType = normalizeMimeType(image.type);
-  const ext = extensionFromMime(mimeType);
-  let fileName = ensureFileName(
-    image.fileName,
-    `issue_${Date.now()}_${index}.${ext}`
+  // imageURL (data: URL) chỉ là dự phòng: trên native pipeline ưu tiên file:// của uri.
+  // Bật resumable thì tải theo chunk (có tiến độ), tắt thì multipart qua imagePipeline như cũ
+  await resumableUploadService.appendImage(
+    formData,
+    fieldName,
+    image,
+    "issue",
+    `issue_${Date.now()}_${index}.jpg`,
+    slot
   );
-  if (!fileName.includes(".")) fileName = `${fileName}.${ext}`;
-
-  if (uri.startsWith("data:")) {
-    if (Platform.OS === "web") {
-      const blob = await dataUrlToBlob(uri);
-      // @ts-ignore
-      formData.append(fieldName, blob, fileName);
-      return;
-    }
-
-    // Mobile (base64): write to temp file then attach as rnFile
-    const base64Data = uri.split(",")[1];
-    if (!base64Data) return;
-
-    const baseDir =
-      (FileSystem as any).cacheDirectory ??
-      (FileSystem as any).documentDirectory ??
-      "";
-    const tempUri = baseDir + fileName;
-
-    await FileSystem.writeAsStringAsync(tempUri, base64Data, {
-      encoding: (FileSystem as any).EncodingType?.Base64 ?? "base64",
-    });
-
-    const rnFile: any = {
-      uri: tempUri,
-      name: fileName,
-      type: mimeType,
-    };
-    console.log("📎 [TripDeliveryIssue] append data: image", {
-      name: rnFile.name,
-      type: rnFile.type,
-      uriPrefix: String(rnFile.uri).slice(0, 20),
-    });
-    // @ts-ignore
-    formData.append(fieldName, rnFile);
-    return;
-  }
-
-  if (uri.startsWith("content://") && Platform.OS !== "web") {
-    // On Android some servers/multipart impls can't read content:// directly.
-    // Copy to cache and upload the file:// uri.
-    const baseDir =
-      (FileSystem as any).cacheDirectory ??
-      (FileSystem as any).documentDirectory ??
-      "";
-    const tempUri = baseDir + fileName;
-    try {
-      await FileSystem.copyAsync({ from: uri, to: tempUri });
-      const rnFile: any = { uri: tempUri, name: fileName, type: mimeType };
-      console.log("📎 [TripDeliveryIssue] append content:// (copied)", {
-        name: rnFile.name,
-        type: rnFile.type,
-        uriPrefix: String(rnFile.uri).slice(0, 20),
-      });
-      // @ts-ignore
-      formData.append(fieldName, rnFile);
-      return;
-    } catch (e) {
-      console.warn(
-        "⚠️ [TripDeliveryIssue] copyAsync failed, falling back to content://",
-        e
-      );
-      // Fall through to try uploading content:// directly
-    }
-  }
-
-  if (uri.startsWith("file://") || uri.startsWith("content://") || uri.startsWith("/")) {
-    const rnFile: any = { uri, name: fileName, type: mimeType };
-    console.log("📎 [TripDeliveryIssue] append file/content image", {
-      name: rnFile.name,
-      type: rnFile.type,
-      uriPrefix: String(rnFile.uri).slice(0, 20),
-    });
-    // @ts-ignore
-    formData.append(fieldName, rnFile);
-    return;
-  }
-
-  if (uri.startsWith("http://") || uri.startsWith("https://")) {
-    const resp = await fetch(uri);
-    const blob = await resp.blob();
-    // @ts-ignore
-    formData.append(fieldName, blob, fileName);
-    return;
-  }
 };
 
 const tripDeliveryIssueService = {
-  async reportIssue(dto: TripDeliveryIssueCreateDTO, images: IssueImage[]) {
+  async reportIssue(
+    dto: TripDeliveryIssueCreateDTO,
+    images: IssueImage[],
+    idempotencyKey?: string,
+    uploads?: UploadSlots
+  ) {
     try {
       const formData = new FormData();
       
@@ -182,7 +63,7 @@ const tripDeliveryIssueService = {
       
       // Append image files (same approach as item/package upload)
       for (let i = 0; i < images.length; i++) {
-        await appendIssueImage(formData, "Images", images[i], i);
+        await appendIssueImage(formData, "Images", images[i], i, uploads?.(`Images[${i}]`));
       }
 
       console.log("📤 Driver sending FormData with", images.length, "images");
@@ -190,6 +71,7 @@ const tripDeliveryIssueService = {
         timeout: 60000,
         headers: {
           "Content-Type": "multipart/form-data",
+          ...idempotencyHeaders(idempotencyKey),
         },
       });
       return res.data;
@@ -244,14 +126,10 @@ const tripDeliveryIssueService = {
     try {
       // Create form data for image upload
       const formData = new FormData();
-      const fileName = imageUri.split("/").pop() || "image.jpg";
-      const fileType = fileName.split(".").pop() || "jpg";
-
-      formData.append("file", {
-        uri: imageUri,
-        name: fileName,
-        type: `image/${fileType}`,
-      } as any);
+      const fileName = imageUri.startsWith("data:")
+        ? `issue_${Date.now()}.jpg`
+        : imageUri.split("/").pop() || "image.jpg";
+      await imagePipeline.append(formData, "file", imageUri, "issue", fileName);
 
       // Upload to your image service endpoint
       const res = await api.post("api/upload/image", formData, {
@@ -1,4 +1,6 @@
-import api, { apiPublic } from "@/config/api";
+import api, { apiPublic, idempotencyHeaders } from "@/config/api";
+import resumableUploadService from "@/services/resumableUploadService";
+import type { UploadSlots } from "@/utils/resumableUpload";
 
 const tripService = {
   async createForOwner(payload: any) {
@@ -110,7 +112,9 @@ const tripService = {
         queryParams.append("sortDirection", params.sortDirection);
       if (params.status) queryParams.append("status", params.status);
 
-      const res = await api.get(`api/trip/provider?${queryParams.toString()}`);
+      const res = await api.get(`api/trip/provider?${queryParams.toString()}`, {
+        cache: { tags: ["trip"] },
+      });
       return res.data;
     } catch (e: any) {
       console.error("getTripsByProvider failed", e);
@@ -189,9 +193,14 @@ const tripService = {
     }
   },
 
-  async changeStatus(dto: { TripId: string; NewStatus: string }) {
+  async changeStatus(
+    dto: { TripId: string; NewStatus: string },
+    idempotencyKey?: string
+  ) {
     try {
-      const res = await api.put(`api/trip/change-status`, dto);
+      const res = await api.put(`api/trip/change-status`, dto, {
+        headers: idempotencyHeaders(idempotencyKey),
+      });
       return res.data;
     } catch (e: any) {
       console.error("changeStatus failed", e);
@@ -286,7 +295,7 @@ const tripService = {
       Note?: string;
       EvidenceImage?: string | File | null; // File for web, uri string for mobile
     }>;
-  }) {
+  }, idempotencyKey?: string, uploads?: UploadSlots) {
     try {
       // Build FormData if there are any images
       const hasImages = dto.ChecklistItems.some((item) => item.EvidenceImage);
@@ -310,7 +319,8 @@ const tripService = {
         }
 
         // Add checklist items
-        dto.ChecklistItems.forEach((item, index) => {
+        for (let index = 0; index < dto.ChecklistItems.length; index++) {
+          const item = dto.ChecklistItems[index];
           console.log(`🔍 Processing ChecklistItem ${index}:`, item);
           if (!item.TripVehicleHandoverTermResultId) {
             console.error(
@@ -333,26 +343,16 @@ const tripService = {
             formData.append(`ChecklistItems[${index}].Note`, item.Note);
           }
 
-          // Handle image upload
-          if (item.EvidenceImage) {
-            if (typeof item.EvidenceImage === "string") {
-              // Mobile: uri string
-              const uriParts = item.EvidenceImage.split(".");
-              const fileType = uriParts[uriParts.length - 1];
-              formData.append(`ChecklistItems[${index}].EvidenceImage`, {
-                uri: item.EvidenceImage,
-                name: `evidence-${index}.${fileType}`,
-                type: `image/${fileType}`,
-              } as any);
-            } else {
-              // Web: File object
-              formData.append(
-                `ChecklistItems[${index}].EvidenceImage`,
-                item.EvidenceImage
-              );
-            }
-          }
-        });
+          // Ảnh minh chứng: nén qua imagePipeline (uri trên mobile, File trên web)
+          await resumableUploadService.appendImage(
+            formData,
+            `ChecklistItems[${index}].EvidenceImage`,
+            item.EvidenceImage,
+            "evidence",
+            `evidence-${index}.jpg`,
+            uploads?.(`ChecklistItems[${index}].EvidenceImage`)
+          );
+        }
 
         const res = await api.put(
           `api/TripVehicleHandoverRecord/update-checklist`,
@@ -360,6 +360,7 @@ const tripService = {
           {
             headers: {
               "Content-Type": "multipart/form-data",
+              ...idempotencyHeaders(idempotencyKey),
             },
           }
         );
@@ -368,7 +369,8 @@ const tripService = {
         // No images, send as JSON
         const res = await api.put(
           `api/TripVehicleHandoverRecord/update-checklist`,
-          dto
+          dto,
+          { headers: idempotencyHeaders(idempotencyKey) }
         );
         return res.data;
       }
@@ -1,6 +1,20 @@
 import api from "@/config/api";
-import { Platform } from "react-native";
-import * as FileSystem from "expo-file-system/legacy";
+import imagePipeline, { ImageSource } from "@/services/imagePipeline";
+import resumableUploadService from "@/services/resumableUploadService";
+import { createLogger } from "@/utils/logger";
+
+const log = createLogger("vehicleService");
+
+// File giấy tờ từ form: chuỗi URI hoặc object từ ImagePicker (uri + data URL dự phòng)
+const documentSource = (fileObj: any): ImageSource | null => {
+  if (!fileObj) return null;
+  if (typeof fileObj === "string" || fileObj instanceof Blob) return fileObj;
+  return {
+    ...fileObj,
+    uri: fileObj.uri ?? fileObj.vehicleImageURL ?? fileObj.url,
+    imageURL: fileObj.imageURL ?? fileObj.documentImageURL,
+  };
+};
 
 const vehicleService = {
   getMyVehicles: async (params: {
@@ -21,7 +35,8 @@ const vehicleService = {
     if (params.status) queryParams.append("status", params.status);
 
     const res = await api.get(
-      `api/vehicle/get-my-vehicles?${queryParams.toString()}`
+      `api/vehicle/get-my-vehicles?${queryParams.toString()}`,
+      { cache: { tags: ["vehicle"] } }
     );
     return res.data;
   },
@@ -56,57 +71,16 @@ const vehicleService = {
           form.append(`${docPrefix}.ExpirationDate`, String(exp));
 
         const attachFile = async (fileObj: any, fieldName: string) => {
-          if (!fileObj) return;
-          let uri: string | undefined;
-          if (typeof fileObj === "string") uri = fileObj;
-          else if (typeof fileObj === "object")
-            uri =
-              fileObj.uri ??
-              fileObj.vehicleImageURL ??
-              fileObj.imageURL ??
-              fileObj.url;
-          if (!uri) return;
-
-          if (uri.startsWith("data:")) {
-            try {
-              const resp = await fetch(uri);
-              const blob = await resp.blob();
-              // @ts-ignore
-              form.append(
-                `${docPrefix}.${fieldName}`,
-                blob,
-                `${fieldName}-${Date.now()}-${di}.jpg`
-              );
-            } catch (e) {
-              console.warn(
-                "Failed to convert dataUrl to blob for document file",
-                e
-              );
-            }
-          } else if (
-            uri.startsWith("file://") ||
-            uri.startsWith("content://") ||
-            uri.startsWith("/")
-          ) {
-            // @ts-ignore
-            form.append(`${docPrefix}.${fieldName}`, {
-              uri,
-              name: `${fieldName}-${Date.now()}-${di}.jpg`,
-              type: "image/jpeg",
-            });
-          } else {
-            try {
-              const resp = await fetch(uri);
-              const blob = await resp.blob();
-              // @ts-ignore
-              form.append(
-                `${docPrefix}.${fieldName}`,
-                blob,
-                `${fieldName}-${Date.now()}-${di}.jpg`
-              );
-            } catch (e) {
-              console.warn("Unsupported document file URI, skipping:", uri, e);
-            }
+          try {
+            await resumableUploadService.appendImage(
+              form,
+              `${docPrefix}.${fieldName}`,
+              documentSource(fileObj),
+              "vehicleDocument",
+              `${fieldName}-${Date.now()}-${di}.jpg`
+            );
+          } catch (e) {
+            console.warn("Unsupported document file, skipping:", fieldName, e);
           }
         };
 
@@ -159,31 +133,6 @@ const vehicleService = {
       const imagesRaw: any[] =
         payload.VehicleImages ?? payload.vehicleImages ?? payload.images ?? [];
 
-      const dataUrlToBlob = async (dataUrl: string) => {
-        try {
-          const resp = await fetch(dataUrl);
-          return await resp.blob();
-        } catch (err) {
-          try {
-            const base64Marker = ";base64,";
-            const parts = dataUrl.split(base64Marker);
-            const contentType = dataUrl.substring(
-              dataUrl.indexOf(":") + 1,
-              dataUrl.indexOf(";")
-            );
-            const raw = atob(parts[1]);
-            const rawLength = raw.length;
-            const uInt8Array = new Uint8Array(rawLength);
-            for (let i = 0; i < rawLength; ++i)
-              uInt8Array[i] = raw.charCodeAt(i);
-            return new Blob([uInt8Array], { type: contentType });
-          } catch (e) {
-            console.warn("dataUrlToBlob fallback failed", e);
-            throw e;
-          }
-        }
-      };
-
       for (let i = 0; i < imagesRaw.length; i++) {
         const img = imagesRaw[i];
         const imgPrefix = `VehicleImages[${i}]`;
@@ -199,55 +148,16 @@ const vehicleService = {
         form.append(`${imgPrefix}.ImageType`, String(imageType));
         if (caption) form.append(`${imgPrefix}.Caption`, caption);
 
-        if (uri.startsWith("data:")) {
-          try {
-            const blob = await dataUrlToBlob(uri);
-            // @ts-ignore
-            form.append(
-              `${imgPrefix}.ImageFile`,
-              blob,
-              `vehicle-${Date.now()}-${i}.jpg`
-            );
-          } catch (e) {
-            console.warn(
-              "Failed to convert dataUrl to blob for vehicle image",
-              e
-            );
-          }
-        } else if (
-          uri.startsWith("file://") ||
-          uri.startsWith("content://") ||
-          uri.startsWith("/")
-        ) {
-          // Get MIME type from image object and validate it
-          let mimeType = img.type || "image/jpeg";
-          if (mimeType && !mimeType.includes('/')) {
-            mimeType = `image/${mimeType}`;
-          }
-          
-          const rnFile = {
-            uri,
-            name: img.fileName || `vehicle-${Date.now()}-${i}.jpg`,
-            type: mimeType,
-          };
-          
-          console.log(`>>> [vehicleService] APPEND FILE MOBILE:`, JSON.stringify(rnFile));
-          
-          // @ts-ignore
-          form.append(`${imgPrefix}.ImageFile`, rnFile);
-        } else {
-          try {
-            const resp = await fetch(uri);
-            const blob = await resp.blob();
-            // @ts-ignore
-            form.append(
-              `${imgPrefix}.ImageFile`,
-              blob,
-              `vehicle-${Date.now()}-${i}.jpg`
-            );
-          } catch (e) {
-            console.warn("Unsupported vehicle image URI, skipping:", uri, e);
-          }
+        try {
+          await resumableUploadService.appendImage(
+            form,
+            `${imgPrefix}.ImageFile`,
+            typeof img === "string" ? img : { ...img, uri },
+            "vehicle",
+            `vehicle-${Date.now()}-${i}.jpg`
+          );
+        } catch (e) {
+          console.warn("Unsupported vehicle image, skipping:", uri, e);
         }
       }
 
@@ -264,56 +174,16 @@ const vehicleService = {
           form.append(`${docPrefix}.ExpirationDate`, String(exp));
 
         const attachFile = async (fileObj: any, fieldName: string) => {
-          if (!fileObj) return;
-          let uri: string | undefined;
-          if (typeof fileObj === "string") uri = fileObj;
-          else if (typeof fileObj === "object")
-            uri =
-              fileObj.uri ??
-              fileObj.vehicleImageURL ??
-              fileObj.imageURL ??
-              fileObj.url;
-          if (!uri) return;
-
-          if (uri.startsWith("data:")) {
-            try {
-              const blob = await dataUrlToBlob(uri);
-              // @ts-ignore
-              form.append(
-                `${docPrefix}.${fieldName}`,
-                blob,
-                `${fieldName}-${Date.now()}-${di}.jpg`
-              );
-            } catch (e) {
-              console.warn(
-                "Failed to convert dataUrl to blob for document file",
-                e
-              );
-            }
-          } else if (
-            uri.startsWith("file://") ||
-            uri.startsWith("content://") ||
-            uri.startsWith("/")
-          ) {
-            // @ts-ignore
-            form.append(`${docPrefix}.${fieldName}`, {
-              uri,
-              name: `${fieldName}-${Date.now()}-${di}.jpg`,
-              type: "image/jpeg",
-            });
-          } else {
-            try {
-              const resp = await fetch(uri);
-              const blob = await resp.blob();
-              // @ts-ignore
-              form.append(
-                `${docPrefix}.${fieldName}`,
-                blob,
-                `${fieldName}-${Date.now()}-${di}.jpg`
-              );
-            } catch (e) {
-              console.warn("Unsupported document file URI, skipping:", uri, e);
-            }
+          try {
+            await resumableUploadService.appendImage(
+              form,
+              `${docPrefix}.${fieldName}`,
+              documentSource(fileObj),
+              "vehicleDocument",
+              `${fieldName}-${Date.now()}-${di}.jpg`
+            );
+          } catch (e) {
+            console.warn("Unsupported document file, skipping:", fieldName, e);
           }
         };
 
@@ -368,187 +238,22 @@ const vehicleService = {
         if (parts.length === 3) {
           const isoDate = `${parts[2]}-${parts[1]}-${parts[0]}`; // yyyy-MM-dd
           formData.append("ExpirationDate", isoDate);
-          console.log(
-            `ExpirationDate converted: ${documentData.expirationDate} → ${isoDate}`
-          );
+          log.debug(() => `ExpirationDate converted: ${documentData.expirationDate} → ${isoDate}`);
         } else {
           formData.append("ExpirationDate", documentData.expirationDate);
         }
       }
 
-      // Helper to convert data URL to Blob (for WEB)
-      const dataUrlToBlob = async (dataUrl: string) => {
-        try {
-          const resp = await fetch(dataUrl);
-          return await resp.blob();
-        } catch (err) {
-          try {
-            const base64Marker = ";base64,";
-            const parts = dataUrl.split(base64Marker);
-            const contentType = dataUrl.substring(
-              dataUrl.indexOf(":") + 1,
-              dataUrl.indexOf(";")
-            );
-            const raw = atob(parts[1]);
-            const rawLength = raw.length;
-            const uInt8Array = new Uint8Array(rawLength);
-            for (let i = 0; i < rawLength; ++i) {
-              uInt8Array[i] = raw.charCodeAt(i);
-            }
-            return new Blob([uInt8Array], { type: contentType });
-          } catch (e) {
-            console.warn("dataUrlToBlob fallback failed", e);
-            throw e;
-          }
-        }
-      };
-
-      // Helper function to attach file - COPY TỪ ItemService
       const attachFile = async (fileObj: any, fieldName: string) => {
-        if (!fileObj) return;
-
-        // Ưu tiên imageURL (dataURL) trước, sau đó base64, cuối cùng là uri
-        let uri: string | undefined;
-        if (fileObj.imageURL && fileObj.imageURL.startsWith("data:")) {
-          uri = fileObj.imageURL;
-        } else if (fileObj.base64) {
-          uri = fileObj.base64.startsWith("data:")
-            ? fileObj.base64
-            : `data:image/jpeg;base64,${fileObj.base64}`;
-        } else if (fileObj.uri) {
-          uri = fileObj.uri;
-        }
-
-        if (!uri) {
-          console.warn(`${fieldName}: No URI or base64 found`);
-          return;
-        }
-
-        console.log(
-          `>>> [addVehicleDocument] Attaching ${fieldName}: ${uri.substring(
-            0,
-            30
-          )}...`
-        );
-
         try {
-          if (uri.startsWith("data:")) {
-            // ===========================
-            // === LUỒNG DATA: URL ===
-            // ===========================
-
-            if (Platform.OS === "web") {
-              // === WEB: Convert to Blob ===
-              console.log(
-                `>>> [addVehicleDocument] Web: Converting data:URL to Blob for ${fieldName}`
-              );
-              const blob = await dataUrlToBlob(uri);
-              const fileName =
-                fileObj.fileName || `${fieldName}-${Date.now()}.jpg`;
-              // @ts-ignore
-              formData.append(fieldName, blob, fileName);
-            } else {
-              // === MOBILE: Write base64 to temp file then use file:// URI ===
-              console.log(
-                `>>> [addVehicleDocument] Mobile: Writing base64 to temp file for ${fieldName}`
-              );
-
-              const base64Data = uri.split(",")[1];
-              const fileName =
-                fileObj.fileName || `${fieldName}-${Date.now()}.jpg`;
-              
-              // MIME type validation - ensure proper format
-              let mimeType = fileObj.type || "image/jpeg";
-              // If type is just "image" or "jpeg", convert to "image/jpeg"
-              if (mimeType && !mimeType.includes('/')) {
-                // If it's already prefixed with "image", don't add prefix again
-                mimeType = "image/jpeg"; // Default to jpeg
-              } else if (mimeType.startsWith('image/image')) {
-                // Fix double prefix
-                mimeType = "image/jpeg";
-              }
-              console.log(`>>> [addVehicleDocument] MIME type for ${fieldName}: ${mimeType}`);
-
-              const baseDir =
-                (FileSystem as any).cacheDirectory ??
-                (FileSystem as any).documentDirectory ??
-                "";
-              const tempUri = baseDir + fileName;
-
-              console.log(`>>> [addVehicleDocument] Writing to: ${tempUri}`);
-              await FileSystem.writeAsStringAsync(tempUri, base64Data, {
-                encoding: (FileSystem as any).EncodingType?.Base64 ?? "base64",
-              });
-              console.log(`>>> [addVehicleDocument] Write successful: ${tempUri}`);
-
-              const rnFile: any = {
-                uri: tempUri,
-                name: fileName,
-                type: mimeType,
-              };
-
-              console.log(`>>> [addVehicleDocument] Appending file:`, { uri: tempUri, name: fileName, type: mimeType });
-              // @ts-ignore
-              formData.append(fieldName, rnFile);
-            }
-          } else if (
-            uri.startsWith("file://") ||
-            uri.startsWith("content://") ||
-            uri.startsWith("/")
-          ) {
-            // ===================================
-            // === LUỒNG MOBILE (file:) ===
-            // ===================================
-            console.log(
-              `>>> [addVehicleDocument] Mobile file:// for ${fieldName}`
-            );
-
-            const fileName =
-              fileObj.fileName || `${fieldName}-${Date.now()}.jpg`;
-            
-            // MIME type validation
-            let mimeType = fileObj.type || "image/jpeg";
-            if (mimeType && !mimeType.includes('/')) {
-              mimeType = `image/${mimeType}`;
-            }
-
-            const rnFile: any = {
-              uri: uri,
-              name: fileName,
-              type: mimeType,
-            };
-
-            // @ts-ignore
-            formData.append(fieldName, rnFile);
-          } else if (uri.startsWith("http://") || uri.startsWith("https://")) {
-            // ===========================
-            // === LUỒNG HTTP(S) URL ===
-            // ===========================
-            console.log(
-              `>>> [addVehicleDocument] Fetching http(s):// for ${fieldName}`
-            );
-            const resp = await fetch(uri);
-            const blob = await resp.blob();
-            // @ts-ignore
-            formData.append(fieldName, blob, `${fieldName}-${Date.now()}.jpg`);
-          } else if (uri.startsWith("blob:")) {
-            // ===========================
-            // === LUỒNG BLOB: URL (WEB) ===
-            // ===========================
-            console.log(
-              `>>> [addVehicleDocument] Web: Converting blob: URL for ${fieldName}`
-            );
-            const resp = await fetch(uri);
-            const blob = await resp.blob();
-            const fileName =
-              fileObj.fileName || `${fieldName}-${Date.now()}.jpg`;
-            // @ts-ignore
-            formData.append(fieldName, blob, fileName);
-          } else {
-            console.warn(
-              `${fieldName}: Định dạng URI không được hỗ trợ: ${uri}`
-            );
-          }
+          const appended = await resumableUploadService.appendImage(
+            formData,
+            fieldName,
+            documentSource(fileObj),
+            "vehicleDocument",
+            `${fieldName}-${Date.now()}.jpg`
+          );
+          if (!appended) console.warn(`${fieldName}: No URI or base64 found`);
         } catch (err) {
           console.warn(`Lỗi khi xử lý ${fieldName}:`, err);
         }
@@ -562,10 +267,7 @@ const vehicleService = {
         await attachFile(documentData.backFile, "BackFile");
       }
 
-      console.log(
-        "Sending FormData to API:",
-        `api/VehicleDocument/add/${vehicleId}`
-      );
+      log.debug(() => `Sending FormData to api/VehicleDocument/add/${vehicleId}`);
 
       // Send FormData with explicit multipart/form-data header
       const res = await api.post(
@@ -1,6 +1,6 @@
 import { vietmapServicesKey } from '@/vietmap_config'
 
-type AutocompleteParams = {
+export type AutocompleteParams = {
   text: string
   focus?: { lat: number; lng: number }
   display_type?: number
@@ -22,21 +22,23 @@ const buildUrl = (p: AutocompleteParams) => {
   return `${BASE}?${qs.toString()}`
 }
 
-const autocomplete = async (params: AutocompleteParams) => {
+const isAbortError = (e: any) => e?.name === 'AbortError'
+
+/**
+ * Gọi autocomplete. Truyền signal để huỷ request cũ; khi bị huỷ sẽ ném AbortError.
+ * Lỗi mạng / HTTP cũng được ném ra (không trả []) để nơi gọi không cache nhầm
+ * "không có gợi ý" cho một lỗi thoáng qua.
+ */
+const autocomplete = async (params: AutocompleteParams, options?: { signal?: AbortSignal }) => {
   if (!params.text || params.text.trim().length === 0) return []
-  try {
-    const url = buildUrl(params)
-    const resp = await fetch(url)
-    if (!resp.ok) throw new Error(`Vietmap autocomplete failed: ${resp.status}`)
-    const data = await resp.json()
-    // API returns an array of place objects
-    return Array.isArray(data) ? data : (data?.result ?? [])
-  } catch (e) {
-    console.warn('vietmapAutocompleteService.autocomplete error', e)
-    return []
-  }
+  const url = buildUrl(params)
+  const resp = await fetch(url, { signal: options?.signal })
+  if (!resp.ok) throw new Error(`Vietmap autocomplete failed: ${resp.status}`)
+  const data = await resp.json()
+  // API returns an array of place objects
+  return Array.isArray(data) ? data : (data?.result ?? [])
 }
 
-const vietmapAutocompleteService = { autocomplete }
+const vietmapAutocompleteService = { autocomplete, isAbortError }
 
 export default vietmapAutocompleteService
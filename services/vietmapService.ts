@@ -1,6 +1,8 @@
 import { vietmapServicesKey } from '@/config/vietmap'
 import type { Position } from 'geojson'
 import { decodePolyline } from '@/utils/polyline'
+import requestScheduler from '@/config/requestScheduler'
+import apiTelemetry from '@/config/apiTelemetry'
 
 const ROUTE_URL = 'https://maps.vietmap.vn/api/route/v3'
 
@@ -102,7 +104,12 @@ const vietmapService = {
       // Debug: log final request URL
       try { console.debug('VietMap route URL:', url) } catch {}
 
-      const res = await fetch(url, { method: 'GET', headers: { 'Accept': 'application/json' } })
+      // Route đi qua hàng đợi chung với slot critical: không bị upload/prefetch chặn
+      const res = await requestScheduler.run('critical', () =>
+        apiTelemetry.measureFetch('vietmap', 'GET', ROUTE_URL, () =>
+          fetch(url, { method: 'GET', headers: { 'Accept': 'application/json' } })
+        )
+      )
       let data: any = null
 
       if (!res.ok) {
@@ -226,7 +233,11 @@ const vietmapService = {
       const url = `${ROUTE_URL}?${params.toString()}`
       try { console.debug('VietMap route URL:', url) } catch {}
 
-      const res = await fetch(url, { method: 'GET', headers: { Accept: 'application/json' } })
+      const res = await requestScheduler.run('critical', () =>
+        apiTelemetry.measureFetch('vietmap', 'GET', ROUTE_URL, () =>
+          fetch(url, { method: 'GET', headers: { Accept: 'application/json' } })
+        )
+      )
       let data: any = null
 
       if (!res.ok) {
@@ -301,7 +312,9 @@ const vietmapService = {
         url += `&focus=${focus[1]},${focus[0]}`
       }
 
-      const res = await fetch(url, { method: 'GET', headers: { Accept: 'application/json' } })
+      const res = await apiTelemetry.measureFetch('vietmap', 'GET', url, () =>
+        fetch(url, { method: 'GET', headers: { Accept: 'application/json' } })
+      )
       if (!res.ok) {
         console.warn('Search API failed', res.status)
         return []
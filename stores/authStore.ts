@@ -1,9 +1,13 @@
 // src/stores/authStore.ts
 import { create } from 'zustand'
-import AsyncStorage from '@react-native-async-storage/async-storage'
 import { jwtDecode } from 'jwt-decode'
 import { AuthenticatedUser } from '@/models/types'
 import { authService } from '@/services/authService'
+import { clearAllUserData, hydrateToken, refreshToken, setToken } from '@/utils/token'
+import persistedState from '@/utils/persistedState'
+import { prefetchRoleBundle } from '@/utils/roleBundles'
+import requestCache from '@/config/requestCache'
+import { useEntityStore } from './entityStore'
 
 interface AuthState {
   user: AuthenticatedUser | null
@@ -22,19 +26,23 @@ export const useAuthStore = create<AuthState>((set) => ({
 
   restoreSession: async () => {
     try {
-      const token = await AsyncStorage.getItem('accessToken')
-      const userStr = await AsyncStorage.getItem('user')
-      const walletStr = await AsyncStorage.getItem('wallet')
-      const verifyStr = await AsyncStorage.getItem('verificationStatus')
-      if (token && userStr) {
+      // 1 lượt đọc storage cho mọi key lúc khởi động (xem utils/persistedState)
+      await persistedState.hydrate()
+      const token = persistedState.get('accessToken')
+      const storedRefresh = persistedState.get('refreshToken')
+      const storedUser = persistedState.get('user')
+      if (token && storedUser) {
         const decoded: any = jwtDecode(token)
-        
-        if (decoded.exp * 1000 > Date.now()) {
-          const storedUser = JSON.parse(userStr)
-          let storedWallet = walletStr ? JSON.parse(walletStr) : null
+        // Nạp token vào bộ nhớ 1 lần: từ đây interceptor không đọc AsyncStorage nữa
+        hydrateToken(token, storedRefresh ?? storedUser?.refreshToken ?? null)
+
+        // Access token đã hết hạn nhưng còn refresh token: làm mới thay vì bắt đăng nhập lại
+        const alive = decoded.exp * 1000 > Date.now() || !!(await refreshToken())
+        if (alive) {
+          let storedWallet = persistedState.get('wallet') ?? null
           // if backend response DTO was stored accidentally, extract result
           if (storedWallet && storedWallet.result) storedWallet = storedWallet.result
-          const verifyData = verifyStr ? JSON.parse(verifyStr) : null
+          const verifyData = persistedState.get('verificationStatus') ?? null
           set({ 
             user: storedUser, 
             wallet: storedWallet, 
@@ -45,7 +53,8 @@ export const useAuthStore = create<AuthState>((set) => ({
           return
         }
       }
-      await AsyncStorage.multiRemove(['accessToken', 'user'])
+      hydrateToken(null)
+      persistedState.remove(['accessToken', 'refreshToken', 'user'])
     } catch (e) {
       console.error('restoreSession error', e)
     } finally {
@@ -54,9 +63,11 @@ export const useAuthStore = create<AuthState>((set) => ({
   },
 
   login: async (userData) => {
-    await AsyncStorage.setItem('accessToken', userData.accessToken)
-    await AsyncStorage.setItem('user', JSON.stringify(userData))
+    await setToken(userData.accessToken, userData.refreshToken)
+    persistedState.set('user', userData)
     set({ user: userData })
+    // Tải chunk màn home của role trong lúc chờ ví / trạng thái xác minh
+    prefetchRoleBundle(userData.role)
 
     // fetch wallet and verification status after login (best-effort)
     try {
@@ -65,7 +76,7 @@ export const useAuthStore = create<AuthState>((set) => ({
       const w = await walletService.getMyWallet()
       if (w && w.isSuccess !== false) {
         const walletObj = (w.result ?? w.data) || w
-        await AsyncStorage.setItem('wallet', JSON.stringify(walletObj))
+        persistedState.set('wallet', walletObj)
         set({ wallet: walletObj })
       }
       const verifyResp = await ekycService.checkVerifiedStatus()
@@ -78,7 +89,7 @@ export const useAuthStore = create<AuthState>((set) => ({
           isVerified,
           message
         }
-        await AsyncStorage.setItem('verificationStatus', JSON.stringify(statusData))
+        persistedState.set('verificationStatus', statusData)
         set({ 
           isVerified: statusData.isVerified,
           verificationMessage: statusData.message
@@ -95,10 +106,13 @@ export const useAuthStore = create<AuthState>((set) => ({
       // Gọi API logout với token trong header (interceptor tự động gán)
       // API sẽ tự xóa token nếu thành công
       await authService.logout()
+      requestCache.clear()
+      useEntityStore.getState().clear()
       
       // API thành công → xóa các dữ liệu local khác
       console.log('🔄 Clearing local user data...')
-      await AsyncStorage.multiRemove(['user', 'wallet', 'verificationStatus'])
+      persistedState.remove(['user', 'wallet', 'verificationStatus'])
+      await persistedState.flush()
       set({ user: null, wallet: null, isVerified: false, verificationMessage: '' })
       console.log('✅ Logout completed successfully')
     } catch (e) {
@@ -106,7 +120,9 @@ export const useAuthStore = create<AuthState>((set) => ({
       
       // API failed → có thể vẫn xóa local data để user có thể logout
       // Hoặc throw error để UI hiển thị lỗi cho user
-      await AsyncStorage.multiRemove(['accessToken', 'user', 'wallet', 'verificationStatus'])
+      await clearAllUserData()
+      requestCache.clear()
+      useEntityStore.getState().clear()
       set({ user: null, wallet: null, isVerified: false, verificationMessage: '' })
       console.warn('⚠️ Forced local logout due to API failure')
       
@@ -0,0 +1,236 @@
+import { useEffect } from 'react'
+import { create } from 'zustand'
+import { useShallow } from 'zustand/react/shallow'
+
+/**
+ * Entity Store - kho dữ liệu chuẩn hoá theo ID dùng chung giữa các màn hình
+ *
+ * - Mỗi loại (trip, assignment, vehicle, package, post) là 1 map id -> entity,
+ *   mỗi loại giữ đúng 1 dạng dữ liệu (vehicle/package/post: dạng đã map ở hook,
+ *   trip: payload chi tiết từ tripService.getById).
+ * - upsert gộp cập nhật từng phần với structural sharing: nhánh không đổi giữ
+ *   nguyên reference, không đổi gì thì không set state => selector không re-render.
+ * - Giới hạn số entity mỗi loại theo LRU; entity đang được component dùng
+ *   (useEntity/useEntityList) không bị đuổi.
+ */
+
+export type EntityKind = 'trip' | 'assignment' | 'vehicle' | 'package' | 'post'
+
+type EntityMap = Record<string, any>
+
+const ENTITY_KINDS: EntityKind[] = ['trip', 'assignment', 'vehicle', 'package', 'post']
+
+const ENTITY_CAPS: Record<EntityKind, number> = {
+  trip: 100,
+  assignment: 300,
+  vehicle: 200,
+  package: 500,
+  post: 300,
+}
+
+const ENTITY_ID_FIELDS: Record<EntityKind, string[]> = {
+  trip: ['tripId', 'TripId', 'id'],
+  assignment: ['tripDriverAssignmentId', 'TripDriverAssignmentId', 'assignmentId', 'id'],
+  vehicle: ['vehicleId', 'VehicleId', 'id'],
+  package: ['packageId', 'PackageId', 'id'],
+  post: ['postTripId', 'PostTripId', 'postPackageId', 'PostPackageId', 'id'],
+}
+
+export const entityIdOf = (kind: EntityKind, raw: any): string | null => {
+  if (!raw) return null
+  for (const field of ENTITY_ID_FIELDS[kind]) {
+    const v = raw[field]
+    if (v !== undefined && v !== null && v !== '') return String(v)
+  }
+  return null
+}
+
+const isPlainObject = (v: any): v is Record<string, any> =>
+  v !== null && typeof v === 'object' && Object.getPrototypeOf(v) === Object.prototype
+
+/**
+ * Gộp next vào prev, giữ reference của mọi nhánh không đổi.
+ * Object: gộp từng phần (key undefined = không cập nhật). Mảng: thay thế, nhưng
+ * phần tử không đổi vẫn giữ reference.
+ */
+export function mergeShared<T>(prev: T, next: any): T {
+  if (prev === next) return prev
+  if (Array.isArray(prev) && Array.isArray(next)) {
+    let changed = prev.length !== next.length
+    const out = next.map((v, i) => {
+      const merged = i < prev.length ? mergeShared(prev[i], v) : v
+      if (merged !== prev[i]) changed = true
+      return merged
+    })
+    return (changed ? out : prev) as T
+  }
+  if (isPlainObject(prev) && isPlainObject(next)) {
+    let out: Record<string, any> | null = null
+    for (const key of Object.keys(next)) {
+      const value = next[key]
+      if (value === undefined) continue
+      const merged = mergeShared((prev as any)[key], value)
+      if (merged !== (prev as any)[key]) {
+        if (!out) out = { ...(prev as any) }
+        out[key] = merged
+      }
+    }
+    return (out ?? prev) as T
+  }
+  return Object.is(prev, next) ? prev : (next as T)
+}
+
+// LRU + số component đang giữ, ngoài state để không gây re-render
+const lru: Record<EntityKind, Map<string, true>> = {
+  trip: new Map(),
+  assignment: new Map(),
+  vehicle: new Map(),
+  package: new Map(),
+  post: new Map(),
+}
+const retained: Record<EntityKind, Map<string, number>> = {
+  trip: new Map(),
+  assignment: new Map(),
+  vehicle: new Map(),
+  package: new Map(),
+  post: new Map(),
+}
+
+const touch = (kind: EntityKind, id: string) => {
+  const order = lru[kind]
+  order.delete(id)
+  order.set(id, true)
+}
+
+// Các id bị đuổi để giữ loại `kind` trong giới hạn
+const pickEvictions = (kind: EntityKind): string[] => {
+  const order = lru[kind]
+  const over = order.size - ENTITY_CAPS[kind]
+  if (over <= 0) return []
+  const out: string[] = []
+  for (const id of Array.from(order.keys())) {
+    if (out.length >= over) break
+    if (!retained[kind].has(id)) out.push(id)
+  }
+  out.forEach((id) => order.delete(id))
+  return out
+}
+
+interface EntityState {
+  entities: Record<EntityKind, EntityMap>
+  upsert: (kind: EntityKind, id: string, partial: any) => void
+  upsertMany: (kind: EntityKind, items: any[], idOf?: (item: any) => string | null) => string[]
+  remove: (kind: EntityKind, id: string) => void
+  clear: (kind?: EntityKind) => void
+}
+
+const emptyEntities = (): Record<EntityKind, EntityMap> => ({
+  trip: {},
+  assignment: {},
+  vehicle: {},
+  package: {},
+  post: {},
+})
+
+export const useEntityStore = create<EntityState>((set, get) => ({
+  entities: emptyEntities(),
+
+  upsert: (kind, id, partial) => {
+    get().upsertMany(kind, [partial], () => id)
+  },
+
+  // Gộp cả lô rồi set 1 lần; chỉ copy map của loại có thay đổi
+  upsertMany: (kind, items, idOf = (item) => entityIdOf(kind, item)) => {
+    const current = get().entities[kind]
+    let nextMap: EntityMap | null = null
+    const ids: string[] = []
+    for (const item of items) {
+      const id = idOf(item)
+      if (!id || !item) continue
+      ids.push(id)
+      touch(kind, id)
+      const prev = (nextMap ?? current)[id]
+      const merged = prev === undefined ? item : mergeShared(prev, item)
+      if (merged !== prev) {
+        if (!nextMap) nextMap = { ...current }
+        nextMap[id] = merged
+      }
+    }
+    const evicted = pickEvictions(kind)
+    if (evicted.length > 0) {
+      if (!nextMap) nextMap = { ...current }
+      evicted.forEach((id) => delete nextMap![id])
+    }
+    if (nextMap) {
+      const map = nextMap
+      set((s) => ({ entities: { ...s.entities, [kind]: map } }))
+    }
+    return ids
+  },
+
+  remove: (kind, id) => {
+    const current = get().entities[kind]
+    lru[kind].delete(id)
+    if (!(id in current)) return
+    const next = { ...current }
+    delete next[id]
+    set((s) => ({ entities: { ...s.entities, [kind]: next } }))
+  },
+
+  clear: (kind) => {
+    const kinds = kind ? [kind] : ENTITY_KINDS
+    kinds.forEach((k) => lru[k].clear())
+    set((s) => {
+      const entities = { ...s.entities }
+      kinds.forEach((k) => {
+        entities[k] = {}
+      })
+      return { entities }
+    })
+  },
+}))
+
+// Giữ entity không bị đuổi khi component còn mount
+const useRetain = (kind: EntityKind, ids: (string | null | undefined)[]) => {
+  const key = ids.filter(Boolean).join('|')
+  useEffect(() => {
+    if (!key) return
+    const list = key.split('|')
+    const counts = retained[kind]
+    list.forEach((id) => counts.set(id, (counts.get(id) ?? 0) + 1))
+    return () => {
+      list.forEach((id) => {
+        const n = (counts.get(id) ?? 1) - 1
+        if (n <= 0) counts.delete(id)
+        else counts.set(id, n)
+      })
+    }
+  }, [kind, key])
+}
+
+/** 1 entity; chỉ re-render khi chính entity đó đổi reference */
+export function useEntity<T = any>(kind: EntityKind, id: string | null | undefined): T | null {
+  useRetain(kind, [id])
+  return useEntityStore((s) => (id ? (s.entities[kind][id] as T) ?? null : null))
+}
+
+/** Danh sách theo thứ tự ids; so sánh nông từng phần tử */
+export function useEntityList<T = any>(kind: EntityKind, ids: string[]): T[] {
+  useRetain(kind, ids)
+  return useEntityStore(
+    useShallow((s) => {
+      const map = s.entities[kind]
+      const out: T[] = []
+      for (const id of ids) {
+        const e = map[id]
+        if (e !== undefined) out.push(e as T)
+      }
+      return out
+    })
+  )
+}
+
+export const getEntity = <T = any>(kind: EntityKind, id: string): T | null =>
+  (useEntityStore.getState().entities[kind][id] as T) ?? null
+
+export default useEntityStore
@@ -1,17 +1,19 @@
-import { create } from 'zustand'
+import { useEntityStore } from './entityStore'
 
+// Giữ API cũ của tripStore, dữ liệu nằm trong entity store (kind 'trip'):
+// ghi chỉ copy map trip khi có thay đổi thật và giữ nguyên các nhánh không đổi.
 interface TripDetailCacheState {
-  tripDetails: Record<string, any>
   setTripDetail: (tripId: string, detail: any) => void
   getTripDetail: (tripId: string) => any | null
   clear: () => void
 }
 
-export const useTripStore = create<TripDetailCacheState>((set, get) => ({
-  tripDetails: {},
-  setTripDetail: (tripId, detail) => set((s) => ({ tripDetails: { ...s.tripDetails, [tripId]: detail } })),
-  getTripDetail: (tripId) => get().tripDetails[tripId] || null,
-  clear: () => set({ tripDetails: {} }),
-}))
+const tripStoreApi: TripDetailCacheState = {
+  setTripDetail: (tripId, detail) => useEntityStore.getState().upsert('trip', tripId, detail),
+  getTripDetail: (tripId) => useEntityStore.getState().entities.trip[tripId] || null,
+  clear: () => useEntityStore.getState().clear('trip'),
+}
+
+export const useTripStore = (): TripDetailCacheState => tripStoreApi
 
-export default useTripStore
\ No newline at end of file
+export default useTripStore
@@ -1,4 +1,3 @@
-import along from "@turf/along";
 import findDistance from "@turf/distance";
 import { point } from "@turf/helpers";
 import { Animated } from "react-native";
@@ -10,21 +9,38 @@ type RouteSimulatorFeature = GeoJSON.Feature<
 
 class Polyline {
   private readonly coordinates: GeoJSON.Position[];
-  private readonly lineStringFeature: GeoJSON.Feature<GeoJSON.LineString>;
+  // cumulative[i] = quãng đường (km) từ điểm 0 đến điểm i, tính 1 lần khi khởi tạo
+  private readonly cumulative: Float64Array;
   public readonly totalDistance: number;
 
   constructor(lineStringFeature: GeoJSON.Feature<GeoJSON.LineString>) {
     this.coordinates = lineStringFeature.geometry.coordinates;
-    this.lineStringFeature = lineStringFeature;
 
-    this.totalDistance = 0;
+    this.cumulative = new Float64Array(this.coordinates.length);
     for (let i = 1; i < this.coordinates.length; i++) {
-      this.totalDistance += findDistance(this.get(i - 1), this.get(i));
+      this.cumulative[i] =
+        this.cumulative[i - 1] + findDistance(this.get(i - 1), this.get(i));
     }
+    this.totalDistance =
+      this.coordinates.length > 0
+        ? this.cumulative[this.coordinates.length - 1]
+        : 0;
   }
 
   coordinateFromStart(distance: number): RouteSimulatorFeature {
-    const pointAlong = along(this.lineStringFeature, distance);
+    const clamped = Math.max(0, Math.min(distance, this.totalDistance));
+    const index = this.segmentIndexAt(clamped);
+    const from = this.coordinates[index];
+    const to = this.coordinates[Math.min(index + 1, this.coordinates.length - 1)];
+    const segmentLength = this.cumulative[index + 1] - this.cumulative[index];
+    const fraction =
+      segmentLength > 0 ? (clamped - this.cumulative[index]) / segmentLength : 0;
+
+    // Nội suy tuyến tính trong segment thay vì turf along (O(n)) mỗi frame
+    const pointAlong = point([
+      from[0] + (to[0] - from[0]) * fraction,
+      from[1] + (to[1] - from[1]) * fraction,
+    ]);
 
     return {
       ...pointAlong,
@@ -37,17 +53,31 @@ class Polyline {
   }
 
   findNearestFloorIndex(currentDistance: number) {
-    let runningDistance = 0;
-
-    for (let i = 1; i < this.coordinates.length; i++) {
-      runningDistance += findDistance(this.get(i - 1), this.get(i));
-
-      if (runningDistance >= currentDistance) {
-        return i - 1;
+    if (
+      this.coordinates.length < 2 ||
+      currentDistance > this.totalDistance
+    ) {
+      return -1;
+    }
+    return this.segmentIndexAt(Math.max(0, currentDistance));
+  }
+
+  /**
+   * Binary search: segment i sao cho cumulative[i] <= distance <= cumulative[i + 1]
+   */
+  private segmentIndexAt(distance: number): number {
+    let lo = 0;
+    let hi = this.coordinates.length - 2;
+    if (hi <= 0) return 0;
+    while (lo < hi) {
+      const mid = (lo + hi) >>> 1;
+      if (this.cumulative[mid + 1] < distance) {
+        lo = mid + 1;
+      } else {
+        hi = mid;
       }
     }
-
-    return -1;
+    return lo;
   }
 
   get(index: number) {
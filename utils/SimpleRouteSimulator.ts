@@ -2,8 +2,18 @@
  * SimpleRouteSimulator - GPS Simulation Engine (Lightweight)
  * Giả lập xe chạy trên tuyến đường có sẵn
  * Hỗ trợ Pause/Resume và nhiều tài xế
+ *
+ * Tất cả simulator chạy chung 1 SimulationClock (fixed timestep),
+ * di chuyển theo quãng đường tích lũy tính trước của route.
  */
 
+import {
+  createSeededRandom,
+  simulationClock,
+  SimulationClock,
+  SimulationParticipant,
+} from "./SimulationClock";
+
 type Position = [number, number]; // [lng, lat]
 
 export interface SimulatorLocation {
@@ -20,20 +30,29 @@ export interface SimulatorConfig {
   updateIntervalMs?: number; // Tần suất update (ms), default 3000
   onUpdate?: (location: SimulatorLocation) => void;
   onComplete?: () => void;
+  clock?: SimulationClock; // Clock dùng chung, default simulationClock
+  seed?: number; // Seed cho dao động tốc độ (tất định)
+  speedJitter?: number; // Biên độ dao động tốc độ 0-1, default 0 (tốc độ đều)
 }
 
-export class SimpleRouteSimulator {
+export class SimpleRouteSimulator implements SimulationParticipant {
   private route: Position[];
   private speedKmH: number;
   private updateIntervalMs: number;
   private onUpdate?: (location: SimulatorLocation) => void;
   private onComplete?: () => void;
+  private clock: SimulationClock;
+  private speedJitter: number;
+  private random: () => number;
 
+  // cumulative[i] = quãng đường (m) từ điểm 0 đến điểm i, tính 1 lần
+  private cumulative: Float64Array;
   private currentIndex: number = 0;
   private isRunning: boolean = false;
-  private intervalId?: ReturnType<typeof setInterval>;
   private totalDistance: number = 0;
   private traveledDistance: number = 0;
+  private currentSpeedMps: number = 0;
+  private sinceLastEmitMs: number = 0;
 
   constructor(config: SimulatorConfig) {
     this.route = config.route;
@@ -41,9 +60,17 @@ export class SimpleRouteSimulator {
     this.updateIntervalMs = config.updateIntervalMs || 3000;
     this.onUpdate = config.onUpdate;
     this.onComplete = config.onComplete;
+    this.clock = config.clock || simulationClock;
+    this.speedJitter = Math.max(0, Math.min(config.speedJitter || 0, 1));
+    this.random = createSeededRandom(
+      typeof config.seed === "number" ? config.seed : 1
+    );
 
-    // Tính tổng quãng đường
-    this.totalDistance = this.calculateTotalDistance();
+    // Tính trước quãng đường tích lũy của từng điểm
+    this.cumulative = this.buildCumulativeDistances();
+    this.totalDistance =
+      this.cumulative.length > 0 ? this.cumulative[this.cumulative.length - 1] : 0;
+    this.currentSpeedMps = (this.speedKmH * 1000) / 3600;
   }
 
   /**
@@ -60,23 +87,23 @@ export class SimpleRouteSimulator {
       return;
     }
 
-    this.currentIndex = startIndex;
-    this.isRunning = true;
-
-    // Tính quãng đường đã đi
-    this.traveledDistance = this.calculateDistanceToIndex(startIndex);
+    this.currentIndex = Math.max(0, startIndex);
+    this.traveledDistance = this.cumulative[this.currentIndex] || 0;
 
     console.log(
       `[SimpleRouteSimulator] Started at index ${startIndex}/${this.route.length}`
     );
 
-    // Emit vị trí đầu tiên ngay lập tức
-    this.emitCurrentLocation();
+    this.run();
+  }
 
-    // Bắt đầu vòng lặp
-    this.intervalId = setInterval(() => {
-      this.tick();
-    }, this.updateIntervalMs);
+  /**
+   * Tiếp tục từ đúng vị trí đã pause (không snap về đỉnh route)
+   */
+  public resume(): void {
+    if (this.isRunning) return;
+    if (this.traveledDistance >= this.totalDistance) return;
+    this.run();
   }
 
   /**
@@ -89,10 +116,7 @@ export class SimpleRouteSimulator {
     }
 
     this.isRunning = false;
-    if (this.intervalId) {
-      clearInterval(this.intervalId);
-      this.intervalId = undefined;
-    }
+    this.clock.remove(this);
 
     console.log(`[SimpleRouteSimulator] Paused at index ${this.currentIndex}`);
     return this.currentIndex;
@@ -102,12 +126,25 @@ export class SimpleRouteSimulator {
    * Dừng hoàn toàn
    */
   public stop(): void {
-    this.pause();
+    if (this.isRunning) {
+      this.isRunning = false;
+      this.clock.remove(this);
+    }
     this.currentIndex = 0;
     this.traveledDistance = 0;
+    this.sinceLastEmitMs = 0;
     console.log("[SimpleRouteSimulator] Stopped");
   }
 
+  /**
+   * Đổi tốc độ khi đang chạy (áp dụng từ bước kế tiếp)
+   */
+  public setSpeedKmH(speedKmH: number): void {
+    if (!(speedKmH > 0)) return;
+    this.speedKmH = speedKmH;
+    this.currentSpeedMps = (speedKmH * 1000) / 3600;
+  }
+
   /**
    * Tìm điểm gần nhất trên route so với vị trí cho trước
    * Dùng khi Resume để snap xe về đường
@@ -142,121 +179,120 @@ export class SimpleRouteSimulator {
       isRunning: this.isRunning,
       currentIndex: this.currentIndex,
       totalPoints: this.route.length,
-      progress: (this.traveledDistance / this.totalDistance) * 100,
+      progress:
+        this.totalDistance > 0
+          ? (this.traveledDistance / this.totalDistance) * 100
+          : 0,
       remainingKm: (this.totalDistance - this.traveledDistance) / 1000,
     };
   }
 
-  // ============ PRIVATE METHODS ============
-
-  private tick(): void {
-    if (!this.isRunning) return;
-
-    // Tính khoảng cách xe có thể đi được trong 1 interval
-    const distancePerUpdate =
-      ((this.speedKmH * 1000) / 3600) * (this.updateIntervalMs / 1000); // meters
+  /**
+   * Vị trí nội suy hiện tại (không emit)
+   */
+  public getLocation(): SimulatorLocation | null {
+    if (this.route.length === 0) return null;
+    return this.buildLocation(this.clock.now());
+  }
 
-    // Tăng traveled distance
-    this.traveledDistance += distancePerUpdate;
+  /**
+   * Được SimulationClock gọi mỗi bước cố định
+   */
+  public advance(stepMs: number, nowMs: number): boolean {
+    if (!this.isRunning) return false;
 
-    // ✅ Chỉ kiểm tra từ currentIndex trở đi (không duyệt lại từ đầu)
-    const distanceToCurrentIndex = this.calculateDistanceToIndex(
-      this.currentIndex
-    );
-    let remainingInRoute = this.traveledDistance - distanceToCurrentIndex;
-
-    // Di chuyển currentIndex nếu vượt qua segment hiện tại
-    while (this.currentIndex < this.route.length - 1 && remainingInRoute > 0) {
-      const [lng1, lat1] = this.route[this.currentIndex];
-      const [lng2, lat2] = this.route[this.currentIndex + 1];
-      const segmentDist = this.haversineDistance(lat1, lng1, lat2, lng2);
-
-      if (remainingInRoute >= segmentDist) {
-        // Vượt qua segment này, chuyển sang segment tiếp theo
-        this.currentIndex++;
-        remainingInRoute -= segmentDist;
-        console.log(
-          `[Simulation:TICK] ✅ Moved to segment ${this.currentIndex}`
-        );
-      } else {
-        // Đang ở trong segment này
-        break;
-      }
+    let speedMps = (this.speedKmH * 1000) / 3600;
+    if (this.speedJitter > 0) {
+      speedMps *= 1 + this.speedJitter * (this.random() * 2 - 1);
+    }
+    this.currentSpeedMps = speedMps;
+    this.traveledDistance += speedMps * (stepMs / 1000);
+
+    // Con trỏ segment chỉ tiến về phía trước: O(1) khấu hao mỗi bước
+    const lastIndex = this.route.length - 1;
+    while (
+      this.currentIndex < lastIndex &&
+      this.cumulative[this.currentIndex + 1] <= this.traveledDistance
+    ) {
+      this.currentIndex++;
     }
 
     // Kiểm tra đã đến đích chưa
     if (
       this.traveledDistance >= this.totalDistance ||
-      this.currentIndex >= this.route.length - 1
+      this.currentIndex >= lastIndex
     ) {
+      this.traveledDistance = this.totalDistance;
+      this.currentIndex = Math.max(0, lastIndex);
+      this.isRunning = false;
       console.log("[SimpleRouteSimulator] 🏁 Reached destination");
-      this.pause();
       if (this.onComplete) {
         this.onComplete();
       }
-      return;
+      // onComplete có thể start() lại (chạy vòng lặp) - khi đó giữ trong clock
+      return this.isRunning;
+    }
+
+    this.sinceLastEmitMs += stepMs;
+    if (this.sinceLastEmitMs >= this.updateIntervalMs) {
+      this.sinceLastEmitMs -= this.updateIntervalMs;
+      this.emitCurrentLocation(nowMs);
     }
+    return true;
+  }
+
+  // ============ PRIVATE METHODS ============
+
+  private run(): void {
+    this.isRunning = true;
+    this.sinceLastEmitMs = 0;
+
+    // Emit vị trí đầu tiên ngay lập tức
+    this.emitCurrentLocation(this.clock.now());
 
-    this.emitCurrentLocation();
+    // Gắn vào clock dùng chung (không tạo timer riêng)
+    this.clock.add(this);
   }
 
-  private emitCurrentLocation(): void {
+  private emitCurrentLocation(nowMs: number): void {
     if (this.currentIndex >= this.route.length) return;
+    if (this.onUpdate) {
+      this.onUpdate(this.buildLocation(nowMs));
+    }
+  }
 
+  private buildLocation(nowMs: number): SimulatorLocation {
     const current = this.route[this.currentIndex];
     const next =
       this.currentIndex < this.route.length - 1
         ? this.route[this.currentIndex + 1]
         : current;
 
-    // Tính khoảng cách đã đi từ điểm current
-    const distanceToCurrentIndex = this.calculateDistanceToIndex(
-      this.currentIndex
-    );
-    const distanceInSegment = this.traveledDistance - distanceToCurrentIndex;
-
-    // Khoảng cách của segment hiện tại
-    const segmentDistance = this.haversineDistance(
-      current[1],
-      current[0],
-      next[1],
-      next[0]
-    );
+    // Khoảng cách đã đi trong segment hiện tại (tra bảng, không cộng dồn lại)
+    const segmentStart = this.cumulative[this.currentIndex];
+    const segmentDistance =
+      this.currentIndex < this.route.length - 1
+        ? this.cumulative[this.currentIndex + 1] - segmentStart
+        : 0;
+    const distanceInSegment = this.traveledDistance - segmentStart;
 
     // Tỷ lệ nội suy (0-1) trong segment
     const fraction =
       segmentDistance > 0
-        ? Math.min(distanceInSegment / segmentDistance, 1)
+        ? Math.max(0, Math.min(distanceInSegment / segmentDistance, 1))
         : 0;
 
     // Nội suy vị trí thực tế giữa current và next
     const interpolatedLat = current[1] + (next[1] - current[1]) * fraction;
     const interpolatedLng = current[0] + (next[0] - current[0]) * fraction;
 
-    const heading = this.calculateBearing(
-      current[1],
-      current[0],
-      next[1],
-      next[0]
-    );
-
-    const location: SimulatorLocation = {
-      latitude: interpolatedLat, // ✅ Vị trí nội suy (thay đổi liên tục)
-      longitude: interpolatedLng, // ✅ Vị trí nội suy (thay đổi liên tục)
-      heading: heading,
-      speed: (this.speedKmH * 1000) / 3600, // Convert to m/s
-      timestamp: Date.now(),
+    return {
+      latitude: interpolatedLat,
+      longitude: interpolatedLng,
+      heading: this.calculateBearing(current[1], current[0], next[1], next[0]),
+      speed: this.currentSpeedMps,
+      timestamp: nowMs,
     };
-
-    console.log(
-      `[Tracking:SIMULATION] Sent: ${interpolatedLat.toFixed(
-        6
-      )}, ${interpolatedLng.toFixed(6)}, ${this.speedKmH.toFixed(1)} km/h`
-    );
-
-    if (this.onUpdate) {
-      this.onUpdate(location);
-    }
   }
 
   /**
@@ -307,29 +343,17 @@ export class SimpleRouteSimulator {
   }
 
   /**
-   * Tính tổng quãng đường của route
-   */
-  private calculateTotalDistance(): number {
-    let total = 0;
-    for (let i = 0; i < this.route.length - 1; i++) {
-      const [lng1, lat1] = this.route[i];
-      const [lng2, lat2] = this.route[i + 1];
-      total += this.haversineDistance(lat1, lng1, lat2, lng2);
-    }
-    return total;
-  }
-
-  /**
-   * Tính quãng đường từ đầu đến index
+   * Quãng đường tích lũy (m) của từng điểm trên route
    */
-  private calculateDistanceToIndex(index: number): number {
-    let total = 0;
-    for (let i = 0; i < Math.min(index, this.route.length - 1); i++) {
-      const [lng1, lat1] = this.route[i];
-      const [lng2, lat2] = this.route[i + 1];
-      total += this.haversineDistance(lat1, lng1, lat2, lng2);
+  private buildCumulativeDistances(): Float64Array {
+    const cumulative = new Float64Array(this.route.length);
+    for (let i = 1; i < this.route.length; i++) {
+      const [lng1, lat1] = this.route[i - 1];
+      const [lng2, lat2] = this.route[i];
+      cumulative[i] =
+        cumulative[i - 1] + this.haversineDistance(lat1, lng1, lat2, lng2);
     }
-    return total;
+    return cumulative;
   }
 
   private toRadians(degrees: number): number {
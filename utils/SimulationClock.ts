@@ -0,0 +1,222 @@
+/**
+ * SimulationClock - Đồng hồ giả lập dùng chung
+ * Một vòng lặp duy nhất tiến tất cả xe giả lập theo bước thời gian cố định
+ * (fixed timestep), thay vì mỗi SimpleRouteSimulator tự tạo một setInterval.
+ *
+ * - Realtime: tự chạy bằng 1 timer, bù trễ (accumulator) để không bị trôi
+ * - Manual: không có timer, gọi step(ms) để tiến thời gian (headless/test, tất định)
+ */
+
+export interface SimulationParticipant {
+  /**
+   * Tiến participant thêm 1 bước cố định.
+   * Trả về false khi participant đã xong (clock sẽ tự gỡ).
+   */
+  advance(stepMs: number, nowMs: number): boolean;
+}
+
+export interface SimulationClockConfig {
+  fixedStepMs?: number; // Bước thời gian cố định (ms), default 100
+  maxStepsPerTick?: number; // Chặn "spiral of death" khi JS thread bị nghẽn, default 50
+  manual?: boolean; // true = không tự chạy timer, dùng step()
+}
+
+export interface SimulationClockStats {
+  participants: number;
+  simulatedMs: number;
+  ticks: number;
+  steps: number;
+  droppedMs: number; // Thời gian bị bỏ qua do vượt maxStepsPerTick
+  lastTickCostMs: number;
+  avgTickCostMs: number;
+}
+
+const nowMonotonic = (): number =>
+  typeof performance !== "undefined" && typeof performance.now === "function"
+    ? performance.now()
+    : Date.now();
+
+/**
+ * PRNG tất định (mulberry32) - cùng seed cho cùng chuỗi số
+ */
+export const createSeededRandom = (seed: number): (() => number) => {
+  let state = seed >>> 0;
+  return () => {
+    state = (state + 0x6d2b79f5) >>> 0;
+    let t = state;
+    t = Math.imul(t ^ (t >>> 15), t | 1);
+    t ^= t + Math.imul(t ^ (t >>> 7), t | 61);
+    return ((t ^ (t >>> 14)) >>> 0) / 4294967296;
+  };
+};
+
+export class SimulationClock {
+  private fixedStepMs: number;
+  private maxStepsPerTick: number;
+  private manual: boolean;
+
+  // Mảng phẳng thay vì Set để vòng lặp nóng không cấp phát iterator
+  private participants: SimulationParticipant[] = [];
+  private intervalId?: ReturnType<typeof setInterval>;
+  private lastTickAt: number = 0;
+  private accumulatorMs: number = 0;
+
+  // Mốc thời gian epoch cho chế độ manual (timestamp tất định)
+  private epochMs: number = Date.now();
+  private simulatedMs: number = 0;
+
+  private ticks: number = 0;
+  private steps: number = 0;
+  private droppedMs: number = 0;
+  private lastTickCostMs: number = 0;
+  private totalTickCostMs: number = 0;
+
+  constructor(config: SimulationClockConfig = {}) {
+    this.fixedStepMs = config.fixedStepMs || 100;
+    this.maxStepsPerTick = config.maxStepsPerTick || 50;
+    this.manual = !!config.manual;
+  }
+
+  /**
+   * Đăng ký participant; timer chỉ chạy khi có ít nhất 1 participant
+   */
+  public add(participant: SimulationParticipant): void {
+    if (this.participants.indexOf(participant) !== -1) return;
+    this.participants.push(participant);
+    this.ensureTimer();
+  }
+
+  public remove(participant: SimulationParticipant): void {
+    const idx = this.participants.indexOf(participant);
+    if (idx === -1) return;
+    // swap-remove O(1)
+    const last = this.participants.length - 1;
+    this.participants[idx] = this.participants[last];
+    this.participants.pop();
+    if (this.participants.length === 0) this.stopTimer();
+  }
+
+  public has(participant: SimulationParticipant): boolean {
+    return this.participants.indexOf(participant) !== -1;
+  }
+
+  /**
+   * Thời gian hiện tại của clock (ms epoch).
+   * Realtime: Date.now(). Manual: epoch + thời gian đã giả lập.
+   */
+  public now(): number {
+    return this.manual ? this.epochMs + this.simulatedMs : Date.now();
+  }
+
+  public getFixedStepMs(): number {
+    return this.fixedStepMs;
+  }
+
+  /**
+   * Chuyển sang chế độ manual (tất định) - dùng cho test/headless
+   */
+  public setManual(manual: boolean, epochMs?: number): void {
+    this.manual = manual;
+    if (typeof epochMs === "number") this.epochMs = epochMs;
+    this.accumulatorMs = 0;
+    if (manual) {
+      this.stopTimer();
+    } else {
+      this.ensureTimer();
+    }
+  }
+
+  /**
+   * Tiến clock thêm elapsedMs (chia thành các bước cố định).
+   * Dùng trực tiếp ở chế độ manual; realtime tick cũng đi qua đây.
+   */
+  public step(elapsedMs: number): void {
+    const startedAt = nowMonotonic();
+    this.accumulatorMs += elapsedMs;
+
+    let stepsThisTick = 0;
+    while (
+      this.accumulatorMs >= this.fixedStepMs &&
+      stepsThisTick < this.maxStepsPerTick
+    ) {
+      this.accumulatorMs -= this.fixedStepMs;
+      this.simulatedMs += this.fixedStepMs;
+      this.advanceAll();
+      stepsThisTick++;
+    }
+
+    if (this.accumulatorMs >= this.fixedStepMs) {
+      // Bị nghẽn quá lâu: bỏ phần dư thay vì đuổi theo mãi
+      const dropped =
+        this.accumulatorMs - (this.accumulatorMs % this.fixedStepMs);
+      this.droppedMs += dropped;
+      this.accumulatorMs -= dropped;
+    }
+
+    this.steps += stepsThisTick;
+    this.ticks++;
+    this.lastTickCostMs = nowMonotonic() - startedAt;
+    this.totalTickCostMs += this.lastTickCostMs;
+  }
+
+  public getStats(): SimulationClockStats {
+    return {
+      participants: this.participants.length,
+      simulatedMs: this.simulatedMs,
+      ticks: this.ticks,
+      steps: this.steps,
+      droppedMs: this.droppedMs,
+      lastTickCostMs: this.lastTickCostMs,
+      avgTickCostMs: this.ticks > 0 ? this.totalTickCostMs / this.ticks : 0,
+    };
+  }
+
+  // ============ PRIVATE METHODS ============
+
+  private advanceAll(): void {
+    const now = this.now();
+    // Duyệt ngược để swap-remove an toàn khi participant kết thúc
+    for (let i = this.participants.length - 1; i >= 0; i--) {
+      const participant = this.participants[i];
+      let keep = true;
+      try {
+        keep = participant.advance(this.fixedStepMs, now);
+      } catch (error) {
+        console.error("[SimulationClock] Participant error:", error);
+        keep = false;
+      }
+      // participant có thể đã tự gỡ trong advance() (vd. onComplete -> stop)
+      if (!keep && this.participants[i] === participant) {
+        this.remove(participant);
+      }
+    }
+  }
+
+  private ensureTimer(): void {
+    if (this.manual || this.intervalId || this.participants.length === 0) {
+      return;
+    }
+    this.lastTickAt = nowMonotonic();
+    this.accumulatorMs = 0;
+    this.intervalId = setInterval(() => {
+      const now = nowMonotonic();
+      const elapsed = now - this.lastTickAt;
+      this.lastTickAt = now;
+      this.step(elapsed);
+    }, this.fixedStepMs);
+  }
+
+  private stopTimer(): void {
+    if (this.intervalId) {
+      clearInterval(this.intervalId);
+      this.intervalId = undefined;
+    }
+  }
+}
+
+/**
+ * Clock dùng chung cho toàn app - mọi SimpleRouteSimulator mặc định gắn vào đây
+ */
+export const simulationClock = new SimulationClock();
+
+export default simulationClock;
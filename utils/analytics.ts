@@ -1,11 +1,15 @@
+import { createLogger } from '@/utils/logger'
+
 type AnalyticsPayload = Record<string, any>
 
+// Sự kiện vào ring buffer của logger (xuất được khi debug hiện trường); console chỉ ở dev
+const log = createLogger('analytics')
+
 export function track(event: string, payload: AnalyticsPayload = {}) {
   try {
     // Replace with real analytics later
-    // eslint-disable-next-line no-console
-    console.log('[analytics]', event, payload)
+    log.info(event, payload)
   } catch {}
 }
 
-export default { track }
\ No newline at end of file
+export default { track }
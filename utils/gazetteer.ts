@@ -0,0 +1,450 @@
+import { VN_GAZETTEER_PACKED } from '@/constants/vnGazetteerData'
+import { foldVietnamese } from '@/utils/prefixTrie'
+// Gazetteer đơn vị hành chính VN chạy hoàn toàn offline.
+// - Dữ liệu đóng gói sẵn (constants/vnGazetteerData.ts), parse lười ở lần gọi đầu
+// - Lưu dạng cột: typed array cho toạ độ/bbox/cấp/cha, 1 mảng khoá đã fold được sắp xếp
+//   để tìm exact/prefix bằng binary search; fuzzy (edit distance) chỉ quét trong đơn vị cha
+// - normalizeAddress: tách tỉnh/huyện/xã từ địa chỉ tự do + geocode thô (tâm/bbox)
+// - reverseGeocodeCoarse: toạ độ -> tỉnh/TP không cần mạng (chưa đủ dữ liệu ranh giới cho cấp huyện)
+
+export type AdminLevel = 1 | 2 | 3 // 1 tỉnh/TP, 2 quận/huyện, 3 phường/xã
+
+export interface AdminUnit {
+  index: number
+  code: string
+  level: AdminLevel
+  type: string
+  name: string
+  fullName: string
+  parent: number // index của đơn vị cha, -1 nếu là tỉnh
+  center: [number, number] // [lng, lat]
+  bbox: [number, number, number, number] // [w, s, e, n]
+}
+
+export interface AdminMatch {
+  unit: AdminUnit
+  score: number // 1 exact, 0.9 prefix, <0.8 fuzzy
+}
+
+export interface CoarseGeocode {
+  lng: number
+  lat: number
+  bbox: [number, number, number, number]
+  level: AdminLevel
+}
+
+export interface NormalizedAddress {
+  input: string
+  street: string | null
+  ward: AdminUnit | null
+  district: AdminUnit | null
+  province: AdminUnit | null
+  formatted: string
+  geocode: CoarseGeocode | null
+  confidence: number
+}
+
+const TYPE_NAMES: Record<string, string> = {
+  C: 'Thành phố',
+  P: 'Tỉnh',
+  Q: 'Quận',
+  H: 'Huyện',
+  TP: 'Thành phố',
+  TX: 'Thị xã',
+  PH: 'Phường',
+  X: 'Xã',
+  TT: 'Thị trấn',
+}
+
+const LEVEL_OF_TYPE: Record<string, AdminLevel> = {
+  C: 1, P: 1, Q: 2, H: 2, TP: 2, TX: 2, PH: 3, X: 3, TT: 3,
+}
+
+// Tên gọi tắt/thường dùng (đã fold) -> code
+const ALIASES: Record<string, string> = {
+  'hcm': '79',
+  'tphcm': '79',
+  'tp hcm': '79',
+  'sai gon': '79',
+  'saigon': '79',
+  'hn': '01',
+  'hue': '46',
+  'tt hue': '46',
+  'brvt': '77',
+  'ba ria vung tau': '77',
+  'vung tau': '77',
+  'dac lac': '66',
+  'daklak': '66',
+  'dak nong': '67',
+  'hoa binh': '17',
+  'thanh hoa': '38',
+  'khanh hoa': '56',
+}
+
+// Tiền tố loại đơn vị trong địa chỉ tự do (đã fold)
+const ADMIN_PREFIX = /^(thanh pho|tp|tinh|quan|huyen|thi xa|tx|thi tran|tt|phuong|xa|district|ward|city|province)\s+/
+const SHORT_NUMBERED = /^(q|p|quan|phuong)\s*(\d+)$/
+const COUNTRY = /^(viet nam|vietnam|vn)$/
+
+export function stripAdminPrefix(folded: string): string {
+  let key = folded
+  const numbered = key.match(SHORT_NUMBERED)
+  if (numbered) return String(Number(numbered[2]))
+  // Có thể lặp: "tp thanh pho ..." hiếm nhưng rẻ
+  for (let i = 0; i < 2; i++) {
+    const next = key.replace(ADMIN_PREFIX, '')
+    if (next === key) break
+    key = next
+  }
+  return /^\d+$/.test(key) ? String(Number(key)) : key
+}
+
+/** Edit distance có cắt sớm khi vượt max (trả max + 1) */
+function boundedLevenshtein(a: string, b: string, max: number): number {
+  if (Math.abs(a.length - b.length) > max) return max + 1
+  let prev = new Array(b.length + 1)
+  let curr = new Array(b.length + 1)
+  for (let j = 0; j <= b.length; j++) prev[j] = j
+  for (let i = 1; i <= a.length; i++) {
+    curr[0] = i
+    let rowMin = curr[0]
+    for (let j = 1; j <= b.length; j++) {
+      const cost = a.charCodeAt(i - 1) === b.charCodeAt(j - 1) ? 0 : 1
+      curr[j] = Math.min(prev[j] + 1, curr[j - 1] + 1, prev[j - 1] + cost)
+      if (curr[j] < rowMin) rowMin = curr[j]
+    }
+    if (rowMin > max) return max + 1
+    const tmp = prev
+    prev = curr
+    curr = tmp
+  }
+  return prev[b.length]
+}
+
+export class Gazetteer {
+  private loaded = false
+  private count = 0
+
+  // Cột dữ liệu
+  private codes: string[] = []
+  private types: string[] = []
+  private names: string[] = []
+  private levels = new Uint8Array(0)
+  private parents = new Int32Array(0)
+  private centers = new Float32Array(0) // lng, lat
+  private bboxes = new Float32Array(0) // w, s, e, n
+  private children = new Map<number, number[]>()
+  private byCode = new Map<string, number>()
+
+  // Chỉ mục khoá đã sắp xếp: keys[i] -> keyUnits[i]
+  private keys: string[] = []
+  private keyUnits = new Int32Array(0)
+
+  private loadMs = 0
+
+  /** Parse dữ liệu đóng gói (tự gọi ở lần tra cứu đầu) */
+  ensureLoaded(): void {
+    if (this.loaded) return
+    const started = Date.now()
+    const rows = VN_GAZETTEER_PACKED.split('\n')
+    const n = rows.length
+    this.count = n
+    this.codes = new Array(n)
+    this.types = new Array(n)
+    this.names = new Array(n)
+    this.levels = new Uint8Array(n)
+    this.parents = new Int32Array(n)
+    this.centers = new Float32Array(n * 2)
+    this.bboxes = new Float32Array(n * 4)
+    const parentCodes: string[] = new Array(n)
+
+    for (let i = 0; i < n; i++) {
+      const f = rows[i].split('|')
+      this.codes[i] = f[0]
+      parentCodes[i] = f[1]
+      this.types[i] = f[2]
+      this.names[i] = f[3]
+      this.levels[i] = LEVEL_OF_TYPE[f[2]] || 3
+      this.centers[i * 2] = Number(f[5])
+      this.centers[i * 2 + 1] = Number(f[4])
+      for (let k = 0; k < 4; k++) this.bboxes[i * 4 + k] = Number(f[6 + k])
+      this.byCode.set(f[0], i)
+    }
+
+    const pairs: [string, number][] = []
+    for (let i = 0; i < n; i++) {
+      const parent = parentCodes[i] ? this.byCode.get(parentCodes[i]) ?? -1 : -1
+      this.parents[i] = parent
+      const list = this.children.get(parent)
+      if (list) list.push(i)
+      else this.children.set(parent, [i])
+      pairs.push([stripAdminPrefix(foldVietnamese(this.names[i])), i])
+    }
+    for (const alias of Object.keys(ALIASES)) {
+      const idx = this.byCode.get(ALIASES[alias])
+      if (idx !== undefined) pairs.push([alias, idx])
+    }
+    pairs.sort((a, b) => (a[0] < b[0] ? -1 : a[0] > b[0] ? 1 : a[1] - b[1]))
+    this.keys = pairs.map((p) => p[0])
+    this.keyUnits = Int32Array.from(pairs.map((p) => p[1]))
+
+    this.loaded = true
+    this.loadMs = Date.now() - started
+  }
+
+  get size(): number {
+    this.ensureLoaded()
+    return this.count
+  }
+
+  getLoadMs(): number {
+    return this.loadMs
+  }
+
+  unit(index: number): AdminUnit {
+    this.ensureLoaded()
+    const type = this.types[index]
+    return {
+      index,
+      code: this.codes[index],
+      level: this.levels[index] as AdminLevel,
+      type,
+      name: this.names[index],
+      fullName: `${TYPE_NAMES[type] || ''} ${this.names[index]}`.trim(),
+      parent: this.parents[index],
+      center: [this.centers[index * 2], this.centers[index * 2 + 1]],
+      bbox: [
+        this.bboxes[index * 4],
+        this.bboxes[index * 4 + 1],
+        this.bboxes[index * 4 + 2],
+        this.bboxes[index * 4 + 3],
+      ],
+    }
+  }
+
+  byCodeOf(code: string): AdminUnit | null {
+    this.ensureLoaded()
+    const idx = this.byCode.get(code)
+    return idx === undefined ? null : this.unit(idx)
+  }
+
+  /**
+   * Tìm đơn vị theo tên (không dấu, bỏ tiền tố "Quận/Phường/TP...").
+   * Thứ tự: exact -> prefix (binary search) -> fuzzy trong phạm vi cha.
+   */
+  lookup(text: string, options: { level?: AdminLevel; parent?: number; limit?: number } = {}): AdminMatch[] {
+    this.ensureLoaded()
+    const key = stripAdminPrefix(foldVietnamese(text))
+    if (!key) return []
+    const limit = options.limit ?? 5
+    const accept = (idx: number) =>
+      (options.level === undefined || this.levels[idx] === options.level) &&
+      (options.parent === undefined || this.isWithin(idx, options.parent))
+
+    const out: AdminMatch[] = []
+    const seen = new Set<number>()
+    const push = (idx: number, score: number) => {
+      if (seen.has(idx) || !accept(idx)) return
+      seen.add(idx)
+      out.push({ unit: this.unit(idx), score })
+    }
+
+    let i = this.lowerBound(key)
+    for (; i < this.keys.length && this.keys[i] === key; i++) push(this.keyUnits[i], 1)
+    if (out.length > 0) return out.slice(0, limit)
+
+    // Prefix: chỉ khi khoá đủ dài để không khớp lung tung
+    if (key.length >= 3) {
+      for (; i < this.keys.length && out.length < limit && this.keys[i].startsWith(key); i++) {
+        push(this.keyUnits[i], 0.9)
+      }
+      if (out.length > 0) return out
+    }
+
+    // Fuzzy: gõ sai/thiếu 1-2 ký tự, giới hạn trong cha để giữ nhanh
+    const maxEdits = key.length <= 4 ? 0 : key.length <= 8 ? 1 : 2
+    if (maxEdits === 0) return out
+    const candidates = options.parent !== undefined ? this.descendants(options.parent, options.level) : this.allAtLevel(options.level)
+    const scored: AdminMatch[] = []
+    for (const idx of candidates) {
+      const d = boundedLevenshtein(key, stripAdminPrefix(foldVietnamese(this.names[idx])), maxEdits)
+      if (d <= maxEdits) scored.push({ unit: this.unit(idx), score: 0.8 - d * 0.1 })
+    }
+    scored.sort((a, b) => b.score - a.score)
+    return scored.slice(0, limit)
+  }
+
+  /**
+   * Chuẩn hoá địa chỉ tự do: "12 Nguyễn Huệ, Q1, TPHCM"
+   * -> { street: '12 Nguyễn Huệ', district: Quận 1, province: TP Hồ Chí Minh, geocode: tâm Quận 1 }
+   */
+  normalizeAddress(text: string): NormalizedAddress {
+    this.ensureLoaded()
+    const segments = (text || '')
+      .split(/[,;\n]/)
+      .map((s) => s.trim())
+      .filter((s) => s.length > 0 && !COUNTRY.test(foldVietnamese(s)))
+
+    let province: AdminMatch | null = null
+    let district: AdminMatch | null = null
+    let ward: AdminMatch | null = null
+    let end = segments.length
+
+    // Tỉnh: 1-2 đoạn cuối
+    for (let k = end - 1; k >= Math.max(0, end - 2) && !province; k--) {
+      const m = this.lookup(segments[k], { level: 1, limit: 1 })[0]
+      // Khớp mờ với tỉnh nhưng khớp đúng tên 1 quận/huyện ("Bình Thạnh" ≠ "Bình Thuận") => không phải tỉnh
+      if (m && m.score < 0.9 && this.lookup(segments[k], { level: 2, limit: 1 })[0]?.score === 1) continue
+      if (m) {
+        province = m
+        end = k
+      }
+    }
+    // Không tách bằng dấu phẩy: tìm tên tỉnh ở cuối chuỗi
+    if (!province && segments.length > 0) {
+      const folded = foldVietnamese(segments[segments.length - 1])
+      for (let i = 0; i < this.keys.length; i++) {
+        const idx = this.keyUnits[i]
+        if (this.levels[idx] !== 1) continue
+        if (folded === this.keys[i] || folded.endsWith(` ${this.keys[i]}`)) {
+          province = { unit: this.unit(idx), score: 0.85 }
+          break
+        }
+      }
+    }
+
+    // Quận/huyện: đoạn ngay trước tỉnh, trong phạm vi tỉnh nếu đã biết
+    for (let k = end - 1; k >= Math.max(0, end - 2) && !district; k--) {
+      const m = this.lookup(segments[k], { level: 2, parent: province?.unit.index, limit: 2 })
+      // Không biết tỉnh thì chỉ nhận khi duy nhất (tránh "Quận 1" của tỉnh khác)
+      if (m.length === 1 || (m.length > 1 && province)) {
+        district = m[0]
+        end = k
+      }
+    }
+    if (district && !province) {
+      province = { unit: this.unit(district.unit.parent), score: district.score * 0.9 }
+    }
+
+    // Phường/xã
+    if (district) {
+      for (let k = end - 1; k >= Math.max(0, end - 2) && !ward; k--) {
+        const m = this.lookup(segments[k], { level: 3, parent: district.unit.index, limit: 1 })[0]
+        if (m) {
+          ward = m
+          end = k
+        }
+      }
+    }
+
+    const street = end > 0 ? segments.slice(0, end).join(', ') : null
+    const finest = ward || district || province
+    const matched = [ward, district, province].filter(Boolean) as AdminMatch[]
+    const confidence = matched.length === 0
+      ? 0
+      : matched.reduce((acc, m) => acc * m.score, 1) * (0.6 + 0.4 * (matched.length / 3))
+
+    return {
+      input: text,
+      street,
+      ward: ward?.unit ?? null,
+      district: district?.unit ?? null,
+      province: province?.unit ?? null,
+      formatted: [street, ward?.unit.fullName, district?.unit.fullName, province?.unit.fullName].filter(Boolean).join(', '),
+      geocode: finest
+        ? { lng: finest.unit.center[0], lat: finest.unit.center[1], bbox: finest.unit.bbox, level: finest.unit.level }
+        : null,
+      confidence: Math.round(confidence * 100) / 100,
+    }
+  }
+
+  /** Geocode thô (tâm đơn vị nhỏ nhất khớp được), null nếu không nhận ra */
+  geocode(text: string): CoarseGeocode | null {
+    return this.normalizeAddress(text).geocode
+  }
+
+  /**
+   * Toạ độ -> tỉnh/TP: tỉnh có bbox chứa điểm và tâm gần nhất, fallback tỉnh có tâm gần nhất.
+   * Chỉ tới cấp tỉnh: bbox quận/huyện trong dữ liệu là hộp ước lượng quanh tâm, không đủ tin
+   * để ghi tên quận vào địa chỉ check-in/check-out; chưa có dữ liệu phường/xã.
+   */
+  reverseGeocodeCoarse(lat: number, lng: number): AdminUnit | null {
+    this.ensureLoaded()
+    const cosLat = Math.cos((lat * Math.PI) / 180)
+    let inside = -1
+    let insideD = Infinity
+    let nearest = -1
+    let nearestD = Infinity
+    for (let i = 0; i < this.count; i++) {
+      if (this.levels[i] !== 1) continue
+      const dx = (this.centers[i * 2] - lng) * cosLat
+      const dy = this.centers[i * 2 + 1] - lat
+      const d = dx * dx + dy * dy
+      if (d < nearestD) {
+        nearestD = d
+        nearest = i
+      }
+      if (
+        lng < this.bboxes[i * 4] || lat < this.bboxes[i * 4 + 1] ||
+        lng > this.bboxes[i * 4 + 2] || lat > this.bboxes[i * 4 + 3]
+      ) continue
+      if (d < insideD) {
+        insideD = d
+        inside = i
+      }
+    }
+    const idx = inside >= 0 ? inside : nearest
+    return idx >= 0 ? this.unit(idx) : null
+  }
+
+  /** Chuỗi địa chỉ thô "Thành phố Hồ Chí Minh" cho toạ độ */
+  describeCoarse(lat: number, lng: number): string | null {
+    return this.reverseGeocodeCoarse(lat, lng)?.fullName ?? null
+  }
+
+  // ============ PRIVATE METHODS ============
+
+  private lowerBound(key: string): number {
+    let lo = 0
+    let hi = this.keys.length
+    while (lo < hi) {
+      const mid = (lo + hi) >>> 1
+      if (this.keys[mid] < key) lo = mid + 1
+      else hi = mid
+    }
+    return lo
+  }
+
+  private isWithin(idx: number, ancestor: number): boolean {
+    let p = this.parents[idx]
+    while (p !== -1) {
+      if (p === ancestor) return true
+      p = this.parents[p]
+    }
+    return false
+  }
+
+  private descendants(ancestor: number, level?: AdminLevel): number[] {
+    const out: number[] = []
+    const stack = (this.children.get(ancestor) || []).slice()
+    while (stack.length > 0) {
+      const idx = stack.pop()!
+      if (level === undefined || this.levels[idx] === level) out.push(idx)
+      const kids = this.children.get(idx)
+      if (kids) stack.push(...kids)
+    }
+    return out
+  }
+
+  private allAtLevel(level?: AdminLevel): number[] {
+    const out: number[] = []
+    for (let i = 0; i < this.count; i++) {
+      if (level === undefined || this.levels[i] === level) out.push(i)
+    }
+    return out
+  }
+}
+
+export const gazetteer = new Gazetteer()
+
+export default gazetteer
@@ -0,0 +1,101 @@
+// Geohash (base32) cho lượng tử hoá vị trí thành ô, dùng làm khoá cache theo không gian.
+// Độ dài ô xấp xỉ ở vĩ độ VN: 6 ký tự ~1.2km x 0.6km, 7 ~150m x 150m, 8 ~38m x 19m.
+
+const BASE32 = '0123456789bcdefghjkmnpqrstuvwxyz'
+
+export interface GeohashBounds {
+  minLat: number
+  minLng: number
+  maxLat: number
+  maxLng: number
+}
+
+export function encodeGeohash(lat: number, lng: number, precision: number = 7): string {
+  let minLat = -90
+  let maxLat = 90
+  let minLng = -180
+  let maxLng = 180
+  let hash = ''
+  let bits = 0
+  let ch = 0
+  let evenBit = true // bit chẵn = kinh độ
+
+  while (hash.length < precision) {
+    if (evenBit) {
+      const mid = (minLng + maxLng) / 2
+      if (lng >= mid) {
+        ch = (ch << 1) | 1
+        minLng = mid
+      } else {
+        ch = ch << 1
+        maxLng = mid
+      }
+    } else {
+      const mid = (minLat + maxLat) / 2
+      if (lat >= mid) {
+        ch = (ch << 1) | 1
+        minLat = mid
+      } else {
+        ch = ch << 1
+        maxLat = mid
+      }
+    }
+    evenBit = !evenBit
+    if (++bits === 5) {
+      hash += BASE32[ch]
+      bits = 0
+      ch = 0
+    }
+  }
+  return hash
+}
+
+export function decodeGeohashBounds(hash: string): GeohashBounds {
+  let minLat = -90
+  let maxLat = 90
+  let minLng = -180
+  let maxLng = 180
+  let evenBit = true
+
+  for (let i = 0; i < hash.length; i++) {
+    const idx = BASE32.indexOf(hash[i])
+    if (idx === -1) throw new Error(`Invalid geohash: ${hash}`)
+    for (let b = 4; b >= 0; b--) {
+      const bit = (idx >> b) & 1
+      if (evenBit) {
+        const mid = (minLng + maxLng) / 2
+        if (bit) minLng = mid
+        else maxLng = mid
+      } else {
+        const mid = (minLat + maxLat) / 2
+        if (bit) minLat = mid
+        else maxLat = mid
+      }
+      evenBit = !evenBit
+    }
+  }
+  return { minLat, minLng, maxLat, maxLng }
+}
+
+/** Ô chứa điểm và 8 ô xung quanh (điểm gần mép ô vẫn tìm được hàng xóm) */
+export function geohashNeighborhood(lat: number, lng: number, precision: number = 7): string[] {
+  const center = encodeGeohash(lat, lng, precision)
+  const b = decodeGeohashBounds(center)
+  const dLat = b.maxLat - b.minLat
+  const dLng = b.maxLng - b.minLng
+  const cLat = (b.minLat + b.maxLat) / 2
+  const cLng = (b.minLng + b.maxLng) / 2
+  const out = [center]
+  for (let dy = -1; dy <= 1; dy++) {
+    for (let dx = -1; dx <= 1; dx++) {
+      if (dx === 0 && dy === 0) continue
+      const nLat = cLat + dy * dLat
+      if (nLat > 90 || nLat < -90) continue
+      let nLng = cLng + dx * dLng
+      if (nLng > 180) nLng -= 360
+      if (nLng < -180) nLng += 360
+      out.push(encodeGeohash(nLat, nLng, precision))
+    }
+  }
+  return out
+}
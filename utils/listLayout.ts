@@ -0,0 +1,136 @@
+/**
+ * List Layout Table - bảng chiều cao/offset cho danh sách ảo hoá
+ *
+ * - Chiều cao mỗi dòng ước lượng trước (estimateHeight) để FlatList có getItemLayout
+ *   ngay từ lần render đầu, không phải đo từng ô mới biết offset.
+ * - Ô nào đã đo thực tế (onLayout) thì dùng số đo, nhớ theo key nên dữ liệu
+ *   đổi thứ tự/nạp thêm trang vẫn giữ số đo cũ.
+ * - Offset là tổng cộng dồn, tính lại lười từ dòng đầu tiên bị đổi.
+ * - numColumns > 1: mỗi "dòng" là 1 hàng gồm nhiều ô, cao bằng ô cao nhất.
+ */
+
+export interface ItemLayout {
+  length: number
+  offset: number
+  index: number
+}
+
+export class ItemLayoutTable {
+  private rowKeys: string[][] = []
+  private estimates: number[] = []
+  private measured = new Map<string, number>()
+  private heights: number[] = []
+  private offsets: number[] = []
+  // Dòng đầu tiên có offset cần tính lại
+  private dirtyFrom = 0
+
+  constructor(private numColumns: number = 1) {}
+
+  /** Nạp danh sách mới (key + chiều cao ước lượng theo thứ tự hiển thị) */
+  setItems(keys: string[], estimates: number[]) {
+    const rows: string[][] = []
+    const rowEstimates: number[] = []
+    for (let i = 0; i < keys.length; i += this.numColumns) {
+      rows.push(keys.slice(i, i + this.numColumns))
+      rowEstimates.push(Math.max(...estimates.slice(i, i + this.numColumns)))
+    }
+    // Giữ phần đầu không đổi (thường gặp khi nối thêm trang) để khỏi cộng dồn lại
+    let same = 0
+    while (
+      same < rows.length &&
+      same < this.rowKeys.length &&
+      this.estimates[same] === rowEstimates[same] &&
+      sameKeys(rows[same], this.rowKeys[same])
+    ) {
+      same++
+    }
+    this.rowKeys = rows
+    this.estimates = rowEstimates
+    this.heights.length = rows.length
+    this.offsets.length = rows.length
+    for (let r = same; r < rows.length; r++) this.heights[r] = this.rowHeight(r)
+    this.dirtyFrom = Math.min(this.dirtyFrom, same)
+    // Bỏ số đo của key không còn trong danh sách
+    if (this.measured.size > keys.length * 2) {
+      const alive = new Set(keys)
+      this.measured.forEach((_, key) => {
+        if (!alive.has(key)) this.measured.delete(key)
+      })
+    }
+  }
+
+  /** Ghi số đo thực tế; trả true nếu layout thay đổi (cần render lại) */
+  setMeasured(key: string, height: number, rowIndex: number): boolean {
+    const rounded = Math.round(height * 2) / 2
+    if (this.measured.get(key) === rounded) return false
+    this.measured.set(key, rounded)
+    if (rowIndex < 0 || rowIndex >= this.rowKeys.length) return false
+    const next = this.rowHeight(rowIndex)
+    if (next === this.heights[rowIndex]) return false
+    this.heights[rowIndex] = next
+    this.dirtyFrom = Math.min(this.dirtyFrom, rowIndex + 1)
+    return true
+  }
+
+  getLayout(rowIndex: number): ItemLayout {
+    this.ensureOffsets(rowIndex)
+    return { length: this.heights[rowIndex] ?? 0, offset: this.offsets[rowIndex] ?? 0, index: rowIndex }
+  }
+
+  /** Dòng chứa offset cuộn (tìm nhị phân) */
+  rowAtOffset(offset: number): number {
+    const count = this.rowKeys.length
+    if (count === 0) return -1
+    this.ensureOffsets(count - 1)
+    let lo = 0
+    let hi = count - 1
+    while (lo < hi) {
+      const mid = (lo + hi + 1) >> 1
+      if (this.offsets[mid] <= offset) lo = mid
+      else hi = mid - 1
+    }
+    return lo
+  }
+
+  keysInRow(rowIndex: number): string[] {
+    return this.rowKeys[rowIndex] ?? []
+  }
+
+  getNumColumns(): number {
+    return this.numColumns
+  }
+
+  rowCount(): number {
+    return this.rowKeys.length
+  }
+
+  // ============ PRIVATE METHODS ============
+
+  private rowHeight(rowIndex: number): number {
+    const keys = this.rowKeys[rowIndex]
+    let height = 0
+    let allMeasured = true
+    for (const key of keys) {
+      const m = this.measured.get(key)
+      if (m === undefined) allMeasured = false
+      else height = Math.max(height, m)
+    }
+    return allMeasured ? height : Math.max(height, this.estimates[rowIndex])
+  }
+
+  private ensureOffsets(rowIndex: number) {
+    if (rowIndex < this.dirtyFrom) return
+    let offset = this.dirtyFrom > 0 ? this.offsets[this.dirtyFrom - 1] + this.heights[this.dirtyFrom - 1] : 0
+    for (let r = this.dirtyFrom; r <= rowIndex && r < this.heights.length; r++) {
+      this.offsets[r] = offset
+      offset += this.heights[r]
+    }
+    this.dirtyFrom = Math.min(rowIndex + 1, this.heights.length)
+  }
+}
+
+function sameKeys(a: string[], b: string[]): boolean {
+  if (a.length !== b.length) return false
+  for (let i = 0; i < a.length; i++) if (a[i] !== b[i]) return false
+  return true
+}
@@ -0,0 +1,122 @@
+import { track } from '@/utils/analytics'
+
+/**
+ * List Perf Monitor - đo FPS khi cuộn và số ô trống (blank cell) của danh sách
+ *
+ * - FPS: đếm khung requestAnimationFrame trong 1 phiên cuộn (từ lúc kéo tới khi
+ *   quán tính dừng); khung cách khung trước > 1.5 lần 16.7ms tính là rớt khung.
+ * - Blank cell: dòng nằm trong viewport nhưng ô chưa được mount (FlatList chưa kịp
+ *   render), lấy mẫu theo sự kiện onScroll.
+ * - Hết mỗi phiên cuộn gửi 1 sự kiện analytics 'list_scroll_perf'.
+ */
+
+export interface ListScrollPerfReport {
+  list: string
+  durationMs: number
+  fps: number
+  droppedFrames: number
+  blankSamples: number
+  blankCells: number
+  maxBlankCells: number
+  mountedCells: number
+}
+
+const FRAME_MS = 1000 / 60
+// Phiên quá ngắn (chạm nhẹ) không đủ mẫu để tính FPS
+const MIN_SESSION_MS = 250
+
+export class ListPerfMonitor {
+  private mounted = new Set<string>()
+  private scrolling = false
+  private rafId: number | null = null
+  private startedAt = 0
+  private lastFrameAt = 0
+  private frames = 0
+  private droppedFrames = 0
+  private blankSamples = 0
+  private blankCells = 0
+  private maxBlankCells = 0
+  private lastReport: ListScrollPerfReport | null = null
+
+  constructor(private name: string) {}
+
+  cellMounted(key: string) {
+    this.mounted.add(key)
+  }
+
+  cellUnmounted(key: string) {
+    this.mounted.delete(key)
+  }
+
+  isMounted(key: string): boolean {
+    return this.mounted.has(key)
+  }
+
+  /** Bắt đầu phiên cuộn (onScrollBeginDrag); gọi lặp khi đang cuộn thì bỏ qua */
+  beginScroll() {
+    if (this.scrolling) return
+    this.scrolling = true
+    this.startedAt = now()
+    this.lastFrameAt = this.startedAt
+    this.frames = 0
+    this.droppedFrames = 0
+    this.blankSamples = 0
+    this.blankCells = 0
+    this.maxBlankCells = 0
+    this.rafId = requestAnimationFrame(this.onFrame)
+  }
+
+  /** Ghi mẫu số ô trống trong viewport */
+  sampleBlank(blank: number) {
+    if (!this.scrolling) return
+    this.blankSamples++
+    this.blankCells += blank
+    if (blank > this.maxBlankCells) this.maxBlankCells = blank
+  }
+
+  /** Kết thúc phiên cuộn (onMomentumScrollEnd, hoặc onScrollEndDrag không có quán tính) */
+  endScroll() {
+    if (!this.scrolling) return
+    this.scrolling = false
+    if (this.rafId !== null) cancelAnimationFrame(this.rafId)
+    this.rafId = null
+
+    const durationMs = now() - this.startedAt
+    if (durationMs < MIN_SESSION_MS) return
+    this.lastReport = {
+      list: this.name,
+      durationMs: Math.round(durationMs),
+      fps: Math.round((this.frames * 1000 * 10) / durationMs) / 10,
+      droppedFrames: this.droppedFrames,
+      blankSamples: this.blankSamples,
+      blankCells: this.blankCells,
+      maxBlankCells: this.maxBlankCells,
+      mountedCells: this.mounted.size,
+    }
+    track('list_scroll_perf', this.lastReport)
+  }
+
+  getLastReport(): ListScrollPerfReport | null {
+    return this.lastReport
+  }
+
+  dispose() {
+    this.endScroll()
+    this.mounted.clear()
+  }
+
+  // ============ PRIVATE METHODS ============
+
+  private onFrame = () => {
+    if (!this.scrolling) return
+    const t = now()
+    this.frames++
+    const gap = t - this.lastFrameAt
+    if (gap > FRAME_MS * 1.5) this.droppedFrames += Math.round(gap / FRAME_MS) - 1
+    this.lastFrameAt = t
+    this.rafId = requestAnimationFrame(this.onFrame)
+  }
+}
+
+const now = (): number =>
+  typeof performance !== 'undefined' && typeof performance.now === 'function' ? performance.now() : Date.now()
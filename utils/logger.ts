@@ -0,0 +1,305 @@
+/**
+ * Logger - log có cấp độ cho hot path (GPS, SignalR, danh sách...), gần như không tốn gì ở release
+ *
+ * - Cấp: trace < debug < info < warn < error. Bản production bỏ hẳn lời gọi log.trace /
+ *   log.debug lúc build (scripts/babel/stripLogCalls.js trong babel.config.js), trừ khi
+ *   build với EXPO_PUBLIC_LOG_LEVEL=debug|trace. Lúc chạy, cấp dưới getLogLevel() bị bỏ qua
+ *   trước khi đụng tới message.
+ * - Format lười: message / data có thể là hàm, chỉ được gọi khi bản ghi thật sự được giữ
+ *   => log.debug('Sent', () => ({ lat, lng })) không dựng object / chuỗi khi bị lọc.
+ * - Lấy mẫu theo module: createLogger('SignalR', { sampleRate: 0.1 }) giữ ~1/10 bản ghi
+ *   trace/debug/info (warn/error luôn giữ); setModuleSampling() đổi lúc chạy.
+ * - Ring buffer nhị phân cố định RING_BYTES trên máy: mỗi bản ghi
+ *   [u32 ms từ lúc khởi động][u8 cấp][u8 module][u16 độ dài][UTF-8], đầy thì đè bản ghi cũ
+ *   nhất. exportText() / exportBinary() để lấy log khi debug ngoài hiện trường.
+ * - Console chỉ in từ CONSOLE_LEVEL (dev: debug, release: warn) để tránh bridge traffic.
+ */
+
+export type LogLevel = 'trace' | 'debug' | 'info' | 'warn' | 'error'
+type Lazy<T> = T | (() => T)
+
+const LEVELS: Record<LogLevel, number> = { trace: 0, debug: 1, info: 2, warn: 3, error: 4 }
+const LEVEL_NAMES: LogLevel[] = ['trace', 'debug', 'info', 'warn', 'error']
+
+const RING_BYTES = 64 * 1024
+const HEADER_BYTES = 8
+const MAX_MESSAGE_BYTES = 480
+const MAX_MODULES = 255
+
+// Script Node (scripts/loadtest...) import service dùng logger: không có __DEV__
+const DEV = typeof __DEV__ !== 'undefined' && __DEV__
+const envLevel = process.env.EXPO_PUBLIC_LOG_LEVEL as LogLevel | undefined
+const CONSOLE_LEVEL = DEV ? LEVELS.debug : LEVELS.warn
+
+let minLevel = envLevel && envLevel in LEVELS ? LEVELS[envLevel] : DEV ? LEVELS.debug : LEVELS.info
+const epoch = Date.now()
+
+// ============ UTF-8 (Hermes cũ không có TextEncoder/TextDecoder) ============
+
+const encodeUtf8 = (text: string, maxBytes: number): Uint8Array => {
+  const out = new Uint8Array(Math.min(maxBytes, text.length * 3))
+  let n = 0
+  for (let i = 0; i < text.length; i++) {
+    let code = text.charCodeAt(i)
+    if (code >= 0xd800 && code <= 0xdbff && i + 1 < text.length) {
+      code = 0x10000 + ((code - 0xd800) << 10) + (text.charCodeAt(++i) - 0xdc00)
+    }
+    const size = code < 0x80 ? 1 : code < 0x800 ? 2 : code < 0x10000 ? 3 : 4
+    if (n + size > out.length) break
+    if (size === 1) out[n++] = code
+    else if (size === 2) {
+      out[n++] = 0xc0 | (code >> 6)
+      out[n++] = 0x80 | (code & 0x3f)
+    } else if (size === 3) {
+      out[n++] = 0xe0 | (code >> 12)
+      out[n++] = 0x80 | ((code >> 6) & 0x3f)
+      out[n++] = 0x80 | (code & 0x3f)
+    } else {
+      out[n++] = 0xf0 | (code >> 18)
+      out[n++] = 0x80 | ((code >> 12) & 0x3f)
+      out[n++] = 0x80 | ((code >> 6) & 0x3f)
+      out[n++] = 0x80 | (code & 0x3f)
+    }
+  }
+  return out.subarray(0, n)
+}
+
+const decodeUtf8 = (bytes: Uint8Array): string => {
+  let text = ''
+  for (let i = 0; i < bytes.length; ) {
+    const b = bytes[i++]
+    let code = b
+    if (b >= 0xf0) code = ((b & 0x07) << 18) | ((bytes[i++] & 0x3f) << 12) | ((bytes[i++] & 0x3f) << 6) | (bytes[i++] & 0x3f)
+    else if (b >= 0xe0) code = ((b & 0x0f) << 12) | ((bytes[i++] & 0x3f) << 6) | (bytes[i++] & 0x3f)
+    else if (b >= 0xc0) code = ((b & 0x1f) << 6) | (bytes[i++] & 0x3f)
+    text += String.fromCodePoint(code)
+  }
+  return text
+}
+
+const BASE64 = 'ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/'
+
+const toBase64 = (bytes: Uint8Array): string => {
+  let out = ''
+  for (let i = 0; i < bytes.length; i += 3) {
+    const chunk = (bytes[i] << 16) | ((bytes[i + 1] ?? 0) << 8) | (bytes[i + 2] ?? 0)
+    out += BASE64[(chunk >> 18) & 63] + BASE64[(chunk >> 12) & 63]
+    out += i + 1 < bytes.length ? BASE64[(chunk >> 6) & 63] : '='
+    out += i + 2 < bytes.length ? BASE64[chunk & 63] : '='
+  }
+  return out
+}
+
+// ============ RING BUFFER ============
+
+export interface LogRecord {
+  t: number
+  level: LogLevel
+  module: string
+  message: string
+}
+
+class LogRing {
+  private bytes = new Uint8Array(RING_BYTES)
+  private view = new DataView(this.bytes.buffer)
+  /** vị trí bản ghi cũ nhất / vị trí ghi tiếp theo / số byte đang dùng */
+  private head = 0
+  private tail = 0
+  private used = 0
+  private modules: string[] = []
+  private moduleIds = new Map<string, number>()
+  stats = { written: 0, overwritten: 0, bytes: 0 }
+
+  moduleId(name: string): number {
+    let id = this.moduleIds.get(name)
+    if (id === undefined) {
+      // Quá MAX_MODULES thì dồn chung vào module cuối
+      id = Math.min(this.modules.length, MAX_MODULES - 1)
+      if (id === this.modules.length) this.modules.push(name)
+      this.moduleIds.set(name, id)
+    }
+    return id
+  }
+
+  write(level: number, moduleId: number, message: string) {
+    const body = encodeUtf8(message, MAX_MESSAGE_BYTES)
+    const size = HEADER_BYTES + body.length
+    while (RING_BYTES - this.used < size) this.dropOldest()
+
+    const header = new Uint8Array(HEADER_BYTES)
+    const headerView = new DataView(header.buffer)
+    headerView.setUint32(0, Math.min(0xffffffff, Date.now() - epoch))
+    headerView.setUint8(4, level)
+    headerView.setUint8(5, moduleId)
+    headerView.setUint16(6, body.length)
+    this.copyIn(header)
+    this.copyIn(body)
+    this.used += size
+    this.stats.written++
+    this.stats.bytes = this.used
+  }
+
+  /** Bản ghi từ cũ tới mới */
+  records(): LogRecord[] {
+    const out: LogRecord[] = []
+    const linear = this.linearize()
+    const view = new DataView(linear.buffer)
+    for (let pos = 0; pos + HEADER_BYTES <= linear.length; ) {
+      const length = view.getUint16(pos + 6)
+      out.push({
+        t: epoch + view.getUint32(pos),
+        level: LEVEL_NAMES[view.getUint8(pos + 4)] ?? 'info',
+        module: this.modules[view.getUint8(pos + 5)] ?? '?',
+        message: decodeUtf8(linear.subarray(pos + HEADER_BYTES, pos + HEADER_BYTES + length)),
+      })
+      pos += HEADER_BYTES + length
+    }
+    return out
+  }
+
+  /** Bản ghi theo thứ tự thời gian, liền mạch (không vòng) */
+  linearize(): Uint8Array {
+    const out = new Uint8Array(this.used)
+    const first = Math.min(this.used, RING_BYTES - this.head)
+    out.set(this.bytes.subarray(this.head, this.head + first))
+    if (first < this.used) out.set(this.bytes.subarray(0, this.used - first), first)
+    return out
+  }
+
+  moduleTable() {
+    return [...this.modules]
+  }
+
+  clear() {
+    this.head = this.tail = this.used = 0
+    this.stats = { written: 0, overwritten: 0, bytes: 0 }
+  }
+
+  private dropOldest() {
+    const lengthAt = (this.head + 6) % RING_BYTES
+    const length = (this.bytes[lengthAt] << 8) | this.bytes[(lengthAt + 1) % RING_BYTES]
+    const size = HEADER_BYTES + length
+    this.head = (this.head + size) % RING_BYTES
+    this.used -= size
+    this.stats.overwritten++
+  }
+
+  private copyIn(data: Uint8Array) {
+    const first = Math.min(data.length, RING_BYTES - this.tail)
+    this.bytes.set(data.subarray(0, first), this.tail)
+    if (first < data.length) this.bytes.set(data.subarray(first), 0)
+    this.tail = (this.tail + data.length) % RING_BYTES
+  }
+}
+
+const ring = new LogRing()
+const sampling = new Map<string, number>()
+
+const resolve = <T>(value: Lazy<T>): T => (typeof value === 'function' ? (value as () => T)() : value)
+
+const stringify = (data: unknown): string => {
+  if (data instanceof Error) return `${data.name}: ${data.message}`
+  if (typeof data === 'string') return data
+  try {
+    return JSON.stringify(data) ?? String(data)
+  } catch {
+    return String(data)
+  }
+}
+
+const CONSOLE: Record<LogLevel, (...args: any[]) => void> = {
+  trace: (...args) => console.log(...args),
+  debug: (...args) => console.log(...args),
+  info: (...args) => console.log(...args),
+  warn: (...args) => console.warn(...args),
+  error: (...args) => console.error(...args),
+}
+
+// ============ PUBLIC API ============
+
+export interface Logger {
+  trace(message: Lazy<string>, data?: Lazy<unknown>): void
+  debug(message: Lazy<string>, data?: Lazy<unknown>): void
+  info(message: Lazy<string>, data?: Lazy<unknown>): void
+  warn(message: Lazy<string>, data?: Lazy<unknown>): void
+  error(message: Lazy<string>, data?: Lazy<unknown>): void
+  /** Có nên dựng dữ liệu log tốn kém không (vd. vòng lặp chỉ để log) */
+  enabled(level: LogLevel): boolean
+}
+
+/**
+ * Tạo logger cho 1 module.
+ * @param module - Tên ngắn, hiện trong console ([module]) và bản ghi ring buffer.
+ * @param options.sampleRate - Tỷ lệ giữ bản ghi trace/debug/info (0..1, mặc định 1).
+ */
+export const createLogger = (module: string, options: { sampleRate?: number } = {}): Logger => {
+  const moduleId = ring.moduleId(module)
+  if (options.sampleRate !== undefined && !sampling.has(module)) sampling.set(module, options.sampleRate)
+  let seen = 0
+  let kept = 0
+
+  const sampled = () => {
+    const rate = sampling.get(module) ?? 1
+    if (rate >= 1) return true
+    // Đếm thay vì random: tỷ lệ giữ đúng và đều theo thời gian
+    seen++
+    if (Math.floor(seen * rate) <= kept) return false
+    kept++
+    return true
+  }
+
+  const emit = (level: LogLevel, message: Lazy<string>, data?: Lazy<unknown>) => {
+    const rank = LEVELS[level]
+    if (rank < minLevel) return
+    if (rank < LEVELS.warn && !sampled()) return
+    const text = resolve(message)
+    const payload = data === undefined ? undefined : resolve(data)
+    ring.write(rank, moduleId, payload === undefined ? text : `${text} ${stringify(payload)}`)
+    if (rank >= CONSOLE_LEVEL) {
+      if (payload === undefined) CONSOLE[level](`[${module}] ${text}`)
+      else CONSOLE[level](`[${module}] ${text}`, payload)
+    }
+  }
+
+  return {
+    trace: (message, data) => emit('trace', message, data),
+    debug: (message, data) => emit('debug', message, data),
+    info: (message, data) => emit('info', message, data),
+    warn: (message, data) => emit('warn', message, data),
+    error: (message, data) => emit('error', message, data),
+    enabled: (level) => LEVELS[level] >= minLevel,
+  }
+}
+
+export const setLogLevel = (level: LogLevel) => {
+  minLevel = LEVELS[level]
+}
+
+export const getLogLevel = (): LogLevel => LEVEL_NAMES[minLevel]
+
+/** Đổi tỷ lệ lấy mẫu của 1 module lúc chạy (1 = giữ hết) */
+export const setModuleSampling = (module: string, rate: number) => {
+  sampling.set(module, Math.max(0, Math.min(1, rate)))
+}
+
+export const logBuffer = {
+  records: (): LogRecord[] => ring.records(),
+
+  /** Mỗi bản ghi 1 dòng, để chia sẻ / dán vào issue */
+  exportText(): string {
+    return ring
+      .records()
+      .map((r) => `${new Date(r.t).toISOString()} ${r.level.toUpperCase().padEnd(5)} [${r.module}] ${r.message}`)
+      .join('\n')
+  },
+
+  /** Dạng gọn để gửi lên server: bytes base64 theo layout ở đầu file + bảng tên module */
+  exportBinary() {
+    return { epoch, modules: ring.moduleTable(), data: toBase64(ring.linearize()) }
+  },
+
+  getStats: () => ({ ...ring.stats, capacity: RING_BYTES, level: getLogLevel() }),
+  clear: () => ring.clear(),
+}
+
+export default createLogger
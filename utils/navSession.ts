@@ -1,29 +1,25 @@
-import AsyncStorage from '@react-native-async-storage/async-storage'
+import persistedState from '@/utils/persistedState'
 
 export interface NavSessionData {
   startedAt: number
   routeSummary?: { points?: number }
 }
 
-const keyOf = (cacheKey: string) => `nav_session:${cacheKey}`
+// Đọc/ghi qua persistedState: phiên dẫn đường đã được nạp sẵn lúc khởi động
+const keyOf = (cacheKey: string) => `nav_session:${cacheKey}` as const
 
 export async function getNavSession(cacheKey: string): Promise<NavSessionData | null> {
   try {
-    const raw = await AsyncStorage.getItem(keyOf(cacheKey))
-    return raw ? (JSON.parse(raw) as NavSessionData) : null
+    return await persistedState.read(keyOf(cacheKey))
   } catch {
     return null
   }
 }
 
 export async function saveNavSession(cacheKey: string, data: NavSessionData): Promise<void> {
-  try {
-    await AsyncStorage.setItem(keyOf(cacheKey), JSON.stringify(data))
-  } catch {}
+  persistedState.set(keyOf(cacheKey), data)
 }
 
 export async function clearNavSession(cacheKey: string): Promise<void> {
-  try {
-    await AsyncStorage.removeItem(keyOf(cacheKey))
-  } catch {}
+  persistedState.remove([keyOf(cacheKey)])
 }
@@ -0,0 +1,520 @@
+/**
+ * Offline Outbox - hàng đợi bền vững cho thao tác ghi khi mất sóng
+ *
+ * - submit(kind, payload): đang online và scope không còn gì chờ thì gửi thẳng; mất mạng
+ *   (hoặc lỗi thử lại được) thì lưu vào hàng đợi và trả ngay { queued: true } để UI đi tiếp.
+ * - Mỗi thao tác có idempotency key cố định từ lần gửi đầu: gửi lại sau timeout/mất mạng
+ *   không tạo bản ghi trùng trên server.
+ * - Thứ tự phụ thuộc: thao tác cùng scope (vd. cùng chuyến) gửi lần lượt theo thứ tự đưa
+ *   vào; dependsOn cho phụ thuộc khác scope. Các scope độc lập gửi song song.
+ * - Attachment (ảnh minh chứng) được adapter chép ra chỗ bền vững lúc đưa vào hàng đợi,
+ *   xoá sau khi gửi xong.
+ * - durable: lưu entry trước cả lần gửi đầu (thao tác có upload dài). App bị tắt giữa chừng
+ *   thì lần khởi động sau gửi lại; handler ghi tiến độ (vd. fileId đã tải) qua saveResume
+ *   để lần gửi lại dùng tiếp.
+ * - Lỗi không thử lại được (4xx, server từ chối) thì bỏ khỏi hàng đợi, ghi vào `rejected`
+ *   để UI báo và lấy lại dữ liệu thật từ server.
+ * - Báo cáo: độ sâu hàng đợi (hiện tại/đỉnh), thời gian xả hàng đợi, thời gian chờ lâu nhất.
+ *
+ * Không import module native: RN wiring ở services/driverOutboxService.ts.
+ */
+
+export type OutboxStatus = 'queued' | 'sending'
+
+export interface OutboxEntry<P = any> {
+  id: string
+  kind: string
+  idempotencyKey: string
+  scope: string
+  dependsOn: string[]
+  payload: P
+  /** Ref attachment đã lưu bền vững (do adapter tạo) */
+  attachments: Record<string, any>
+  /** Tiến độ handler ghi lại giữa các lần gửi (saveResume) */
+  resume: Record<string, any>
+  status: OutboxStatus
+  attempts: number
+  createdAt: number
+  nextAttemptAt: number
+  error?: string
+}
+
+export interface OutboxRejection {
+  id: string
+  kind: string
+  scope: string
+  payload: any
+  error: string
+  response?: any
+  rejectedAt: number
+}
+
+export interface OutboxHandlerContext {
+  idempotencyKey: string
+  attachments: Record<string, any>
+  /** true khi gửi lại từ hàng đợi */
+  replay: boolean
+  /** Id entry đang gửi; không có khi gửi thẳng không qua hàng đợi */
+  entryId?: string
+  resume: Record<string, any>
+  /** Ghi tiến độ vào entry (lưu bền vững cùng hàng đợi) */
+  saveResume(key: string, value: any): void
+}
+
+export type OutboxHandler<P = any> = (payload: P, ctx: OutboxHandlerContext) => Promise<any>
+
+export interface SubmitOptions {
+  scope: string
+  dependsOn?: string[]
+  attachments?: Record<string, any>
+  /** Lưu entry trước khi gửi lần đầu: sống qua lần app bị tắt giữa chừng */
+  durable?: boolean
+}
+
+export type SubmitResult =
+  | { queued: false; result: any; idempotencyKey: string }
+  | { queued: true; entryId: string; idempotencyKey: string }
+
+export interface OutboxSnapshot {
+  online: boolean
+  depth: number
+  entries: ReadonlyArray<OutboxEntry>
+  rejected: ReadonlyArray<OutboxRejection>
+}
+
+export interface OutboxDrainReport {
+  sent: number
+  rejected: number
+  retries: number
+  drainMs: number
+  maxDepth: number
+  /** Thời gian từ lúc đưa vào hàng đợi tới khi server nhận, lâu nhất trong đợt */
+  maxQueuedMs: number
+}
+
+export interface OutboxAdapters {
+  storage: {
+    getItem(key: string): Promise<string | null>
+    setItem(key: string, value: string): Promise<void>
+  }
+  /** Lỗi mất mạng/timeout/5xx: giữ lại để gửi sau */
+  isRetryable(error: any): boolean
+  /** Chép attachment ra chỗ bền vững; trả ref lưu được bằng JSON */
+  persistAttachment?(entryId: string, name: string, source: any): Promise<any>
+  releaseAttachment?(ref: any): Promise<void>
+  onDrained?(report: OutboxDrainReport): void
+}
+
+export interface OfflineOutboxOptions {
+  storageKey?: string
+  /** Số scope gửi song song khi xả hàng đợi */
+  concurrency?: number
+  retryBaseMs?: number
+  retryMaxMs?: number
+  /** Quá số lần thử (khi đang online) thì coi là bị từ chối */
+  maxAttempts?: number
+  /** Thao tác chờ quá lâu thì bỏ (server đã sang trạng thái khác) */
+  expireMs?: number
+  maxRejected?: number
+}
+
+/** Server từ chối hẳn (không thử lại); response giữ nguyên để UI hiển thị */
+export class OutboxRejectedError extends Error {
+  constructor(message: string, public response?: any) {
+    super(message)
+  }
+}
+
+export class OfflineOutbox {
+  private options: Required<OfflineOutboxOptions>
+  private handlers = new Map<string, OutboxHandler>()
+  private entries: OutboxEntry[] = []
+  private rejected: OutboxRejection[] = []
+  private online = true
+  private loaded: Promise<void> | null = null
+  private draining: Promise<void> | null = null
+  private timer: ReturnType<typeof setTimeout> | null = null
+  private listeners = new Set<(snapshot: OutboxSnapshot) => void>()
+  private snapshot: OutboxSnapshot | null = null
+  private persistChain: Promise<void> = Promise.resolve()
+  private persistScheduled = false
+  // Đợt xả hiện tại: bắt đầu khi có hàng đợi và gửi được, kết thúc khi hàng đợi rỗng
+  private drainStartedAt: number | null = null
+  private drainCounters = { sent: 0, rejected: 0, retries: 0, maxQueuedMs: 0 }
+  private stats = {
+    submitted: 0,
+    sentDirect: 0,
+    queued: 0,
+    replayed: 0,
+    rejected: 0,
+    retries: 0,
+    maxDepth: 0,
+    drains: 0,
+    lastDrainMs: 0,
+    lastMaxQueuedMs: 0,
+  }
+
+  constructor(private adapters: OutboxAdapters, options: OfflineOutboxOptions = {}) {
+    this.options = {
+      storageKey: 'offline_outbox_v1',
+      concurrency: 2,
+      retryBaseMs: 2000,
+      retryMaxMs: 60000,
+      maxAttempts: 30,
+      expireMs: 3 * 24 * 60 * 60 * 1000,
+      maxRejected: 20,
+      ...options,
+    }
+  }
+
+  register<P>(kind: string, handler: OutboxHandler<P>) {
+    this.handlers.set(kind, handler)
+  }
+
+  async submit<P>(kind: string, payload: P, options: SubmitOptions): Promise<SubmitResult> {
+    const handler = this.handlers.get(kind)
+    if (!handler) throw new Error(`Outbox: chưa đăng ký handler cho ${kind}`)
+    await this.load()
+    this.stats.submitted++
+    const idempotencyKey = newId('idem')
+    const dependsOn = options.dependsOn ?? []
+
+    // Còn thao tác cùng scope đang chờ thì phải xếp sau, không gửi vượt
+    const blocked = !this.online || this.entries.some((e) => e.scope === options.scope || dependsOn.includes(e.id))
+    let directError: string | undefined
+    if (!blocked && !options.durable) {
+      const resume: Record<string, any> = {}
+      try {
+        const result = await handler(payload, {
+          idempotencyKey,
+          attachments: options.attachments ?? {},
+          replay: false,
+          resume,
+          saveResume: (key, value) => (resume[key] = value),
+        })
+        this.stats.sentDirect++
+        return { queued: false, result, idempotencyKey }
+      } catch (e: any) {
+        if (!this.adapters.isRetryable(e)) throw e
+        // Gửi thẳng thất bại vì mạng: xếp hàng với cùng idempotency key
+        directError = e?.message || 'Lỗi mạng'
+      }
+    }
+
+    const id = newId('ob')
+    const entry: OutboxEntry<P> = {
+      id,
+      kind,
+      idempotencyKey,
+      scope: options.scope,
+      dependsOn,
+      payload,
+      attachments: await this.persistAttachments(id, options.attachments ?? {}),
+      resume: {},
+      status: 'queued',
+      attempts: directError ? 1 : 0,
+      createdAt: Date.now(),
+      nextAttemptAt: directError ? Date.now() + this.options.retryBaseMs : 0,
+      error: directError,
+    }
+    this.entries.push(entry)
+
+    if (options.durable && !blocked) {
+      // Gửi ngay như gửi thẳng nhưng entry đã nằm trong hàng đợi (status sending)
+      entry.status = 'sending'
+      entry.attempts++
+      this.changed()
+      try {
+        const result = await handler(payload, this.contextOf(entry, false))
+        this.remove(entry)
+        this.stats.sentDirect++
+        this.changed()
+        // Thao tác cùng scope đưa vào trong lúc gửi đang chờ entry này
+        if (this.online && this.entries.length > 0) this.drain()
+        return { queued: false, result, idempotencyKey }
+      } catch (e: any) {
+        if (!this.adapters.isRetryable(e)) {
+          // Người gọi nhận lỗi trực tiếp như gửi thẳng, không ghi vào rejected
+          this.remove(entry)
+          this.changed()
+          if (this.online && this.entries.length > 0) this.drain()
+          throw e
+        }
+        entry.status = 'queued'
+        entry.error = e?.message || 'Lỗi mạng'
+        entry.nextAttemptAt = Date.now() + this.options.retryBaseMs
+      }
+    }
+
+    this.stats.queued++
+    this.stats.maxDepth = Math.max(this.stats.maxDepth, this.entries.length)
+    this.changed()
+    if (this.online) this.drain()
+    return { queued: true, entryId: id, idempotencyKey }
+  }
+
+  /** Báo trạng thái mạng (NetInfo); có mạng lại thì xả hàng đợi ngay */
+  setOnline(online: boolean) {
+    if (this.online === online) return
+    this.online = online
+    if (online) {
+      // Mạng vừa có lại: bỏ back-off cũ
+      this.entries.forEach((e) => (e.nextAttemptAt = 0))
+      this.drain()
+    } else if (this.timer) {
+      clearTimeout(this.timer)
+      this.timer = null
+    }
+    this.changed(false)
+  }
+
+  isOnline() {
+    return this.online
+  }
+
+  /** Gửi các thao tác đã sẵn sàng; gọi lặp khi đang xả thì dùng chung 1 lượt */
+  drain(): Promise<void> {
+    if (!this.draining) {
+      this.draining = this.runDrain().finally(() => {
+        this.draining = null
+      })
+    }
+    return this.draining
+  }
+
+  getSnapshot(): OutboxSnapshot {
+    if (!this.snapshot) {
+      this.snapshot = {
+        online: this.online,
+        depth: this.entries.length,
+        entries: this.entries.slice(),
+        rejected: this.rejected.slice(),
+      }
+    }
+    return this.snapshot
+  }
+
+  subscribe(listener: (snapshot: OutboxSnapshot) => void): () => void {
+    this.listeners.add(listener)
+    return () => {
+      this.listeners.delete(listener)
+    }
+  }
+
+  /** Bỏ thông báo từ chối đã hiển thị */
+  dismissRejected(id: string) {
+    const before = this.rejected.length
+    this.rejected = this.rejected.filter((r) => r.id !== id)
+    if (this.rejected.length !== before) this.changed()
+  }
+
+  load(): Promise<void> {
+    if (!this.loaded) {
+      this.loaded = this.adapters.storage
+        .getItem(this.options.storageKey)
+        .then((raw) => {
+          if (!raw) return
+          const saved = JSON.parse(raw) as { entries?: OutboxEntry[]; rejected?: OutboxRejection[] }
+          // App bị tắt khi đang gửi: gửi lại (idempotency key giữ nguyên)
+          const restored = (saved.entries ?? []).map((e) => ({ ...e, resume: e.resume ?? {}, status: 'queued' as const, nextAttemptAt: 0 }))
+          this.entries = [...restored, ...this.entries]
+          this.rejected = [...(saved.rejected ?? []), ...this.rejected].slice(-this.options.maxRejected)
+          this.stats.maxDepth = Math.max(this.stats.maxDepth, this.entries.length)
+          this.changed(false)
+        })
+        .catch((e) => console.warn('[OfflineOutbox] không đọc được hàng đợi đã lưu', e))
+    }
+    return this.loaded
+  }
+
+  getStats() {
+    return { ...this.stats, depth: this.entries.length, online: this.online }
+  }
+
+  // ============ PRIVATE METHODS ============
+
+  private async runDrain() {
+    await this.load()
+    if (this.timer) {
+      clearTimeout(this.timer)
+      this.timer = null
+    }
+    if (this.entries.length > 0 && this.online && this.drainStartedAt === null) {
+      this.drainStartedAt = Date.now()
+      this.drainCounters = { sent: 0, rejected: 0, retries: 0, maxQueuedMs: 0 }
+    }
+
+    while (this.online) {
+      const ready = this.readyEntries()
+      if (ready.length === 0) break
+      await Promise.all(ready.map((entry) => this.send(entry)))
+    }
+
+    // Scope có entry durable đang gửi ngoài lượt xả thì không hẹn giờ: submit drain lại khi nó xong
+    const busy = new Set(this.entries.filter((e) => e.status === 'sending').map((e) => e.scope))
+    const waiting = this.entries.filter((e) => e.status === 'queued' && !busy.has(e.scope))
+    if (this.entries.length === 0) this.finishDrain()
+    else if (this.online && waiting.length > 0) {
+      const next = Math.min(...waiting.map((e) => e.nextAttemptAt))
+      this.scheduleDrain(Math.max(0, next - Date.now()))
+    }
+  }
+
+  /** Mỗi scope lấy thao tác đầu tiên chưa bị chặn, tối đa `concurrency` scope */
+  private readyEntries(): OutboxEntry[] {
+    const now = Date.now()
+    const ids = new Set(this.entries.map((e) => e.id))
+    const seenScopes = new Set<string>()
+    const ready: OutboxEntry[] = []
+    for (const entry of this.entries) {
+      if (seenScopes.has(entry.scope)) continue
+      seenScopes.add(entry.scope)
+      if (entry.status !== 'queued' || entry.nextAttemptAt > now) continue
+      if (entry.dependsOn.some((id) => ids.has(id))) continue
+      ready.push(entry)
+      if (ready.length >= this.options.concurrency) break
+    }
+    return ready
+  }
+
+  private async send(entry: OutboxEntry) {
+    const handler = this.handlers.get(entry.kind)
+    if (!handler) {
+      this.reject(entry, `Không có handler cho ${entry.kind}`)
+      return
+    }
+    if (Date.now() - entry.createdAt > this.options.expireMs) {
+      this.reject(entry, 'Thao tác chờ quá lâu, đã huỷ')
+      return
+    }
+
+    entry.status = 'sending'
+    entry.attempts++
+    this.changed()
+    try {
+      await handler(entry.payload, this.contextOf(entry, true))
+      this.remove(entry)
+      this.stats.replayed++
+      this.drainCounters.sent++
+      this.drainCounters.maxQueuedMs = Math.max(this.drainCounters.maxQueuedMs, Date.now() - entry.createdAt)
+      this.changed()
+    } catch (e: any) {
+      if (!this.adapters.isRetryable(e) || entry.attempts >= this.options.maxAttempts) {
+        this.reject(entry, e?.message || 'Server từ chối thao tác', e?.response)
+        return
+      }
+      entry.status = 'queued'
+      entry.error = e?.message
+      const backoff = Math.min(this.options.retryMaxMs, this.options.retryBaseMs * 2 ** (entry.attempts - 1))
+      entry.nextAttemptAt = Date.now() + backoff / 2 + Math.random() * (backoff / 2)
+      this.stats.retries++
+      this.drainCounters.retries++
+      this.changed()
+    }
+  }
+
+  private contextOf(entry: OutboxEntry, replay: boolean): OutboxHandlerContext {
+    return {
+      idempotencyKey: entry.idempotencyKey,
+      attachments: entry.attachments,
+      replay,
+      entryId: entry.id,
+      resume: entry.resume,
+      saveResume: (key, value) => {
+        entry.resume[key] = value
+        this.changed()
+      },
+    }
+  }
+
+  private reject(entry: OutboxEntry, error: string, response?: any) {
+    this.remove(entry)
+    this.rejected.push({
+      id: entry.id,
+      kind: entry.kind,
+      scope: entry.scope,
+      payload: entry.payload,
+      error,
+      response: response?.data ?? response,
+      rejectedAt: Date.now(),
+    })
+    if (this.rejected.length > this.options.maxRejected) this.rejected.shift()
+    this.stats.rejected++
+    this.drainCounters.rejected++
+    this.changed()
+  }
+
+  private remove(entry: OutboxEntry) {
+    this.entries = this.entries.filter((e) => e.id !== entry.id)
+    const release = this.adapters.releaseAttachment
+    if (release) forEachRef(entry.attachments, (ref) => release(ref).catch(() => {}))
+  }
+
+  private finishDrain() {
+    if (this.drainStartedAt === null) return
+    const report: OutboxDrainReport = {
+      ...this.drainCounters,
+      drainMs: Date.now() - this.drainStartedAt,
+      maxDepth: this.stats.maxDepth,
+    }
+    this.drainStartedAt = null
+    this.stats.drains++
+    this.stats.lastDrainMs = report.drainMs
+    this.stats.lastMaxQueuedMs = report.maxQueuedMs
+    // Đỉnh độ sâu tính lại cho đợt mất mạng sau
+    this.stats.maxDepth = 0
+    if (report.sent + report.rejected > 0) this.adapters.onDrained?.(report)
+  }
+
+  private scheduleDrain(delayMs: number | null) {
+    if (delayMs === null || this.timer) return
+    this.timer = setTimeout(() => {
+      this.timer = null
+      this.drain()
+    }, delayMs)
+  }
+
+  private async persistAttachments(entryId: string, attachments: Record<string, any>) {
+    const persist = this.adapters.persistAttachment
+    if (!persist) return attachments
+    const out: Record<string, any> = {}
+    for (const name of Object.keys(attachments)) {
+      const value = attachments[name]
+      if (value === null || value === undefined) continue
+      out[name] = Array.isArray(value)
+        ? await Promise.all(value.map((v, i) => persist(entryId, `${name}_${i}`, v)))
+        : await persist(entryId, name, value)
+    }
+    return out
+  }
+
+  private changed(save = true) {
+    this.snapshot = null
+    if (save) this.persist()
+    const snapshot = this.getSnapshot()
+    this.listeners.forEach((listener) => listener(snapshot))
+  }
+
+  // Ghi nối tiếp và gộp như ResumableUploader
+  private persist() {
+    if (this.persistScheduled) return
+    this.persistScheduled = true
+    this.persistChain = this.persistChain
+      .then(() => {
+        this.persistScheduled = false
+        const data = JSON.stringify({ entries: this.entries, rejected: this.rejected })
+        return this.adapters.storage.setItem(this.options.storageKey, data)
+      })
+      .catch((e) => console.warn('[OfflineOutbox] không lưu được hàng đợi', e))
+  }
+}
+
+const newId = (prefix: string) =>
+  `${prefix}_${Date.now().toString(36)}_${Math.random().toString(36).slice(2, 10)}`
+
+const forEachRef = (attachments: Record<string, any>, fn: (ref: any) => void) => {
+  Object.values(attachments).forEach((value) => {
+    if (Array.isArray(value)) value.forEach(fn)
+    else if (value !== null && value !== undefined) fn(value)
+  })
+}
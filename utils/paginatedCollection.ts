@@ -0,0 +1,346 @@
+/**
+ * Paginated Collection - danh sách cuộn vô hạn theo cursor
+ *
+ * - Mỗi trang gọi fetcher({ cursor, pageSize }) và nhận lại { items, nextCursor }.
+ *   API hiện tại vẫn phân trang pageNumber/pageSize: dùng offsetCursor/toOffsetPage
+ *   để coi số trang như cursor; backend trả nextCursor thì dùng luôn.
+ * - Prefetch: nạp sẵn trang kế tiếp (chưa hiển thị) ngay khi vừa thêm trang,
+ *   loadMore lúc cuộn gần cuối chỉ việc nối vào, không chờ mạng.
+ * - Khử trùng lặp theo key: phân trang offset bị lệch khi có bản ghi mới chèn lên đầu
+ *   => trang sau lặp lại vài dòng của trang trước; dòng trùng chỉ cập nhật dữ liệu.
+ * - Cửa sổ giới hạn: giữ tối đa maxItems dòng; vượt thì bỏ các trang ở đầu bên kia
+ *   (nhớ cursor để loadPrevious nạp lại khi cuộn ngược).
+ */
+
+export interface CursorPage<T> {
+  items: T[]
+  /** null = hết dữ liệu */
+  nextCursor: string | null
+  totalCount?: number
+}
+
+export interface CursorPageRequest {
+  /** null = trang đầu */
+  cursor: string | null
+  pageSize: number
+  /** true = nạp sẵn, chưa ai chờ (fetcher nên gửi với priority "background") */
+  prefetch?: boolean
+}
+
+export type CursorPageFetcher<T> = (request: CursorPageRequest) => Promise<CursorPage<T>>
+
+export interface PaginatedCollectionOptions<T> {
+  fetchPage: CursorPageFetcher<T>
+  keyOf: (item: T) => string
+  pageSize?: number
+  /** Số dòng tối đa giữ trong bộ nhớ */
+  maxItems?: number
+  /** Nạp sẵn trang kế tiếp sau mỗi lần thêm trang */
+  prefetch?: boolean
+}
+
+export interface PaginatedSnapshot<T> {
+  items: T[]
+  totalCount: number
+  loading: boolean
+  loadingMore: boolean
+  loadingPrevious: boolean
+  refreshing: boolean
+  hasMore: boolean
+  /** Đầu danh sách đã bị cắt khỏi cửa sổ, cuộn lên sẽ nạp lại */
+  hasPrevious: boolean
+  error: string | null
+}
+
+interface LoadedPage {
+  cursor: string | null
+  nextCursor: string | null
+  keys: string[]
+}
+
+const DEFAULT_PAGE_SIZE = 20
+const DEFAULT_MAX_ITEMS = 600
+
+// ============ OFFSET ADAPTER ============
+
+/** Cursor của API pageNumber/pageSize: cursor = số trang dạng chuỗi */
+export const offsetCursor = {
+  toPageNumber: (cursor: string | null): number => {
+    const n = cursor ? parseInt(cursor, 10) : 1
+    return Number.isFinite(n) && n > 0 ? n : 1
+  },
+  fromPageNumber: (pageNumber: number): string => String(pageNumber),
+}
+
+/**
+ * Chuẩn hoá 1 trang offset về CursorPage. Ưu tiên nextCursor/hasNextPage của backend,
+ * sau đó totalPages/totalCount, cuối cùng là "trang đủ pageSize thì còn tiếp".
+ */
+export function toOffsetPage<T>(
+  items: T[],
+  pageNumber: number,
+  pageSize: number,
+  meta: { totalCount?: number; totalPages?: number; hasNextPage?: boolean; nextCursor?: string | null } = {}
+): CursorPage<T> {
+  if (meta.nextCursor !== undefined) {
+    return { items, nextCursor: meta.nextCursor || null, totalCount: meta.totalCount }
+  }
+  let hasNext: boolean
+  if (typeof meta.hasNextPage === 'boolean') hasNext = meta.hasNextPage
+  else if (meta.totalPages !== undefined && meta.totalPages > 0) hasNext = pageNumber < meta.totalPages
+  else if (meta.totalCount !== undefined) hasNext = pageNumber * pageSize < meta.totalCount
+  else hasNext = items.length >= pageSize
+  return {
+    items,
+    nextCursor: hasNext && items.length > 0 ? offsetCursor.fromPageNumber(pageNumber + 1) : null,
+    totalCount: meta.totalCount,
+  }
+}
+
+// ============ COLLECTION ============
+
+export class PaginatedCollection<T> {
+  private options: Required<PaginatedCollectionOptions<T>>
+  private pages: LoadedPage[] = []
+  private byKey = new Map<string, T>()
+  // Cursor các trang đã bị cắt khỏi đầu cửa sổ (cuối mảng = trang liền trước pages[0])
+  private droppedHead: (string | null)[] = []
+  private prefetched = new Map<string, Promise<CursorPage<T>>>()
+  private inflight: Promise<void> | null = null
+  // Tăng mỗi lần reset để bỏ kết quả của request cũ
+  private generation = 0
+  private listeners = new Set<(snapshot: PaginatedSnapshot<T>) => void>()
+  private snapshot: PaginatedSnapshot<T> = {
+    items: [],
+    totalCount: 0,
+    loading: false,
+    loadingMore: false,
+    loadingPrevious: false,
+    refreshing: false,
+    hasMore: true,
+    hasPrevious: false,
+    error: null,
+  }
+  private stats = { pagesFetched: 0, prefetchHits: 0, duplicatesMerged: 0, itemsTrimmed: 0 }
+
+  constructor(options: PaginatedCollectionOptions<T>) {
+    this.options = {
+      pageSize: DEFAULT_PAGE_SIZE,
+      maxItems: DEFAULT_MAX_ITEMS,
+      prefetch: true,
+      ...options,
+    }
+    // Cửa sổ phải chứa được ít nhất 2 trang, nếu không sẽ cắt trang vừa nạp
+    this.options.maxItems = Math.max(this.options.maxItems, this.options.pageSize * 2)
+  }
+
+  getSnapshot(): PaginatedSnapshot<T> {
+    return this.snapshot
+  }
+
+  getStats() {
+    return { ...this.stats, windowSize: this.snapshot.items.length, pages: this.pages.length }
+  }
+
+  subscribe(listener: (snapshot: PaginatedSnapshot<T>) => void): () => void {
+    this.listeners.add(listener)
+    return () => {
+      this.listeners.delete(listener)
+    }
+  }
+
+  /** Nạp lại từ đầu; refresh = true giữ danh sách cũ tới khi có dữ liệu mới (pull-to-refresh) */
+  reload(refresh: boolean = false): Promise<void> {
+    const generation = ++this.generation
+    this.prefetched.clear()
+    this.inflight = null
+    this.patch({ loading: !refresh, refreshing: refresh, loadingMore: false, loadingPrevious: false, error: null })
+
+    const task = this.options
+      .fetchPage({ cursor: null, pageSize: this.options.pageSize })
+      .then((page) => {
+        if (generation !== this.generation) return
+        this.stats.pagesFetched++
+        this.pages = []
+        this.byKey.clear()
+        this.droppedHead = []
+        this.appendPage(null, page)
+        this.patch({ loading: false, refreshing: false }, true)
+        this.prefetchNext()
+      })
+      .catch((error) => {
+        if (generation !== this.generation) return
+        this.patch({ loading: false, refreshing: false, error: this.errorMessage(error) })
+      })
+      .finally(() => {
+        if (this.inflight === task) this.inflight = null
+      })
+    this.inflight = task
+    return task
+  }
+
+  /** Cuộn gần cuối: nối trang kế tiếp (dùng bản prefetch nếu có) */
+  loadMore(): Promise<void> {
+    const cursor = this.tailCursor()
+    if (this.inflight || cursor === null || this.pages.length === 0) return this.inflight ?? Promise.resolve()
+    const generation = this.generation
+    const prefetched = this.prefetched.get(cursor)
+    if (prefetched) this.stats.prefetchHits++
+    this.patch({ loadingMore: true, error: null })
+
+    const task = (prefetched ?? this.fetch(cursor))
+      .then((page) => {
+        if (generation !== this.generation) return
+        this.prefetched.delete(cursor)
+        this.appendPage(cursor, page)
+        this.trimHead()
+        this.patch({ loadingMore: false }, true)
+        this.prefetchNext()
+      })
+      .catch((error) => {
+        if (generation !== this.generation) return
+        this.prefetched.delete(cursor)
+        this.patch({ loadingMore: false, error: this.errorMessage(error) })
+      })
+      .finally(() => {
+        if (this.inflight === task) this.inflight = null
+      })
+    this.inflight = task
+    return task
+  }
+
+  /** Cuộn ngược lên phần đầu đã bị cắt khỏi cửa sổ */
+  loadPrevious(): Promise<void> {
+    if (this.inflight || this.droppedHead.length === 0) return this.inflight ?? Promise.resolve()
+    const generation = this.generation
+    const cursor = this.droppedHead[this.droppedHead.length - 1]
+    this.patch({ loadingPrevious: true, error: null })
+
+    const task = this.fetch(cursor)
+      .then((page) => {
+        if (generation !== this.generation) return
+        this.droppedHead.pop()
+        this.prependPage(cursor, page)
+        this.trimTail()
+        this.patch({ loadingPrevious: false }, true)
+      })
+      .catch((error) => {
+        if (generation !== this.generation) return
+        this.patch({ loadingPrevious: false, error: this.errorMessage(error) })
+      })
+      .finally(() => {
+        if (this.inflight === task) this.inflight = null
+      })
+    this.inflight = task
+    return task
+  }
+
+  /** Cập nhật cục bộ 1 dòng (vd. đánh dấu đã đọc) */
+  update(key: string, updater: (item: T) => T) {
+    const item = this.byKey.get(key)
+    if (item === undefined) return
+    this.byKey.set(key, updater(item))
+    this.patch({}, true)
+  }
+
+  /** Cập nhật cục bộ mọi dòng trong cửa sổ */
+  updateAll(updater: (item: T) => T) {
+    this.byKey.forEach((item, key) => this.byKey.set(key, updater(item)))
+    this.patch({}, true)
+  }
+
+  /** Xoá cục bộ 1 dòng (vd. sau khi xoá thành công trên server) */
+  remove(key: string) {
+    if (!this.byKey.delete(key)) return
+    this.pages.forEach((page) => {
+      page.keys = page.keys.filter((k) => k !== key)
+    })
+    this.patch({ totalCount: Math.max(0, this.snapshot.totalCount - 1) }, true)
+  }
+
+  // ============ PRIVATE METHODS ============
+
+  private fetch(cursor: string, prefetch = false): Promise<CursorPage<T>> {
+    this.stats.pagesFetched++
+    return this.options.fetchPage({ cursor, pageSize: this.options.pageSize, prefetch })
+  }
+
+  private tailCursor(): string | null {
+    return this.pages.length > 0 ? this.pages[this.pages.length - 1].nextCursor : null
+  }
+
+  private prefetchNext() {
+    if (!this.options.prefetch) return
+    const cursor = this.tailCursor()
+    if (cursor === null || this.prefetched.has(cursor)) return
+    const pending = this.fetch(cursor, true)
+    // Lỗi prefetch không báo ra UI; loadMore sẽ thử lại
+    pending.catch(() => {
+      if (this.prefetched.get(cursor) === pending) this.prefetched.delete(cursor)
+    })
+    this.prefetched.set(cursor, pending)
+  }
+
+  // Dòng đã có trong cửa sổ thì cập nhật dữ liệu, không thêm lần nữa
+  private collectKeys(page: CursorPage<T>): string[] {
+    const keys: string[] = []
+    for (const item of page.items) {
+      const key = this.options.keyOf(item)
+      if (this.byKey.has(key)) this.stats.duplicatesMerged++
+      else keys.push(key)
+      this.byKey.set(key, item)
+    }
+    return keys
+  }
+
+  private appendPage(cursor: string | null, page: CursorPage<T>) {
+    this.pages.push({ cursor, nextCursor: page.nextCursor, keys: this.collectKeys(page) })
+    if (page.totalCount !== undefined) this.snapshot = { ...this.snapshot, totalCount: page.totalCount }
+  }
+
+  private prependPage(cursor: string | null, page: CursorPage<T>) {
+    this.pages.unshift({ cursor, nextCursor: page.nextCursor, keys: this.collectKeys(page) })
+  }
+
+  private trimHead() {
+    while (this.pages.length > 1 && this.countItems() > this.options.maxItems) {
+      const dropped = this.pages.shift()!
+      this.droppedHead.push(dropped.cursor)
+      dropped.keys.forEach((k) => this.byKey.delete(k))
+      this.stats.itemsTrimmed += dropped.keys.length
+    }
+  }
+
+  private trimTail() {
+    let trimmed = false
+    while (this.pages.length > 1 && this.countItems() > this.options.maxItems) {
+      const dropped = this.pages.pop()!
+      dropped.keys.forEach((k) => this.byKey.delete(k))
+      this.stats.itemsTrimmed += dropped.keys.length
+      trimmed = true
+    }
+    // Trang cuối mới có nextCursor trỏ tới trang vừa bỏ => loadMore nạp lại được
+    if (trimmed) this.prefetched.clear()
+  }
+
+  private countItems(): number {
+    return this.pages.reduce((sum, page) => sum + page.keys.length, 0)
+  }
+
+  private errorMessage(error: any): string {
+    return error?.response?.data?.message || error?.message || 'Không thể tải dữ liệu'
+  }
+
+  private patch(partial: Partial<PaginatedSnapshot<T>>, rebuildItems: boolean = false) {
+    const next: PaginatedSnapshot<T> = { ...this.snapshot, ...partial }
+    if (rebuildItems) {
+      const items: T[] = []
+      this.pages.forEach((page) => page.keys.forEach((k) => items.push(this.byKey.get(k)!)))
+      next.items = items
+      next.hasMore = this.tailCursor() !== null
+      next.hasPrevious = this.droppedHead.length > 0
+    }
+    this.snapshot = next
+    this.listeners.forEach((listener) => listener(next))
+  }
+}
@@ -0,0 +1,221 @@
+import AsyncStorage from '@react-native-async-storage/async-storage'
+import type { AuthenticatedUser } from '@/models/types'
+import type { NavSessionData } from '@/utils/navSession'
+import { track } from '@/utils/analytics'
+
+/**
+ * Persisted State - nạp AsyncStorage 1 lần lúc khởi động, đọc/ghi qua bộ nhớ
+ *
+ * - hydrate(): multiGet đúng các key cố định (KNOWN_KEYS) trong 1 lượt, thay vì mỗi nơi
+ *   tự await getItem lúc mount. Gọi nhiều lần dùng chung 1 promise.
+ * - Key theo chuyến (nav_session:*, trip:*:pickupMarked) không vào lượt khởi động: số key
+ *   tăng theo số chuyến, nạp hết thì thời gian khởi động tăng mãi. read() nạp từng key khi cần,
+ *   màn chi tiết chuyến xoá chúng khi chuyến kết thúc.
+ * - get/read: đọc từ bộ nhớ (read chờ hydrate nếu chưa xong). Key ngoài KNOWN_KEYS đọc
+ *   thẳng storage 1 lần rồi giữ lại.
+ * - set/remove: cập nhật bộ nhớ ngay, ghi xuống storage gộp theo lô sau WRITE_DELAY_MS
+ *   (multiSet + multiRemove); flush() khi cần chắc đã ghi (token, logout). Lô ghi lỗi được
+ *   xếp lại (trừ key đã có giá trị mới hơn) và thử lại sau WRITE_RETRY_MS.
+ * - Đo thời gian nằm trong storage: hydrateMs / storageMs / lượt gọi, báo "storage_hydrated".
+ *
+ * Cache lớn tự quản (reverse geocode, lịch sử địa chỉ, giờ lái) vẫn tự nạp lười
+ * khi dùng tới, không kéo vào lượt khởi động.
+ */
+
+export interface PersistedSchema {
+  accessToken: string
+  refreshToken: string
+  user: AuthenticatedUser
+  wallet: any
+  verificationStatus: { isVerified: boolean; message: string }
+  '@cached_regions': any[]
+  'drivershare:lastGoodLocation:v1': any
+  [navSession: `nav_session:${string}`]: NavSessionData
+  [pickupMark: `trip:${string}:pickupMarked`]: string
+}
+
+export type PersistedKey = Extract<keyof PersistedSchema, string>
+
+// Key lưu chuỗi thô (không JSON)
+const RAW_KEYS = new Set<string>(['accessToken', 'refreshToken'])
+const RAW_PATTERNS = [/^trip:.+:pickupMarked$/]
+
+const KNOWN_KEYS = [
+  'accessToken',
+  'refreshToken',
+  'user',
+  'wallet',
+  'verificationStatus',
+  '@cached_regions',
+  'drivershare:lastGoodLocation:v1',
+]
+
+const WRITE_DELAY_MS = 250
+const WRITE_RETRY_MS = 5 * 1000
+
+const isRaw = (key: string) => RAW_KEYS.has(key) || RAW_PATTERNS.some((p) => p.test(key))
+
+const decode = (key: string, raw: string | null): any => {
+  if (raw === null || isRaw(key)) return raw
+  try {
+    return JSON.parse(raw)
+  } catch {
+    return null
+  }
+}
+
+class PersistedState {
+  /** key -> chuỗi đã lưu (null = không có) */
+  private values = new Map<string, string | null>()
+  private hydrating: Promise<void> | null = null
+  private hydrated = false
+  private pendingWrites = new Map<string, string | null>()
+  private writeTimer: ReturnType<typeof setTimeout> | null = null
+  private flushing: Promise<void> = Promise.resolve()
+  private stats = {
+    hydrateMs: 0,
+    hydratedKeys: 0,
+    hydratedBytes: 0,
+    storageMs: 0,
+    storageCalls: 0,
+    memoryReads: 0,
+    directReads: 0,
+    writes: 0,
+    writeBatches: 0,
+    writeFailures: 0,
+  }
+
+  /** Nạp mọi key đã biết trong 1 lượt; gọi sớm nhất có thể lúc khởi động */
+  hydrate(): Promise<void> {
+    if (this.hydrating) return this.hydrating
+    this.hydrating = (async () => {
+      const startedAt = Date.now()
+      try {
+        // Key chưa có trong storage trả null: ghi nhận luôn để khỏi đọc lại
+        const entries = await this.timed(() => AsyncStorage.multiGet(KNOWN_KEYS))
+        entries.forEach(([key, value]) => {
+          // set() trong lúc đang hydrate thắng giá trị cũ trong storage
+          if (!this.values.has(key)) this.values.set(key, value)
+          this.stats.hydratedBytes += value?.length ?? 0
+        })
+        this.stats.hydratedKeys = entries.filter(([, value]) => value !== null).length
+      } catch (e) {
+        console.warn('[PersistedState] hydrate failed', e)
+      } finally {
+        this.hydrated = true
+        this.stats.hydrateMs = Date.now() - startedAt
+        track('storage_hydrated', { ...this.stats })
+      }
+    })()
+    return this.hydrating
+  }
+
+  isHydrated() {
+    return this.hydrated
+  }
+
+  /** Đọc đồng bộ từ bộ nhớ (undefined = chưa hydrate / key chưa nạp) */
+  get<K extends PersistedKey>(key: K): PersistedSchema[K] | null | undefined {
+    if (!this.values.has(key)) return undefined
+    this.stats.memoryReads++
+    return decode(key, this.values.get(key) ?? null)
+  }
+
+  /** Đọc sau khi hydrate; key ngoài danh sách đọc storage 1 lần rồi giữ trong bộ nhớ */
+  async read<K extends PersistedKey>(key: K): Promise<PersistedSchema[K] | null> {
+    await this.hydrate()
+    if (!this.values.has(key) && !KNOWN_KEYS.includes(key)) {
+      this.stats.directReads++
+      const raw = await this.timed(() => AsyncStorage.getItem(key))
+      if (!this.values.has(key)) this.values.set(key, raw)
+    }
+    return this.get(key) ?? null
+  }
+
+  set<K extends PersistedKey>(key: K, value: PersistedSchema[K] | null) {
+    const raw = value === null || value === undefined ? null : isRaw(key) ? String(value) : JSON.stringify(value)
+    this.values.set(key, raw)
+    this.pendingWrites.set(key, raw)
+    this.stats.writes++
+    this.scheduleWrite()
+  }
+
+  remove(keys: PersistedKey[]) {
+    keys.forEach((key) => this.set(key, null))
+  }
+
+  /** Ghi ngay các thay đổi đang chờ */
+  flush(): Promise<void> {
+    if (this.writeTimer) {
+      clearTimeout(this.writeTimer)
+      this.writeTimer = null
+    }
+    // Nối tiếp sau lượt ghi trước: thứ tự ghi giữ đúng thứ tự set
+    this.flushing = this.flushing.then(() => this.writeBatch())
+    return this.flushing
+  }
+
+  /** Xoá bộ nhớ (vd. sau AsyncStorage.clear ở màn dev) */
+  reset() {
+    this.values.clear()
+    this.pendingWrites.clear()
+    this.hydrating = null
+    this.hydrated = false
+  }
+
+  getStats() {
+    return { ...this.stats, hydrated: this.hydrated, pendingWrites: this.pendingWrites.size }
+  }
+
+  // ============ PRIVATE METHODS ============
+
+  private scheduleWrite(delay = WRITE_DELAY_MS) {
+    if (this.writeTimer) return
+    this.writeTimer = setTimeout(() => {
+      this.writeTimer = null
+      this.flush()
+    }, delay)
+  }
+
+  private async writeBatch() {
+    if (this.pendingWrites.size === 0) return
+    const batch = Array.from(this.pendingWrites)
+    this.pendingWrites.clear()
+    const sets = batch.filter((e): e is [string, string] => e[1] !== null)
+    const removes = batch.filter(([, v]) => v === null).map(([k]) => k)
+    this.stats.writeBatches++
+    let failed: [string, string | null][] = []
+    try {
+      if (sets.length > 0) await this.timed(() => AsyncStorage.multiSet(sets))
+    } catch (e) {
+      console.warn('[PersistedState] multiSet failed', e)
+      failed = failed.concat(sets)
+    }
+    try {
+      if (removes.length > 0) await this.timed(() => AsyncStorage.multiRemove(removes))
+    } catch (e) {
+      console.warn('[PersistedState] multiRemove failed', e)
+      failed = failed.concat(removes.map((k): [string, null] => [k, null]))
+    }
+    if (failed.length === 0) return
+    this.stats.writeFailures++
+    // Bộ nhớ đã giữ giá trị mới: xếp lại để storage không lệch; set() mới hơn trong lúc ghi thì giữ cái mới
+    failed.forEach(([key, raw]) => {
+      if (!this.pendingWrites.has(key)) this.pendingWrites.set(key, raw)
+    })
+    this.scheduleWrite(WRITE_RETRY_MS)
+  }
+
+  private async timed<T>(run: () => Promise<T>): Promise<T> {
+    const startedAt = Date.now()
+    this.stats.storageCalls++
+    try {
+      return await run()
+    } finally {
+      this.stats.storageMs += Date.now() - startedAt
+    }
+  }
+}
+
+export const persistedState = new PersistedState()
+export default persistedState
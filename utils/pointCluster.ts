@@ -0,0 +1,394 @@
+import type { Feature, FeatureCollection, Point } from 'geojson'
+// Chỉ mục gom cụm điểm (bài đăng, kiện hàng, xe) theo lưới phân cấp trên Web Mercator.
+// Mỗi zoom là một lưới ô vuông có kích thước cố định theo pixel; ô ở zoom z chứa đúng 4 ô ở z+1
+// nên cây cụm có sẵn mà không cần dựng lại. Mỗi ô chỉ giữ count + tổng toạ độ (tâm cụm),
+// thêm/xoá/di chuyển 1 điểm là O(số zoom). Truy vấn theo viewport chỉ duyệt các ô trong khung.
+
+export interface ClusterPointInput<P = Record<string, any>> {
+  id: string
+  lng: number
+  lat: number
+  properties?: P
+}
+
+export interface ClusterProperties {
+  cluster: true
+  cluster_id: number
+  point_count: number
+  point_count_abbreviated: string
+  expansion_zoom: number
+}
+
+export type PointProperties<P> = P & { cluster: false; point_id: string }
+
+export type ClusterFeature<P = Record<string, any>> = Feature<Point, ClusterProperties | PointProperties<P>>
+
+export type ClusterFeatureCollection<P = Record<string, any>> = FeatureCollection<Point, ClusterProperties | PointProperties<P>>
+
+/** [west, south, east, north] */
+export type LngLatBBox = [number, number, number, number]
+
+export interface PointClusterOptions {
+  minZoom?: number // default 0
+  maxZoom?: number // Zoom cuối còn gom cụm, lớn hơn thì trả điểm lẻ. Default 16
+  cellSizePx?: number // Cạnh ô lưới (px, làm tròn về luỹ thừa 2). Default 64
+}
+
+interface Cell {
+  count: number
+  sx: number
+  sy: number
+}
+
+interface StoredPoint<P> {
+  id: string
+  lng: number
+  lat: number
+  x: number
+  y: number
+  properties: P
+}
+
+const ZOOM_BITS = 32 // cluster_id = key * 32 + zoom
+
+const lngX = (lng: number) => lng / 360 + 0.5
+
+const latY = (lat: number) => {
+  const sin = Math.sin((lat * Math.PI) / 180)
+  const y = 0.5 - (0.25 * Math.log((1 + sin) / (1 - sin))) / Math.PI
+  return y < 0 ? 0 : y > 1 ? 1 : y
+}
+
+const xLng = (x: number) => (x - 0.5) * 360
+
+const yLat = (y: number) => {
+  const y2 = ((180 - y * 360) * Math.PI) / 180
+  return (360 * Math.atan(Math.exp(y2))) / Math.PI - 90
+}
+
+const abbreviate = (count: number) =>
+  count >= 10000 ? `${Math.round(count / 1000)}k` : count >= 1000 ? `${Math.round(count / 100) / 10}k` : String(count)
+
+export class PointClusterIndex<P = Record<string, any>> {
+  private minZoom: number
+  private maxZoom: number
+  private cellsPerTileLog2: number
+  // levels[z] = key -> Cell, với z trong [minZoom, maxZoom]
+  private levels: Map<number, Cell>[] = []
+  // Lưới lá (maxZoom + 1): key -> danh sách id điểm
+  private leaves = new Map<number, string[]>()
+  private points = new Map<string, StoredPoint<P>>()
+  private version = 0
+
+  constructor(options: PointClusterOptions = {}) {
+    this.minZoom = options.minZoom ?? 0
+    this.maxZoom = options.maxZoom ?? 16
+    const cellsPerTile = 256 / (options.cellSizePx ?? 64)
+    this.cellsPerTileLog2 = Math.max(0, Math.round(Math.log2(cellsPerTile)))
+    for (let z = 0; z <= this.maxZoom; z++) this.levels.push(new Map())
+  }
+
+  get size(): number {
+    return this.points.size
+  }
+
+  /** Tăng mỗi khi dữ liệu đổi, dùng làm dependency cho memo/cache */
+  getVersion(): number {
+    return this.version
+  }
+
+  has(id: string): boolean {
+    return this.points.has(id)
+  }
+
+  /** Dựng lại toàn bộ chỉ mục cho một dataset mới */
+  load(points: ClusterPointInput<P>[]): this {
+    this.clear()
+    for (let i = 0; i < points.length; i++) this.insert(points[i])
+    this.version++
+    return this
+  }
+
+  clear(): void {
+    for (let z = 0; z < this.levels.length; z++) this.levels[z].clear()
+    this.leaves.clear()
+    this.points.clear()
+    this.version++
+  }
+
+  add(point: ClusterPointInput<P>): void {
+    if (this.points.has(point.id)) this.delete(point.id)
+    this.insert(point)
+    this.version++
+  }
+
+  remove(id: string): boolean {
+    if (!this.delete(id)) return false
+    this.version++
+    return true
+  }
+
+  /**
+   * Đồng bộ với danh sách mới theo id: chỉ thêm/xoá/di chuyển phần thay đổi.
+   * Trả về true nếu có thay đổi.
+   */
+  sync(points: ClusterPointInput<P>[]): boolean {
+    let changed = false
+    const seen = new Set<string>()
+    for (let i = 0; i < points.length; i++) {
+      const p = points[i]
+      if (!Number.isFinite(p.lng) || !Number.isFinite(p.lat)) continue
+      seen.add(p.id)
+      const existing = this.points.get(p.id)
+      if (existing && existing.lng === p.lng && existing.lat === p.lat) {
+        if (p.properties !== undefined && existing.properties !== p.properties) {
+          existing.properties = p.properties
+          changed = true
+        }
+        continue
+      }
+      if (existing) this.delete(p.id)
+      this.insert(p)
+      changed = true
+    }
+    if (seen.size !== this.points.size) {
+      for (const id of Array.from(this.points.keys())) {
+        if (!seen.has(id)) {
+          this.delete(id)
+          changed = true
+        }
+      }
+    }
+    if (changed) this.version++
+    return changed
+  }
+
+  /**
+   * Cụm + điểm lẻ trong khung nhìn ở mức zoom (số thực, làm tròn xuống)
+   */
+  getClusters(bbox: LngLatBBox, zoom: number): ClusterFeatureCollection<P> {
+    const features: ClusterFeature<P>[] = []
+    const z = Math.max(this.minZoom, Math.min(Math.floor(zoom), this.maxZoom + 1))
+    const dim = this.dim(z)
+    const west = bbox[0] <= bbox[2] ? bbox[0] : -180 // khung vắt qua kinh tuyến 180 => lấy cả dải
+    const east = bbox[0] <= bbox[2] ? bbox[2] : 180
+    const x0 = Math.max(0, Math.floor(lngX(west) * dim))
+    const x1 = Math.min(dim - 1, Math.floor(lngX(east) * dim))
+    const y0 = Math.max(0, Math.floor(latY(bbox[3]) * dim))
+    const y1 = Math.min(dim - 1, Math.floor(latY(bbox[1]) * dim))
+
+    if (z > this.maxZoom) {
+      this.forEachInRange(this.leaves, dim, x0, x1, y0, y1, (_key, ids) => {
+        for (let i = 0; i < ids.length; i++) features.push(this.pointFeature(this.points.get(ids[i])!))
+      })
+    } else {
+      this.forEachInRange(this.levels[z], dim, x0, x1, y0, y1, (key, cell) => {
+        if (cell.count === 1) {
+          const id = this.firstLeafId(z, key)
+          if (id) features.push(this.pointFeature(this.points.get(id)!))
+          return
+        }
+        features.push(this.clusterFeature(z, key, cell))
+      })
+    }
+    return { type: 'FeatureCollection', features }
+  }
+
+  /** Zoom nhỏ nhất mà cụm bắt đầu tách ra (dùng khi chạm vào cụm) */
+  getClusterExpansionZoom(clusterId: number): number {
+    let z = clusterId % ZOOM_BITS
+    let key = Math.floor(clusterId / ZOOM_BITS)
+    while (z < this.maxZoom) {
+      const children = this.childKeys(z, key, this.levels[z + 1])
+      if (children.length !== 1) return z + 1
+      key = children[0]
+      z++
+    }
+    return this.maxZoom + 1
+  }
+
+  /** Các điểm thuộc cụm (phân trang bằng limit/offset) */
+  getLeaves(clusterId: number, limit: number = 10, offset: number = 0): ClusterFeature<P>[] {
+    const out: ClusterFeature<P>[] = []
+    let skipped = 0
+    const visit = (z: number, key: number): boolean => {
+      if (z > this.maxZoom) {
+        const ids = this.leaves.get(key)
+        if (!ids) return false
+        for (let i = 0; i < ids.length; i++) {
+          if (skipped < offset) {
+            skipped++
+            continue
+          }
+          out.push(this.pointFeature(this.points.get(ids[i])!))
+          if (out.length >= limit) return true
+        }
+        return false
+      }
+      const next = z + 1 > this.maxZoom ? this.leaves : this.levels[z + 1]
+      const children = this.childKeys(z, key, next)
+      for (let i = 0; i < children.length; i++) {
+        if (visit(z + 1, children[i])) return true
+      }
+      return false
+    }
+    visit(clusterId % ZOOM_BITS, Math.floor(clusterId / ZOOM_BITS))
+    return out
+  }
+
+  // ============ PRIVATE METHODS ============
+
+  private dim(z: number): number {
+    return Math.pow(2, z + this.cellsPerTileLog2)
+  }
+
+  private keyAt(x: number, y: number, z: number): number {
+    const dim = this.dim(z)
+    const cx = Math.min(dim - 1, Math.floor(x * dim))
+    const cy = Math.min(dim - 1, Math.floor(y * dim))
+    return cy * dim + cx
+  }
+
+  private insert(input: ClusterPointInput<P>): void {
+    if (!Number.isFinite(input.lng) || !Number.isFinite(input.lat)) return
+    const x = lngX(input.lng)
+    const y = latY(input.lat)
+    this.points.set(input.id, {
+      id: input.id,
+      lng: input.lng,
+      lat: input.lat,
+      x,
+      y,
+      properties: (input.properties ?? {}) as P
+    })
+    for (let z = this.minZoom; z <= this.maxZoom; z++) {
+      const key = this.keyAt(x, y, z)
+      const level = this.levels[z]
+      const cell = level.get(key)
+      if (cell) {
+        cell.count++
+        cell.sx += x
+        cell.sy += y
+      } else {
+        level.set(key, { count: 1, sx: x, sy: y })
+      }
+    }
+    const leafKey = this.keyAt(x, y, this.maxZoom + 1)
+    const ids = this.leaves.get(leafKey)
+    if (ids) ids.push(input.id)
+    else this.leaves.set(leafKey, [input.id])
+  }
+
+  private delete(id: string): boolean {
+    const p = this.points.get(id)
+    if (!p) return false
+    this.points.delete(id)
+    for (let z = this.minZoom; z <= this.maxZoom; z++) {
+      const key = this.keyAt(p.x, p.y, z)
+      const level = this.levels[z]
+      const cell = level.get(key)
+      if (!cell) continue
+      if (cell.count <= 1) {
+        level.delete(key)
+      } else {
+        cell.count--
+        cell.sx -= p.x
+        cell.sy -= p.y
+      }
+    }
+    const leafKey = this.keyAt(p.x, p.y, this.maxZoom + 1)
+    const ids = this.leaves.get(leafKey)
+    if (ids) {
+      const idx = ids.indexOf(id)
+      if (idx !== -1) {
+        ids[idx] = ids[ids.length - 1]
+        ids.pop()
+      }
+      if (ids.length === 0) this.leaves.delete(leafKey)
+    }
+    return true
+  }
+
+  // Duyệt ô trong khung; nếu khung rộng hơn số ô đang có thì duyệt map và lọc (zoom thấp)
+  private forEachInRange<T>(
+    cells: Map<number, T>,
+    dim: number,
+    x0: number,
+    x1: number,
+    y0: number,
+    y1: number,
+    fn: (key: number, value: T) => void
+  ): void {
+    if (x1 < x0 || y1 < y0) return
+    const area = (x1 - x0 + 1) * (y1 - y0 + 1)
+    if (area > cells.size) {
+      cells.forEach((value, key) => {
+        const cx = key % dim
+        const cy = (key - cx) / dim
+        if (cx >= x0 && cx <= x1 && cy >= y0 && cy <= y1) fn(key, value)
+      })
+      return
+    }
+    for (let cy = y0; cy <= y1; cy++) {
+      for (let cx = x0; cx <= x1; cx++) {
+        const key = cy * dim + cx
+        const value = cells.get(key)
+        if (value !== undefined) fn(key, value)
+      }
+    }
+  }
+
+  private childKeys(z: number, key: number, next: Map<number, any>): number[] {
+    const dim = this.dim(z)
+    const cx = key % dim
+    const cy = (key - cx) / dim
+    const childDim = dim * 2
+    const out: number[] = []
+    for (let dy = 0; dy < 2; dy++) {
+      for (let dx = 0; dx < 2; dx++) {
+        const childKey = (cy * 2 + dy) * childDim + (cx * 2 + dx)
+        if (next.has(childKey)) out.push(childKey)
+      }
+    }
+    return out
+  }
+
+  // Ô chỉ có 1 điểm: đi xuống theo nhánh duy nhất tới lưới lá để lấy id
+  private firstLeafId(z: number, key: number): string | undefined {
+    while (z <= this.maxZoom) {
+      const next = z + 1 > this.maxZoom ? this.leaves : this.levels[z + 1]
+      const children = this.childKeys(z, key, next)
+      if (children.length === 0) return undefined
+      key = children[0]
+      z++
+    }
+    return this.leaves.get(key)?.[0]
+  }
+
+  private clusterFeature(z: number, key: number, cell: Cell): ClusterFeature<P> {
+    const clusterId = key * ZOOM_BITS + z
+    return {
+      type: 'Feature',
+      id: clusterId,
+      properties: {
+        cluster: true,
+        cluster_id: clusterId,
+        point_count: cell.count,
+        point_count_abbreviated: abbreviate(cell.count),
+        expansion_zoom: this.getClusterExpansionZoom(clusterId)
+      },
+      geometry: { type: 'Point', coordinates: [xLng(cell.sx / cell.count), yLat(cell.sy / cell.count)] }
+    }
+  }
+
+  private pointFeature(p: StoredPoint<P>): ClusterFeature<P> {
+    return {
+      type: 'Feature',
+      id: p.id,
+      properties: { ...p.properties, cluster: false, point_id: p.id } as PointProperties<P>,
+      geometry: { type: 'Point', coordinates: [p.lng, p.lat] }
+    }
+  }
+}
+
+export default PointClusterIndex
@@ -0,0 +1,115 @@
+// Prefix trie cho tra cứu địa chỉ/địa danh trên máy, không phân biệt dấu tiếng Việt.
+// Mỗi entry được đánh chỉ mục tại đầu mỗi từ, nên "hue" khớp cả "12 Nguyễn Huệ, Quận 1".
+
+/** Bỏ dấu, đ -> d, viết thường, gom khoảng trắng/dấu câu */
+export function foldVietnamese(text: string): string {
+  return (text || '')
+    .normalize('NFD')
+    .replace(/[\u0300-\u036f]/g, '')
+    .replace(/đ/g, 'd')
+    .replace(/Đ/g, 'D')
+    .toLowerCase()
+    .replace(/[^a-z0-9]+/g, ' ')
+    .trim()
+}
+
+interface TrieNode {
+  children: Map<string, TrieNode>
+  ids: Set<string> // Entry có 1 từ bắt đầu đúng tại node này (chỉ node cuối của khoá)
+}
+
+const createNode = (): TrieNode => ({ children: new Map(), ids: new Set() })
+
+export class PrefixTrie {
+  private root: TrieNode = createNode()
+  // id -> các khoá đã chèn, để xoá được
+  private keysById = new Map<string, string[]>()
+
+  get size(): number {
+    return this.keysById.size
+  }
+
+  has(id: string): boolean {
+    return this.keysById.has(id)
+  }
+
+  /** Chèn (hoặc chèn lại) entry với văn bản hiển thị của nó */
+  insert(id: string, text: string): void {
+    if (this.keysById.has(id)) this.remove(id)
+    const folded = foldVietnamese(text)
+    if (!folded) return
+    const words = folded.split(' ')
+    const keys: string[] = []
+    // Khoá = phần còn lại của chuỗi tính từ mỗi từ, để prefix nhiều từ vẫn khớp
+    for (let i = 0; i < words.length; i++) {
+      const key = words.slice(i).join(' ')
+      if (keys.indexOf(key) !== -1) continue
+      keys.push(key)
+      let node = this.root
+      for (let c = 0; c < key.length; c++) {
+        const ch = key[c]
+        let next = node.children.get(ch)
+        if (!next) {
+          next = createNode()
+          node.children.set(ch, next)
+        }
+        node = next
+      }
+      node.ids.add(id)
+    }
+    this.keysById.set(id, keys)
+  }
+
+  remove(id: string): boolean {
+    const keys = this.keysById.get(id)
+    if (!keys) return false
+    this.keysById.delete(id)
+    for (const key of keys) this.removeKey(this.root, key, 0, id)
+    return true
+  }
+
+  clear(): void {
+    this.root = createNode()
+    this.keysById.clear()
+  }
+
+  /**
+   * Các id có 1 từ bắt đầu bằng prefix (đã fold).
+   * Dừng sớm khi đủ limit id khác nhau.
+   */
+  search(prefix: string, limit: number = 50): string[] {
+    const folded = foldVietnamese(prefix)
+    if (!folded) return []
+    let node: TrieNode | undefined = this.root
+    for (let c = 0; c < folded.length && node; c++) node = node.children.get(folded[c])
+    if (!node) return []
+
+    const out = new Set<string>()
+    const stack: TrieNode[] = [node]
+    while (stack.length > 0 && out.size < limit) {
+      const current = stack.pop()!
+      current.ids.forEach((id) => {
+        if (out.size < limit) out.add(id)
+      })
+      current.children.forEach((child) => stack.push(child))
+    }
+    return Array.from(out)
+  }
+
+  // ============ PRIVATE METHODS ============
+
+  // Xoá id khỏi node cuối của key, tỉa các nhánh rỗng trên đường quay về
+  private removeKey(node: TrieNode, key: string, depth: number, id: string): boolean {
+    if (depth === key.length) {
+      node.ids.delete(id)
+    } else {
+      const child = node.children.get(key[depth])
+      if (child && this.removeKey(child, key, depth + 1, id)) {
+        node.children.delete(key[depth])
+      }
+    }
+    return node.ids.size === 0 && node.children.size === 0
+  }
+}
+
+export default PrefixTrie
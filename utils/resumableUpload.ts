@@ -0,0 +1,538 @@
+/**
+ * Resumable Upload - upload file theo chunk, song song, tiếp tục được sau khi app khởi động lại
+ *
+ * Giao thức (backend hoặc scripts/uploads/localUploadServer.js):
+ *   POST /api/uploads                      { fileName, mimeType, size, chunkSize, chunkCount, purpose }
+ *                                          -> { uploadId, receivedChunks: number[] }
+ *   GET  /api/uploads/{id}                 -> { uploadId, receivedChunks, completed, fileId?, url? }
+ *   PUT  /api/uploads/{id}/chunks/{index}  body nhị phân, header X-Chunk-Sha256
+ *                                          -> 200 | 409 (hash sai) | 404 (phiên hết hạn)
+ *   POST /api/uploads/{id}/complete        { fileHash } -> { fileId, url }
+ *
+ * - Mỗi chunk kèm SHA-256, server kiểm tra trước khi nhận; fileHash = SHA-256 của chuỗi
+ *   nối các hash chunk (hash list), server đối chiếu khi complete.
+ * - Mỗi file tải tối đa `parallelChunks` chunk cùng lúc, chunk lỗi tự thử lại với
+ *   back-off + jitter; lỗi 4xx (trừ 404/408/409/429) thì dừng file.
+ * - Trạng thái (uploadId, chunk đã xong, hash) lưu qua storage adapter sau mỗi chunk:
+ *   resumePending() hỏi server chunk nào đã nhận rồi tải phần còn lại.
+ * - Upload của thao tác bền vững (outbox entry) đi qua uploadInSlot(): id bản ghi và fileId
+ *   ghi vào slot của entry, lần gửi lại sau khi khởi động lại dùng tiếp thay vì tải lại.
+ *   Upload không có owner (form chỉ sống trong bộ nhớ) thì app bỏ lúc khởi động.
+ * - Cùng file (uri + size + purpose) đưa vào lần nữa thì dùng lại bản ghi cũ.
+ *
+ * Không import module native: RN wiring ở services/resumableUploadService.ts,
+ * script Node dùng adapter của riêng nó.
+ */
+
+export type UploadStatus = 'pending' | 'uploading' | 'completed' | 'failed' | 'cancelled'
+
+export interface UploadFileInput {
+  uri: string
+  fileName: string
+  mimeType: string
+  /** Bỏ trống thì hỏi adapter */
+  size?: number
+}
+
+export interface UploadOptions {
+  purpose?: string
+  chunkSize?: number
+  /** Thao tác bền vững giữ kết quả (vd. id outbox entry); không có thì không tiếp tục qua lần khởi động lại */
+  owner?: string
+}
+
+/** Trạng thái upload lưu cùng thao tác bền vững */
+export interface UploadSlotState {
+  id: string
+  fileId?: string
+  url?: string
+}
+
+/** Chỗ lưu trạng thái upload trong thao tác sở hữu nó (outbox entry) */
+export interface UploadSlot {
+  owner: string
+  get(): UploadSlotState | undefined
+  set(state: UploadSlotState): void
+}
+
+/** Slot theo tên field của form (không có = upload chỉ sống trong phiên) */
+export type UploadSlots = (field: string) => UploadSlot | undefined
+
+export interface UploadResult {
+  fileId: string
+  url?: string
+}
+
+export interface UploadProgress {
+  id: string
+  fileName: string
+  status: UploadStatus
+  bytesUploaded: number
+  totalBytes: number
+  chunksDone: number
+  chunkCount: number
+  error?: string
+}
+
+export interface UploadSessionInfo {
+  uploadId: string
+  receivedChunks: number[]
+  completed?: boolean
+  fileId?: string
+  url?: string
+}
+
+export interface UploadTransport {
+  createSession(body: {
+    fileName: string
+    mimeType: string
+    size: number
+    chunkSize: number
+    chunkCount: number
+    purpose?: string
+  }): Promise<UploadSessionInfo>
+  getSession(uploadId: string): Promise<UploadSessionInfo>
+  putChunk(uploadId: string, index: number, bytes: Uint8Array, sha256: string): Promise<void>
+  complete(uploadId: string, body: { fileHash: string }): Promise<UploadResult>
+}
+
+export interface UploadAdapters {
+  storage: {
+    getItem(key: string): Promise<string | null>
+    setItem(key: string, value: string): Promise<void>
+  }
+  /** Kích thước file; -1 nếu file không còn */
+  fileSize(uri: string): Promise<number>
+  readChunk(uri: string, offset: number, length: number): Promise<Uint8Array>
+  sha256Hex(data: Uint8Array | string): Promise<string>
+  transport: UploadTransport
+}
+
+export interface ResumableUploaderOptions {
+  chunkSize?: number
+  parallelChunks?: number
+  maxChunkAttempts?: number
+  retryBaseMs?: number
+  storageKey?: string
+  /** Bản ghi đã xong/lỗi giữ lại bao lâu để tái sử dụng */
+  retainMs?: number
+}
+
+interface UploadRecord {
+  id: string
+  uploadId: string | null
+  uri: string
+  fileName: string
+  mimeType: string
+  size: number
+  chunkSize: number
+  chunkCount: number
+  purpose?: string
+  owner?: string
+  chunkHashes: (string | null)[]
+  done: boolean[]
+  status: UploadStatus
+  result?: UploadResult
+  error?: string
+  createdAt: number
+  updatedAt: number
+}
+
+/** Lỗi transport có HTTP status (để phân biệt lỗi thử lại được) */
+export class UploadHttpError extends Error {
+  constructor(message: string, public status: number) {
+    super(message)
+  }
+}
+
+const DEFAULT_CHUNK_SIZE = 512 * 1024
+const RETRYABLE_STATUS = new Set([404, 408, 409, 429])
+
+const sleep = (ms: number) => new Promise((resolve) => setTimeout(resolve, ms))
+
+export class ResumableUploader {
+  private options: Required<ResumableUploaderOptions>
+  private records = new Map<string, UploadRecord>()
+  private running = new Map<string, Promise<UploadResult>>()
+  private listeners = new Set<(progress: UploadProgress) => void>()
+  private loaded: Promise<void> | null = null
+  private persistChain: Promise<void> = Promise.resolve()
+  private persistScheduled = false
+  // Tạo lại phiên khi server trả 404: các worker song song dùng chung 1 lần tạo
+  private resyncing = new Map<string, Promise<void>>()
+  private stats = {
+    filesStarted: 0,
+    filesCompleted: 0,
+    filesFailed: 0,
+    filesResumed: 0,
+    chunksUploaded: 0,
+    chunksSkipped: 0,
+    chunkRetries: 0,
+    bytesUploaded: 0,
+  }
+
+  constructor(private adapters: UploadAdapters, options: ResumableUploaderOptions = {}) {
+    this.options = {
+      chunkSize: DEFAULT_CHUNK_SIZE,
+      parallelChunks: 3,
+      maxChunkAttempts: 5,
+      retryBaseMs: 500,
+      storageKey: 'resumable_uploads_v1',
+      retainMs: 24 * 60 * 60 * 1000,
+      ...options,
+    }
+  }
+
+  /** Đưa file vào hàng đợi và bắt đầu tải; trả id cục bộ để theo dõi tiến độ */
+  async enqueue(file: UploadFileInput, options: UploadOptions = {}): Promise<string> {
+    await this.load()
+    const size = file.size ?? (await this.adapters.fileSize(file.uri))
+    if (size < 0) throw new Error(`Không đọc được file ${file.fileName}`)
+
+    const existing = this.findReusable(file.uri, size, options.purpose)
+    if (existing) {
+      if (existing.status !== 'completed') this.start(existing)
+      return existing.id
+    }
+
+    const chunkSize = options.chunkSize ?? this.options.chunkSize
+    const chunkCount = Math.max(1, Math.ceil(size / chunkSize))
+    const now = Date.now()
+    const record: UploadRecord = {
+      id: `up_${now.toString(36)}_${Math.random().toString(36).slice(2, 8)}`,
+      uploadId: null,
+      uri: file.uri,
+      fileName: file.fileName,
+      mimeType: file.mimeType,
+      size,
+      chunkSize,
+      chunkCount,
+      purpose: options.purpose,
+      owner: options.owner,
+      chunkHashes: new Array(chunkCount).fill(null),
+      done: new Array(chunkCount).fill(false),
+      status: 'pending',
+      createdAt: now,
+      updatedAt: now,
+    }
+    this.records.set(record.id, record)
+    this.persist()
+    this.start(record)
+    return record.id
+  }
+
+  /** enqueue + chờ xong */
+  async upload(file: UploadFileInput, options: UploadOptions = {}): Promise<UploadResult> {
+    const id = await this.enqueue(file, options)
+    return this.waitFor(id)
+  }
+
+  waitFor(id: string): Promise<UploadResult> {
+    const record = this.records.get(id)
+    if (!record) return Promise.reject(new Error(`Upload ${id} không tồn tại`))
+    if (record.status === 'completed' && record.result) return Promise.resolve(record.result)
+    return this.running.get(id) ?? Promise.reject(new Error(record.error || `Upload ${id} ${record.status}`))
+  }
+
+  /**
+   * Upload gắn với thao tác bền vững: slot đã có fileId thì dùng luôn, có id bản ghi thì chờ
+   * bản ghi đó (tiếp tục nếu dở dang), không thì prepare() rồi tải mới. Trả null nếu không có file.
+   */
+  async uploadInSlot(
+    slot: UploadSlot,
+    prepare: () => Promise<UploadFileInput | null>,
+    options: UploadOptions = {}
+  ): Promise<UploadResult | null> {
+    const saved = slot.get()
+    if (saved?.fileId) return { fileId: saved.fileId, url: saved.url }
+    await this.load()
+    if (saved?.id && this.records.has(saved.id)) {
+      try {
+        return this.fillSlot(slot, saved.id, await this.resume(saved.id))
+      } catch (e) {
+        // File tạm đã bị dọn / upload bị huỷ: tải lại từ nguồn
+        console.warn('[ResumableUpload] không tiếp tục được upload đã lưu, tải lại', e)
+      }
+    }
+    const file = await prepare()
+    if (!file) return null
+    const id = await this.enqueue(file, { ...options, owner: slot.owner })
+    slot.set({ id })
+    return this.fillSlot(slot, id, await this.waitFor(id))
+  }
+
+  /** Chờ 1 upload; bản ghi dở dang/lỗi chưa chạy thì chạy lại */
+  async resume(id: string): Promise<UploadResult> {
+    await this.load()
+    const record = this.records.get(id)
+    if (record && record.status !== 'completed' && record.status !== 'cancelled') this.start(record)
+    return this.waitFor(id)
+  }
+
+  /** Tiếp tục các upload dở dang từ storage (sau khi app/script khởi động lại) */
+  async resumePending(): Promise<number> {
+    await this.load()
+    let resumed = 0
+    this.records.forEach((record) => {
+      if (record.status === 'pending' || record.status === 'uploading') {
+        this.stats.filesResumed++
+        this.start(record)
+        resumed++
+      }
+    })
+    return resumed
+  }
+
+  /**
+   * Bỏ các upload dở dang của lần chạy trước mà không ai dùng kết quả (form chờ fileId đã mất
+   * cùng tiến trình, phiên trên server tự hết hạn). `filter` chọn theo owner. Trả số bản ghi bị bỏ.
+   */
+  async discardPending(filter: (owner?: string) => boolean = () => true): Promise<number> {
+    await this.load()
+    let discarded = 0
+    this.records.forEach((record) => {
+      if (this.running.has(record.id) || !filter(record.owner)) return
+      if (record.status === 'pending' || record.status === 'uploading' || record.status === 'failed') {
+        this.records.delete(record.id)
+        discarded++
+      }
+    })
+    if (discarded > 0) this.persist()
+    return discarded
+  }
+
+  cancel(id: string) {
+    const record = this.records.get(id)
+    if (!record || record.status === 'completed') return
+    record.status = 'cancelled'
+    this.touch(record)
+  }
+
+  getProgress(id: string): UploadProgress | null {
+    const record = this.records.get(id)
+    return record ? this.progressOf(record) : null
+  }
+
+  subscribe(listener: (progress: UploadProgress) => void): () => void {
+    this.listeners.add(listener)
+    return () => {
+      this.listeners.delete(listener)
+    }
+  }
+
+  getStats() {
+    return { ...this.stats, active: this.running.size, records: this.records.size }
+  }
+
+  // ============ PRIVATE METHODS ============
+
+  private fillSlot(slot: UploadSlot, id: string, result: UploadResult): UploadResult {
+    slot.set({ id, fileId: result.fileId, url: result.url })
+    return result
+  }
+
+  private start(record: UploadRecord) {
+    if (this.running.has(record.id)) return
+    this.stats.filesStarted++
+    const task = this.run(record).finally(() => this.running.delete(record.id))
+    // Người gọi enqueue không chờ kết quả: tránh unhandled rejection
+    task.catch(() => {})
+    this.running.set(record.id, task)
+  }
+
+  private async run(record: UploadRecord): Promise<UploadResult> {
+    record.status = 'uploading'
+    record.error = undefined
+    this.touch(record)
+    try {
+      if ((await this.adapters.fileSize(record.uri)) !== record.size) {
+        throw new Error('File nguồn đã thay đổi hoặc không còn')
+      }
+      await this.syncSession(record)
+      // Phiên bị tạo lại giữa chừng thì các chunk đã qua bị đánh dấu chưa xong: chạy thêm lượt
+      for (let pass = 0; pass < 3 && record.status === 'uploading' && record.done.includes(false); pass++) {
+        await this.uploadChunks(record)
+      }
+      if (record.status === 'cancelled') throw new Error('Upload đã huỷ')
+      if (record.done.includes(false)) throw new Error('Không tải được hết các phần của file')
+
+      const hashes = record.chunkHashes as string[]
+      const fileHash = await this.adapters.sha256Hex(hashes.join(''))
+      record.result = await this.adapters.transport.complete(record.uploadId!, { fileHash })
+      record.status = 'completed'
+      this.stats.filesCompleted++
+      this.touch(record)
+      return record.result
+    } catch (e: any) {
+      if (record.status !== 'cancelled') {
+        record.status = 'failed'
+        record.error = e?.message || 'Upload thất bại'
+        this.stats.filesFailed++
+      }
+      this.touch(record)
+      throw e
+    }
+  }
+
+  /** Tạo phiên mới, hoặc hỏi lại server chunk nào đã nhận (phiên cũ sau restart) */
+  private async syncSession(record: UploadRecord) {
+    if (record.uploadId) {
+      try {
+        const info = await this.adapters.transport.getSession(record.uploadId)
+        this.applyReceived(record, info.receivedChunks)
+        return
+      } catch (e: any) {
+        if (!(e instanceof UploadHttpError && e.status === 404)) throw e
+        // Phiên đã hết hạn trên server: tải lại từ đầu
+      }
+    }
+    const info = await this.adapters.transport.createSession({
+      fileName: record.fileName,
+      mimeType: record.mimeType,
+      size: record.size,
+      chunkSize: record.chunkSize,
+      chunkCount: record.chunkCount,
+      purpose: record.purpose,
+    })
+    record.uploadId = info.uploadId
+    record.done = new Array(record.chunkCount).fill(false)
+    this.applyReceived(record, info.receivedChunks)
+    this.touch(record)
+  }
+
+  private resync(record: UploadRecord): Promise<void> {
+    let pending = this.resyncing.get(record.id)
+    if (!pending) {
+      record.uploadId = null
+      pending = this.syncSession(record).finally(() => this.resyncing.delete(record.id))
+      this.resyncing.set(record.id, pending)
+    }
+    return pending
+  }
+
+  private applyReceived(record: UploadRecord, received: number[]) {
+    const set = new Set(received)
+    for (let i = 0; i < record.chunkCount; i++) {
+      // Chỉ tin chunk đã có hash cục bộ; thiếu hash thì tải lại để tính fileHash
+      const ok = set.has(i) && record.chunkHashes[i] !== null
+      if (ok) this.stats.chunksSkipped++
+      record.done[i] = ok
+    }
+  }
+
+  private async uploadChunks(record: UploadRecord) {
+    let next = 0
+    const worker = async () => {
+      while (record.status === 'uploading') {
+        while (next < record.chunkCount && record.done[next]) next++
+        if (next >= record.chunkCount) return
+        const index = next++
+        await this.uploadChunk(record, index)
+      }
+    }
+    const workers = Array.from({ length: Math.min(this.options.parallelChunks, record.chunkCount) }, worker)
+    await Promise.all(workers)
+  }
+
+  private async uploadChunk(record: UploadRecord, index: number) {
+    const offset = index * record.chunkSize
+    const length = Math.min(record.chunkSize, record.size - offset)
+    const bytes = await this.adapters.readChunk(record.uri, offset, length)
+    const hash = await this.adapters.sha256Hex(bytes)
+    record.chunkHashes[index] = hash
+
+    for (let attempt = 1; ; attempt++) {
+      if (record.status !== 'uploading') return
+      try {
+        await this.adapters.transport.putChunk(record.uploadId!, index, bytes, hash)
+        record.done[index] = true
+        this.stats.chunksUploaded++
+        this.stats.bytesUploaded += length
+        this.touch(record)
+        return
+      } catch (e: any) {
+        const status = e instanceof UploadHttpError ? e.status : 0
+        const retryable = status === 0 || status >= 500 || RETRYABLE_STATUS.has(status)
+        if (!retryable || attempt >= this.options.maxChunkAttempts) throw e
+        if (status === 404) await this.resync(record)
+        this.stats.chunkRetries++
+        const backoff = this.options.retryBaseMs * 2 ** (attempt - 1)
+        await sleep(backoff / 2 + Math.random() * backoff)
+      }
+    }
+  }
+
+  private findReusable(uri: string, size: number, purpose?: string): UploadRecord | null {
+    let found: UploadRecord | null = null
+    this.records.forEach((record) => {
+      if (
+        record.uri === uri &&
+        record.size === size &&
+        record.purpose === purpose &&
+        record.status !== 'cancelled'
+      ) {
+        found = record
+      }
+    })
+    return found
+  }
+
+  private progressOf(record: UploadRecord): UploadProgress {
+    let chunksDone = 0
+    let bytesUploaded = 0
+    for (let i = 0; i < record.chunkCount; i++) {
+      if (!record.done[i]) continue
+      chunksDone++
+      bytesUploaded += Math.min(record.chunkSize, record.size - i * record.chunkSize)
+    }
+    return {
+      id: record.id,
+      fileName: record.fileName,
+      status: record.status,
+      bytesUploaded,
+      totalBytes: record.size,
+      chunksDone,
+      chunkCount: record.chunkCount,
+      error: record.error,
+    }
+  }
+
+  private touch(record: UploadRecord) {
+    record.updatedAt = Date.now()
+    const progress = this.progressOf(record)
+    this.listeners.forEach((listener) => listener(progress))
+    this.persist()
+  }
+
+  private load(): Promise<void> {
+    if (!this.loaded) {
+      this.loaded = this.adapters.storage
+        .getItem(this.options.storageKey)
+        .then((raw) => {
+          if (!raw) return
+          const cutoff = Date.now() - this.options.retainMs
+          const saved: UploadRecord[] = JSON.parse(raw)
+          saved.forEach((record) => {
+            const finished = record.status !== 'pending' && record.status !== 'uploading'
+            if (finished && record.updatedAt < cutoff) return
+            if (!this.records.has(record.id)) this.records.set(record.id, record)
+          })
+        })
+        .catch((e) => console.warn('[ResumableUpload] không đọc được trạng thái đã lưu', e))
+    }
+    return this.loaded
+  }
+
+  // Ghi nối tiếp và gộp: nhiều chunk xong liên tiếp chỉ ghi 1 lần với trạng thái mới nhất
+  private persist() {
+    if (this.persistScheduled) return
+    this.persistScheduled = true
+    this.persistChain = this.persistChain
+      .then(() => {
+        this.persistScheduled = false
+        const snapshot = JSON.stringify(Array.from(this.records.values()))
+        return this.adapters.storage.setItem(this.options.storageKey, snapshot)
+      })
+      .catch((e) => console.warn('[ResumableUpload] không lưu được trạng thái', e))
+  }
+}
@@ -0,0 +1,54 @@
+/**
+ * Ring Buffer - bộ đệm vòng dung lượng cố định
+ *
+ * - Mảng cấp phát 1 lần theo capacity; đầy thì ghi đè phần tử cũ nhất, không cấp phát thêm.
+ * - Mỗi phần tử có số thứ tự tăng dần (seq) => bên đọc nhớ seq đã xử lý và lấy phần mới
+ *   bằng since(seq); phần đã bị ghi đè trước khi đọc được đếm vào `dropped`.
+ */
+
+export class RingBuffer<T> {
+  private items: (T | undefined)[]
+  /** Tổng số phần tử đã push (seq của phần tử kế tiếp) */
+  private total = 0
+
+  constructor(readonly capacity: number) {
+    this.items = new Array(Math.max(1, capacity))
+  }
+
+  push(item: T) {
+    this.items[this.total % this.items.length] = item
+    this.total++
+  }
+
+  get size(): number {
+    return Math.min(this.total, this.items.length)
+  }
+
+  /** seq của phần tử kế tiếp sẽ được push */
+  get nextSeq(): number {
+    return this.total
+  }
+
+  /** Các phần tử có seq >= fromSeq còn trong bộ đệm, cũ trước mới sau */
+  since(fromSeq: number): { items: T[]; dropped: number; nextSeq: number } {
+    const oldest = this.total - this.size
+    const start = Math.max(fromSeq, oldest)
+    const items: T[] = []
+    for (let seq = start; seq < this.total; seq++) {
+      items.push(this.items[seq % this.items.length] as T)
+    }
+    return { items, dropped: Math.max(0, start - fromSeq), nextSeq: this.total }
+  }
+
+  /** Toàn bộ phần tử còn giữ, cũ trước mới sau */
+  toArray(): T[] {
+    return this.since(0).items
+  }
+
+  clear() {
+    this.items = new Array(this.items.length)
+    this.total = 0
+  }
+}
+
+export default RingBuffer
@@ -0,0 +1,54 @@
+import { Role } from '@/models/types'
+import { track } from '@/utils/analytics'
+
+/**
+ * Role Bundles - nạp trước code màn home của role ngay khi biết role
+ *
+ * Web: expo-router asyncRoutes (app.json) tách mỗi route thành chunk riêng, nên
+ * provider không tải/parse code điều hướng của tài xế. Khi đọc được role (user đã lưu
+ * lúc hydrate, hoặc vừa đăng nhập) thì import() trước màn home của role đó để chunk
+ * về song song với khôi phục phiên thay vì đợi Redirect mới bắt đầu tải.
+ * Native: metro inlineRequires đã trì hoãn evaluate module tới lần dùng đầu; import()
+ * ở đây đo thời gian evaluate của màn home.
+ *
+ * Mỗi role nạp 1 lần, báo "role_bundle_loaded" { role, loadMs, modules }.
+ */
+
+type ModuleLoader = () => Promise<unknown>
+
+const ROLE_BUNDLES: Record<string, ModuleLoader[]> = {
+  [Role.DRIVER]: [() => import('@/screens/driver-v2/DriverHomeScreen')],
+  [Role.OWNER]: [() => import('@/screens/owner-v2/OwnerHomeScreen')],
+  [Role.PROVIDER]: [() => import('@/screens/provider-v2/ProviderHomeScreen')],
+}
+
+const now = (): number =>
+  typeof performance !== 'undefined' && typeof performance.now === 'function' ? performance.now() : Date.now()
+
+const loading = new Map<string, Promise<void>>()
+const loadTimes: Record<string, number> = {}
+
+/** Nạp trước chunk màn home của role; role không có bundle riêng thì bỏ qua */
+export const prefetchRoleBundle = (role: string | null | undefined): Promise<void> => {
+  const loaders = role ? ROLE_BUNDLES[role] : undefined
+  if (!role || !loaders) return Promise.resolve()
+  const existing = loading.get(role)
+  if (existing) return existing
+
+  const startedAt = now()
+  const pending = Promise.all(loaders.map((load) => load()))
+    .then(() => {
+      loadTimes[role] = Math.round(now() - startedAt)
+      track('role_bundle_loaded', { role, loadMs: loadTimes[role], modules: loaders.length })
+    })
+    .catch((e) => {
+      // Lỗi mạng khi tải chunk: để router tự tải lại lúc điều hướng
+      loading.delete(role)
+      console.warn('[RoleBundles] prefetch failed', role, e)
+    })
+  loading.set(role, pending)
+  return pending
+}
+
+/** Thời gian nạp của từng role đã prefetch (ms) */
+export const getRoleBundleStats = () => ({ ...loadTimes })
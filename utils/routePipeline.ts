@@ -0,0 +1,420 @@
+import type { Feature, LineString, Position } from 'geojson'
+import type { Bounds } from '@/utils/map'
+// Route pipeline chạy trong Web Worker cho map web.
+// Decode polyline, lọc toạ độ, tính quãng đường tích luỹ, bounds và snap vị trí
+// đều nằm trong worker; UI thread chỉ nhận kết quả để setData/fitBounds/setPaintProperty.
+//
+// - Đầu vào toạ độ được làm phẳng thành Float64Array và transfer (không clone mảng lồng nhau)
+// - Mảng quãng đường tích luỹ chỉ sống trong worker, snap chỉ trả về vài số
+// - Không có Worker (native, SSR, test) => chạy cùng một mã trên main thread qua scope giả
+
+export interface RouteInput {
+  coordinates?: Position[] | null
+  encoded?: string | null
+  precision?: number
+}
+
+export interface RouteGeometry {
+  routeId: string
+  line: Feature<LineString>
+  bounds: Bounds | null
+  totalM: number
+  pointCount: number
+}
+
+export interface RouteSnap {
+  routeId: string
+  segmentIndex: number // Đỉnh đầu của đoạn chứa điểm snap
+  snapped: [number, number] // [lng, lat] trên tuyến
+  offRouteM: number // Khoảng cách từ vị trí thật tới tuyến
+  traveledM: number
+  remainingM: number
+  fraction: number // 0..1 theo quãng đường
+  bearing: number // Hướng của đoạn tuyến tại điểm snap (độ)
+}
+
+type PipelineRequest =
+  | { type: 'load'; id: number; routeId: string; flat?: Float64Array; encoded?: string; precision?: number }
+  | { type: 'snap'; id: number; routeId: string; lng: number; lat: number }
+  | { type: 'release'; id: number; routeId: string }
+
+type PipelineResponse =
+  | { type: 'loaded'; id: number; route: RouteGeometry }
+  | { type: 'snapped'; id: number; snap: RouteSnap | null }
+  | { type: 'released'; id: number }
+  | { type: 'error'; id: number; message: string }
+
+/**
+ * Thân worker. Hàm này được serialize bằng toString() vào Blob URL nên phải tự chứa:
+ * không tham chiếu import/biến ngoài, không dùng spread/for-of/optional chaining
+ * (tránh Babel chèn helper ở scope module).
+ */
+function routePipelineWorkerMain(scope: any) {
+  var R = 6371000
+  var RAD = Math.PI / 180
+  var SNAP_WINDOW_BACK = 3
+  var SNAP_WINDOW_AHEAD = 40
+  var SNAP_RESCAN_M = 60
+  var routes: Record<string, any> = {}
+
+  function decode(encoded: string, precision: number): Float64Array {
+    var factor = Math.pow(10, precision)
+    var out = new Float64Array(encoded.length * 2)
+    var n = 0
+    var index = 0
+    var lat = 0
+    var lng = 0
+    while (index < encoded.length) {
+      var shift = 0
+      var result = 0
+      var b
+      do {
+        b = encoded.charCodeAt(index++) - 63
+        result |= (b & 0x1f) << shift
+        shift += 5
+      } while (b >= 0x20 && index < encoded.length)
+      lat += result & 1 ? ~(result >> 1) : result >> 1
+      shift = 0
+      result = 0
+      do {
+        b = encoded.charCodeAt(index++) - 63
+        result |= (b & 0x1f) << shift
+        shift += 5
+      } while (b >= 0x20 && index < encoded.length)
+      lng += result & 1 ? ~(result >> 1) : result >> 1
+      // Chuẩn hoá về [lng, lat]
+      out[n++] = lng / factor
+      out[n++] = lat / factor
+    }
+    return out.subarray(0, n)
+  }
+
+  function haversine(lng1: number, lat1: number, lng2: number, lat2: number): number {
+    var dLat = (lat2 - lat1) * RAD
+    var dLng = (lng2 - lng1) * RAD
+    var a = Math.sin(dLat / 2) * Math.sin(dLat / 2) +
+      Math.cos(lat1 * RAD) * Math.cos(lat2 * RAD) * Math.sin(dLng / 2) * Math.sin(dLng / 2)
+    return 2 * R * Math.atan2(Math.sqrt(a), Math.sqrt(1 - a))
+  }
+
+  function bearing(lng1: number, lat1: number, lng2: number, lat2: number): number {
+    var p1 = lat1 * RAD
+    var p2 = lat2 * RAD
+    var dl = (lng2 - lng1) * RAD
+    var y = Math.sin(dl) * Math.cos(p2)
+    var x = Math.cos(p1) * Math.sin(p2) - Math.sin(p1) * Math.cos(p2) * Math.cos(dl)
+    return (Math.atan2(y, x) / RAD + 360) % 360
+  }
+
+  // Lọc điểm không hợp lệ / trùng liên tiếp, dựng quãng đường tích luỹ và bounds
+  function ingest(routeId: string, flat: Float64Array) {
+    var coords = new Float64Array(flat.length)
+    var n = 0
+    for (var i = 0; i + 1 < flat.length; i += 2) {
+      var x = flat[i]
+      var y = flat[i + 1]
+      if (!isFinite(x) || !isFinite(y)) continue
+      if (n >= 2 && coords[n - 2] === x && coords[n - 1] === y) continue
+      coords[n++] = x
+      coords[n++] = y
+    }
+    coords = coords.slice(0, n)
+    var count = n / 2
+    var cumulative = new Float64Array(count)
+    var lineCoords = new Array(count)
+    var minLng = Infinity
+    var minLat = Infinity
+    var maxLng = -Infinity
+    var maxLat = -Infinity
+    for (var k = 0; k < count; k++) {
+      var lng = coords[k * 2]
+      var lat = coords[k * 2 + 1]
+      if (k > 0) cumulative[k] = cumulative[k - 1] + haversine(coords[k * 2 - 2], coords[k * 2 - 1], lng, lat)
+      if (lng < minLng) minLng = lng
+      if (lng > maxLng) maxLng = lng
+      if (lat < minLat) minLat = lat
+      if (lat > maxLat) maxLat = lat
+      lineCoords[k] = [lng, lat]
+    }
+    var totalM = count > 0 ? cumulative[count - 1] : 0
+    routes[routeId] = { coords: coords, cumulative: cumulative, count: count, totalM: totalM, hint: 0 }
+    return {
+      routeId: routeId,
+      line: { type: 'Feature', properties: {}, geometry: { type: 'LineString', coordinates: lineCoords } },
+      bounds: count > 0 ? { sw: [minLng, minLat], ne: [maxLng, maxLat] } : null,
+      totalM: totalM,
+      pointCount: count
+    }
+  }
+
+  // Chiếu điểm lên các đoạn [from, to) bằng phép chiếu phẳng cục bộ (đủ chính xác ở cỡ vài km)
+  function scan(route: any, lng: number, lat: number, from: number, to: number) {
+    var c = route.coords
+    var kx = Math.cos(lat * RAD) * R * RAD
+    var ky = R * RAD
+    var best = { index: -1, t: 0, d2: Infinity }
+    for (var i = from; i < to; i++) {
+      var ax = (c[i * 2] - lng) * kx
+      var ay = (c[i * 2 + 1] - lat) * ky
+      var bx = (c[i * 2 + 2] - lng) * kx
+      var by = (c[i * 2 + 3] - lat) * ky
+      var dx = bx - ax
+      var dy = by - ay
+      var len2 = dx * dx + dy * dy
+      var t = len2 > 0 ? -(ax * dx + ay * dy) / len2 : 0
+      if (t < 0) t = 0
+      else if (t > 1) t = 1
+      var px = ax + t * dx
+      var py = ay + t * dy
+      var d2 = px * px + py * py
+      if (d2 < best.d2) {
+        best.index = i
+        best.t = t
+        best.d2 = d2
+      }
+    }
+    return best
+  }
+
+  function snap(routeId: string, lng: number, lat: number) {
+    var route = routes[routeId]
+    if (!route || route.count < 2) return null
+    var segments = route.count - 1
+    // Tìm quanh đoạn lần trước trước, chỉ quét toàn tuyến khi lệch xa (rẽ nhầm, nhảy GPS)
+    var best = scan(route, lng, lat, Math.max(0, route.hint - SNAP_WINDOW_BACK), Math.min(segments, route.hint + SNAP_WINDOW_AHEAD))
+    if (best.index === -1 || Math.sqrt(best.d2) > SNAP_RESCAN_M) {
+      var full = scan(route, lng, lat, 0, segments)
+      if (full.d2 < best.d2) best = full
+    }
+    var i = best.index
+    route.hint = i
+    var c = route.coords
+    var segLen = route.cumulative[i + 1] - route.cumulative[i]
+    var traveled = route.cumulative[i] + best.t * segLen
+    return {
+      routeId: routeId,
+      segmentIndex: i,
+      snapped: [c[i * 2] + (c[i * 2 + 2] - c[i * 2]) * best.t, c[i * 2 + 1] + (c[i * 2 + 3] - c[i * 2 + 1]) * best.t],
+      offRouteM: Math.sqrt(best.d2),
+      traveledM: traveled,
+      remainingM: Math.max(0, route.totalM - traveled),
+      fraction: route.totalM > 0 ? Math.min(1, traveled / route.totalM) : 0,
+      bearing: bearing(c[i * 2], c[i * 2 + 1], c[i * 2 + 2], c[i * 2 + 3])
+    }
+  }
+
+  scope.onmessage = function (event: any) {
+    var msg = event.data
+    try {
+      if (msg.type === 'load') {
+        var flat = msg.flat || decode(msg.encoded || '', msg.precision || 5)
+        scope.postMessage({ type: 'loaded', id: msg.id, route: ingest(msg.routeId, flat) })
+      } else if (msg.type === 'snap') {
+        scope.postMessage({ type: 'snapped', id: msg.id, snap: snap(msg.routeId, msg.lng, msg.lat) })
+      } else if (msg.type === 'release') {
+        delete routes[msg.routeId]
+        scope.postMessage({ type: 'released', id: msg.id })
+      }
+    } catch (e: any) {
+      scope.postMessage({ type: 'error', id: msg.id, message: String((e && e.message) || e) })
+    }
+  }
+}
+
+interface Pending {
+  resolve: (value: any) => void
+  reject: (error: Error) => void
+}
+
+class RoutePipeline {
+  private worker: Worker | null = null
+  private fallbackScope: any = null
+  private nextId = 1
+  private nextRouteId = 1
+  private pending = new Map<number, Pending>()
+  // Snap đang bay theo route; fix GPS mới đến khi đang bận thì chỉ giữ fix mới nhất
+  private snapInFlight = new Map<string, boolean>()
+  private snapQueued = new Map<string, { lng: number; lat: number; waiters: Pending[] }>()
+  // Đầu vào của các route đang sống, để nạp lại vào fallback khi worker chết
+  private routeInputs = new Map<string, RouteInput>()
+
+  /** Sinh routeId duy nhất cho mỗi map instance */
+  createRouteId(prefix = 'route'): string {
+    return `${prefix}-${this.nextRouteId++}`
+  }
+
+  /** true nếu đang chạy trong Web Worker thật (false = fallback main thread) */
+  isOffMainThread(): boolean {
+    this.ensureBackend()
+    return !!this.worker
+  }
+
+  load(routeId: string, input: RouteInput): Promise<RouteGeometry> {
+    this.routeInputs.set(routeId, input)
+    const coords = input.coordinates
+    if (coords && coords.length > 0) {
+      // Làm phẳng 1 lần rồi transfer, rẻ hơn structured clone mảng lồng nhau
+      const flat = new Float64Array(coords.length * 2)
+      for (let i = 0; i < coords.length; i++) {
+        flat[i * 2] = Number(coords[i][0])
+        flat[i * 2 + 1] = Number(coords[i][1])
+      }
+      return this.request({ type: 'load', id: 0, routeId, flat }, [flat.buffer]).then((res) => res.route)
+    }
+    return this.request({ type: 'load', id: 0, routeId, encoded: input.encoded || '', precision: input.precision ?? 5 })
+      .then((res) => res.route)
+  }
+
+  /**
+   * Snap vị trí [lng, lat] lên tuyến. Khi một snap khác của cùng route đang chạy,
+   * các lời gọi dồn lại và đều nhận kết quả của vị trí mới nhất.
+   */
+  snap(routeId: string, position: Position): Promise<RouteSnap | null> {
+    const lng = Number(position[0])
+    const lat = Number(position[1])
+    if (!Number.isFinite(lng) || !Number.isFinite(lat)) return Promise.resolve(null)
+
+    return new Promise<RouteSnap | null>((resolve, reject) => {
+      if (this.snapInFlight.get(routeId)) {
+        const queued = this.snapQueued.get(routeId)
+        if (queued) {
+          queued.lng = lng
+          queued.lat = lat
+          queued.waiters.push({ resolve, reject })
+        } else {
+          this.snapQueued.set(routeId, { lng, lat, waiters: [{ resolve, reject }] })
+        }
+        return
+      }
+      this.dispatchSnap(routeId, lng, lat, [{ resolve, reject }])
+    })
+  }
+
+  release(routeId: string): void {
+    this.routeInputs.delete(routeId)
+    this.rejectQueued(routeId, new Error('Route released'))
+    this.request({ type: 'release', id: 0, routeId }).catch(() => {})
+  }
+
+  dispose(): void {
+    this.worker?.terminate()
+    this.worker = null
+    this.fallbackScope = null
+    const error = new Error('Route pipeline disposed')
+    // Waiter đang xếp hàng phải được settle trước, settle() của snap đang bay sẽ không thấy chúng nữa
+    Array.from(this.snapQueued.keys()).forEach((routeId) => this.rejectQueued(routeId, error))
+    this.pending.forEach((p) => p.reject(error))
+    this.pending.clear()
+    this.snapInFlight.clear()
+    this.routeInputs.clear()
+  }
+
+  // ============ PRIVATE METHODS ============
+
+  private dispatchSnap(routeId: string, lng: number, lat: number, waiters: Pending[]) {
+    this.snapInFlight.set(routeId, true)
+    const settle = () => {
+      this.snapInFlight.delete(routeId)
+      const queued = this.snapQueued.get(routeId)
+      if (queued) {
+        this.snapQueued.delete(routeId)
+        this.dispatchSnap(routeId, queued.lng, queued.lat, queued.waiters)
+      }
+    }
+    this.request({ type: 'snap', id: 0, routeId, lng, lat })
+      .then((res) => {
+        waiters.forEach((w) => w.resolve(res.snap))
+        settle()
+      })
+      .catch((error) => {
+        waiters.forEach((w) => w.reject(error))
+        settle()
+      })
+  }
+
+  private rejectQueued(routeId: string, error: Error) {
+    const queued = this.snapQueued.get(routeId)
+    if (!queued) return
+    this.snapQueued.delete(routeId)
+    queued.waiters.forEach((w) => w.reject(error))
+  }
+
+  private request(message: PipelineRequest, transfer?: Transferable[]): Promise<any> {
+    this.ensureBackend()
+    const id = this.nextId++
+    message.id = id
+    return new Promise((resolve, reject) => {
+      this.pending.set(id, { resolve, reject })
+      if (this.worker) {
+        this.worker.postMessage(message, transfer || [])
+      } else {
+        this.fallbackScope.onmessage({ data: message })
+      }
+    })
+  }
+
+  private handleResponse = (response: PipelineResponse) => {
+    const pending = this.pending.get(response.id)
+    if (!pending) return
+    this.pending.delete(response.id)
+    if (response.type === 'error') pending.reject(new Error(response.message))
+    else pending.resolve(response)
+  }
+
+  private ensureBackend() {
+    if (this.worker || this.fallbackScope) return
+    if (typeof Worker !== 'undefined' && typeof Blob !== 'undefined' && typeof URL !== 'undefined' && URL.createObjectURL) {
+      try {
+        const source = `(${routePipelineWorkerMain.toString()})(self)`
+        const url = URL.createObjectURL(new Blob([source], { type: 'application/javascript' }))
+        this.worker = new Worker(url)
+        URL.revokeObjectURL(url)
+        this.worker.onmessage = (event: MessageEvent) => this.handleResponse(event.data)
+        this.worker.onerror = (event) => {
+          console.warn('[RoutePipeline] Worker error, falling back to main thread', event)
+          this.failOver()
+        }
+        return
+      } catch (error) {
+        console.warn('[RoutePipeline] Worker unavailable, using main thread', error)
+        this.worker = null
+      }
+    }
+    this.installFallback()
+  }
+
+  private installFallback() {
+    // Cùng mã worker, phản hồi trả về ở microtask để giữ API bất đồng bộ như worker thật
+    const scope: any = {
+      postMessage: (data: PipelineResponse) => {
+        Promise.resolve().then(() => this.handleResponse(data))
+      }
+    }
+    routePipelineWorkerMain(scope)
+    this.fallbackScope = scope
+  }
+
+  /**
+   * Worker chết: chuyển sang main thread, nạp lại các route đang sống vào fallback
+   * rồi mới từ chối request đang bay. settle() của snap bị từ chối sẽ gửi tiếp snap
+   * đang xếp hàng sang fallback, nơi route đã có sẵn.
+   */
+  private failOver() {
+    this.worker?.terminate()
+    this.worker = null
+    const crashed = Array.from(this.pending.values())
+    this.pending.clear()
+    this.installFallback()
+    this.routeInputs.forEach((input, routeId) => {
+      this.load(routeId, input).catch((error) => {
+        console.warn('[RoutePipeline] Reload after failover failed', routeId, error)
+      })
+    })
+    const error = new Error('Route worker crashed')
+    crashed.forEach((p) => p.reject(error))
+  }
+}
+
+export const routePipeline = new RoutePipeline()
+
+export default routePipeline
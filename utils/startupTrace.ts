@@ -0,0 +1,113 @@
+import { Platform } from 'react-native'
+import { track } from '@/utils/analytics'
+import { getRoleBundleStats } from '@/utils/roleBundles'
+
+/**
+ * Startup Trace - mốc khởi động lạnh tới lúc màn home của từng role dùng được
+ *
+ * Mốc (ms tính từ performance.now() = 0: web là lúc bắt đầu điều hướng, native là
+ * lúc runtime JS khởi động):
+ *   bundle_loaded  - app/_layout nạp xong module (toàn bộ import đã chạy)
+ *   auth_restored  - authStore.restoreSession xong
+ *   first_render   - màn home của role commit lần đầu
+ *   first_data     - lượt tải dữ liệu đầu tiên của màn home xong (lỗi cũng tính, dataOk=false)
+ *
+ * Mỗi mốc chỉ ghi lần đầu; đủ first_data thì báo "startup_trace" 1 lần rồi thôi.
+ * Web kèm số file JS / byte đã giải nén tải tới lúc đó (resource timing) để thấy
+ * phần parse/evaluate tiết kiệm được nhờ tách chunk theo role (utils/roleBundles).
+ * Harness scripts/startup/startupBench.ts chèn window.__STARTUP_BENCH__ = { reportUrl, run }
+ * trước khi bundle chạy => kết quả được POST về local API stand-in để tổng hợp.
+ */
+
+export type StartupMark = 'bundle_loaded' | 'auth_restored' | 'first_render' | 'first_data'
+
+export interface StartupTraceReport {
+  role: string | null
+  platform: string
+  run: number | null
+  dataOk: boolean
+  marks: Partial<Record<StartupMark, number>>
+  /** Web: script đã tải tới lúc báo cáo */
+  scripts?: { count: number; bytes: number }
+  /** Thời gian nạp trước chunk màn home của role (utils/roleBundles) */
+  roleBundleMs?: number
+}
+
+const now = (): number =>
+  typeof performance !== 'undefined' && typeof performance.now === 'function' ? performance.now() : Date.now()
+
+const loadedScripts = (): { count: number; bytes: number } | undefined => {
+  if (typeof performance === 'undefined' || typeof performance.getEntriesByType !== 'function') return undefined
+  const entries = performance.getEntriesByType('resource') as PerformanceResourceTiming[]
+  const scripts = entries.filter((e) => e.initiatorType === 'script' || /\.js(\?|$)/.test(e.name))
+  return { count: scripts.length, bytes: scripts.reduce((sum, e) => sum + (e.decodedBodySize || 0), 0) }
+}
+
+const benchConfig = (): { reportUrl?: string; run?: number } | null =>
+  (globalThis as any).__STARTUP_BENCH__ ?? null
+
+class StartupTrace {
+  private marks: Partial<Record<StartupMark, number>> = {}
+  private role: string | null = null
+  private dataOk = true
+  private reported = false
+
+  mark(name: StartupMark) {
+    if (this.reported || this.marks[name] !== undefined) return
+    this.marks[name] = Math.round(now())
+  }
+
+  /** Màn home commit lần đầu; role lấy từ user đã khôi phục */
+  markFirstRender(role: string | undefined | null) {
+    if (this.reported || this.marks.first_render !== undefined) return
+    this.role = role ?? null
+    this.mark('first_render')
+  }
+
+  /** Lượt tải dữ liệu đầu của màn home xong => chốt và báo kết quả */
+  markFirstData(ok = true) {
+    if (this.reported || this.marks.first_render === undefined) return
+    this.dataOk = ok
+    this.mark('first_data')
+    this.report()
+  }
+
+  getReport(): StartupTraceReport {
+    return {
+      role: this.role,
+      platform: Platform.OS,
+      run: benchConfig()?.run ?? null,
+      dataOk: this.dataOk,
+      marks: { ...this.marks },
+      scripts: loadedScripts(),
+      roleBundleMs: this.role ? getRoleBundleStats()[this.role] : undefined,
+    }
+  }
+
+  // ============ PRIVATE METHODS ============
+
+  private report() {
+    this.reported = true
+    const report = this.getReport()
+    track('startup_trace', {
+      role: report.role,
+      platform: report.platform,
+      dataOk: report.dataOk,
+      ...report.marks,
+      scriptCount: report.scripts?.count,
+      scriptBytes: report.scripts?.bytes,
+      roleBundleMs: report.roleBundleMs,
+    })
+
+    const reportUrl = benchConfig()?.reportUrl
+    if (!reportUrl) return
+    fetch(reportUrl, {
+      method: 'POST',
+      headers: { 'Content-Type': 'application/json' },
+      body: JSON.stringify(report),
+    }).catch((e) => console.warn('[StartupTrace] report failed', e))
+  }
+}
+
+export const startupTrace = new StartupTrace()
+export default startupTrace
@@ -1,55 +1,198 @@
-import AsyncStorage from "@react-native-async-storage/async-storage";
+import { jwtDecode } from "jwt-decode";
+import persistedState from "@/utils/persistedState";
 
-const TOKEN_KEY = "accessToken";
+/** Làm mới khi token còn ít hơn chừng này thời gian */
+const REFRESH_MARGIN_MS = 2 * 60 * 1000;
+/** Làm mới thất bại thì thử lại sau */
+const REFRESH_RETRY_MS = 30 * 1000;
 
 /**
- * Lưu token vào AsyncStorage.
- * @param token - Chuỗi token cần lưu.
+ * Token giữ trong bộ nhớ: interceptor axios / SignalR đọc từ đây thay vì
+ * AsyncStorage mỗi request. Nạp 1 lần ở authStore.restoreSession (hydrateToken),
+ * ghi qua setToken (bộ nhớ + persistedState, flush ngay).
+ *
+ * Làm mới chủ động: hẹn giờ tới (exp - REFRESH_MARGIN_MS) thì gọi refresher do
+ * authService đăng ký; getValidToken() gặp token sắp hết hạn cũng làm mới trước khi trả.
+ * Nhiều nơi cùng cần làm mới thì dùng chung 1 promise.
  */
-export const setToken = async (token: string): Promise<void> => {
+
+export type TokenRefresher = (
+  refreshToken: string,
+  accessToken: string
+) => Promise<{ accessToken: string; refreshToken?: string } | null>;
+
+const memory: {
+  hydrated: boolean;
+  accessToken: string | null;
+  refreshToken: string | null;
+  expiresAt: number | null;
+} = { hydrated: false, accessToken: null, refreshToken: null, expiresAt: null };
+
+let refresher: TokenRefresher | null = null;
+let refreshing: Promise<string | null> | null = null;
+let refreshTimer: ReturnType<typeof setTimeout> | null = null;
+let loading: Promise<void> | null = null;
+let lastFailureAt = 0;
+
+const expiryOf = (token: string): number | null => {
   try {
-    await AsyncStorage.setItem(TOKEN_KEY, token);
-  } catch (error) {
-    console.error("Lỗi khi lưu token:", error);
+    const { exp } = jwtDecode<{ exp?: number }>(token);
+    return typeof exp === "number" ? exp * 1000 : null;
+  } catch {
+    return null;
+  }
+};
+
+const scheduleRefresh = () => {
+  if (refreshTimer) clearTimeout(refreshTimer);
+  refreshTimer = null;
+  if (!refresher || !memory.refreshToken || memory.expiresAt === null) return;
+  const delay = Math.max(0, memory.expiresAt - REFRESH_MARGIN_MS - Date.now());
+  refreshTimer = setTimeout(() => {
+    refreshTimer = null;
+    refreshToken();
+  }, delay);
+};
+
+const remember = (accessToken: string | null, refreshTokenValue?: string | null) => {
+  memory.hydrated = true;
+  memory.accessToken = accessToken;
+  memory.expiresAt = accessToken ? expiryOf(accessToken) : null;
+  if (refreshTokenValue !== undefined) memory.refreshToken = refreshTokenValue;
+  scheduleRefresh();
+};
+
+// Chưa ai hydrate (vd. gọi API trước restoreSession): đọc storage đúng 1 lần
+const ensureLoaded = (): Promise<void> => {
+  if (memory.hydrated) return Promise.resolve();
+  if (!loading) {
+    loading = persistedState
+      .hydrate()
+      .then(() => {
+        if (memory.hydrated) return;
+        remember(persistedState.get("accessToken") ?? null, persistedState.get("refreshToken") ?? null);
+      })
+      .catch((error) => {
+        console.error("Lỗi khi lấy token:", error);
+      })
+      .finally(() => {
+        loading = null;
+      });
   }
+  return loading;
+};
+
+/**
+ * Nạp token đã đọc sẵn vào bộ nhớ (authStore.restoreSession), không đọc lại storage.
+ * @param accessToken - Access token đã lưu.
+ * @param refreshTokenValue - Refresh token (nếu có).
+ */
+export const hydrateToken = (accessToken: string | null, refreshTokenValue?: string | null): void => {
+  remember(accessToken, refreshTokenValue ?? null);
 };
 
 /**
- * Lấy token từ AsyncStorage.
+ * Lưu token vào bộ nhớ và storage.
+ * @param token - Chuỗi token cần lưu.
+ * @param refreshTokenValue - Refresh token đi kèm (bỏ qua = giữ nguyên).
+ */
+export const setToken = async (token: string, refreshTokenValue?: string): Promise<void> => {
+  remember(token, refreshTokenValue);
+  persistedState.set("accessToken", token);
+  if (refreshTokenValue !== undefined) persistedState.set("refreshToken", refreshTokenValue);
+  // Token phải xuống đĩa ngay, không chờ lượt ghi gộp
+  await persistedState.flush();
+};
+
+/**
+ * Lấy token (từ bộ nhớ; lần đầu chờ persistedState.hydrate nếu chưa nạp).
  * @returns - Promise chứa chuỗi token hoặc null nếu không tìm thấy.
  */
 export const getToken = async (): Promise<string | null> => {
-  try {
-    return await AsyncStorage.getItem(TOKEN_KEY);
-  } catch (error) {
-    console.error("Lỗi khi lấy token:", error);
-    return null;
+  await ensureLoaded();
+  return memory.accessToken;
+};
+
+/**
+ * Lấy token còn hạn: sắp hết hạn thì chờ làm mới xong (dùng chung 1 lần làm mới).
+ * Làm mới lỗi thì trả token hiện tại, server sẽ trả 401 nếu thật sự hết hạn.
+ */
+export const getValidToken = async (): Promise<string | null> => {
+  await ensureLoaded();
+  const { accessToken, expiresAt } = memory;
+  // Vừa làm mới lỗi thì không bắt từng request chờ thử lại (timer sẽ thử sau)
+  const coolingDown = Date.now() - lastFailureAt < REFRESH_RETRY_MS;
+  if (accessToken && expiresAt !== null && expiresAt - Date.now() < REFRESH_MARGIN_MS && !coolingDown) {
+    return (await refreshToken()) ?? memory.accessToken;
   }
+  return accessToken;
+};
+
+/** Đăng ký hàm gọi API làm mới token (authService) */
+export const setTokenRefresher = (fn: TokenRefresher | null): void => {
+  refresher = fn;
+  scheduleRefresh();
 };
 
 /**
- * Xóa token khỏi AsyncStorage.
+ * Làm mới token ngay; lời gọi đồng thời dùng chung 1 promise.
+ * @returns - Token mới, hoặc null nếu không làm mới được.
+ */
+export const refreshToken = (): Promise<string | null> => {
+  if (refreshing) return refreshing;
+  const fn = refresher;
+  const { accessToken, refreshToken: currentRefresh } = memory;
+  if (!fn || !accessToken || !currentRefresh) return Promise.resolve(null);
+
+  refreshing = fn(currentRefresh, accessToken)
+    .then(async (result) => {
+      // Đã logout / đổi tài khoản trong lúc chờ: bỏ kết quả
+      if (!result?.accessToken || memory.accessToken !== accessToken) return null;
+      await setToken(result.accessToken, result.refreshToken ?? currentRefresh);
+      return result.accessToken;
+    })
+    .catch((error) => {
+      // Backend chưa có endpoint làm mới: gỡ refresher, không thử lại mỗi REFRESH_RETRY_MS
+      if (error?.response?.status === 404) {
+        console.warn("Endpoint làm mới token không tồn tại (404), tắt làm mới token");
+        if (refresher === fn) refresher = null;
+        return null;
+      }
+      console.warn("Lỗi khi làm mới token:", error?.message ?? error);
+      return null;
+    })
+    .then((token) => {
+      lastFailureAt = token ? 0 : Date.now();
+      // Thử lại khi token hiện tại còn hạn; hết hạn rồi thì chờ đăng nhập lại
+      if (!token && refresher && memory.accessToken === accessToken && (memory.expiresAt ?? 0) > Date.now()) {
+        if (refreshTimer) clearTimeout(refreshTimer);
+        refreshTimer = setTimeout(() => {
+          refreshTimer = null;
+          refreshToken();
+        }, REFRESH_RETRY_MS);
+      }
+      return token;
+    })
+    .finally(() => {
+      refreshing = null;
+    });
+  return refreshing;
+};
+
+/**
+ * Xóa token khỏi bộ nhớ và storage.
  */
 export const removeToken = async (): Promise<void> => {
-  try {
-    await AsyncStorage.removeItem(TOKEN_KEY);
-  } catch (error) {
-    console.error("Lỗi khi xóa token:", error);
-  }
+  remember(null, null);
+  persistedState.remove(["accessToken", "refreshToken"]);
+  await persistedState.flush();
 };
 
 /**
  * Xóa toàn bộ dữ liệu người dùng khi logout.
  */
 export const clearAllUserData = async (): Promise<void> => {
-  try {
-    await AsyncStorage.multiRemove([
-      "accessToken",
-      "user",
-      "wallet",
-      "verificationStatus",
-    ]);
-  } catch (error) {
-    console.error("Lỗi khi xóa dữ liệu người dùng:", error);
-  }
+  remember(null, null);
+  persistedState.remove(["accessToken", "refreshToken", "user", "wallet", "verificationStatus"]);
+  await persistedState.flush();
 };